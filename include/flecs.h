@@ -38,9 +38,11 @@ typedef struct ecs_time_t {
 
 /* Utility headers */
 #include <flecs/util/os_api.h>
+#include <flecs/util/slab.h>
 #include <flecs/util/vector.h>
 #include <flecs/util/chunked.h>
 #include <flecs/util/map.h>
+#include <flecs/util/sparse.h>
 #include <flecs/util/stats.h>
 #include <flecs/util/os_api.h>
 
@@ -65,6 +67,7 @@ typedef const char *EcsId;
 /** Component component */
 typedef struct EcsComponent {
     uint32_t size;
+    uint32_t alignment; /* Column alignment (0 for ECS_COLUMN_ALIGNMENT) */
 } EcsComponent;
 
 /** Prefab component */
@@ -172,10 +175,32 @@ typedef struct ecs_type_filter_t {
     ecs_type_filter_kind_t exclude_kind;
 } ecs_type_filter_t;
 
+/** A filter handle caches which tables of a system match a type filter. */
+typedef struct ecs_filter_t ecs_filter_t;
+
+/** A query caches which tables match a signature. */
+typedef struct ecs_query_t ecs_query_t;
+
+/** Iterator for the matched entities of a query. */
+typedef struct ecs_query_iter_t {
+    ecs_query_t *query;          /* Query that is iterated */
+    uint32_t index;              /* Index of next matched table */
+    uint32_t row;                /* Next row in current table */
+    uint32_t count;              /* Number of rows in current table */
+    ecs_rows_t rows;             /* Entities and columns of current iteration */
+} ecs_query_iter_t;
+
 /** System action callback type */
 typedef void (*ecs_system_action_t)(
     ecs_rows_t *data);
 
+/** Compare callback used for sorting rows by component value */
+typedef int (*ecs_compare_action_t)(
+    ecs_entity_t e1,
+    void *ptr1,
+    ecs_entity_t e2,
+    void *ptr2);
+
 /** Initialization function signature of modules */
 typedef void (*ecs_module_init_action_t)(
     ecs_world_t *world,
@@ -215,6 +240,21 @@ extern ecs_type_t
 #define ECS_SINGLETON ((ecs_entity_t)(ECS_ENTITY_FLAGS_MASK - 1))
 #define ECS_INVALID_ENTITY (0)
 
+/* The lower 32 bits of an entity handle contain its id. Bits 32-47 contain a
+ * generation, which is incremented when a deleted id is reused. */
+#define ECS_ENTITY_ID_MASK ((ecs_entity_t)0xFFFFFFFF)
+#define ECS_GENERATION_MASK ((ecs_entity_t)0xFFFF << 32)
+#define ECS_GENERATION(e) (((e) & ECS_GENERATION_MASK) >> 32)
+#define ECS_GENERATION_INC(e)\
+    (((e) & ~ECS_GENERATION_MASK) |\
+        (((e) + ((ecs_entity_t)1 << 32)) & ECS_GENERATION_MASK))
+
+/* Component columns are allocated so that the first element is aligned to at
+ * least this many bytes (one cache line), which allows systems to use aligned
+ * SIMD loads on column data. Components can request a larger alignment by
+ * setting EcsComponent::alignment before the component is added to entities. */
+#define ECS_COLUMN_ALIGNMENT (64)
+
 /* This allows passing 0 as type to functions that accept types */
 #define T0 (0)
 
@@ -458,6 +498,114 @@ void ecs_set_automerge(
     ecs_world_t *world,
     bool auto_merge);
 
+/** Automatically shrink tables with low occupancy.
+ * When enabled, ecs_progress releases unused memory of tables (see ecs_shrink)
+ * of which the number of entities has stayed below the specified fraction of
+ * the allocated number of rows for the specified number of frames. This
+ * prevents a world from holding on to memory after a temporary spike in the
+ * number of entities.
+ *
+ * @param world The world.
+ * @param threshold Occupancy (between 0 and 1) below which tables are shrunk,
+ *                  or 0 to disable automatic shrinking.
+ * @param frames Number of consecutive frames a table must stay below the 
+ *               threshold before it is shrunk.
+ */
+FLECS_EXPORT
+void ecs_set_autoshrink(
+    ecs_world_t *world,
+    float threshold,
+    uint32_t frames);
+
+/** Automatically delete empty tables.
+ * When enabled, ecs_progress deletes tables (see ecs_gc) that have been empty
+ * for the specified number of consecutive frames.
+ *
+ * @param world The world.
+ * @param frames Number of frames a table must be empty before it is deleted,
+ *               or 0 to disable automatically deleting tables.
+ */
+FLECS_EXPORT
+void ecs_set_autogc(
+    ecs_world_t *world,
+    uint32_t frames);
+
+/** Set the size of table column chunks.
+ * By default, the components of a table are stored in contiguous arrays that
+ * are reallocated when the table grows. This moves existing components in
+ * memory, which requires systems to revalidate cached pointers to components
+ * of other entities. Growing a large table also copies all of its components.
+ *
+ * When a chunk size is set, tables store their components in fixed-size chunks
+ * instead. Adding entities to a table then never moves existing components.
+ * Systems are invoked once per chunk, so rows->count never exceeds the number
+ * of rows that fit in a chunk.
+ *
+ * The chunk size only applies to tables created after this operation is called.
+ * The number of rows per chunk is the largest power of two for which a row of
+ * the largest component in the table still fits in the chunk.
+ *
+ * @param world The world.
+ * @param size The size of a chunk in bytes, or 0 to use contiguous storage.
+ */
+FLECS_EXPORT
+void ecs_set_table_chunk_size(
+    ecs_world_t *world,
+    uint32_t size);
+
+/** Allocate large column buffers from a separate arena.
+ * Storage that is owned by the main thread, like table columns and the tables
+ * matched by systems, is allocated from a slab allocator of the world. Memory
+ * released by one table is then reused by the next, instead of being returned
+ * to the OS heap. Allocations that exceed the largest size class of the slab
+ * (16KB) go to the OS heap. In practice these are the columns of large tables.
+ *
+ * When the column arena is enabled, these allocations are served from a second
+ * slab with size classes up to 8MB. This benefits applications that frequently
+ * create and delete large tables, at the cost of retaining the memory of
+ * deleted tables. Statistics for both allocators are reported by ecs_get_stats.
+ *
+ * @param world The world.
+ * @param enable Whether to route large column allocations to the arena.
+ */
+FLECS_EXPORT
+void ecs_set_column_arena(
+    ecs_world_t *world,
+    bool enable);
+
+/** Store a component in a sparse set instead of in tables.
+ * Adding or removing a component moves an entity to another table, which copies
+ * all of its other components. For components that are added and removed
+ * frequently, like tags that mark an entity as selected or dirty, this can be
+ * expensive. A sparse component is stored in a set that is indexed by entity
+ * id, which makes adding and removing it O(1) without moving the entity.
+ *
+ * Sparse components can be used with ecs_add, ecs_remove, ecs_set, ecs_has,
+ * ecs_get_ptr and ecs_count like regular components. Column systems can match
+ * them as regular (And), optional or Not columns from self. Matched entities
+ * are filtered while the system runs. If the system reads data from a sparse
+ * component the system is invoked once per entity, and the component column
+ * is passed as a shared column.
+ *
+ * Sparse components are not part of the entity type (see ecs_get_type), do not
+ * trigger OnAdd, OnRemove or OnSet systems, and cannot be inherited from
+ * prefabs. Changes made by worker threads are applied when the thread stage is
+ * merged.
+ *
+ * This operation must be called before the component is added to an entity,
+ * and before systems that use the component are created.
+ *
+ * @param world The world.
+ * @param component The component to store in a sparse set.
+ */
+FLECS_EXPORT
+void _ecs_set_sparse_storage(
+    ecs_world_t *world,
+    ecs_entity_t component);
+
+#define ecs_set_sparse_storage(world, component)\
+    _ecs_set_sparse_storage(world, ecs_entity(component))
+
 /** Set number of worker threads.
  * This operation sets the number of worker threads to which to distribute the
  * processing load. If this function is called multiple times, the total number
@@ -627,6 +775,56 @@ void _ecs_dim_type(
 #define ecs_dim_type(world, type, entity_count)\
     _ecs_dim_type(world, T##type, entity_count)
 
+/** Release memory that is not used by tables.
+ * Tables keep the memory of their columns when entities are deleted or moved to
+ * other tables, so that memory does not have to be reallocated when entities
+ * are added again. After a large number of entities has been deleted, this
+ * operation can be used to return unused memory. Tables that are empty release
+ * all of their memory.
+ *
+ * This operation may move components in memory, and should not be called while
+ * iterating.
+ *
+ * @param world The world.
+ */
+FLECS_EXPORT
+void ecs_shrink(
+    ecs_world_t *world);
+
+/** Delete empty tables.
+ * When entities are created with a new combination of components, a table is
+ * created for that combination. Tables are not deleted when they become empty,
+ * so applications that use many transient combinations of components can end
+ * up with a large number of empty tables. Empty tables do not cost time when
+ * systems are ran, but they do have to be evaluated when new systems are
+ * created and when counting or iterating entities with a filter.
+ *
+ * This operation deletes all empty tables. A table is recreated when an entity
+ * is created with its combination of components again. This operation should 
+ * not be called while iterating.
+ *
+ * @param world The world.
+ */
+FLECS_EXPORT
+void ecs_gc(
+    ecs_world_t *world);
+
+/** Release memory that is not used by a type (table).
+ * This operation is the same as ecs_shrink, but only releases memory of the
+ * table for the specified type.
+ *
+ * @param world The world.
+ * @param type Handle to the type, as obtained by ecs_type_get.
+ */
+FLECS_EXPORT
+void _ecs_shrink_type(
+    ecs_world_t *world,
+    ecs_type_t type);
+
+/* Macro to ensure you don't accidentally pass a non-type into the function */
+#define ecs_shrink_type(world, type)\
+    _ecs_shrink_type(world, T##type)
+
 /** Set a range for issueing new entity ids.
  * This function constrains the entity identifiers returned by ecs_new to the 
  * specified range. This operation can be used to ensure that multiple processes
@@ -859,14 +1057,15 @@ ecs_entity_t ecs_clone(
     ecs_entity_t entity,
     bool copy_value);
 
-/** Delete components for an entity.
- * This operation will delete all components from the specified entity. As
- * entities in Flecs do not have an explicit lifecycle, this operation will not
- * invalidate the entity id.
+/** Delete an entity.
+ * This operation will delete all components from the specified entity, and
+ * invalidate the entity handle. The id of the entity is recycled by subsequent
+ * calls to ecs_new, with an incremented generation. As a result, the deleted
+ * handle will not refer to the new entity, which can be tested with
+ * ecs_is_alive.
  *
  * When the delete operation is invoked upon an already deleted entity, the
- * operation will have no effect, as it will attempt to delete components from
- * an already empty entity.
+ * operation will have no effect.
  *
  * As a result of a delete operation, EcsOnRemove systems will be invoked if
  * applicable for any of the removed components.
@@ -879,6 +1078,39 @@ void ecs_delete(
     ecs_world_t *world,
     ecs_entity_t entity);
 
+/** Delete a range of entities.
+ * This operation deletes count entities, starting from the specified entity.
+ * It is equivalent to calling ecs_delete for each entity in the range, but
+ * entities are deleted in bulk: EcsOnRemove systems are invoked once for each
+ * range of entities that is stored in subsequent rows of a table, and each
+ * table is compacted once. Entities in the range that are not alive are
+ * ignored.
+ *
+ * @param world The world.
+ * @param entity The first entity to delete.
+ * @param count The number of entities to delete.
+ */
+FLECS_EXPORT
+void ecs_delete_w_count(
+    ecs_world_t *world,
+    ecs_entity_t entity,
+    uint32_t count);
+
+/** Delete an array of entities.
+ * This operation is equivalent to ecs_delete_w_count, for entities that do not
+ * have to be consecutive. The array may contain entities that are not alive,
+ * or that occur more than once.
+ *
+ * @param world The world.
+ * @param entities The entities to delete.
+ * @param count The number of entities in the array.
+ */
+FLECS_EXPORT
+void ecs_delete_n(
+    ecs_world_t *world,
+    const ecs_entity_t *entities,
+    uint32_t count);
+
 /** Delete all entities containing a (set of) component(s). 
  * This operation provides a more efficient alternative to deleting entities one
  * by one by deleting an entire table or set of tables in a single operation.
@@ -961,6 +1193,71 @@ void _ecs_add_remove(
 #define ecs_add_remove(world, entity, to_add, to_remove)\
     _ecs_add_remove(world, entity, T##to_add, T##to_remove)
 
+/** Add a type to a range of entities.
+ * This operation adds a type to the entities [entity, entity + count). The
+ * result is the same as calling ecs_add for each entity in the range, but
+ * entities that are stored next to each other in the same table (which is the
+ * case for entities created with ecs_new_w_count) are moved to the new table
+ * at once, with a single copy per component column.
+ *
+ * @param world The world.
+ * @param entity The first entity in the range.
+ * @param count The number of entities in the range.
+ * @param type The type to add to the entities.
+ */
+FLECS_EXPORT
+void _ecs_add_w_count(
+    ecs_world_t *world,
+    ecs_entity_t entity,
+    uint32_t count,
+    ecs_type_t type);
+
+/* Macro to ensure you don't accidentally pass a non-type into the function */
+#define ecs_add_w_count(world, entity, count, type)\
+    _ecs_add_w_count(world, entity, count, T##type)
+
+/** Remove a type from a range of entities.
+ * This operation is the same as ecs_add_w_count, but removes the type from the
+ * entities [entity, entity + count).
+ *
+ * @param world The world.
+ * @param entity The first entity in the range.
+ * @param count The number of entities in the range.
+ * @param type The type to remove from the entities.
+ */
+FLECS_EXPORT
+void _ecs_remove_w_count(
+    ecs_world_t *world,
+    ecs_entity_t entity,
+    uint32_t count,
+    ecs_type_t type);
+
+/* Macro to ensure you don't accidentally pass a non-type into the function */
+#define ecs_remove_w_count(world, entity, count, type)\
+    _ecs_remove_w_count(world, entity, count, T##type)
+
+/** Add and remove types from a range of entities.
+ * This operation is the same as ecs_add_remove, but adds and removes the types
+ * for the entities [entity, entity + count). See ecs_add_w_count.
+ *
+ * @param world The world.
+ * @param entity The first entity in the range.
+ * @param count The number of entities in the range.
+ * @param to_add The type to add to the entities.
+ * @param to_remove The type to remove from the entities.
+ */
+FLECS_EXPORT
+void _ecs_add_remove_w_count(
+    ecs_world_t *world,
+    ecs_entity_t entity,
+    uint32_t count,
+    ecs_type_t to_add,
+    ecs_type_t to_remove);
+
+/* Macro to ensure you don't accidentally pass a non-type into the function */
+#define ecs_add_remove_w_count(world, entity, count, to_add, to_remove)\
+    _ecs_add_remove_w_count(world, entity, count, T##to_add, T##to_remove)
+
 /** Adopt a child entity by a parent.
  * This operation adds the specified parent entity to the type of the specified
  * entity, which effectively establishes a parent-child relationship. The parent
@@ -1240,6 +1537,77 @@ bool ecs_contains(
     ecs_entity_t parent,
     ecs_entity_t child);
 
+/** Enable or disable a component for an entity.
+ * A disabled component is not removed from the entity, but column systems skip
+ * the entity as long as one of the components it matches from the entity
+ * itself is disabled. Other operations, like ecs_has and ecs_get_ptr, are not
+ * affected.
+ *
+ * Unlike adding or removing a tag, this operation does not move the entity to
+ * another table, and is therefore cheap enough to call every frame. The state
+ * is kept when the entity moves to another table, and is reset when the
+ * component is removed. Components are enabled by default.
+ *
+ * The entity must own the component. This operation may be called while
+ * iterating, unless the world has worker threads.
+ *
+ * @param world The world.
+ * @param entity The entity.
+ * @param component The component to enable or disable.
+ * @param enabled true to enable the component, false to disable it.
+ */
+FLECS_EXPORT
+void _ecs_enable_component(
+    ecs_world_t *world,
+    ecs_entity_t entity,
+    ecs_entity_t component,
+    bool enabled);
+
+#define ecs_enable_component(world, entity, component, enabled)\
+    _ecs_enable_component(world, entity, ecs_entity(component), enabled)
+
+/** Test if a component is enabled for an entity.
+ *
+ * @param world The world.
+ * @param entity The entity.
+ * @param component The component.
+ * @returns true if the entity owns the component and it is enabled.
+ */
+FLECS_EXPORT
+bool _ecs_is_component_enabled(
+    ecs_world_t *world,
+    ecs_entity_t entity,
+    ecs_entity_t component);
+
+#define ecs_is_component_enabled(world, entity, component)\
+    _ecs_is_component_enabled(world, entity, ecs_entity(component))
+
+/** Enable or disable an entity.
+ * A disabled entity is skipped by all column systems, except for systems that
+ * match EcsDisabled. As with ecs_enable_component, this does not change the
+ * type of the entity. The entity must have at least one component.
+ *
+ * @param world The world.
+ * @param entity The entity to enable or disable.
+ * @param enabled true to enable the entity, false to disable it.
+ */
+FLECS_EXPORT
+void ecs_enable_entity(
+    ecs_world_t *world,
+    ecs_entity_t entity,
+    bool enabled);
+
+/** Test if an entity is enabled (see ecs_enable_entity).
+ *
+ * @param world The world.
+ * @param entity The entity.
+ * @returns true if the entity is enabled, otherwise false.
+ */
+FLECS_EXPORT
+bool ecs_is_entity_enabled(
+    ecs_world_t *world,
+    ecs_entity_t entity);
+
 /** Return container for component.
  * This function allows the application to query for a container of the
  * specified entity that has the specified component. If there are multiple
@@ -1309,6 +1677,21 @@ bool ecs_is_empty(
     ecs_world_t *world,
     ecs_entity_t entity);
 
+/** Return if the entity is alive.
+ * This returns whether the provided entity handle refers to an entity that has
+ * been created and not deleted. Handles of deleted entities are not alive, even
+ * after their id has been recycled. Entities created or deleted while in
+ * progress are only reflected after the stage has been merged.
+ *
+ * @param world The world.
+ * @param entity The entity handle.
+ * @returns true if alive, false if not alive.
+ */
+FLECS_EXPORT
+bool ecs_is_alive(
+    ecs_world_t *world,
+    ecs_entity_t entity);
+
 /** Returns number of entities that have a given type. 
  * This operation will count the number of entities that have all of the
  * components in the specified type.
@@ -1329,9 +1712,11 @@ uint32_t _ecs_count(
 
 /** Lookup an entity by id.
  * This operation is a convenient way to lookup entities by string identifier
- * that have the EcsId component. It is recommended to cache the result of this
- * function, as the function must iterates over all entities and all components
- * in an entity.
+ * that have the EcsId component. Entities are found through a name index, which
+ * is updated when EcsId is set with ecs_set, ecs_set_w_data or ecs_clone. An
+ * id that is assigned by writing to the pointer returned by ecs_get_ptr is not
+ * added to the index. Ids set while in progress can be found by the thread that
+ * set them, and by all threads after the stage is merged.
  *
  * @param world The world.
  * @param id The id to lookup.
@@ -1683,6 +2068,138 @@ ecs_entity_t _ecs_run_w_filter(
 #define ecs_run_w_filter(world, system, delta_time, offset, limit, type, param)\
     _ecs_run_w_filter(world, system, delta_time, offset, limit, T##type, param)
 
+/** Create a filter handle.
+ * A filter handle filters the entities of a system in the same way as the type
+ * filter of ecs_run_w_filter. The handle caches the matched tables of the
+ * system that contain the components of the filter, which makes running a
+ * system with a filter as cheap as running it without. The cache is only
+ * recomputed when the tables of the system change.
+ *
+ * A filter handle can be used with more than one system, but only caches the
+ * tables of the last system it was used with. A filter handle must not be used
+ * by multiple threads at the same time.
+ *
+ * @param world The world.
+ * @param type The components that matched entities must have.
+ * @returns A new filter handle.
+ */
+FLECS_EXPORT
+ecs_filter_t* _ecs_filter_new(
+    ecs_world_t *world,
+    ecs_type_t type);
+
+#define ecs_filter_new(world, type)\
+    _ecs_filter_new(world, T##type)
+
+/** Free a filter handle.
+ *
+ * @param filter The filter handle to free.
+ */
+FLECS_EXPORT
+void ecs_filter_free(
+    ecs_filter_t *filter);
+
+/** Run system with offset/limit and a filter handle.
+ * This operation is the same as ecs_run_w_filter, but uses a filter handle
+ * created with ecs_filter_new instead of a type.
+ *
+ * @param world The world.
+ * @param system The system to invoke.
+ * @param delta_time: The time passed since the last system invocation.
+ * @param offset The number of entities to skip.
+ * @param limit The maximum number of entities to iterate (0 for no limit).
+ * @param filter The filter handle.
+ * @param param A user-defined parameter to pass to the system.
+ * @returns handle to last evaluated entity if system was interrupted.
+ */
+FLECS_EXPORT
+ecs_entity_t ecs_run_w_filter_handle(
+    ecs_world_t *world,
+    ecs_entity_t system,
+    float delta_time,
+    uint32_t offset,
+    uint32_t limit,
+    ecs_filter_t *filter,
+    void *param);
+
+/** Sort the tables of a system by a component.
+ * This operation keeps the rows of the tables matched by a system sorted by the
+ * value of the specified component, using the provided comparator. Iterating
+ * the system then visits entities in order of that value, for example a
+ * spatial cell or a material id, which improves cache locality for systems
+ * that access neighbouring entities, and avoids a separate sort for ordered
+ * rendering.
+ *
+ * Tables are sorted once per frame, at the start of ecs_progress, and when the
+ * system is ran with ecs_run outside of ecs_progress. Entities added while in
+ * progress are appended to their table until the next frame. Only tables that
+ * own the component are sorted. Sorting only moves rows if the table is not
+ * already sorted, and is stable, so rows with equal values keep their order.
+ *
+ * Because the rows of a table are shared between systems, tables matched by
+ * more than one system should only be sorted by one of them.
+ *
+ * @param world The world.
+ * @param system The column system for which to sort tables.
+ * @param component The component to sort by.
+ * @param compare The comparator, or NULL to stop sorting.
+ */
+FLECS_EXPORT
+void _ecs_set_system_sort(
+    ecs_world_t *world,
+    ecs_entity_t system,
+    ecs_entity_t component,
+    ecs_compare_action_t compare);
+
+#define ecs_set_system_sort(world, system, component, compare)\
+    _ecs_set_system_sort(world, system, ecs_entity(component), compare)
+
+/** Declare the components that a column system writes.
+ * Table columns keep track of when they were last written. Columns are marked
+ * as written by ecs_set, ecs_set_w_data, when the data of a stage is merged,
+ * and by column systems that declare that they write the column with this
+ * operation. Adding, removing, disabling or sorting entities marks the entity
+ * column of a table as written. Writes through pointers returned by
+ * ecs_get_ptr or by systems that did not declare them are not tracked.
+ *
+ * After a system has ran for a table, the columns of the table that the system
+ * matched for the provided components are marked as written.
+ *
+ * @param world The world.
+ * @param system The column system.
+ * @param type The components written by the system, or NULL for none.
+ */
+FLECS_EXPORT
+void _ecs_set_system_writes(
+    ecs_world_t *world,
+    ecs_entity_t system,
+    ecs_type_t type);
+
+#define ecs_set_system_writes(world, system, type)\
+    _ecs_set_system_writes(world, system, T##type)
+
+/** Only run a column system for tables that changed.
+ * When enabled, a system skips tables of which none of the columns that it
+ * reads from the table, nor the entity column, were written since the previous
+ * time the system ran (see ecs_set_system_writes). This makes systems that
+ * react to changes, like rebuilding a spatial index, cheap when nothing
+ * changed.
+ *
+ * A system is not invoked for changes it made itself, except when it runs on
+ * multiple threads, in which case its own writes are visible the next time it
+ * runs. Changes to components that the system reads from other entities, like
+ * containers or prefabs, are not detected.
+ *
+ * @param world The world.
+ * @param system The column system.
+ * @param enabled true to only run the system on changed tables.
+ */
+FLECS_EXPORT
+void ecs_set_system_on_change(
+    ecs_world_t *world,
+    ecs_entity_t system,
+    bool enabled);
+
 /** Set system context.
  * This operation allows an application to register custom data with a system.
  * This data can be accessed using the ecs_get_system_context operation, or
@@ -1870,12 +2387,88 @@ FLECS_EXPORT
 ecs_type_t ecs_table_type(
     ecs_rows_t *rows);
 
-/** Get type of table that system is currently iterating over. */
+/** Get column of table that system is currently iterating over.
+ * This returns a pointer to the first row of the table, which means that the
+ * component of the first entity passed to the system is at index rows->offset.
+ * 
+ * If the table stores its components in chunks (see ecs_set_table_chunk_size)
+ * the system is invoked once per chunk. The returned pointer can then only be
+ * indexed from rows->offset up to rows->offset + rows->count, which are the
+ * rows of the chunk that is being iterated. */
 FLECS_EXPORT
 void* ecs_table_column(
     ecs_rows_t *rows,
     uint32_t column);
 
+/* -- Query API -- */
+
+/** Create a query.
+ * A query matches entities with a signature, in the same way as a column
+ * system, but is not invoked by ecs_progress. Instead, the application iterates
+ * the matched entities of a query with ecs_query_iter and ecs_query_next, for
+ * example:
+ *
+ * ecs_query_iter_t it = ecs_query_iter(query);
+ * while (ecs_query_next(&it)) {
+ *     ECS_COLUMN(&it.rows, Position, p, 1);
+ *     for (int i = 0; i < it.rows.count; i ++) {
+ *         p[i].x ++;
+ *     }
+ * }
+ *
+ * A query caches the tables that match its signature. Tables that are created
+ * after the query are matched when they are created, so that iterating a query
+ * does not require matching. Signatures with SYSTEM columns or sparse
+ * components are not supported by queries.
+ *
+ * Queries are rematched when a change happens to a container or prefab, at the
+ * start of ecs_progress, in the same way as systems. Queries that are not freed
+ * by the application are freed by ecs_fini.
+ *
+ * @param world The world.
+ * @param sig The signature of the query. The string must remain valid for the
+ *            lifetime of the query.
+ * @returns A new query.
+ */
+FLECS_EXPORT
+ecs_query_t* ecs_query_new(
+    ecs_world_t *world,
+    const char *sig);
+
+/** Free a query.
+ *
+ * @param query The query to free.
+ */
+FLECS_EXPORT
+void ecs_query_free(
+    ecs_query_t *query);
+
+/** Create an iterator for a query.
+ * Entities must not be added to or removed from the tables of the query while
+ * it is iterated. Operations on a world that is in progress are staged, and can
+ * be used while iterating.
+ *
+ * @param query The query to iterate.
+ * @returns An iterator positioned before the first matched entities.
+ */
+FLECS_EXPORT
+ecs_query_iter_t ecs_query_iter(
+    ecs_query_t *query);
+
+/** Progress a query iterator.
+ * Each iteration sets the rows member of the iterator to a range of entities
+ * that are stored contiguously, which can be accessed with the same macro's
+ * that are used in systems, like ECS_COLUMN. Empty tables and disabled entities
+ * are skipped. If the query has no columns that match tables, it is iterated
+ * once with a count of zero.
+ *
+ * @param it The iterator.
+ * @returns true if the iterator has entities, false if iteration is done.
+ */
+FLECS_EXPORT
+bool ecs_query_next(
+    ecs_query_iter_t *it);
+
 /* -- Functions used in convenience macro's -- */
 
 /** Convenience function to create an entity with id and component expression.
@@ -5,12 +5,18 @@
 extern "C" {
 #endif
 
+/* Maps are open addressing hash tables. Slots are divided in groups of 16, and
+ * each slot has a control byte that stores 7 bits of the hash of its key. A
+ * lookup compares the control bytes of a group in parallel (SSE2 or NEON, with
+ * a scalar fallback) and only loads the keys of slots with a matching byte.
+ * Elements move when a map is resized, so pointers returned by the map are only
+ * valid until the next insertion. */
+
 typedef struct ecs_map_t ecs_map_t;
 
 typedef struct ecs_map_iter_t {
     ecs_map_t *map;
-    uint32_t bucket_index;
-    uint32_t node;
+    uint32_t index;
 } ecs_map_iter_t;
 
 FLECS_EXPORT
@@ -18,6 +24,13 @@ ecs_map_t* ecs_map_new(
     uint32_t size,
     uint32_t elem_size);
 
+/** Create a map that allocates its memory from a slab */
+FLECS_EXPORT
+ecs_map_t* ecs_map_new_w_slab(
+    uint32_t size,
+    uint32_t elem_size,
+    ecs_slab_t *slab);
+
 FLECS_EXPORT
 void ecs_map_free(
     ecs_map_t *map);
@@ -0,0 +1,103 @@
+#ifndef FLECS_SLAB_H
+#define FLECS_SLAB_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* A slab allocator serves allocations from free lists that are bucketed by
+ * size class. Sizes up to 128 bytes are rounded up to a multiple of 16, larger
+ * sizes have four classes per power of two. Small classes are carved from
+ * blocks of ECS_SLAB_BLOCK_SIZE bytes, larger classes are allocated one at a
+ * time from the OS heap. Memory is never returned to the OS heap until the
+ * slab is freed, but is reused by later allocations of the same class.
+ *
+ * Allocations that exceed the max_size of a slab are routed to its arena, if
+ * one is set, or otherwise to the OS heap.
+ *
+ * A bump slab instead allocates by incrementing a pointer in a block. Released
+ * memory is not reused until the slab is reset, which releases everything that
+ * was allocated from it at once.
+ *
+ * A slab is not thread safe. Memory must be released on the thread that owns
+ * the slab, and a slab must outlive all memory allocated from it. */
+
+typedef struct ecs_slab_t ecs_slab_t;
+
+typedef struct ecs_slab_stats_t {
+    uint32_t allocd;        /* Bytes allocated from the OS heap */
+    uint32_t used;          /* Bytes of size classes that are in use */
+    uint32_t alloc_count;   /* Number of allocations */
+    uint32_t os_alloc_count; /* Number of allocations from the OS heap */
+} ecs_slab_stats_t;
+
+#define ECS_SLAB_BLOCK_SIZE (64 * 1024)
+
+FLECS_EXPORT
+ecs_slab_t* ecs_slab_new(
+    uint32_t max_size);
+
+/** Create a bump slab. Blocks are at least block_size bytes. */
+FLECS_EXPORT
+ecs_slab_t* ecs_slab_new_bump(
+    uint32_t block_size);
+
+FLECS_EXPORT
+void ecs_slab_free(
+    ecs_slab_t *slab);
+
+/** Release all memory of a bump slab. Blocks are kept for reuse. */
+FLECS_EXPORT
+void ecs_slab_reset(
+    ecs_slab_t *slab);
+
+/** Route allocations that are larger than max_size to another slab. */
+FLECS_EXPORT
+void ecs_slab_set_arena(
+    ecs_slab_t *slab,
+    ecs_slab_t *arena);
+
+/** Allocate memory. If slab is NULL, memory is allocated from the OS heap. */
+FLECS_EXPORT
+void* ecs_slab_alloc(
+    ecs_slab_t *slab,
+    uint32_t size);
+
+FLECS_EXPORT
+void* ecs_slab_calloc(
+    ecs_slab_t *slab,
+    uint32_t size);
+
+FLECS_EXPORT
+void* ecs_slab_realloc(
+    ecs_slab_t *slab,
+    void *ptr,
+    uint32_t size);
+
+/** Release memory. The slab must be the one passed to ecs_slab_alloc. */
+FLECS_EXPORT
+void ecs_slab_release(
+    ecs_slab_t *slab,
+    void *ptr);
+
+/** Get the slab (or arena) that owns memory returned by ecs_slab_alloc. */
+FLECS_EXPORT
+ecs_slab_t* ecs_slab_owner(
+    void *ptr);
+
+FLECS_EXPORT
+void ecs_slab_get_stats(
+    ecs_slab_t *slab,
+    ecs_slab_stats_t *stats);
+
+FLECS_EXPORT
+void ecs_slab_memory(
+    ecs_slab_t *slab,
+    uint32_t *allocd,
+    uint32_t *used);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
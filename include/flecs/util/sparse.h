@@ -0,0 +1,117 @@
+#ifndef FLECS_SPARSE_H
+#define FLECS_SPARSE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* A sparse set stores elements in pages that are directly indexed by key. This
+ * makes it a good fit for keys that are mostly dense and increasing, like
+ * entity identifiers, as a lookup only requires loading the page and then the
+ * element. A dense array of keys enables fast iteration. Keys that are too
+ * large to be stored in pages are stored in a map.
+ *
+ * Keys smaller than 2^48 are paged by their lower 32 bits. The bits above that
+ * are a generation: an index can be stored with only one generation at a time,
+ * and a lookup with a different generation does not find the element. This
+ * allows for detecting stale keys after an index is reused. */
+
+typedef struct ecs_sparse_t ecs_sparse_t;
+
+typedef struct ecs_sparse_iter_t {
+    ecs_sparse_t *sparse;
+    uint32_t index;
+} ecs_sparse_iter_t;
+
+FLECS_EXPORT
+ecs_sparse_t* ecs_sparse_new(
+    uint32_t size,
+    uint32_t elem_size);
+
+FLECS_EXPORT
+void ecs_sparse_free(
+    ecs_sparse_t *sparse);
+
+FLECS_EXPORT
+void ecs_sparse_clear(
+    ecs_sparse_t *sparse);
+
+FLECS_EXPORT
+void ecs_sparse_memory(
+    ecs_sparse_t *sparse,
+    uint32_t *allocd,
+    uint32_t *used);
+
+FLECS_EXPORT
+uint32_t ecs_sparse_count(
+    ecs_sparse_t *sparse);
+
+FLECS_EXPORT
+uint32_t ecs_sparse_set_size(
+    ecs_sparse_t *sparse,
+    uint32_t size);
+
+FLECS_EXPORT
+uint32_t ecs_sparse_grow(
+    ecs_sparse_t *sparse,
+    uint32_t size);
+
+/* Returns NULL if a different generation of the index of key is set */
+FLECS_EXPORT
+void* _ecs_sparse_set(
+    ecs_sparse_t *sparse,
+    uint64_t key,
+    const void *data,
+    uint32_t size);
+
+#define ecs_sparse_set(sparse, key, data)\
+    _ecs_sparse_set(sparse, key, data, sizeof(*(data)))
+
+FLECS_EXPORT
+bool _ecs_sparse_has(
+    ecs_sparse_t *sparse,
+    uint64_t key,
+    void *value_out,
+    uint32_t size);
+
+#define ecs_sparse_has(sparse, key, data)\
+    _ecs_sparse_has(sparse, key, data, sizeof(*(data)))
+
+FLECS_EXPORT
+void* ecs_sparse_get_ptr(
+    ecs_sparse_t *sparse,
+    uint64_t key);
+
+/* Test if a different generation of the index of key is set */
+FLECS_EXPORT
+bool ecs_sparse_is_stale(
+    ecs_sparse_t *sparse,
+    uint64_t key);
+
+FLECS_EXPORT
+int ecs_sparse_remove(
+    ecs_sparse_t *sparse,
+    uint64_t key);
+
+FLECS_EXPORT
+ecs_sparse_iter_t ecs_sparse_iter(
+    ecs_sparse_t *sparse);
+
+FLECS_EXPORT
+bool ecs_sparse_hasnext(
+    ecs_sparse_iter_t *it);
+
+FLECS_EXPORT
+void* ecs_sparse_next(
+    ecs_sparse_iter_t *it);
+
+FLECS_EXPORT
+void* ecs_sparse_next_w_key(
+    ecs_sparse_iter_t *it,
+    uint64_t *key_out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
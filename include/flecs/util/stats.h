@@ -63,6 +63,10 @@ typedef struct ecs_world_stats_t {
     float frame_time;
     float merge_time;
     EcsMemoryStats memory;
+    ecs_slab_stats_t allocator;
+    ecs_slab_stats_t column_arena;
+    uint32_t type_merge_hits;
+    uint32_t type_merge_misses;
     ecs_vector_t *features;
     ecs_vector_t *on_load_systems;
     ecs_vector_t *post_load_systems;
@@ -24,6 +24,8 @@ struct ecs_vector_params_t {
     void *move_ctx;
     void *ctx;
     uint32_t element_size; /* Size of an element */
+    uint32_t alignment; /* Alignment of the buffer (power of two, 0 for default) */
+    ecs_slab_t *slab; /* Allocator for new buffers (NULL for the OS heap) */
 };
 
 FLECS_EXPORT
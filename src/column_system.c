@@ -16,6 +16,14 @@ const ecs_vector_params_t matched_column_params = {
     .element_size = sizeof(uint32_t)
 };
 
+const ecs_vector_params_t sparse_column_params = {
+    .element_size = sizeof(ecs_sparse_column_t)
+};
+
+static ecs_vector_params_t filter_table_params = {
+    .element_size = sizeof(int32_t)
+};
+
 static
 ecs_entity_t components_contains(
     ecs_world_t *world,
@@ -32,7 +40,7 @@ ecs_entity_t components_contains(
 
         if (entity & ECS_CHILDOF) {
             entity &= ECS_ENTITY_MASK;
-            ecs_row_t *row = ecs_map_get_ptr(world->main_stage.entity_index, entity);
+            ecs_row_t *row = ecs_sparse_get_ptr(world->main_stage.entity_index, entity);
             ecs_assert(row != 0, ECS_INTERNAL_ERROR, NULL);
 
             ecs_entity_t component = ecs_type_contains(
@@ -56,7 +64,7 @@ ecs_entity_t ecs_get_entity_for_component(
     ecs_entity_t component)
 {
     if (entity) {
-        ecs_row_t *row = ecs_map_get_ptr(world->main_stage.entity_index, entity);
+        ecs_row_t *row = ecs_sparse_get_ptr(world->main_stage.entity_index, entity);
         ecs_assert(row != NULL, ECS_INTERNAL_ERROR, NULL);
         type = row->type;
     }
@@ -78,6 +86,24 @@ ecs_entity_t ecs_get_entity_for_component(
 }
 
 /** Add table to system, compute offsets for system components in table rows */
+/** Get sparse column for system column, NULL if column is not sparse */
+static
+ecs_sparse_column_t* get_sparse_column(
+    EcsSystem *system_data,
+    uint32_t column)
+{
+    ecs_sparse_column_t *columns = ecs_vector_first(system_data->sparse_columns);
+    uint32_t i, count = ecs_vector_count(system_data->sparse_columns);
+
+    for (i = 0; i < count; i ++) {
+        if (columns[i].column == column) {
+            return &columns[i];
+        }
+    }
+
+    return NULL;
+}
+
 static
 void add_table(
     ecs_world_t *world,
@@ -91,8 +117,9 @@ void add_table(
 
     /* Initially always add table to inactive group. If the system is registered
      * with the table and the table is not empty, the table will send an
-     * activate signal to the system. */
-    if (table) {
+     * activate signal to the system. Queries (system is 0) are not registered
+     * with tables, and skip empty tables while iterating. */
+    if (table && system) {
         table_data = ecs_vector_add(
             &system_data->inactive_tables, &matched_table_params);
     } else {
@@ -107,13 +134,16 @@ void add_table(
 
     table_data->table = table;
     table_data->references = NULL;
+    system_data->tables_version ++;
 
     /* Array that contains the system column to table column mapping */
-    table_data->columns = ecs_os_malloc(sizeof(uint32_t) * column_count);
+    table_data->columns = ecs_slab_calloc(
+        world->slab, sizeof(int32_t) * column_count);
 
     /* Store the components of the matched table. In the case of OR expressions,
      * components may differ per matched table. */
-    table_data->components = ecs_os_malloc(sizeof(ecs_entity_t) * column_count);
+    table_data->components = ecs_slab_alloc(
+        world->slab, sizeof(ecs_entity_t) * column_count);
 
     /* Walk columns parsed from the system signature */
     ecs_system_column_t *columns = ecs_vector_first(system_data->base.columns);
@@ -125,6 +155,26 @@ void add_table(
         ecs_system_expr_elem_kind_t kind = column->kind;
         ecs_system_expr_oper_kind_t oper_kind = column->oper_kind;
 
+        /* Data of sparse components differs per entity. Pass it to the system
+         * as a reference, of which the pointer is set for each entity. */
+        ecs_sparse_column_t *sparse = get_sparse_column(&system_data->base, c);
+        if (sparse) {
+            table_data->columns[c] = 0;
+
+            if (sparse->storage->size && oper_kind != EcsOperNot) {
+                ecs_reference_t *ref = ecs_vector_add(
+                        &table_data->references, &reference_params);
+                ref->entity = ECS_INVALID_ENTITY;
+                ref->component = column->is.component;
+                ref->cached_ptr = NULL;
+                table_data->columns[c] = -ecs_vector_count(
+                    table_data->references);
+            }
+
+            table_data->components[c] = column->is.component;
+            continue;
+        }
+
         /* Column that retrieves data from self or a fixed entity */
         if (kind == EcsFromSelf || kind == EcsFromEntity || 
             kind == EcsFromOwned || kind == EcsFromShared) 
@@ -288,7 +338,7 @@ void add_table(
         table_data->components[c] = component;
     }
 
-    if (table) {
+    if (table && system) {
         ecs_table_register_system(world, table, system);
     }
 }
@@ -296,11 +346,20 @@ void add_table(
 /* Remove table */
 static
 void remove_table(
+    ecs_world_t *world,
     EcsColSystem *system_data,
     ecs_vector_t *tables,
     int32_t index)
 {
-    (void)system_data;
+    ecs_matched_table_t *table_data = ecs_vector_get(
+        tables, &matched_table_params, index);
+
+    system_data->tables_version ++;
+
+    ecs_slab_release(world->slab, table_data->columns);
+    ecs_slab_release(world->slab, table_data->components);
+    ecs_vector_free(table_data->references);
+
     ecs_vector_remove_index(tables, &matched_table_params, index);
 }
 
@@ -320,6 +379,21 @@ bool match_table(
 
     ecs_type_t type, table_type = table->type;
 
+    /* Reject most tables that do not have the required components with the
+     * bloom signature. Components from self may be inherited from a prefab,
+     * which cannot be tested with the signature of the table. */
+    if (!ecs_bloom_contains(table->bloom, 
+        system_data->base.and_from_owned_bloom))
+    {
+        return false;
+    }
+
+    if (!(table->flags & EcsTableHasPrefab) && !ecs_bloom_contains(
+        table->bloom, system_data->base.and_from_self_bloom))
+    {
+        return false;
+    }
+
     if (!system_data->base.match_disabled && ecs_type_has_entity_intern(
         world, table_type, EEcsDisabled, false))
     {
@@ -483,6 +557,7 @@ void order_cascade_tables(
     }
 
     ecs_vector_sort(system_data->tables, &matched_table_params, table_compare);
+    system_data->tables_version ++;
 }
 
 /** Match existing tables against system (table is created before system) */
@@ -492,12 +567,12 @@ void match_tables(
     ecs_entity_t system,
     EcsColSystem *system_data)
 {
-    uint32_t i, count = ecs_chunked_count(world->main_stage.tables);
-
-    for (i = 0; i < count; i ++) {
-        ecs_table_t *table = ecs_chunked_get(
-            world->main_stage.tables, ecs_table_t, i);
+    /* Only tables with the rarest component of the system can match */
+    ecs_table_iter_t it = ecs_world_tables_iter(world, 
+        system_data->base.and_from_owned, system_data->base.and_from_self);
+    ecs_table_t *table;
 
+    while ((table = ecs_world_tables_next(&it))) {
         if (match_table(world, table, system, system_data)) {
             add_table(world, system, system_data, table);
         }
@@ -568,56 +643,111 @@ void resolve_cascade_container(
     }
 }
 
+/** Add or remove table after a change happened to a container or prefab */
+static
+void rematch_table(
+    ecs_world_t *world,
+    ecs_entity_t system,
+    EcsColSystem *system_data,
+    ecs_table_t *table)
+{
+    /* Is the system currently matched with the table? */
+    int32_t match = table_matched(system_data, system_data->tables, table);
+
+    if (match_table(world, table, system, system_data)) {
+        /* If the table matches, and it is not currently matched, add */
+        if (match == -1) {
+            if (table_matched(system_data, system_data->inactive_tables, table) == -1) {
+                add_table(world, system, system_data, table);
+            }
+
+        /* If table still matches and has cascade column, reevaluate the
+            * sources of references. This may have changed in case 
+            * components were added/removed to container entities */ 
+        } else if (system_data->base.cascade_by) {
+            resolve_cascade_container(
+                world, system_data, match, table->type);
+        }
+    } else {
+        /* If table no longer matches, remove it */
+        if (match != -1) {
+            remove_table(world, system_data, system_data->tables, match);
+        } else {
+            /* Make sure the table is removed if it was inactive */
+            match = table_matched(
+                system_data, system_data->inactive_tables, table);
+            if (match != -1) {
+                remove_table(
+                    world, system_data, system_data->inactive_tables, match);
+            }
+        }
+    }
+}
+
+/** Test if a column of the system uses a changed entity as source */
+static
+bool has_changed_source(
+    EcsColSystem *system_data,
+    ecs_map_t *changes)
+{
+    ecs_system_column_t *columns = ecs_vector_first(system_data->base.columns);
+    uint32_t i, count = ecs_vector_count(system_data->base.columns);
+
+    for (i = 0; i < count; i ++) {
+        if (columns[i].kind == EcsFromEntity && 
+            ecs_map_get_ptr(changes, columns[i].source))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
 /* -- Private API -- */
 
 /* Rematch system with tables after a change happened to a container or prefab */
 void ecs_rematch_system(
     ecs_world_t *world,
-    ecs_entity_t system)
+    ecs_entity_t system,
+    const ecs_rematch_t *rematch)
 {
     EcsColSystem *system_data = ecs_get_ptr(world, system, EcsColSystem);
     ecs_assert(system_data != NULL, ECS_INTERNAL_ERROR, 0);
 
-    ecs_chunked_t *tables = world->main_stage.tables;
-    uint32_t i, count = ecs_chunked_count(tables);
+    ecs_col_system_rematch(world, system, system_data, rematch);
+}
 
-    for (i = 0; i < count; i ++) {
-        /* Is the system currently matched with the table? */
-        ecs_table_t *table = ecs_chunked_get(tables, ecs_table_t, i);
-        int32_t match = table_matched(system_data, system_data->tables, table);
+void ecs_col_system_rematch(
+    ecs_world_t *world,
+    ecs_entity_t system,
+    EcsColSystem *system_data,
+    const ecs_rematch_t *rematch)
+{
+    /* A column with a changed source entity can change whether any table
+     * matches, so test all tables */
+    if (has_changed_source(system_data, rematch->entities)) {
+        ecs_chunked_t *tables = world->main_stage.tables;
+        uint32_t i, count = ecs_chunked_count(tables);
+
+        for (i = 0; i < count; i ++) {
+            ecs_table_t *table = ecs_chunked_get(tables, ecs_table_t, i);
+            rematch_table(world, system, system_data, table);
+        }
 
-        if (match_table(world, table, system, system_data)) {
-            /* If the table matches, and it is not currently matched, add */
-            if (match == -1) {
-                if (table_matched(system_data, system_data->inactive_tables, table) == -1) {
-                    add_table(world, system, system_data, table);
-                }
+    /* Otherwise only tables that inherit from or are a child of a changed
+     * entity can change, if a changed component is used by the system */
+    } else if (system_data->base.columns_bloom & rematch->bloom) {
+        ecs_table_t **tables = ecs_vector_first(rematch->tables);
+        uint32_t i, count = ecs_vector_count(rematch->tables);
 
-            /* If table still matches and has cascade column, reevaluate the
-                * sources of references. This may have changed in case 
-                * components were added/removed to container entities */ 
-            } else if (system_data->base.cascade_by) {
-                resolve_cascade_container(
-                    world, system_data, match, table->type);
-            }
-        } else {
-            /* If table no longer matches, remove it */
-            if (match != -1) {
-                remove_table(system_data, system_data->tables, match);
-            } else {
-                /* Make sure the table is removed if it was inactive */
-                match = table_matched(
-                    system_data, system_data->inactive_tables, table);
-                if (match != -1) {
-                    remove_table(
-                        system_data, system_data->inactive_tables, match);
-                }
-            }
+        for (i = 0; i < count; i ++) {
+            rematch_table(world, system, system_data, tables[i]);
         }
     }
 
-    /* If the system has a CASCADE column and modifications were made, 
-        * reorder the system tables so that the depth order is preserved */
+    /* Adding or removing a container can change the depth of tables, so the
+     * tables of a system with a CASCADE column are always reordered */
     if (system_data->base.cascade_by) {
         order_cascade_tables(world, system_data);
     }
@@ -631,6 +761,13 @@ void ecs_revalidate_system_refs(
     EcsColSystem *system_data = ecs_get_ptr(world, system, EcsColSystem);
     ecs_assert(system_data != NULL, ECS_INTERNAL_ERROR, 0);
 
+    ecs_col_system_revalidate_refs(world, system_data);
+}
+
+void ecs_col_system_revalidate_refs(
+    ecs_world_t *world,
+    EcsColSystem *system_data)
+{
     if (!system_data->base.has_refs) {
         return;
     }
@@ -664,9 +801,109 @@ void ecs_col_system_notify_of_table(
     EcsColSystem *system_data = ecs_get_ptr(world, system, EcsColSystem);
     assert(system_data != NULL);
 
-    if (match_table(world, table, system, system_data)) {
-        add_table(world, system, system_data, table);
+    ecs_col_system_match_table(world, system, system_data, table);
+}
+
+bool ecs_col_system_match_table(
+    ecs_world_t *world,
+    ecs_entity_t system,
+    EcsColSystem *system_data,
+    ecs_table_t *table)
+{
+    if (!match_table(world, table, system, system_data)) {
+        return false;
+    }
+
+    add_table(world, system, system_data, table);
+
+    /* Queries add new tables to the active tables, which are ordered by depth
+     * if the query has a CASCADE column */
+    if (!system && system_data->base.cascade_by) {
+        order_cascade_tables(world, system_data);
     }
+
+    return true;
+}
+
+/** Remove a table that is about to be deleted from the system */
+void ecs_col_system_remove_table(
+    ecs_world_t *world,
+    ecs_entity_t system,
+    ecs_table_t *table)
+{
+    EcsColSystem *system_data = ecs_get_ptr(world, system, EcsColSystem);
+    ecs_assert(system_data != NULL, ECS_INTERNAL_ERROR, NULL);
+
+    /* Tables are only deleted when empty, but make sure the system doesn't
+     * keep a reference if the table was not deactivated */
+    if (ecs_col_system_unmatch_table(world, system_data, table)) {
+        world->valid_schedule = false;
+
+        if (!ecs_vector_count(system_data->tables)) {
+            EcsSystemKind kind = system_data->base.kind;
+            if (kind != EcsManual) {
+                ecs_world_activate_system(world, system, kind, false);
+            }
+        }
+    }
+}
+
+bool ecs_col_system_unmatch_table(
+    ecs_world_t *world,
+    EcsColSystem *system_data,
+    ecs_table_t *table)
+{
+    int32_t match = table_matched(
+        system_data, system_data->inactive_tables, table);
+
+    if (match != -1) {
+        remove_table(world, system_data, system_data->inactive_tables, match);
+        return false;
+    }
+
+    match = table_matched(system_data, system_data->tables, table);
+    if (match != -1) {
+        remove_table(world, system_data, system_data->tables, match);
+        return true;
+    }
+
+    return false;
+}
+
+/** Sort the active tables of a system, if the system has a sort comparator */
+bool ecs_col_system_sort_tables(
+    ecs_world_t *world,
+    ecs_entity_t system)
+{
+    EcsColSystem *system_data = ecs_get_ptr(world, system, EcsColSystem);
+    ecs_assert(system_data != NULL, ECS_INTERNAL_ERROR, NULL);
+
+    ecs_compare_action_t compare = system_data->sort_compare;
+    if (!compare || !system_data->base.enabled) {
+        return false;
+    }
+
+    ecs_matched_table_t *tables = ecs_vector_first(system_data->tables);
+    uint32_t i, count = ecs_vector_count(system_data->tables);
+    bool sorted = false;
+
+    for (i = 0; i < count; i ++) {
+        ecs_table_t *table = tables[i].table;
+        if (table) {
+            sorted |= ecs_table_sort(
+                world, table, system_data->sort_component, compare);
+        }
+    }
+
+    return sorted;
+}
+
+void ecs_col_system_begin_run(
+    ecs_world_t *world,
+    EcsColSystem *system_data)
+{
+    system_data->last_tick = system_data->run_tick;
+    system_data->run_tick = ++ world->change_tick;
 }
 
 /** Get index of table in system's matched tables */
@@ -718,6 +955,8 @@ void ecs_system_activate_table(
     uint32_t src_count = ecs_vector_move_index(
         &dst_array, src_array, &matched_table_params, i);
 
+    system_data->tables_version ++;
+
     if (active) {
         uint32_t dst_count = ecs_vector_count(dst_array);
         if (kind != EcsManual) {
@@ -738,31 +977,20 @@ void ecs_system_activate_table(
     }
 }
 
-ecs_entity_t ecs_new_col_system(
+void ecs_col_system_init(
     ecs_world_t *world,
-    const char *id,
-    EcsSystemKind kind,
-    const char *sig,
-    ecs_system_action_t action)
+    ecs_entity_t system,
+    EcsColSystem *system_data,
+    const char *sig)
 {
     uint32_t count = ecs_columns_count(sig);
 
     ecs_assert(count != 0, ECS_INVALID_PARAMETER, NULL);
 
-    ecs_entity_t result = _ecs_new(
-        world, world->t_col_system);
-
-    EcsId *id_data = ecs_get_ptr(world, result, EcsId);
-    *id_data = id;
-
-    EcsColSystem *system_data = ecs_get_ptr(world, result, EcsColSystem);
-    memset(system_data, 0, sizeof(EcsColSystem));
-    system_data->base.action = action;
     system_data->base.enabled = true;
     system_data->base.signature = sig;
     system_data->base.time_spent = 0;
     system_data->base.columns = ecs_vector_new(&system_column_params, count);
-    system_data->base.kind = kind;
     system_data->base.cascade_by = 0;
     system_data->base.has_refs = false;
     system_data->base.needs_tables = ecs_needs_tables(world, sig);
@@ -771,7 +999,7 @@ ecs_entity_t ecs_new_col_system(
     system_data->ref_params.element_size = sizeof(ecs_reference_t) * count;
     system_data->component_params.element_size = sizeof(ecs_entity_t) * count;
     system_data->period = 0;
-    system_data->entity = result;
+    system_data->entity = system;
 
     system_data->tables = ecs_vector_new(
         &matched_table_params, ECS_SYSTEM_INITIAL_TABLE_COUNT);
@@ -781,19 +1009,74 @@ ecs_entity_t ecs_new_col_system(
     ecs_parse_component_expr(
         world, sig, ecs_parse_signature_action, system_data);
 
+    /* Queries have no entity to store SYSTEM components on, and are iterated
+     * per table range, which does not allow for testing sparse components */
+    ecs_assert(system || !system_data->base.and_from_system, 
+        ECS_INVALID_PARAMETER, NULL);
+    ecs_assert(system || !system_data->base.sparse_columns, 
+        ECS_INVALID_PARAMETER, NULL);
+
     ecs_system_compute_and_families(world, &system_data->base);
 
     ecs_system_init_base(world, &system_data->base);
 
     if (system_data->base.needs_tables) {
-        match_tables(world, result, system_data);
+        match_tables(world, system, system_data);
     } else {
         /* If this system does not match with tables, for example, because it
          * does not have any SELF columns, add a single "matched" table that
          * caches the data for the columns, but does not have a reference to an
          * actual table. */
-        add_table(world, result, system_data, NULL /* table is NULL */);
+        add_table(world, system, system_data, NULL /* table is NULL */);
     }
+}
+
+void ecs_col_system_deinit(
+    ecs_world_t *world,
+    EcsColSystem *system_data)
+{
+    ecs_vector_free(system_data->base.columns);
+    ecs_vector_free(system_data->base.sparse_columns);
+    ecs_vector_free(system_data->jobs);
+
+    uint32_t t;
+    ecs_matched_table_t *tables = ecs_vector_first(
+        system_data->inactive_tables);
+    for (t = 0; t < ecs_vector_count(system_data->inactive_tables); t ++) {
+        ecs_slab_release(world->slab, tables[t].columns);
+        ecs_slab_release(world->slab, tables[t].components);
+    }
+
+    tables = ecs_vector_first(system_data->tables);
+    for (t = 0; t < ecs_vector_count(system_data->tables); t ++) {
+        ecs_slab_release(world->slab, tables[t].columns);
+        ecs_slab_release(world->slab, tables[t].components);
+    }
+
+    ecs_vector_free(system_data->inactive_tables);
+    ecs_vector_free(system_data->tables);
+}
+
+ecs_entity_t ecs_new_col_system(
+    ecs_world_t *world,
+    const char *id,
+    EcsSystemKind kind,
+    const char *sig,
+    ecs_system_action_t action)
+{
+    ecs_entity_t result = _ecs_new(
+        world, world->t_col_system);
+
+    EcsId *id_data = ecs_get_ptr(world, result, EcsId);
+    *id_data = id;
+    ecs_world_index_name(world, result, id);
+
+    EcsColSystem *system_data = ecs_get_ptr(world, result, EcsColSystem);
+    memset(system_data, 0, sizeof(EcsColSystem));
+    system_data->base.action = action;
+    system_data->base.kind = kind;
+
+    ecs_col_system_init(world, result, system_data, sig);
 
     ecs_entity_t *elem = NULL;
 
@@ -830,6 +1113,233 @@ ecs_entity_t ecs_new_col_system(
     return result;
 }
 
+/** Test whether entity matches the sparse columns of a system */
+static
+bool match_sparse(
+    ecs_sparse_column_t *columns,
+    uint32_t count,
+    ecs_entity_t entity)
+{
+    uint32_t i;
+    for (i = 0; i < count; i ++) {
+        ecs_sparse_column_t *column = &columns[i];
+        ecs_system_expr_oper_kind_t oper_kind = column->oper_kind;
+
+        if (oper_kind == EcsOperOptional) {
+            continue;
+        }
+
+        bool has = ecs_sparse_get_ptr(column->storage->data, entity) != NULL;
+        if (has != (oper_kind == EcsOperAnd)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/** Invoke system for the rows in a range that match its sparse columns. If the
+ * system reads data from a sparse column, it is invoked for each entity, as the
+ * data of the entities is not stored contiguously. Otherwise it is invoked for
+ * each range of subsequent matching rows. */
+static
+void run_sparse(
+    ecs_rows_t *info,
+    ecs_system_action_t action,
+    ecs_vector_t *sparse_columns,
+    bool per_entity)
+{
+    ecs_sparse_column_t *columns = ecs_vector_first(sparse_columns);
+    uint32_t c, column_count = ecs_vector_count(sparse_columns);
+    ecs_entity_t *entities = info->entities;
+    uint32_t offset = info->offset;
+    uint32_t count = info->count;
+    uint32_t frame_offset = info->frame_offset;
+    uint32_t i = 0;
+
+    while (i < count && !info->interrupted_by) {
+        uint32_t start = i;
+        while (i < count && match_sparse(columns, column_count, entities[i])) {
+            i ++;
+            if (per_entity) {
+                break;
+            }
+        }
+
+        if (i == start) {
+            i ++;
+            continue;
+        }
+
+        if (per_entity) {
+            ecs_entity_t entity = entities[start];
+
+            for (c = 0; c < column_count; c ++) {
+                int32_t table_column = info->columns[columns[c].column];
+                if (table_column < 0) {
+                    ecs_reference_t *ref = &info->references[-table_column - 1];
+                    ref->entity = entity;
+                    ref->cached_ptr = ecs_sparse_get_ptr(
+                        columns[c].storage->data, entity);
+                }
+            }
+        }
+
+        info->entities = &entities[start];
+        info->offset = offset + start;
+        info->count = i - start;
+        info->frame_offset = frame_offset + start;
+
+        action(info);
+    }
+
+    info->entities = entities;
+    info->offset = offset;
+    info->count = count;
+    info->frame_offset = frame_offset;
+}
+
+/** Collect the bitsets of a table that disable rows for a system. These are
+ * the bitsets of the components that the system matches on the entity itself,
+ * and the bitset of disabled entities. */
+uint32_t ecs_col_system_get_bitsets(
+    EcsColSystem *system_data,
+    ecs_matched_table_t *table,
+    ecs_table_bitset_t **out)
+{
+    ecs_table_t *world_table = table->table;
+    ecs_table_bitset_t *bitsets = ecs_vector_first(world_table->bitsets);
+    uint32_t i, count = ecs_vector_count(world_table->bitsets);
+    ecs_system_column_t *columns = ecs_vector_first(system_data->base.columns);
+    uint32_t c, column_count = ecs_vector_count(system_data->base.columns);
+    uint32_t result = 0;
+
+    for (i = 0; i < count; i ++) {
+        ecs_entity_t component = bitsets[i].component;
+
+        /* Bitset has no disabled rows */
+        if (!ecs_vector_count(bitsets[i].words)) {
+            continue;
+        }
+
+        if (!component) {
+            if (!system_data->base.match_disabled) {
+                out[result ++] = &bitsets[i];
+            }
+            continue;
+        }
+
+        for (c = 0; c < column_count; c ++) {
+            ecs_system_column_t *column = &columns[c];
+
+            if (column->kind != EcsFromSelf && column->kind != EcsFromOwned) {
+                continue;
+            }
+
+            if (column->oper_kind != EcsOperAnd && 
+                column->oper_kind != EcsOperOr) 
+            {
+                continue;
+            }
+
+            if (table->components[c] == component) {
+                out[result ++] = &bitsets[i];
+                break;
+            }
+        }
+    }
+
+    return result;
+}
+
+/** Invoke system for each range of rows that is not disabled */
+static
+void run_enabled(
+    ecs_rows_t *info,
+    ecs_system_action_t action,
+    ecs_table_bitset_t **bitsets,
+    uint32_t bitset_count,
+    ecs_vector_t *sparse_columns,
+    bool sparse_per_entity)
+{
+    ecs_entity_t *entities = info->entities;
+    uint32_t offset = info->offset;
+    uint32_t count = info->count;
+    uint32_t frame_offset = info->frame_offset;
+    uint32_t row = offset, end = offset + count;
+
+    while (!info->interrupted_by) {
+        uint32_t n = ecs_table_enabled_range(
+            bitsets, bitset_count, &row, end);
+        if (!n) {
+            break;
+        }
+
+        info->entities = &entities[row - offset];
+        info->offset = row;
+        info->count = n;
+        info->frame_offset = frame_offset + row - offset;
+
+        if (sparse_columns) {
+            run_sparse(info, action, sparse_columns, sparse_per_entity);
+        } else {
+            action(info);
+        }
+
+        row += n;
+    }
+
+    info->entities = entities;
+    info->offset = offset;
+    info->count = count;
+    info->frame_offset = frame_offset;
+}
+
+/** Test if the columns that a system reads from a table were written since the
+ * previous run of the system. Adding, removing and disabling rows counts as a
+ * change to the entity column. */
+static
+bool table_changed(
+    ecs_matched_table_t *table,
+    ecs_table_column_t *table_data,
+    uint32_t column_count,
+    uint32_t last_tick)
+{
+    if (table_data[0].change_tick > last_tick) {
+        return true;
+    }
+
+    uint32_t c;
+    for (c = 0; c < column_count; c ++) {
+        int32_t column = table->columns[c];
+        if (column > 0 && table_data[column].change_tick > last_tick) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/** Mark the columns of a table that a system writes as changed */
+static
+void mark_written(
+    ecs_world_t *world,
+    ecs_type_t writes,
+    ecs_matched_table_t *table,
+    ecs_table_column_t *table_data,
+    uint32_t column_count)
+{
+    uint32_t c;
+    for (c = 0; c < column_count; c ++) {
+        int32_t column = table->columns[c];
+        if (column > 0 && ecs_type_has_entity_intern(
+            world, writes, table->components[c], false))
+        {
+            table_data[column].change_tick = world->change_tick;
+        }
+    }
+}
+
 /* -- Public API -- */
 
 static
@@ -855,13 +1365,56 @@ bool should_run(
     return true;
 }
 
-ecs_entity_t _ecs_run_w_filter(
+/** Cache indices of the matched tables of a system that pass the filter */
+static
+void update_filter(
+    ecs_world_t *world,
+    ecs_entity_t system,
+    EcsColSystem *system_data,
+    ecs_filter_t *filter)
+{
+    if (filter->system == system && 
+        filter->tables_version == system_data->tables_version) 
+    {
+        return;
+    }
+
+    ecs_vector_clear(filter->tables);
+
+    ecs_matched_table_t *tables = ecs_vector_first(system_data->tables);
+    uint32_t i, count = ecs_vector_count(system_data->tables);
+
+    for (i = 0; i < count; i ++) {
+        ecs_table_t *table = tables[i].table;
+        int32_t index = i;
+
+        if (table) {
+            if (table->flags & EcsTableHasPrefab) {
+                index = -index - 1;
+            } else if (!ecs_bloom_contains(table->bloom, filter->bloom) || 
+                !ecs_type_contains(world, table->type, filter->type, true, true))
+            {
+                continue;
+            }
+        }
+
+        int32_t *elem = ecs_vector_add(&filter->tables, &filter_table_params);
+        *elem = index;
+    }
+
+    filter->system = system;
+    filter->tables_version = system_data->tables_version;
+}
+
+static
+ecs_entity_t run_system(
     ecs_world_t *world,
     ecs_entity_t system,
     float delta_time,
     uint32_t offset,
     uint32_t limit,
     ecs_type_t filter,
+    ecs_filter_t *filter_handle,
     void *param)
 {
     ecs_world_t *real_world = world;
@@ -902,6 +1455,28 @@ ecs_entity_t _ecs_run_w_filter(
         }
     }
 
+    /* The change ticks of systems that are ran by worker threads are advanced
+     * by the main thread when jobs are prepared */
+    bool is_main_thread = world == real_world;
+    if (is_main_thread) {
+        ecs_col_system_begin_run(real_world, system_data);
+    }
+
+    bool on_change = system_data->on_change;
+    uint32_t last_tick = system_data->last_tick;
+    ecs_type_t writes = system_data->writes;
+
+    /* Tables are sorted by ecs_progress before systems are ran. When a system
+     * is ran manually outside of ecs_progress, sort its tables here. Worker
+     * threads never sort, as other threads can iterate the same tables. */
+    if (system_data->sort_compare && world == real_world && 
+        !real_world->in_progress) 
+    {
+        if (ecs_col_system_sort_tables(real_world, system)) {
+            ecs_revalidate_system_refs(real_world, system);
+        }
+    }
+
     ecs_time_t time_start;
     if (measure_time) {
         ecs_os_get_time(&time_start);
@@ -913,18 +1488,68 @@ ecs_entity_t _ecs_run_w_filter(
     bool offset_limit = (offset | limit) != 0;
     bool limit_set = limit != 0;
 
+    /* If the system has sparse columns with data, the pointers to the data are
+     * set for each entity in a copy of the references of a table, as multiple
+     * threads can run the system on the same table. */
+    ecs_vector_t *sparse_columns = system_data->base.sparse_columns;
+    ecs_reference_t *sparse_refs = NULL;
+    bool sparse_per_entity = false;
+
+    if (sparse_columns) {
+        ecs_sparse_column_t *sc = ecs_vector_first(sparse_columns);
+        uint32_t c, sc_count = ecs_vector_count(sparse_columns);
+        for (c = 0; c < sc_count; c ++) {
+            if (sc[c].storage->size && sc[c].oper_kind != EcsOperNot) {
+                sparse_per_entity = true;
+            }
+        }
+
+        if (sparse_per_entity) {
+            sparse_refs = ecs_os_alloca(ecs_reference_t, column_count);
+        }
+    }
+
+    /* Each column can match at most one bitset, in addition to the bitset of
+     * disabled entities */
+    ecs_table_bitset_t **bitsets = ecs_os_alloca(
+        ecs_table_bitset_t*, column_count + 1);
+
+    uint64_t filter_bloom = 0;
+    if (filter) {
+        filter_bloom = ecs_type_bloom(filter);
+    }
+
+    /* A filter handle only stores the tables that pass the filter. Tables that
+     * inherit from prefabs are still tested when the system is ran. */
+    int32_t *filter_tables = NULL;
+    if (filter_handle) {
+        update_filter(real_world, system, system_data, filter_handle);
+        filter = filter_handle->type;
+        filter_bloom = filter_handle->bloom;
+        filter_tables = ecs_vector_first(filter_handle->tables);
+        table_count = ecs_vector_count(filter_handle->tables);
+    }
+
     ecs_rows_t info = {
         .world = world,
         .system = system,
         .param = param,
         .column_count = column_count,
         .delta_time = system_delta_time,
-        .world_time = world->world_time,
+        .world_time = real_world->world_time,
         .frame_offset = offset
     };
 
     for (i = 0; i < table_count; i ++) {
         ecs_matched_table_t *table = &tables[i];
+        bool test_filter = filter != NULL;
+
+        if (filter_tables) {
+            int32_t index = filter_tables[i];
+            test_filter = index < 0;
+            table = &tables[test_filter ? -index - 1 : index];
+        }
+
         ecs_table_t *world_table = table->table;
         ecs_table_column_t *table_data = NULL;
         uint32_t first = 0, count = 0;
@@ -933,7 +1558,13 @@ ecs_entity_t _ecs_run_w_filter(
             table_data = world_table->columns;
             count = ecs_table_count(world_table);
 
-            if (filter) {
+            if (test_filter) {
+                if (!(world_table->flags & EcsTableHasPrefab) && 
+                    !ecs_bloom_contains(world_table->bloom, filter_bloom))
+                {
+                    continue;
+                }
+
                 if (!ecs_type_contains(
                     real_world, world_table->type, filter, true, true))
                 {
@@ -969,13 +1600,22 @@ ecs_entity_t _ecs_run_w_filter(
                 continue;
             }
 
-            ecs_entity_t *entity_buffer = 
-                    ecs_vector_first(table_data[0].data);
-            info.entities = &entity_buffer[first];            
+            if (on_change && !table_changed(
+                table, table_data, column_count, last_tick)) 
+            {
+                continue;
+            }
         }
 
         if (table->references) {
             info.references = ecs_vector_first(table->references);
+
+            if (sparse_refs) {
+                memcpy(sparse_refs, info.references, 
+                    ecs_vector_count(table->references) * 
+                        sizeof(ecs_reference_t));
+                info.references = sparse_refs;
+            }
         } else {
             info.references = NULL;
         }
@@ -984,12 +1624,51 @@ ecs_entity_t _ecs_run_w_filter(
         info.table = world_table;
         info.table_columns = table_data;
         info.components = table->components;
-        info.offset = first;
-        info.count = count;
-        
-        action(&info);
 
-        info.frame_offset += count;
+        if (!world_table) {
+            info.offset = 0;
+            info.count = 0;
+            action(&info);
+        } else {
+            ecs_entity_t *entity_buffer = 
+                    ecs_vector_first(table_data[0].data);
+
+            uint32_t bitset_count = 0;
+            if (world_table->bitsets) {
+                bitset_count = ecs_col_system_get_bitsets(
+                    system_data, table, bitsets);
+            }
+
+            /* Invoke system for each range of rows that is stored contiguously.
+             * Unless the table is chunked, this is the entire table. */
+            do {
+                uint32_t chunk_count = ecs_table_contiguous(
+                    world_table, table_data, first, count);
+
+                info.entities = &entity_buffer[first];
+                info.offset = first;
+                info.count = chunk_count;
+
+                if (bitset_count) {
+                    run_enabled(&info, action, bitsets, bitset_count, 
+                        sparse_columns, sparse_per_entity);
+                } else if (sparse_columns) {
+                    run_sparse(
+                        &info, action, sparse_columns, sparse_per_entity);
+                } else {
+                    action(&info);
+                }
+
+                info.frame_offset += chunk_count;
+                first += chunk_count;
+                count -= chunk_count;
+            } while (count && !info.interrupted_by);
+
+            if (writes) {
+                mark_written(
+                    real_world, writes, table, table_data, column_count);
+            }
+        }
 
         if (info.interrupted_by) {
             interrupted_by = info.interrupted_by;
@@ -997,6 +1676,11 @@ ecs_entity_t _ecs_run_w_filter(
         }
     }
 
+    /* Writes after this point are newer than the current run of the system */
+    if (is_main_thread) {
+        real_world->change_tick ++;
+    }
+
     if (measure_time) {
         system_data->base.time_spent += ecs_time_measure(&time_start);
     }
@@ -1004,6 +1688,57 @@ ecs_entity_t _ecs_run_w_filter(
     return interrupted_by;
 }
 
+ecs_entity_t _ecs_run_w_filter(
+    ecs_world_t *world,
+    ecs_entity_t system,
+    float delta_time,
+    uint32_t offset,
+    uint32_t limit,
+    ecs_type_t filter,
+    void *param)
+{
+    return run_system(
+        world, system, delta_time, offset, limit, filter, NULL, param);
+}
+
+ecs_entity_t ecs_run_w_filter_handle(
+    ecs_world_t *world,
+    ecs_entity_t system,
+    float delta_time,
+    uint32_t offset,
+    uint32_t limit,
+    ecs_filter_t *filter,
+    void *param)
+{
+    ecs_assert(filter != NULL, ECS_INVALID_PARAMETER, NULL);
+    return run_system(
+        world, system, delta_time, offset, limit, NULL, filter, param);
+}
+
+ecs_filter_t* _ecs_filter_new(
+    ecs_world_t *world,
+    ecs_type_t type)
+{
+    ecs_assert(world != NULL, ECS_INVALID_PARAMETER, NULL);
+    ecs_assert(type != NULL, ECS_INVALID_PARAMETER, NULL);
+    (void)world;
+
+    ecs_filter_t *result = ecs_os_calloc(1, sizeof(ecs_filter_t));
+    ecs_assert(result != NULL, ECS_OUT_OF_MEMORY, NULL);
+
+    result->type = type;
+    result->bloom = ecs_type_bloom(type);
+
+    return result;
+}
+
+void ecs_filter_free(
+    ecs_filter_t *filter)
+{
+    ecs_vector_free(filter->tables);
+    ecs_os_free(filter);
+}
+
 ecs_entity_t ecs_run(
     ecs_world_t *world,
     ecs_entity_t system,
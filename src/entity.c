@@ -13,17 +13,15 @@ void copy_column(
     uint32_t size = new_column->size;
 
     if (size) {
-        ecs_vector_params_t param = {.element_size = new_column->size};
-
         if (old_index < 0) old_index *= -1;
         
-        void *dst = ecs_vector_get(new_column->data, &param, new_index - 1);
-        void *src = ecs_vector_get(old_column->data, &param, old_index - 1);
+        void *dst = ecs_table_column_get(new_column, new_index - 1);
+        void *src = ecs_table_column_get(old_column, old_index - 1);
             
         ecs_assert(dst != NULL, ECS_INTERNAL_ERROR, NULL);
         ecs_assert(src != NULL, ECS_INTERNAL_ERROR, NULL);
 
-        memcpy(dst, src, param.element_size);
+        memcpy(dst, src, size);
     }
 }
 
@@ -72,6 +70,70 @@ void copy_row(
     }
 }
 
+/** Add entity to the name index. The index is not thread safe, so names set in
+ * a stage are indexed when the stage is merged. */
+static
+void index_name(
+    ecs_world_t *world,
+    ecs_stage_t *stage,
+    ecs_entity_t entity,
+    const char *name)
+{
+    if (stage == &world->main_stage) {
+        ecs_world_index_name(world, entity, name);
+    } else {
+        ecs_entity_t *elem = ecs_vector_add(
+            &stage->name_stage, &handle_arr_params);
+        *elem = entity;
+    }
+}
+
+/** Add entities in a range of rows to the name index, if the table has names */
+static
+void index_names(
+    ecs_world_t *world,
+    ecs_stage_t *stage,
+    ecs_type_t type,
+    ecs_table_column_t *columns,
+    uint32_t row,
+    uint32_t count)
+{
+    int16_t column = ecs_type_index_of(type, EEcsId);
+    if (column == -1) {
+        return;
+    }
+
+    ecs_entity_t *entities = ecs_vector_first(columns[0].data);
+    uint32_t i;
+
+    for (i = row; i < row + count; i ++) {
+        EcsId *name = ecs_table_column_get(&columns[column + 1], i);
+        index_name(world, stage, entities[i], *name);
+    }
+}
+
+/** Remove entities from the name index when they are moved to a type without
+ * a name. Names removed while in progress are unindexed when merged. */
+static
+void unindex_names(
+    ecs_world_t *world,
+    ecs_type_t old_type,
+    ecs_type_t new_type,
+    ecs_entity_t *entities,
+    uint32_t count)
+{
+    if (ecs_type_index_of(old_type, EEcsId) == -1 || 
+        ecs_type_index_of(new_type, EEcsId) != -1) 
+    {
+        return;
+    }
+
+    uint32_t i;
+    for (i = 0; i < count; i ++) {
+        ecs_world_unindex_name(world, entities[i]);
+    }
+}
+
 static
 void* get_row_ptr(
     ecs_type_t type,
@@ -89,12 +151,11 @@ void* get_row_ptr(
     ecs_assert(index >= 0, ECS_INTERNAL_ERROR, NULL);
 
     ecs_table_column_t *column = &columns[column_index + 1];
-    ecs_vector_params_t param = {.element_size = column->size};
 
-    if (param.element_size) {
+    if (column->size) {
         ecs_assert(column->data != NULL, ECS_INTERNAL_ERROR, NULL);
 
-        void *ptr = ecs_vector_get(column->data, &param, index - 1);
+        void *ptr = ecs_table_column_get(column, index - 1);
         return ptr;
     } else {
         return NULL;
@@ -107,7 +168,7 @@ ecs_row_t row_from_stage(
     ecs_entity_t entity)
 {
     ecs_row_t row;
-    if (ecs_map_has(stage->entity_index, entity, &row)) {
+    if (ecs_sparse_has(stage->entity_index, entity, &row)) {
         return row;
     } else {
         return (ecs_row_t){0, 0};
@@ -122,7 +183,7 @@ bool stage_has_entity(
 {
     ecs_row_t row;
 
-    if (ecs_map_has(stage->entity_index, entity, &row)) {
+    if (ecs_sparse_has(stage->entity_index, entity, &row)) {
         if (row.index) {
             *row_out = row;
             return true;
@@ -410,9 +471,7 @@ ecs_type_t copy_from_prefab(
         uint32_t size = src_column->size;
 
         if (size) {
-            void *src_column_data = ecs_vector_first(src_column->data);
-            void *src_ptr = ECS_OFFSET(
-                src_column_data, size * (prefab_index - 1));
+            void *src_ptr = ecs_table_column_get(src_column, prefab_index - 1);
 
             uint32_t dst_col_index;
             if (info->type == to_add) {
@@ -422,14 +481,11 @@ ecs_type_t copy_from_prefab(
             }
             
             ecs_table_column_t *dst_column = &columns[dst_col_index + 1];
-            void *dst_column_data = ecs_vector_first(dst_column->data);
-            void *dst_ptr = ECS_OFFSET(
-                dst_column_data, size * (info->index - 1 + offset));
+            uint32_t i, dst_row = info->index - 1 + offset;
 
-            uint32_t i;
             for (i = 0; i < limit; i ++) {
+                void *dst_ptr = ecs_table_column_get(dst_column, dst_row + i);
                 memcpy(dst_ptr, src_ptr, size);
-                dst_ptr = ECS_OFFSET(dst_ptr, size);
             }
         }
     }
@@ -541,19 +597,29 @@ uint32_t commit(
     ecs_stage_t *stage,
     ecs_entity_info_t *info,
     ecs_type_t type,
+    ecs_table_t *new_table,
     ecs_type_t to_add,
     ecs_type_t to_remove,
     bool do_set)
 {
-    ecs_table_t *new_table = NULL, *old_table;
+    ecs_table_t *old_table;
     ecs_table_column_t *new_columns = NULL, *old_columns;
-    ecs_map_t *entity_index = stage->entity_index;
+    ecs_sparse_t *entity_index = stage->entity_index;
     ecs_type_t old_type = NULL;
     int32_t new_index = 0, old_index = 0;
     bool in_progress = world->in_progress;
     ecs_entity_t entity = info->entity;
     ecs_type_t remove_type, last_remove_type = NULL;
 
+    /* A deleted handle of which the id has been reused is stale. Committing it
+     * would overwrite the entity index row of the entity that reused the id,
+     * so the operation is ignored. Returns 0 as no row was assigned. */
+    if (!info->table && 
+        ecs_sparse_is_stale(world->main_stage.entity_index, entity)) 
+    {
+        return 0;
+    }
+
     /* Always update remove_merge stage when in progress. It is possible (and
      * likely) that when a component is removed, it hasn't been added in the
      * same iteration. As a result, the staged entity index does not know about
@@ -620,8 +686,11 @@ uint32_t commit(
          * already existed. Instead, the check will be applied when the entity
          * is merged, which will invoke commit again. */
         if (stage->range_check_enabled) {
-            ecs_assert(!world->max_handle || entity <= world->max_handle, ECS_OUT_OF_RANGE, 0);
-            ecs_assert(entity >= world->min_handle, ECS_OUT_OF_RANGE, 0);
+            /* Recycled ids have a generation, which is not part of the id */
+            ecs_entity_t id = entity & ECS_ENTITY_ID_MASK;
+            ecs_assert(!world->max_handle || id <= world->max_handle, ECS_OUT_OF_RANGE, 0);
+            ecs_assert(id >= world->min_handle, ECS_OUT_OF_RANGE, 0);
+            (void)id;
         }
     }
 
@@ -629,15 +698,18 @@ uint32_t commit(
      * requires rematching systems when components are added or removed. This
      * ensures that systems that rely on components from containers or prefabs
      * update the matched tables when the application adds or removes a 
-     * component from, for example, a container. */
-    if (info->is_watched) {
-        world->should_match = true;
+     * component from, for example, a container. Changes to a stage are
+     * registered when the entity is committed to the main stage by a merge. */
+    if (info->is_watched && stage == &world->main_stage) {
+        ecs_world_watch_changed(world, entity, old_type, type);
     }
 
     /* If the new type contains components (that is, it is not 0) obtain the new
-     * table and new columns. */
+     * table (if it was not provided) and new columns. */
     if (type) {
-        new_table = ecs_world_get_table(world, stage, type);
+        if (!new_table) {
+            new_table = ecs_world_get_table(world, stage, type);
+        }
 
         /* This operation will automatically obtain components from the stage if
          * the application is iterating. */
@@ -653,6 +725,13 @@ uint32_t commit(
     if (old_type && type) {
         copy_row(new_table->type, new_columns, new_index, 
             old_type, old_columns, old_index);
+
+        /* Carry over disabled components. When in progress the old row is
+         * stored in the stage, and the main stage row is moved when merging */
+        if (!in_progress && old_table->bitsets) {
+            ecs_table_copy_bitsets(new_table, new_index - 1, old_table, 
+                (old_index < 0 ? -old_index : old_index) - 1);
+        }
     }
 
     /* Update the entity index so that it points to the new table */
@@ -664,18 +743,17 @@ uint32_t commit(
             new_row.index *= -1;
         }
 
-        ecs_map_set(entity_index, entity, &new_row);
+        ecs_sparse_set(entity_index, entity, &new_row);
     } else {
-        if (in_progress) {
-            /* The entity must be kept in the stage index because otherwise the
-             * merge doesn't know that it needs to merge data for the entity */
-            ecs_map_set(entity_index, entity, &((ecs_row_t){0, 0}));
-        } else {
-            ecs_map_remove(entity_index, entity);
-        }
+        /* The entity must be kept in the index, as an empty entity is still
+         * alive. In a stage this also lets the merge know that it needs to 
+         * merge data for the entity. */
+        ecs_sparse_set(entity_index, entity, &((ecs_row_t){0, 0}));
     }
 
     if (!in_progress) {
+        unindex_names(world, old_type, type, &entity, 1);
+
         /* Invoke the OnRemove callbacks when there are components to remove,
          * but only when not in progress. If we are currently in progress, the
          * OnRemove handlers will be invoked during the merge at the end of the
@@ -881,6 +959,107 @@ ecs_type_t ecs_notify(
     return modified;
 }
 
+/** Reserve count contiguous entity ids. Worker threads take ids from a block
+ * that is reserved for their stage, so they only synchronize with other threads
+ * when the block runs out. Other stages are only used from the main thread. */
+static
+ecs_entity_t new_entity_handles(
+    ecs_world_t *world,
+    ecs_stage_t *stage,
+    uint32_t count)
+{
+    ecs_entity_t result;
+
+    if (stage == &world->main_stage || stage == &world->temp_stage) {
+        result = world->last_handle + 1;
+        world->last_handle += count;
+    } else {
+        if (stage->id_block_end - stage->id_block_next < count) {
+            ecs_entity_t block_size = ECS_ENTITY_ID_BLOCK_SIZE;
+            if (block_size < count) {
+                block_size = count;
+            }
+
+            ecs_os_mutex_lock(world->id_mutex);
+
+            /* Don't reserve more ids than are left in the entity range */
+            ecs_entity_t max_handle = world->max_handle;
+            if (max_handle && world->last_handle + block_size > max_handle) {
+                if (max_handle - world->last_handle >= count) {
+                    block_size = max_handle - world->last_handle;
+                }
+            }
+
+            stage->id_block_next = world->last_handle + 1;
+            world->last_handle += block_size;
+
+            ecs_os_mutex_unlock(world->id_mutex);
+
+            stage->id_block_end = stage->id_block_next + block_size;
+        }
+
+        result = stage->id_block_next;
+        stage->id_block_next += count;
+    }
+
+    ecs_assert(!world->max_handle || result + count - 1 <= world->max_handle, 
+        ECS_OUT_OF_RANGE, NULL);
+    ecs_assert(result + count - 1 <= ECS_ENTITY_ID_MASK, 
+        ECS_OUT_OF_RANGE, NULL);
+
+    return result;
+}
+
+/** Get handle for a new entity. Ids of deleted entities are only recycled when
+ * not in progress, as the free list is shared between threads. */
+static
+ecs_entity_t new_entity_handle(
+    ecs_world_t *world,
+    ecs_stage_t *stage)
+{
+    ecs_entity_t entity;
+
+    if (!world->in_progress) {
+        while (ecs_vector_pop(world->free_handles, &handle_arr_params, &entity)) {
+            /* If the deleted handle has been used again (for example, by adding
+             * a component to it) its id cannot be recycled */
+            if (ecs_sparse_get_ptr(world->main_stage.entity_index, entity)) {
+                continue;
+            }
+
+            /* Don't recycle ids outside of the current entity range */
+            ecs_entity_t id = entity & ECS_ENTITY_ID_MASK;
+            if (id < world->min_handle || 
+                (world->max_handle && id > world->max_handle)) 
+            {
+                continue;
+            }
+
+            return ECS_GENERATION_INC(entity);
+        }
+    }
+
+    return new_entity_handles(world, stage, 1);
+}
+
+/** Remove deleted entity from the entity index, and make its id available for
+ * recycling. Only ids of plain entities (without flags) are recycled. */
+static
+void free_entity_handle(
+    ecs_world_t *world,
+    ecs_entity_t entity)
+{
+    ecs_sparse_remove(world->main_stage.entity_index, entity);
+    ecs_sparse_component_clear(world, &world->main_stage, entity);
+    ecs_world_unindex_name(world, entity);
+
+    if (!(entity & ~(ECS_ENTITY_ID_MASK | ECS_GENERATION_MASK))) {
+        ecs_entity_t *elem = ecs_vector_add(
+            &world->free_handles, &handle_arr_params);
+        *elem = entity;
+    }
+}
+
 void ecs_merge_entity(
     ecs_world_t *world,
     ecs_stage_t *stage,
@@ -918,9 +1097,10 @@ void ecs_merge_entity(
     }
 
     int32_t new_index = commit(
-        world, &world->main_stage, &info, type, 0, to_remove, false);
+        world, &world->main_stage, &info, type, NULL, 0, to_remove, false);
     
-    if (type && staged_type) {
+    /* If new_index is 0 the entity is empty, or the handle was stale */
+    if (new_index && staged_type) {
         ecs_table_t *new_table = ecs_world_get_table(world, stage, type);
         assert(new_table != NULL);
 
@@ -931,6 +1111,23 @@ void ecs_merge_entity(
 
         copy_row( new_table->type, new_table->columns, new_index,
                   staged_table->type, staged_columns, staged_row.index); 
+
+        ecs_table_mark_changed(world, new_table, new_table->columns);
+    }
+}
+
+void ecs_merge_delete(
+    ecs_world_t *world,
+    ecs_entity_t entity)
+{
+    ecs_row_t row;
+
+    /* If components were added to the entity after it was deleted, the entity
+     * is still alive after the merge */
+    if (ecs_sparse_has(world->main_stage.entity_index, entity, &row)) {
+        if (!row.type) {
+            free_entity_handle(world, entity);
+        }
     }
 }
 
@@ -951,7 +1148,7 @@ void ecs_set_watch(
         row.type = NULL;
     }
 
-    ecs_map_set(stage->entity_index, entity, &row);
+    ecs_sparse_set(stage->entity_index, entity, &row);
 }
 
 bool ecs_components_contains_component(
@@ -995,17 +1192,320 @@ void ecs_add_remove_intern(
     ecs_assert(world != NULL, ECS_INVALID_PARAMETER, NULL);
     ecs_stage_t *stage = ecs_get_stage(&world);
     ecs_assert(!world->is_merging, ECS_INVALID_WHILE_MERGING, NULL);
+
+    /* Sparse components are added/removed without moving the entity */
+    ecs_type_t sparse_add, sparse_remove;
+    to_add = ecs_sparse_component_split(world, stage, to_add, &sparse_add);
+    to_remove = ecs_sparse_component_split(
+        world, stage, to_remove, &sparse_remove);
+
+    if (sparse_add || sparse_remove) {
+        ecs_sparse_component_add_remove(
+            world, stage, info->entity, sparse_add, sparse_remove);
+
+        if (!to_add && !to_remove) {
+            return;
+        }
+    }
     
     ecs_type_t dst_type = 0;
+    ecs_table_t *dst_table = NULL;
 
     if (populate_info(world, stage, info)) {
-        dst_type = ecs_type_merge_intern(
-            world, stage, info->table->type, to_add, to_remove);
+        ecs_table_t *table = info->table;
+
+        /* Adding or removing a single component is the most common operation,
+         * so the destination table for it is cached in the source table. */
+        ecs_entity_t component = 0;
+        bool is_add = to_add != NULL;
+        if (is_add && !to_remove && ecs_vector_count(to_add) == 1) {
+            component = *(ecs_entity_t*)ecs_vector_first(to_add);
+        } else if (!is_add && to_remove && ecs_vector_count(to_remove) == 1) {
+            component = *(ecs_entity_t*)ecs_vector_first(to_remove);
+        }
+
+        if (component) {
+            dst_table = ecs_table_get_edge(table, component, is_add);
+        }
+
+        if (dst_table) {
+            dst_type = dst_table->type;
+        } else {
+            dst_type = ecs_type_merge_intern(
+                world, stage, table->type, to_add, to_remove);
+
+            /* Edges are only added when not in progress. Tables created while
+             * in progress may be temporary, and adding edges from multiple 
+             * threads is not safe. */
+            if (component && dst_type && !world->in_progress) {
+                dst_table = ecs_world_get_table(world, stage, dst_type);
+                ecs_table_set_edge(world, table, component, dst_table, is_add);
+            }
+        }
     } else {
         dst_type = to_add;
     }
 
-    commit(world, stage, info, dst_type, to_add, to_remove, do_set);
+    commit(world, stage, info, dst_type, dst_table, to_add, to_remove, do_set);
+}
+
+/** Move a range of rows in a table to the table for the specified type. This is
+ * the equivalent of commit for entities that are stored in subsequent rows of
+ * the same table, and can only be used when not in progress. */
+static
+void commit_range(
+    ecs_world_t *world,
+    ecs_stage_t *stage,
+    ecs_table_t *table,
+    uint32_t offset,
+    uint32_t count,
+    ecs_type_t type,
+    bool do_set)
+{
+    ecs_type_t old_type = table->type;
+    ecs_type_t removed = ecs_type_merge_intern(world, stage, old_type, 0, type);
+    ecs_type_t added = ecs_type_merge_intern(world, stage, type, 0, old_type);
+    ecs_table_t *new_table = NULL;
+
+    /* Invoke OnRemove systems while the data is still in the old table */
+    if (removed) {
+        notify_post_merge(
+            world, stage, table, table->columns, offset, count, removed);
+    }
+
+    if (type) {
+        new_table = ecs_world_get_table(world, stage, type);
+    }
+
+    ecs_entity_t *entities = ecs_vector_first(table->columns[0].data);
+    unindex_names(world, old_type, type, &entities[offset], count);
+
+    uint32_t new_index = ecs_table_move(world, new_table, table, offset, count);
+
+    stage->commit_count ++;
+    stage->from_type = old_type;
+    stage->to_type = type;
+
+    if (added) {
+        entities = ecs_vector_first(new_table->columns[0].data);
+
+        ecs_entity_info_t info = {
+            .entity = entities[new_index - 1],
+            .table = new_table,
+            .columns = new_table->columns,
+            .type = type,
+            .index = new_index
+        };
+
+        notify_after_commit(world, stage, &info, 0, count, added, do_set);
+    }
+
+    world->valid_schedule = false;
+}
+
+/** Add/remove components for a range of entities. Entities in the range that
+ * are stored in subsequent rows of a table are moved with a single commit. */
+static
+void add_remove_w_count(
+    ecs_world_t *world,
+    ecs_entity_t entity,
+    uint32_t count,
+    ecs_type_t to_add,
+    ecs_type_t to_remove,
+    bool do_set)
+{
+    ecs_assert(world != NULL, ECS_INVALID_PARAMETER, NULL);
+
+    ecs_world_t *world_arg = world;
+    ecs_stage_t *stage = ecs_get_stage(&world);
+    ecs_assert(!world->is_merging, ECS_INVALID_WHILE_MERGING, NULL);
+
+    ecs_type_t sparse_add, sparse_remove;
+    to_add = ecs_sparse_component_split(world, stage, to_add, &sparse_add);
+    to_remove = ecs_sparse_component_split(
+        world, stage, to_remove, &sparse_remove);
+
+    uint32_t i;
+    if (sparse_add || sparse_remove) {
+        for (i = 0; i < count; i ++) {
+            ecs_sparse_component_add_remove(
+                world, stage, entity + i, sparse_add, sparse_remove);
+        }
+
+        if (!to_add && !to_remove) {
+            return;
+        }
+    }
+
+    i = 0;
+    while (i < count) {
+        ecs_entity_t e = entity + i;
+        ecs_row_t row;
+
+        /* Rows can only be moved in bulk in the main stage. Entities that are
+         * not stored in a table are also committed one by one. */
+        if (world->in_progress || !stage_has_entity(stage, e, &row) || 
+            !row.type) 
+        {
+            ecs_entity_info_t info = {.entity = e};
+            ecs_add_remove_intern(world_arg, &info, to_add, to_remove, do_set);
+            i ++;
+            continue;
+        }
+
+        ecs_table_t *table = ecs_world_get_table(world, stage, row.type);
+        ecs_entity_t *entities = ecs_vector_first(table->columns[0].data);
+        uint32_t table_count = ecs_vector_count(table->columns[0].data);
+        uint32_t offset = (row.index < 0 ? -row.index : row.index) - 1;
+
+        /* Find how many of the next entities are stored in the next rows */
+        uint32_t n = 1;
+        while (i + n < count && offset + n < table_count && 
+            entities[offset + n] == e + n) 
+        {
+            n ++;
+        }
+
+        ecs_type_t type = ecs_type_merge_intern(
+            world, stage, row.type, to_add, to_remove);
+
+        if (type != row.type) {
+            commit_range(world, stage, table, offset, n, type, do_set);
+        }
+
+        i += n;
+    }
+}
+
+/** Location of an entity that is deleted in bulk */
+typedef struct delete_row_t {
+    ecs_table_t *table;
+    uint32_t index;
+    ecs_entity_t entity;
+} delete_row_t;
+
+static
+int compare_delete_row(
+    const void *p1,
+    const void *p2)
+{
+    const delete_row_t *r1 = p1;
+    const delete_row_t *r2 = p2;
+
+    if (r1->table != r2->table) {
+        return (uintptr_t)r1->table > (uintptr_t)r2->table ? 1 : -1;
+    }
+
+    return r1->index > r2->index ? 1 : r1->index < r2->index ? -1 : 0;
+}
+
+/** Delete entities in bulk. Entities are grouped by table, so that OnRemove
+ * systems are invoked once per range of deleted rows, and each table is
+ * compacted in a single pass. If entities is NULL, the count entities starting
+ * from first are deleted. */
+static
+void delete_entities(
+    ecs_world_t *world,
+    ecs_entity_t first,
+    const ecs_entity_t *entities,
+    uint32_t count)
+{
+    ecs_assert(world != NULL, ECS_INVALID_PARAMETER, NULL);
+    ecs_assert(!count || first || entities, ECS_INVALID_PARAMETER, NULL);
+
+    ecs_world_t *world_arg = world;
+    ecs_stage_t *stage = ecs_get_stage(&world);
+    ecs_assert(!world->is_merging, ECS_INVALID_WHILE_MERGING, NULL);
+
+    uint32_t i;
+
+    /* Deletes are staged while in progress */
+    if (world->in_progress) {
+        for (i = 0; i < count; i ++) {
+            ecs_delete(world_arg, entities ? entities[i] : first + i);
+        }
+        return;
+    }
+
+    if (!count) {
+        return;
+    }
+
+    delete_row_t *rows = ecs_os_malloc(sizeof(delete_row_t) * count);
+    ecs_assert(rows != NULL, ECS_OUT_OF_MEMORY, NULL);
+    uint32_t row_count = 0;
+
+    for (i = 0; i < count; i ++) {
+        ecs_entity_t e = entities ? entities[i] : first + i;
+        ecs_row_t row;
+
+        /* Unlike stage_has_entity, this includes empty entities */
+        if (!ecs_sparse_has(stage->entity_index, e, &row)) {
+            continue;
+        }
+
+        if (row.index < 0) {
+            ecs_world_watch_changed(world, e, row.type, NULL);
+        }
+
+        /* Empty entities can be deleted straight away */
+        if (!row.type) {
+            free_entity_handle(world, e);
+            continue;
+        }
+
+        rows[row_count ++] = (delete_row_t){
+            .table = ecs_world_get_table(world, stage, row.type),
+            .index = (row.index < 0 ? -row.index : row.index) - 1,
+            .entity = e
+        };
+    }
+
+    qsort(rows, row_count, sizeof(delete_row_t), compare_delete_row);
+
+    uint32_t *indices = ecs_os_malloc(sizeof(uint32_t) * (row_count + 1));
+    ecs_assert(indices != NULL, ECS_OUT_OF_MEMORY, NULL);
+
+    i = 0;
+    while (i < row_count) {
+        ecs_table_t *table = rows[i].table;
+        uint32_t j, start, n = 0;
+
+        /* Collect the rows to delete from this table, without duplicates */
+        for (; i < row_count && rows[i].table == table; i ++) {
+            if (!n || indices[n - 1] != rows[i].index) {
+                indices[n ++] = rows[i].index;
+            }
+        }
+
+        /* Invoke OnRemove systems once for each range of subsequent rows */
+        for (start = 0, j = 1; j <= n; j ++) {
+            if (j == n || indices[j] != indices[j - 1] + 1) {
+                notify_post_merge(world, stage, table, table->columns,
+                    indices[start], j - start, table->type);
+                start = j;
+            }
+        }
+
+        ecs_table_delete_n(world, table, indices, n);
+
+        stage->commit_count ++;
+        stage->from_type = table->type;
+        stage->to_type = NULL;
+    }
+
+    /* Duplicate entities are only in the entity index the first time */
+    ecs_sparse_t *entity_index = world->main_stage.entity_index;
+    for (i = 0; i < row_count; i ++) {
+        if (ecs_sparse_get_ptr(entity_index, rows[i].entity)) {
+            free_entity_handle(world, rows[i].entity);
+        }
+    }
+
+    ecs_os_free(indices);
+    ecs_os_free(rows);
+
+    world->valid_schedule = false;
 }
 
 /* -- Public functions -- */
@@ -1020,17 +1520,23 @@ ecs_entity_t _ecs_new(
 
     ecs_assert(!world->is_merging, ECS_INVALID_WHILE_MERGING, NULL);
 
-    ecs_entity_t entity = ++ world->last_handle;
+    ecs_entity_t entity = new_entity_handle(world, stage);
 
-    ecs_assert(!world->max_handle || entity <= world->max_handle, 
-        ECS_OUT_OF_RANGE, NULL);
+    ecs_type_t sparse;
+    type = ecs_sparse_component_split(world, stage, type, &sparse);
 
     if (type) {
         ecs_entity_info_t info = {
             .entity = entity
         };
 
-        commit(world, stage, &info, type, type, 0, true);
+        commit(world, stage, &info, type, NULL, type, 0, true);
+    } else {
+        ecs_sparse_set(stage->entity_index, entity, &((ecs_row_t){0, 0}));
+    }
+
+    if (sparse) {
+        ecs_sparse_component_add_remove(world, stage, entity, sparse, NULL);
     }
 
     return entity;
@@ -1092,15 +1598,20 @@ void copy_column_data(
         int32_t column = ecs_type_index_of(type, component);
         ecs_assert(column >= 0, ECS_INTERNAL_ERROR, NULL);
 
-        uint32_t size = columns[column + 1].size;
+        ecs_table_column_t *dst_column = &columns[column + 1];
+        uint32_t size = dst_column->size;
         if (size) { 
-            void *column_data = ecs_vector_first(columns[column + 1].data);
-
-            memcpy(
-                ECS_OFFSET(column_data, (start_row) * size),
-                data->columns[i],
-                data->row_count * size
-            );
+            void *src = data->columns[i];
+            uint32_t row = start_row, count = data->row_count;
+
+            /* Copy per range of rows that is contiguous in the table column */
+            while (count) {
+                uint32_t n = ecs_table_column_contiguous(dst_column, row, count);
+                memcpy(ecs_table_column_get(dst_column, row), src, n * size);
+                src = ECS_OFFSET(src, n * size);
+                row += n;
+                count -= n;
+            }
         }
     }
 }
@@ -1122,7 +1633,7 @@ uint32_t update_entity_index(
     uint32_t row_count = ecs_vector_count(columns[0].data);
 
     /* Obtain the entity index in the current stage */
-    ecs_map_t *entity_index = stage->entity_index;
+    ecs_sparse_t *entity_index = stage->entity_index;
 
     /* We need to commit each entity individually in order to populate
      * the entity index */
@@ -1151,17 +1662,17 @@ uint32_t update_entity_index(
 
             /* Ensure that the last issued handle will always be ahead of the
              * entities created by this operation */
-            if (e > world->last_handle) {
-                world->last_handle = e + 1;
+            if ((e & ECS_ENTITY_ID_MASK) > world->last_handle) {
+                world->last_handle = (e & ECS_ENTITY_ID_MASK) + 1;
             }                            
         } else {
             e = i + result;
         }
 
-        ecs_row_t *row_ptr = ecs_map_get_ptr(entity_index, e);
+        ecs_row_t *row_ptr = ecs_sparse_get_ptr(entity_index, e);
         if (row_ptr) {
             bool is_monitored = false;
-            uint32_t entity_row = row_ptr->index;
+            int32_t entity_row = row_ptr->index;
             if (entity_row < 0) {
                 entity_row *= -1;
                 is_monitored = true;
@@ -1205,6 +1716,15 @@ uint32_t update_entity_index(
                             old_table->type, old_columns, row_ptr->index);
                     }
 
+                    if (!world->in_progress && old_table->bitsets) {
+                        ecs_table_copy_bitsets(
+                            table, row, old_table, entity_row - 1);
+                    }
+
+                    if (stage == &world->main_stage) {
+                        unindex_names(world, old_table->type, type, &e, 1);
+                    }
+
                     /* Delete column from old table */
                     ecs_table_delete(world, old_table, entity_row);
 
@@ -1225,7 +1745,7 @@ uint32_t update_entity_index(
                      * next entity with the one that we want at this row. */
                     if (row_count > (start_row + i)) {
                         ecs_table_swap(stage, table, columns, 
-                            entity_row, start_row + i, row_ptr, NULL);
+                            entity_row - 1, start_row + i, row_ptr, NULL);
 
                     /* We are at the top of the table and the entity is in
                      * the table. This scenario is a bit nasty, since we
@@ -1244,7 +1764,7 @@ uint32_t update_entity_index(
                          * added entities with the entity that we want at
                          * the end of the block */
                         ecs_table_swap(stage, table, columns, 
-                            entity_row, start_row - 1, row_ptr, NULL);
+                            entity_row - 1, start_row - 1, row_ptr, NULL);
 
                         /* Now move back the whole block back one position, 
                          * while moving the entity before the start to the 
@@ -1267,7 +1787,7 @@ uint32_t update_entity_index(
         } else {
             ecs_row_t new_row = (ecs_row_t){.type = type, .index = start_row + i + 1};
                             
-            ecs_map_set(entity_index, e, &new_row);
+            ecs_sparse_set(entity_index, e, &new_row);
 
             if (data->entities) {
                 ecs_table_insert(world, table, columns, e);
@@ -1291,15 +1811,16 @@ ecs_entity_t set_w_data_intern(
 
     ecs_world_t *world_arg = world;
     ecs_stage_t *stage = ecs_get_stage(&world);
-    ecs_entity_t result = world->last_handle + 1;
     uint32_t count = data->row_count;
-    
-    world->last_handle += count;
+    ecs_entity_t result = new_entity_handles(world, stage, count);
 
-    ecs_assert(!world->max_handle || world->last_handle <= world->max_handle, 
-        ECS_OUT_OF_RANGE, NULL);
     ecs_assert(!world->is_merging, ECS_INVALID_WHILE_MERGING, NULL);
 
+    ecs_type_t sparse;
+    type = ecs_sparse_component_split(world, stage, type, &sparse);
+    ecs_assert(!sparse || !data->columns, ECS_UNSUPPORTED, 
+        "cannot set data for sparse components with ecs_set_w_data");
+
     if (type) {
         /* Get table, table columns and grow table to accomodate for new
          * entities */
@@ -1310,15 +1831,15 @@ ecs_entity_t set_w_data_intern(
         uint32_t start_row = 0;
 
         /* Obtain the entity index in the current stage */
-        ecs_map_t *entity_index = stage->entity_index;
+        ecs_sparse_t *entity_index = stage->entity_index;
 
         /* Grow world entity index only if no entity ids are provided. If ids
          * are provided, it is possible that they already appear in the entity
          * index, in which case they will be overwritten. */
-        uint32_t cur_index_count = ecs_map_count(entity_index);
+        uint32_t cur_index_count = ecs_sparse_count(entity_index);
         if (!data->entities) {
             start_row = ecs_table_grow(world, table, columns, count, result) - 1;
-            ecs_map_grow(entity_index, cur_index_count + count);
+            ecs_sparse_grow(entity_index, cur_index_count + count);
         }
 
         /* Obtain list of entities */
@@ -1338,8 +1859,11 @@ ecs_entity_t set_w_data_intern(
         /* If columns were provided, copy data from columns into table */
         if (data->columns) {
             copy_column_data(type, columns, start_row, data);
+            index_names(world, stage, type, columns, start_row, count);
         }
 
+        ecs_table_mark_changed(world, table, columns);
+
         ecs_entity_info_t info = {
             .entity = result, 
             .table = table, 
@@ -1352,6 +1876,14 @@ ecs_entity_t set_w_data_intern(
             world_arg, stage, &info, 0, count, type, true);
     }
 
+    if (sparse) {
+        uint32_t i;
+        for (i = 0; i < count; i ++) {
+            ecs_entity_t e = data->entities ? data->entities[i] : result + i;
+            ecs_sparse_component_add_remove(world, stage, e, sparse, NULL);
+        }
+    }
+
     return result;
 }
 
@@ -1464,9 +1996,13 @@ void ecs_delete(
                 .table = ecs_world_get_table(world, stage, row.type)
             };
 
-            commit(world, stage, &info, 0, 0, row.type, false);
+            commit(world, stage, &info, 0, NULL, 0, row.type, false);
+        }
 
-            ecs_map_remove(world->main_stage.entity_index, entity);
+        /* Empty entities are in the entity index as well, so also test for
+         * entities that have no components */
+        if (ecs_sparse_get_ptr(world->main_stage.entity_index, entity)) {
+            free_entity_handle(world, entity);
         }
     } else {
         /* Mark components of the entity in the main stage as removed. This will
@@ -1478,10 +2014,45 @@ void ecs_delete(
 
         /* Remove the entity from the staged index. Any added components while
          * in progress will be discarded as a result. */
-        ecs_map_set(stage->entity_index, entity, &((ecs_row_t){0, 0}));
+        ecs_sparse_set(stage->entity_index, entity, &((ecs_row_t){0, 0}));
+        ecs_sparse_component_clear(world, stage, entity);
+
+        /* Keep track of deleted entities, so their ids can be recycled after
+         * the merge */
+        ecs_entity_t *elem = ecs_vector_add(
+            &stage->delete_stage, &handle_arr_params);
+        *elem = entity;
     }
 }
 
+void ecs_delete_w_count(
+    ecs_world_t *world,
+    ecs_entity_t entity,
+    uint32_t count)
+{
+    delete_entities(world, entity, NULL, count);
+}
+
+void ecs_delete_n(
+    ecs_world_t *world,
+    const ecs_entity_t *entities,
+    uint32_t count)
+{
+    delete_entities(world, 0, entities, count);
+}
+
+/** Get components that a table must own to match a filter */
+static
+ecs_type_t filter_owned(
+    ecs_type_filter_t *filter)
+{
+    if (!filter || filter->include_kind == EcsMatchAny) {
+        return NULL;
+    }
+
+    return filter->include;
+}
+
 void ecs_delete_w_filter(
     ecs_world_t *world,
     ecs_type_filter_t *filter)
@@ -1491,18 +2062,29 @@ void ecs_delete_w_filter(
 
     ecs_assert(stage == &world->main_stage, ECS_UNSUPPORTED, 
         "delete_w_filter currently only supported on main stage");
+    (void)stage;
 
-    uint32_t i, count = ecs_chunked_count(stage->tables);
+    ecs_table_iter_t it = ecs_world_tables_iter(
+        world, filter_owned(filter), NULL);
+    ecs_table_t *table;
+    uint64_t filter_bloom = ecs_type_filter_bloom(filter);
 
-    for (i = 0; i < count; i ++) {
-        ecs_table_t *table = ecs_chunked_get(stage->tables, ecs_table_t, i);
+    while ((table = ecs_world_tables_next(&it))) {
         ecs_type_t type = table->type;
 
+        if (!ecs_bloom_contains(table->bloom, filter_bloom)) {
+            continue;
+        }
+
         if (!ecs_type_match_w_filter(world, type, filter)) {
             continue;
         }
 
         /* Both filters passed, clear table */
+        unindex_names(world, type, NULL, 
+            ecs_vector_first(table->columns[0].data), 
+            ecs_vector_count(table->columns[0].data));
+
         ecs_table_clear(world, table);
     }
 }
@@ -1519,42 +2101,91 @@ void _ecs_add_remove_w_filter(
     ecs_assert(stage == &world->main_stage, ECS_UNSUPPORTED, 
         "remove_w_filter currently only supported on main stage");
 
-    uint32_t i, count = ecs_chunked_count(stage->tables);
+    ecs_table_iter_t it;
+    ecs_table_t *table;
+    uint64_t filter_bloom = ecs_type_filter_bloom(filter);
 
-    for (i = 0; i < count; i ++) {
-        ecs_table_t *table = ecs_chunked_get(stage->tables, ecs_table_t, i);
+    /* Sparse components are added/removed per entity, as the entities don't
+     * have to be moved to another table */
+    ecs_type_t sparse_add, sparse_remove;
+    to_add = ecs_sparse_component_split(world, stage, to_add, &sparse_add);
+    to_remove = ecs_sparse_component_split(
+        world, stage, to_remove, &sparse_remove);
+
+    if (sparse_add || sparse_remove) {
+        it = ecs_world_tables_iter(world, filter_owned(filter), NULL);
+
+        while ((table = ecs_world_tables_next(&it))) {
+            if (!ecs_bloom_contains(table->bloom, filter_bloom) ||
+                !ecs_type_match_w_filter(world, table->type, filter)) 
+            {
+                continue;
+            }
+
+            ecs_entity_t *entities = ecs_vector_first(table->columns[0].data);
+            uint32_t row, row_count = ecs_vector_count(table->columns[0].data);
+
+            for (row = 0; row < row_count; row ++) {
+                ecs_sparse_component_add_remove(
+                    world, stage, entities[row], sparse_add, sparse_remove);
+            }
+        }
+
+        if (!to_add && !to_remove) {
+            return;
+        }
+    }
+
+    uint64_t add_bloom = ecs_type_bloom(to_add);
+    uint64_t remove_bloom = ecs_type_bloom(to_remove);
+
+    /* Without a filter, a single removed component selects the tables */
+    ecs_type_t owned = filter_owned(filter);
+    if (!owned && ecs_vector_count(to_remove) == 1) {
+        owned = to_remove;
+    }
+
+    it = ecs_world_tables_iter(world, owned, NULL);
+
+    while ((table = ecs_world_tables_next(&it))) {
         ecs_type_t type = table->type;
 
         /* Skip if the type contains none of the components in to_remove */
         if (to_remove) {
+            if (!(table->bloom & remove_bloom)) {
+                continue;
+            }
+
             if (!ecs_type_contains(world, type, to_remove, false, false)) {
                 continue;
             }
         }
 
-        /* Skip if the type already contains all of the components in to_add */
-        if (to_add) {
+        /* Skip if the type already contains all of the components in to_add.
+         * If the signature does not have all bits, the type cannot. */
+        if (to_add && ecs_bloom_contains(table->bloom, add_bloom)) {
             if (ecs_type_contains(world, type, to_add, true, false)) {
                 continue;
             }            
         }
 
-        if (!ecs_type_match_w_filter(world, type, filter)) {
+        if (!ecs_bloom_contains(table->bloom, filter_bloom)) {
             continue;
         }
 
-        /* Component(s) must be removed, find table */
-        ecs_type_t dst_type = ecs_type_merge(world, type, to_add, to_remove);
-        if (!dst_type) {
-            /* If this removes all components, clear table */
-            ecs_table_merge(world, NULL, table);
-        } else {
-            ecs_table_t *dst_table = ecs_world_get_table(world, stage, dst_type);
-            ecs_assert(dst_table != NULL, ECS_INTERNAL_ERROR, NULL);
+        if (!ecs_type_match_w_filter(world, type, filter)) {
+            continue;
+        }
 
-            /* Merge table into dst_table */
-            ecs_table_merge(world, dst_table, table);
+        uint32_t row_count = ecs_vector_count(table->columns[0].data);
+        if (!row_count) {
+            continue;
         }
+
+        /* Move all entities in the table to the destination table. If this
+         * removes all components, the entities are removed from the table */
+        ecs_type_t dst_type = ecs_type_merge(world, type, to_add, to_remove);
+        commit_range(world, stage, table, 0, row_count, dst_type, false);
     }    
 }
 
@@ -1580,18 +2211,20 @@ ecs_entity_t copy_from_stage(
 
         ecs_assert(!dst_entity, ECS_INTERNAL_ERROR, NULL);
 
-        dst_entity = ++ world->last_handle;
+        dst_entity = new_entity_handle(world, stage);
         new_type = src_info.type;
 
         ecs_entity_info_t info = {
             .entity = dst_entity
         };
 
-        commit(world, stage, &info, new_type, src_info.type, 0, false);
+        commit(world, stage, &info, new_type, NULL, src_info.type, 0, false);
 
         if (copy_value) {
             copy_row(info.table->type, info.columns, info.index,
                 src_info.type, src_info.columns, src_info.index);
+            index_names(world, stage, info.table->type, info.columns, 
+                info.index - 1, 1);
 
             ecs_notify(
                 world_arg, stage, world->type_sys_set_index, 
@@ -1620,9 +2253,12 @@ ecs_entity_t ecs_clone(
     }
 
     if (!result) {
-        result = ++ world->last_handle;
+        result = new_entity_handle(world, stage);
+        ecs_sparse_set(stage->entity_index, result, &((ecs_row_t){0, 0}));
     }
 
+    ecs_sparse_component_clone(world, stage, entity, result, copy_value);
+
     return result;
 }
 
@@ -1654,6 +2290,34 @@ void _ecs_add_remove(
     ecs_add_remove_intern(world, &info, add_type, remove_type, false);
 }
 
+void _ecs_add_w_count(
+    ecs_world_t *world,
+    ecs_entity_t entity,
+    uint32_t count,
+    ecs_type_t type)
+{
+    add_remove_w_count(world, entity, count, type, 0, true);
+}
+
+void _ecs_remove_w_count(
+    ecs_world_t *world,
+    ecs_entity_t entity,
+    uint32_t count,
+    ecs_type_t type)
+{
+    add_remove_w_count(world, entity, count, 0, type, false);
+}
+
+void _ecs_add_remove_w_count(
+    ecs_world_t *world,
+    ecs_entity_t entity,
+    uint32_t count,
+    ecs_type_t to_add,
+    ecs_type_t to_remove)
+{
+    add_remove_w_count(world, entity, count, to_add, to_remove, false);
+}
+
 void ecs_adopt(
     ecs_world_t *world,
     ecs_entity_t entity,
@@ -1728,6 +2392,16 @@ void* _ecs_get_ptr(
     /* Get only accepts types that hold a single component */
     ecs_entity_t component = ecs_type_to_entity(world_arg, type);
 
+    ecs_sparse_storage_t *storage = ecs_sparse_component_storage(
+        world, component);
+    if (storage) {
+        if (!storage->size) {
+            return NULL;
+        }
+
+        return ecs_sparse_get_ptr(storage->data, entity);
+    }
+
     ecs_entity_info_t info = {.entity = entity};
     return ecs_get_ptr_intern(world, stage, &info, component, false, true);
 }
@@ -1744,6 +2418,16 @@ ecs_entity_t _ecs_set_ptr_intern(
     ecs_assert(!size || ptr != NULL, ECS_INVALID_PARAMETER, NULL);
     ecs_world_t *world_arg = world;
     ecs_stage_t *stage = ecs_get_stage(&world);
+
+    /* Sparse components are set directly in the sparse storage */
+    ecs_sparse_storage_t *storage = ecs_sparse_component_storage(
+        world, component);
+    if (storage) {
+        ecs_assert(storage->size == size, ECS_INVALID_COMPONENT_SIZE, NULL);
+        ecs_sparse_component_set(world, stage, entity, component, storage, ptr);
+        return entity;
+    }
+
     ecs_type_t type = ecs_type_from_entity(world, component);
     ecs_entity_info_t info = {.entity = entity};
 
@@ -1770,6 +2454,13 @@ ecs_entity_t _ecs_set_ptr_intern(
         memcpy(dst, ptr, size);
     }
 
+    int16_t column = ecs_type_index_of(info.table->type, component);
+    info.columns[column + 1].change_tick = world->change_tick;
+
+    if (component == EEcsId) {
+        index_name(world, stage, entity, *(EcsId*)dst);
+    }
+
     notify_pre_merge(
         world_arg, stage, info.table, info.columns, info.index - 1, 1, type,
         world->type_sys_set_index);
@@ -1823,6 +2514,17 @@ bool ecs_has_intern(
     }
 
     ecs_world_t *world_arg = world;
+    ecs_stage_t *stage = ecs_get_stage(&world);
+
+    ecs_type_t sparse;
+    type = ecs_sparse_component_split(world, stage, type, &sparse);
+    if (sparse) {
+        bool has = ecs_sparse_component_has(world, entity, sparse, match_any);
+        if (!type || has != match_any) {
+            return has;
+        }
+    }
+
     ecs_type_t entity_type = ecs_get_type(world_arg, entity);
     return ecs_type_contains(world, entity_type, type, match_any, match_prefabs) != 0;
 }
@@ -1875,6 +2577,14 @@ bool ecs_has_entity(
     }
 
     ecs_world_t *world_arg = world;
+    ecs_get_stage(&world);
+
+    ecs_sparse_storage_t *storage = ecs_sparse_component_storage(
+        world, component);
+    if (storage) {
+        return ecs_sparse_get_ptr(storage->data, entity) != NULL;
+    }
+
     ecs_type_t entity_type = ecs_get_type(world_arg, entity);
     return ecs_type_has_entity(world, entity_type, component);
 }
@@ -1930,7 +2640,129 @@ bool ecs_is_empty(
     ecs_world_t *world,
     ecs_entity_t entity)
 {
-    return ecs_get_type(world, entity) == NULL;
+    ecs_world_t *world_arg = world;
+    ecs_get_stage(&world);
+
+    return ecs_get_type(world_arg, entity) == NULL && 
+        ecs_sparse_component_is_empty(world, entity);
+}
+
+bool ecs_is_alive(
+    ecs_world_t *world,
+    ecs_entity_t entity)
+{
+    ecs_assert(world != NULL, ECS_INVALID_PARAMETER, NULL);
+
+    ecs_get_stage(&world);
+
+    return ecs_sparse_get_ptr(world->main_stage.entity_index, entity) != NULL;
+}
+
+/** Find the table and row that store an entity in the main stage */
+static
+ecs_table_t* main_stage_row(
+    ecs_world_t *world,
+    ecs_entity_t entity,
+    uint32_t *row_out)
+{
+    ecs_row_t row = row_from_stage(&world->main_stage, entity);
+    if (!row.type) {
+        return NULL;
+    }
+
+    *row_out = (row.index < 0 ? -row.index : row.index) - 1;
+
+    return ecs_world_get_table(world, &world->main_stage, row.type);
+}
+
+static
+void enable_intern(
+    ecs_world_t *world,
+    ecs_entity_t entity,
+    ecs_entity_t component,
+    bool enabled)
+{
+    ecs_assert(world != NULL, ECS_INVALID_PARAMETER, NULL);
+    ecs_assert(world->magic == ECS_WORLD_MAGIC, ECS_INVALID_FROM_WORKER, NULL);
+
+    /* Worker threads read the bitsets while iterating */
+    ecs_assert(!world->in_progress || !ecs_vector_count(world->worker_threads),
+        ECS_INVALID_WHILE_ITERATING, NULL);
+
+    uint32_t row;
+    ecs_table_t *table = main_stage_row(world, entity, &row);
+    ecs_assert(table != NULL, ECS_INVALID_PARAMETER, NULL);
+    ecs_assert(!component || ecs_type_index_of(table->type, component) != -1,
+        ECS_INVALID_PARAMETER, "entity does not own component");
+
+    /* Bitsets are only created when a row is disabled */
+    ecs_table_bitset_t *bitset = ecs_table_get_bitset(
+        table, component, !enabled);
+
+    if (bitset) {
+        ecs_table_bitset_set(bitset, row, !enabled);
+    }
+
+    /* The set of rows iterated by systems changed */
+    table->columns[0].change_tick = world->change_tick;
+}
+
+static
+bool is_enabled_intern(
+    ecs_world_t *world,
+    ecs_entity_t entity,
+    ecs_entity_t component)
+{
+    ecs_assert(world != NULL, ECS_INVALID_PARAMETER, NULL);
+    ecs_get_stage(&world);
+
+    uint32_t row;
+    ecs_table_t *table = main_stage_row(world, entity, &row);
+    if (!table) {
+        return !component;
+    }
+
+    if (component && ecs_type_index_of(table->type, component) == -1) {
+        return false;
+    }
+
+    ecs_table_bitset_t *bitset = ecs_table_get_bitset(table, component, false);
+
+    return !bitset || !ecs_table_bitset_get(bitset, row);
+}
+
+void _ecs_enable_component(
+    ecs_world_t *world,
+    ecs_entity_t entity,
+    ecs_entity_t component,
+    bool enabled)
+{
+    ecs_assert(component != 0, ECS_INVALID_PARAMETER, NULL);
+    enable_intern(world, entity, component, enabled);
+}
+
+bool _ecs_is_component_enabled(
+    ecs_world_t *world,
+    ecs_entity_t entity,
+    ecs_entity_t component)
+{
+    ecs_assert(component != 0, ECS_INVALID_PARAMETER, NULL);
+    return is_enabled_intern(world, entity, component);
+}
+
+void ecs_enable_entity(
+    ecs_world_t *world,
+    ecs_entity_t entity,
+    bool enabled)
+{
+    enable_intern(world, entity, 0, enabled);
+}
+
+bool ecs_is_entity_enabled(
+    ecs_world_t *world,
+    ecs_entity_t entity)
+{
+    return is_enabled_intern(world, entity, 0);
 }
 
 ecs_type_t ecs_type_from_entity(
@@ -1969,8 +2801,7 @@ ecs_type_t ecs_type_from_entity(
     }
 
     if (component == EEcsTypeComponent) {
-        ecs_vector_params_t params = {.element_size = sizeof(EcsTypeComponent)};
-        EcsTypeComponent *fe = ecs_vector_get(columns[1].data, &params, index);
+        EcsTypeComponent *fe = ecs_table_column_get(&columns[1], index);
         type = fe->resolved;
     } else {
         type = ecs_type_find_intern(world, stage, &entity, 1);
@@ -2018,6 +2849,40 @@ ecs_type_t ecs_get_type(
     return result;
 }
 
+/** Count entities with sparse components by iterating the entities of the first
+ * sparse component, and testing for the remaining components */
+static
+uint32_t count_sparse(
+    ecs_world_t *world,
+    ecs_type_t type,
+    ecs_type_t sparse)
+{
+    ecs_entity_t component = *(ecs_entity_t*)ecs_vector_first(sparse);
+    ecs_sparse_storage_t *storage = ecs_sparse_component_storage(
+        world, component);
+    ecs_assert(storage != NULL, ECS_INTERNAL_ERROR, NULL);
+
+    uint32_t result = 0;
+    ecs_sparse_iter_t it = ecs_sparse_iter(storage->data);
+
+    while (ecs_sparse_hasnext(&it)) {
+        uint64_t entity;
+        ecs_sparse_next_w_key(&it, &entity);
+
+        if (!ecs_sparse_component_has(world, entity, sparse, true)) {
+            continue;
+        }
+
+        if (type && !ecs_has_intern(world, entity, type, true, true)) {
+            continue;
+        }
+
+        result ++;
+    }
+
+    return result;
+}
+
 uint32_t _ecs_count(
     ecs_world_t *world,
     ecs_type_t type)
@@ -2026,12 +2891,25 @@ uint32_t _ecs_count(
         return 0;
     }
 
-    ecs_chunked_t *tables = world->main_stage.tables;
-    uint32_t i, count = ecs_chunked_count(tables);
+    ecs_type_t sparse;
+    type = ecs_sparse_component_split(world, &world->main_stage, type, &sparse);
+    if (sparse) {
+        return count_sparse(world, type, sparse);
+    }
+
+    ecs_table_iter_t it = ecs_world_tables_iter(world, NULL, type);
+    ecs_table_t *table;
     uint32_t result = 0;
+    uint64_t bloom = ecs_type_bloom(type);
+
+    while ((table = ecs_world_tables_next(&it))) {
+        /* Components of tables with prefabs may be inherited */
+        if (!(table->flags & EcsTableHasPrefab) && 
+            !ecs_bloom_contains(table->bloom, bloom)) 
+        {
+            continue;
+        }
 
-    for (i = 0; i < count; i ++) {
-        ecs_table_t *table = ecs_chunked_get(tables, ecs_table_t, i);
         if (ecs_type_contains(world, table->type, type, true, true)) {
             result += ecs_vector_count(table->columns[0].data);
         }
@@ -14,6 +14,12 @@ void ecs_merge_entity(
     ecs_entity_t entity,
     ecs_row_t staged_row);
 
+/* Recycle id of entity that was deleted while in progress, if it is still empty
+ * after merging */
+void ecs_merge_delete(
+    ecs_world_t *world,
+    ecs_entity_t entity);
+
 /* Get prefab from type, even if type was introduced while in progress */
 ecs_entity_t ecs_get_prefab_from_type(
     ecs_world_t *world,
@@ -84,6 +90,37 @@ void ecs_world_activate_system(
     EcsSystemKind kind,
     bool active);
 
+/* Register that a watched entity changed type, which triggers rematching of
+ * the systems that use the changed components */
+void ecs_world_watch_changed(
+    ecs_world_t *world,
+    ecs_entity_t entity,
+    ecs_type_t old_type,
+    ecs_type_t new_type);
+
+/* Iterate tables that may have the components in owned (as owned components)
+ * and in self (as owned or inherited components) */
+ecs_table_iter_t ecs_world_tables_iter(
+    ecs_world_t *world,
+    ecs_type_t owned,
+    ecs_type_t self);
+
+/* Get next table from table iterator, or NULL if no tables are left */
+ecs_table_t* ecs_world_tables_next(
+    ecs_table_iter_t *it);
+
+/* Add entity to the name index, so that it can be found with ecs_lookup. Must
+ * be called from the main stage. */
+void ecs_world_index_name(
+    ecs_world_t *world,
+    ecs_entity_t entity,
+    const char *name);
+
+/* Remove entity from the name index when its name is removed or deleted */
+void ecs_world_unindex_name(
+    ecs_world_t *world,
+    ecs_entity_t entity);
+
 /* Get current thread-specific stage */
 ecs_stage_t *ecs_get_stage(
     ecs_world_t **world_ptr);
@@ -110,8 +147,106 @@ void ecs_stage_merge(
     ecs_world_t *world,
     ecs_stage_t *stage);
 
+/* Get slab for allocations in stage, NULL if stage must use the heap */
+ecs_slab_t* ecs_stage_get_slab(
+    ecs_world_t *world,
+    ecs_stage_t *stage);
+
+/* -- Sparse component API -- */
+
+/* Get sparse storage for component, NULL if component is stored in tables */
+ecs_sparse_storage_t* ecs_sparse_component_storage(
+    ecs_world_t *world,
+    ecs_entity_t component);
+
+/* Split type in components stored in tables (returned) and sparse components */
+ecs_type_t ecs_sparse_component_split(
+    ecs_world_t *world,
+    ecs_stage_t *stage,
+    ecs_type_t type,
+    ecs_type_t *sparse_out);
+
+/* Add/remove sparse components to/from entity */
+void ecs_sparse_component_add_remove(
+    ecs_world_t *world,
+    ecs_stage_t *stage,
+    ecs_entity_t entity,
+    ecs_type_t to_add,
+    ecs_type_t to_remove);
+
+/* Set value of sparse component, add it if entity doesn't have it yet */
+void ecs_sparse_component_set(
+    ecs_world_t *world,
+    ecs_stage_t *stage,
+    ecs_entity_t entity,
+    ecs_entity_t component,
+    ecs_sparse_storage_t *storage,
+    const void *ptr);
+
+/* Test if entity has all (or any) of the sparse components in type */
+bool ecs_sparse_component_has(
+    ecs_world_t *world,
+    ecs_entity_t entity,
+    ecs_type_t type,
+    bool match_all);
+
+/* Test if entity has no sparse components */
+bool ecs_sparse_component_is_empty(
+    ecs_world_t *world,
+    ecs_entity_t entity);
+
+/* Remove all sparse components from entity */
+void ecs_sparse_component_clear(
+    ecs_world_t *world,
+    ecs_stage_t *stage,
+    ecs_entity_t entity);
+
+/* Copy sparse components (and optionally their values) to other entity */
+void ecs_sparse_component_clone(
+    ecs_world_t *world,
+    ecs_stage_t *stage,
+    ecs_entity_t src,
+    ecs_entity_t dst,
+    bool copy_value);
+
+/* Apply sparse component operations of worker thread stage */
+void ecs_sparse_component_merge(
+    ecs_world_t *world,
+    ecs_stage_t *stage);
+
+/* Free sparse component operations that were not merged */
+void ecs_sparse_component_stage_free(
+    ecs_stage_t *stage);
+
+/* Free sparse component storage */
+void ecs_sparse_component_fini(
+    ecs_world_t *world);
+
 /* -- Type utility API -- */
 
+/* Compute bloom signature with one bit per entity in type */
+uint64_t ecs_type_bloom(
+    ecs_type_t type);
+
+/* Compute bloom signature of entities that are in only one of two types */
+uint64_t ecs_type_diff_bloom(
+    ecs_type_t type_1,
+    ecs_type_t type_2);
+
+/* Compute bloom signature that a type must contain to match filter */
+uint64_t ecs_type_filter_bloom(
+    ecs_type_filter_t *filter);
+
+/* Free all types in type database */
+void ecs_type_db_free(
+    ecs_type_db_t *db);
+
+/* Get memory used by type database */
+void ecs_type_db_memory(
+    ecs_type_db_t *db,
+    uint32_t *allocd,
+    uint32_t *used);
+
 ecs_type_t ecs_type_find_intern(
     ecs_world_t *world,
     ecs_stage_t *stage,
@@ -191,6 +326,10 @@ ecs_table_column_t *ecs_table_get_columns(
     ecs_stage_t *stage,
     ecs_table_t *table);
 
+/* Remove cached edges to tables that are marked as garbage */
+void ecs_table_clear_garbage_edges(
+    ecs_table_t *table);
+
 void ecs_table_register_system(
     ecs_world_t *world,
     ecs_table_t *table,
@@ -221,6 +360,75 @@ int16_t ecs_table_dim(
 uint64_t ecs_table_count(
     ecs_table_t *table);
 
+/* Get pointer to row in table column */
+void* ecs_table_column_get(
+    ecs_table_column_t *column,
+    uint32_t index);
+
+/* Return number of rows (up to count) starting from index that are stored
+ * contiguously in column */
+uint32_t ecs_table_column_contiguous(
+    ecs_table_column_t *column,
+    uint32_t index,
+    uint32_t count);
+
+/* Return number of rows (up to count) starting from index that are stored
+ * contiguously in all columns of table */
+uint32_t ecs_table_contiguous(
+    ecs_table_t *table,
+    ecs_table_column_t *columns,
+    uint32_t index,
+    uint32_t count);
+
+/* Free data of table column */
+void ecs_table_column_free(
+    ecs_table_column_t *column);
+
+/* Mark all columns of a table (or stage) as written */
+void ecs_table_mark_changed(
+    ecs_world_t *world,
+    ecs_table_t *table,
+    ecs_table_column_t *columns);
+
+/* Find bitset for component (0 for entity) in table, optionally create it */
+ecs_table_bitset_t* ecs_table_get_bitset(
+    ecs_table_t *table,
+    ecs_entity_t component,
+    bool create);
+
+/* Test if row is disabled in bitset */
+bool ecs_table_bitset_get(
+    ecs_table_bitset_t *bitset,
+    uint32_t row);
+
+/* Enable or disable row in bitset */
+void ecs_table_bitset_set(
+    ecs_table_bitset_t *bitset,
+    uint32_t row,
+    bool disabled);
+
+/* Copy disabled components of a row to a (new) row in another table */
+void ecs_table_copy_bitsets(
+    ecs_table_t *dst_table,
+    uint32_t dst_row,
+    ecs_table_t *src_table,
+    uint32_t src_row);
+
+/* Find first range of rows from row up to end that is enabled in all bitsets.
+ * Returns the number of rows in the range, and sets row to its first row. */
+uint32_t ecs_table_enabled_range(
+    ecs_table_bitset_t **bitsets,
+    uint32_t count,
+    uint32_t *row,
+    uint32_t end);
+
+/* Obtain memory usage of table column with count rows */
+void ecs_table_column_memory(
+    ecs_table_column_t *column,
+    uint32_t count,
+    uint32_t *allocd,
+    uint32_t *used);
+
 /* Return size of table row */
 uint32_t ecs_table_row_size(
     ecs_table_t *table);
@@ -235,6 +443,13 @@ void ecs_table_delete(
     ecs_table_t *table,
     int32_t index);
 
+/* Delete rows (0-based, sorted and unique) from table in a single pass */
+void ecs_table_delete_n(
+    ecs_world_t *world,
+    ecs_table_t *table,
+    uint32_t *rows,
+    uint32_t count);
+
 /* Get row from table (or stage) */
 void* ecs_table_get(
     ecs_table_t *table,
@@ -251,6 +466,11 @@ void ecs_table_deinit(
     ecs_world_t *world,
     ecs_table_t *table);
 
+/* Release memory in table that is not used to store rows */
+void ecs_table_shrink(
+    ecs_world_t *world,
+    ecs_table_t *table);
+
 /* Free table */
 void ecs_table_free(
     ecs_world_t *world,
@@ -261,11 +481,35 @@ void ecs_table_clear(
     ecs_world_t *world,
     ecs_table_t *table);
 
-/* Merge data of one table into another table */
-void ecs_table_merge(
+/* Get cached destination table for adding or removing a single component */
+ecs_table_t* ecs_table_get_edge(
+    ecs_table_t *table,
+    ecs_entity_t component,
+    bool is_add);
+
+/* Cache destination table for adding or removing a single component */
+void ecs_table_set_edge(
+    ecs_world_t *world,
+    ecs_table_t *table,
+    ecs_entity_t component,
+    ecs_table_t *dst_table,
+    bool is_add);
+
+/* Sort rows of table by component. Returns true if rows were moved. */
+bool ecs_table_sort(
+    ecs_world_t *world,
+    ecs_table_t *table,
+    ecs_entity_t component,
+    ecs_compare_action_t compare);
+
+/* Move a range of rows to another table (or remove them, if the table is NULL)
+ * and update the entity index. Returns the index of the first moved row. */
+uint32_t ecs_table_move(
     ecs_world_t *world,
-    ecs_table_t *new_table,
-    ecs_table_t *old_table);
+    ecs_table_t *dst_table,
+    ecs_table_t *src_table,
+    uint32_t offset,
+    uint32_t count);
 
 void ecs_table_swap(
     ecs_stage_t *stage,
@@ -302,12 +546,61 @@ ecs_entity_t ecs_new_col_system(
     const char *sig,
     ecs_system_action_t action);
 
+/* Parse signature of column system and match it with existing tables. The
+ * system is 0 for queries. */
+void ecs_col_system_init(
+    ecs_world_t *world,
+    ecs_entity_t system,
+    EcsColSystem *system_data,
+    const char *sig);
+
+/* Free resources of column system */
+void ecs_col_system_deinit(
+    ecs_world_t *world,
+    EcsColSystem *system_data);
+
 /* Notify column system of a new table, which initiates system-table matching */
 void ecs_col_system_notify_of_table(
     ecs_world_t *world,
     ecs_entity_t system,
     ecs_table_t *table);
 
+/* Add table to column system if it matches. Returns true if table matched. */
+bool ecs_col_system_match_table(
+    ecs_world_t *world,
+    ecs_entity_t system,
+    EcsColSystem *system_data,
+    ecs_table_t *table);
+
+/* Remove table from matched tables. Returns true if the table was active. */
+bool ecs_col_system_unmatch_table(
+    ecs_world_t *world,
+    EcsColSystem *system_data,
+    ecs_table_t *table);
+
+/* Collect bitsets of table that disable rows for column system */
+uint32_t ecs_col_system_get_bitsets(
+    EcsColSystem *system_data,
+    ecs_matched_table_t *table,
+    ecs_table_bitset_t **out);
+
+/* Sort tables of column system by its sort component. Returns true if rows
+ * were moved. */
+bool ecs_col_system_sort_tables(
+    ecs_world_t *world,
+    ecs_entity_t system);
+
+/* Advance change ticks of column system before it runs (main thread only) */
+void ecs_col_system_begin_run(
+    ecs_world_t *world,
+    EcsColSystem *system_data);
+
+/* Remove table from column system, before table is deleted */
+void ecs_col_system_remove_table(
+    ecs_world_t *world,
+    ecs_entity_t system,
+    ecs_table_t *table);
+
 /* Notify row system of a new type, which initiates system-type matching */
 void ecs_row_system_notify_of_type(
     ecs_world_t *world,
@@ -346,16 +639,54 @@ int ecs_parse_signature_action(
     const char *source_id,
     void *data);
 
-/* Trigger rematch of system */
+/* Rematch system with tables that depend on changed watched entities */
 void ecs_rematch_system(
     ecs_world_t *world,
-    ecs_entity_t system);
+    ecs_entity_t system,
+    const ecs_rematch_t *rematch);
+
+/* Rematch column system data with tables that depend on changed entities */
+void ecs_col_system_rematch(
+    ecs_world_t *world,
+    ecs_entity_t system,
+    EcsColSystem *system_data,
+    const ecs_rematch_t *rematch);
 
 /* Re-resolve references of system after table realloc */
 void ecs_revalidate_system_refs(
     ecs_world_t *world,
     ecs_entity_t system);
 
+/* Re-resolve references of column system data after table realloc */
+void ecs_col_system_revalidate_refs(
+    ecs_world_t *world,
+    EcsColSystem *system_data);
+
+/* -- Query API -- */
+
+/* Match new table with queries */
+void ecs_notify_queries_of_table(
+    ecs_world_t *world,
+    ecs_table_t *table);
+
+/* Remove table from queries, before table is deleted */
+void ecs_queries_remove_table(
+    ecs_world_t *world,
+    ecs_table_t *table);
+
+/* Rematch queries after a change happened to a container or prefab */
+void ecs_rematch_queries(
+    ecs_world_t *world,
+    const ecs_rematch_t *rematch);
+
+/* Re-resolve references of queries after table realloc */
+void ecs_revalidate_query_refs(
+    ecs_world_t *world);
+
+/* Free queries that were not freed by the application */
+void ecs_queries_fini(
+    ecs_world_t *world);
+
 /* -- Worker API -- */
 
 /* Compute schedule based on current number of entities matching system */
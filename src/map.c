@@ -1,262 +1,274 @@
-
 #include "flecs_private.h"
 
-#define FLECS_LOAD_FACTOR (3.0f / 4.0f)
-
-typedef struct ecs_map_node_t {
-    uint64_t key;           /* Key */
-    uint32_t next;          /* Next node index */
-    uint32_t prev;          /* Previous node index (enables O(1) removal) */
-} ecs_map_node_t;
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define ECS_MAP_SSE2
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define ECS_MAP_NEON
+#endif
+
+/* Number of slots in a group. The control bytes of a group are tested with a
+ * single (SIMD) compare. */
+#define ECS_MAP_GROUP_SIZE (16)
+
+/* Maximum load factor (7/8). Deleted slots count towards the load, as they
+ * lengthen probe sequences just like occupied slots. */
+#define ECS_MAP_LOAD_NUM (7)
+#define ECS_MAP_LOAD_DEN (8)
+
+/* Control byte values. An occupied slot stores the lower 7 bits of the hash in
+ * its control byte, which rejects most non-matching slots without having to
+ * load their key. */
+#define ECS_MAP_EMPTY ((int8_t)-128)
+#define ECS_MAP_DELETED ((int8_t)-2)
+#define ECS_MAP_H2_MASK (0x7F)
 
 struct ecs_map_t {
-    uint32_t *buckets;      /* Array of buckets */
-    ecs_vector_t *nodes;    /* Array with memory for map nodes */
-    ecs_vector_params_t node_params; /* Parameters for node vector */
-    size_t bucket_count;    /* number of buckets */
-    uint32_t count;         /* number of elements */
-    uint32_t min;           /* minimum number of elements */
+    int8_t *ctrl;           /* Control bytes (one per slot), followed by slots */
+    void *slots;            /* Array with keys and values */
+    uint32_t slot_size;     /* Size of key + value */
+    uint32_t data_size;     /* Size of value */
+    uint32_t bucket_count;  /* Number of slots, multiple of group size */
+    uint32_t count;         /* Number of elements */
+    uint32_t deleted;       /* Number of deleted slots */
+    uint32_t min;           /* Minimum number of slots */
+    ecs_slab_t *slab;       /* Allocator for map and slots (NULL for heap) */
 };
 
+/** Mix bits of key, so that sequential ids and aligned pointers are spread out
+ * evenly over groups and control bytes (finalizer of MurmurHash3) */
 static
-size_t data_size(
-    ecs_map_t *map)
+uint64_t hash_key(
+    uint64_t key)
 {
-    return map->node_params.element_size - sizeof(ecs_map_node_t);
+    key ^= key >> 33;
+    key *= 0xff51afd7ed558ccdULL;
+    key ^= key >> 33;
+    key *= 0xc4ceb9fe1a85ec53ULL;
+    key ^= key >> 33;
+    return key;
 }
 
-/** Get map node from index */
+/** Return index of lowest bit that is set in mask */
 static
-ecs_map_node_t *node_from_index(
-    ecs_map_t *map,
-    ecs_vector_t *nodes,
-    uint32_t index)
+uint32_t first_bit(
+    uint32_t mask)
 {
-    return ecs_vector_get(nodes, &map->node_params, index - 1);
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctz(mask);
+#else
+    uint32_t result = 0;
+    while (!(mask & 1)) {
+        mask >>= 1;
+        result ++;
+    }
+    return result;
+#endif
 }
 
-/** Get a bucket for a given key */
+#ifdef ECS_MAP_NEON
+/** Emulate SSE2 movemask, returns one bit per byte lane */
 static
-uint32_t* get_bucket(
-    ecs_map_t *map,
-    uint64_t key)
+uint32_t neon_movemask(
+    uint8x16_t lanes)
 {
-    uint64_t index = key % map->bucket_count;
-    return &map->buckets[index];
-}
-
-/** Callback that updates administration when node is moved in nodes array */
-static
-void move_node(
-    ecs_vector_t *array,
-    const ecs_vector_params_t *params,
-    void *to,
-    void *from,
-    void *ctx)
-{
-    ecs_map_t *map = ctx;
-    ecs_map_node_t *node_p = to;
-    uint32_t node = ecs_vector_get_index(array, &map->node_params, to) + 1;
-    uint32_t prev = node_p->prev;
-    uint32_t next = node_p->next;
-    (void)params;
-    (void)from;
-
-    if (prev) {
-        ecs_map_node_t *prev_p = node_from_index(map, array, prev);
-        prev_p->next = node;
-    } else {
-        uint32_t *bucket = get_bucket(map, node_p->key);
-        *bucket = node;
-    }
+    static const uint8_t bits[ECS_MAP_GROUP_SIZE] = {
+        1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128
+    };
 
-    if (next) {
-        ecs_map_node_t *next_p = node_from_index(map, array, next);
-        next_p->prev = node;
-    }
+    uint8x16_t masked = vandq_u8(lanes, vld1q_u8(bits));
+    return (uint32_t)vaddv_u8(vget_low_u8(masked)) |
+        ((uint32_t)vaddv_u8(vget_high_u8(masked)) << 8);
 }
+#endif
 
-/** Allocate the buckets buffer */
+/** Get bitmask of slots in group with control byte equal to value */
 static
-void alloc_buffer(
-    ecs_map_t *map,
-    uint32_t bucket_count)
+uint32_t group_match(
+    const int8_t *ctrl,
+    int8_t value)
 {
-    if (bucket_count) {
-        map->buckets = ecs_os_calloc(bucket_count * sizeof(uint32_t), 1);
-        ecs_assert(map->buckets != NULL, ECS_OUT_OF_MEMORY, 0);
-    } else {
-        map->buckets = NULL;
+#if defined(ECS_MAP_SSE2)
+    __m128i group = _mm_loadu_si128((const __m128i*)ctrl);
+    return (uint32_t)_mm_movemask_epi8(
+        _mm_cmpeq_epi8(group, _mm_set1_epi8(value)));
+#elif defined(ECS_MAP_NEON)
+    return neon_movemask(vceqq_s8(vld1q_s8(ctrl), vdupq_n_s8(value)));
+#else
+    uint32_t i, result = 0;
+    for (i = 0; i < ECS_MAP_GROUP_SIZE; i ++) {
+        if (ctrl[i] == value) {
+            result |= 1u << i;
+        }
     }
-
-    map->bucket_count = bucket_count;
+    return result;
+#endif
 }
 
-/** Allocate a map object */
+/** Get bitmask of slots in group that are empty or deleted */
 static
-ecs_map_t *alloc_map(
-    uint32_t bucket_count,
-    uint32_t data_size)
+uint32_t group_match_free(
+    const int8_t *ctrl)
 {
-    ecs_map_t *result = ecs_os_malloc(sizeof(ecs_map_t));
-    ecs_assert(result != NULL, ECS_OUT_OF_MEMORY, NULL);
-
-    alloc_buffer(result, bucket_count);
-    result->count = 0;
-    result->min = bucket_count;
-    result->node_params = (ecs_vector_params_t){
-        .element_size = data_size + sizeof(ecs_map_node_t),
-        .move_action = move_node
-    };
-
-    result->nodes = ecs_vector_new(&result->node_params, ECS_MAP_INITIAL_NODE_COUNT);
-    
+#if defined(ECS_MAP_SSE2)
+    return (uint32_t)_mm_movemask_epi8(_mm_loadu_si128((const __m128i*)ctrl));
+#elif defined(ECS_MAP_NEON)
+    return neon_movemask(vcltzq_s8(vld1q_s8(ctrl)));
+#else
+    uint32_t i, result = 0;
+    for (i = 0; i < ECS_MAP_GROUP_SIZE; i ++) {
+        if (ctrl[i] < 0) {
+            result |= 1u << i;
+        }
+    }
     return result;
+#endif
 }
 
-/** Find next non-empty bucket */
 static
-uint32_t next_bucket(
+uint64_t* get_slot(
     ecs_map_t *map,
-    uint32_t start_index)
+    uint32_t slot)
 {
-    size_t i;
-    for (i = start_index; i < map->bucket_count; i ++) {
-        if (map->buckets[i]) {
-            break;
-        }
-    }
-
-    return i;
+    return ECS_OFFSET(map->slots, slot * map->slot_size);
 }
 
 static
-void *get_node_data(
-    ecs_map_node_t *node)
+void *get_slot_data(
+    uint64_t *slot)
 {
-    return ECS_OFFSET(node, sizeof(ecs_map_node_t));
+    return ECS_OFFSET(slot, sizeof(uint64_t));
 }
 
+/** Compute number of slots required to store count elements */
 static
-void set_node_data(
-    ecs_map_t *map,
-    ecs_map_node_t *node,
-    const void *data)
+uint32_t slots_for_count(
+    uint32_t count)
 {
-    if (!data) {
-        return;
-    }
-    
-    void *node_data = get_node_data(node);
-    if (data != node_data) { 
-        if (data) {
-            memcpy(node_data, data, data_size(map));
-        } else {
-            memset(node_data, 0, data_size(map));
-        }
+    uint64_t min_slots =
+        ((uint64_t)count * ECS_MAP_LOAD_DEN + ECS_MAP_LOAD_NUM - 1) /
+            ECS_MAP_LOAD_NUM;
+
+    uint32_t result = ECS_MAP_GROUP_SIZE;
+    while (result < min_slots) {
+        result *= 2;
     }
+
+    return result;
 }
 
-/** Add new node to bucket */
+/** Allocate control bytes and slots */
 static
-void* add_node(
+void alloc_buffer(
     ecs_map_t *map,
-    uint32_t *bucket,
-    uint64_t key,
-    const void *data,
-    ecs_map_node_t *elem_p)
+    uint32_t bucket_count)
 {
-    uint32_t elem;
+    if (bucket_count) {
+        map->ctrl = ecs_slab_alloc(
+            map->slab, bucket_count * (1 + map->slot_size));
+        memset(map->ctrl, ECS_MAP_EMPTY, bucket_count);
 
-    if (!elem_p) {
-        elem_p = ecs_vector_add(&map->nodes, &map->node_params);
-        elem = ecs_vector_count(map->nodes);
+        /* Bucket count is a multiple of the group size, so slots are aligned */
+        map->slots = ECS_OFFSET(map->ctrl, bucket_count);
     } else {
-        elem = ecs_vector_get_index(
-            map->nodes,
-            &map->node_params,
-            elem_p) + 1;
+        map->ctrl = NULL;
+        map->slots = NULL;
     }
 
-    elem_p->key = key;
-    elem_p->next = 0;
-    elem_p->prev = 0;
-    set_node_data(map, elem_p, data);
+    map->bucket_count = bucket_count;
+    map->count = 0;
+    map->deleted = 0;
+}
 
-    uint32_t first = *bucket;
-    if (first) {
-        ecs_map_node_t *first_p = node_from_index(map, map->nodes, first);
-        first_p->prev = elem;
-        elem_p->next = first;
-    }
+/** Find slot for key, returns -1 if key is not in map */
+static
+int32_t find_slot(
+    ecs_map_t *map,
+    uint64_t key,
+    uint64_t hash)
+{
+    uint32_t group_mask = map->bucket_count / ECS_MAP_GROUP_SIZE - 1;
+    uint32_t group = (hash >> 7) & group_mask;
+    int8_t h2 = hash & ECS_MAP_H2_MASK;
+    uint32_t probe;
+
+    /* Triangular probing visits every group when group count is a power of 2 */
+    for (probe = 0; probe <= group_mask; probe ++) {
+        uint32_t first = group * ECS_MAP_GROUP_SIZE;
+        int8_t *ctrl = &map->ctrl[first];
+        uint32_t match = group_match(ctrl, h2);
+
+        while (match) {
+            uint32_t slot = first + first_bit(match);
+            if (*get_slot(map, slot) == key) {
+                return slot;
+            }
+            match &= match - 1;
+        }
 
-    *bucket = elem;
+        /* If a group has an empty slot, the key was never moved past it */
+        if (group_match(ctrl, ECS_MAP_EMPTY)) {
+            return -1;
+        }
 
-    map->count ++;
+        group = (group + probe + 1) & group_mask;
+    }
 
-    return elem_p;
+    return -1;
 }
 
-/** Get map node for a given key */
+/** Find first empty or deleted slot in probe sequence of hash */
 static
-ecs_map_node_t *get_node(
+uint32_t find_free_slot(
     ecs_map_t *map,
-    uint32_t *bucket,
-    uint64_t key)
+    uint64_t hash)
 {
-    uint32_t node = *bucket;
-
-    while (node) {
-        ecs_map_node_t *node_p = node_from_index(map, map->nodes, node);
-
-        if (node_p->prev) {
-            assert(node_from_index(map, map->nodes, node_p->prev)->next == node);
-        }
-        if (node_p->next) {
-            assert(node_from_index(map, map->nodes, node_p->next)->prev == node);
+    uint32_t group_mask = map->bucket_count / ECS_MAP_GROUP_SIZE - 1;
+    uint32_t group = (hash >> 7) & group_mask;
+    uint32_t probe;
+
+    for (probe = 0; probe <= group_mask; probe ++) {
+        uint32_t first = group * ECS_MAP_GROUP_SIZE;
+        uint32_t match = group_match_free(&map->ctrl[first]);
+        if (match) {
+            return first + first_bit(match);
         }
 
-        if (node_p->key == key) {
-            return node_p;
-        }
-        node = node_p->next;
+        group = (group + probe + 1) & group_mask;
     }
 
-    return NULL;
+    /* Load factor guarantees that there is always a free slot */
+    ecs_abort(ECS_INTERNAL_ERROR, NULL);
+    return 0;
 }
 
-/** Resize number of buckets in a map */
+/** Rehash map into a new set of slots */
 static
 void resize_map(
     ecs_map_t *map,
     uint32_t bucket_count)
 {
-    uint32_t *old_buckets = map->buckets;
+    int8_t *old_ctrl = map->ctrl;
     uint32_t old_bucket_count = map->bucket_count;
+    void *old_slots = map->slots;
+    uint32_t slot_size = map->slot_size;
 
     alloc_buffer(map, bucket_count);
-    map->count = 0;
 
-    uint32_t bucket_index;
-    for (bucket_index = 0; bucket_index < old_bucket_count; bucket_index ++) {
-        uint32_t bucket = old_buckets[bucket_index];
-        if (bucket) {
-            uint32_t node = bucket;
-            uint32_t next;
-            uint64_t key;
-
-            ecs_map_node_t *node_p;
-            do {
-                node_p = node_from_index(map, map->nodes, node);
-                next = node_p->next;
-                key = node_p->key;
-                uint32_t *new_bucket = get_bucket(map, key);
-                add_node(map, new_bucket, key, get_node_data(node_p), node_p);
-            } while ((node = next));
+    uint32_t i;
+    for (i = 0; i < old_bucket_count; i ++) {
+        if (old_ctrl[i] >= 0) {
+            uint64_t *old_slot = ECS_OFFSET(old_slots, i * slot_size);
+            uint64_t hash = hash_key(*old_slot);
+            uint32_t slot = find_free_slot(map, hash);
+            map->ctrl[slot] = hash & ECS_MAP_H2_MASK;
+            memcpy(get_slot(map, slot), old_slot, slot_size);
+            map->count ++;
         }
     }
 
-    ecs_os_free(old_buckets);
+    ecs_slab_release(map->slab, old_ctrl);
 }
 
 
@@ -266,40 +278,63 @@ ecs_map_t* ecs_map_new(
     uint32_t size,
     uint32_t data_size)
 {
+    return ecs_map_new_w_slab(size, data_size, NULL);
+}
+
+ecs_map_t* ecs_map_new_w_slab(
+    uint32_t size,
+    uint32_t data_size,
+    ecs_slab_t *slab)
+{
+    ecs_map_t *result = ecs_slab_alloc(slab, sizeof(ecs_map_t));
+    result->slab = slab;
+
     if (!data_size) {
         data_size = sizeof(uint64_t);
     }
-    return alloc_map((float)size / FLECS_LOAD_FACTOR, data_size);
+
+    result->data_size = data_size;
+    result->slot_size = sizeof(uint64_t) +
+        ((data_size + sizeof(uint64_t) - 1) & ~(sizeof(uint64_t) - 1));
+    result->min = size ? slots_for_count(size) : 0;
+
+    alloc_buffer(result, result->min);
+
+    return result;
 }
 
 void ecs_map_clear(
     ecs_map_t *map)
 {
-    uint32_t target_size = (float)map->count / FLECS_LOAD_FACTOR;
+    if (!map->bucket_count) {
+        return;
+    }
 
+    /* Keep enough slots for the elements that were in the map, as maps that
+     * are cleared are typically filled again. If the map would fit in fewer
+     * slots, shrink it so that a spike in elements does not leave it
+     * oversized. */
+    uint32_t target_size = slots_for_count(map->count);
     if (target_size < map->min) {
         target_size = map->min;
     }
 
-    if (target_size < (float)map->bucket_count * 0.75) {
-        ecs_os_free(map->buckets);
+    if (target_size < map->bucket_count) {
+        ecs_slab_release(map->slab, map->ctrl);
         alloc_buffer(map, target_size);
     } else {
-        memset(map->buckets, 0, sizeof(int32_t) * map->bucket_count);
+        memset(map->ctrl, ECS_MAP_EMPTY, map->bucket_count);
+        map->count = 0;
+        map->deleted = 0;
     }
-
-    ecs_vector_reclaim(&map->nodes, &map->node_params);
-    ecs_vector_clear(map->nodes);
-
-    map->count = 0;
 }
 
 void ecs_map_free(
     ecs_map_t *map)
 {
-    ecs_vector_free(map->nodes);
-    ecs_os_free(map->buckets);
-    ecs_os_free(map);
+    ecs_slab_t *slab = map->slab;
+    ecs_slab_release(slab, map->ctrl);
+    ecs_slab_release(slab, map);
 }
 
 void* _ecs_map_set(
@@ -309,35 +344,56 @@ void* _ecs_map_set(
     uint32_t size)
 {
     (void)size;
-    ecs_assert(ecs_map_data_size(map) == size, ECS_INVALID_PARAMETER, NULL);
+    ecs_assert(map->data_size == size, ECS_INVALID_PARAMETER, NULL);
 
-    uint32_t bucket_count = map->bucket_count;
-    if (!bucket_count) {
-        alloc_buffer(map, 2);
-        bucket_count = map->bucket_count;
-    }
+    uint64_t hash = hash_key(key);
+    int32_t slot = -1;
 
-    if (((float)map->count + 1) / (float)bucket_count > FLECS_LOAD_FACTOR) {
-        resize_map(map, bucket_count * 2);
+    if (map->count) {
+        slot = find_slot(map, key, hash);
     }
 
-    uint32_t *bucket = get_bucket(map, key);
-    ecs_map_node_t *node = NULL;
+    if (slot == -1) {
+        uint32_t bucket_count = map->bucket_count;
+        uint32_t load = map->count + map->deleted + 1;
 
-    if (!*bucket) {
-        node = add_node(map, bucket, key, data, NULL);
-    } else {
-        node = get_node(map, bucket, key);
-        if (node) {
-            set_node_data(map, node, data);
-        } else {
-            node = add_node(map, bucket, key, data, NULL);
+        if (load * ECS_MAP_LOAD_DEN > bucket_count * ECS_MAP_LOAD_NUM) {
+            /* Only grow if live elements take up more than 3/4 of the maximum
+             * load, otherwise rehashing just cleans up deleted slots */
+            if (!bucket_count) {
+                bucket_count = ECS_MAP_GROUP_SIZE;
+            } else if ((uint64_t)(map->count + 1) * 4 * ECS_MAP_LOAD_DEN >
+                (uint64_t)bucket_count * 3 * ECS_MAP_LOAD_NUM)
+            {
+                bucket_count *= 2;
+            }
+
+            resize_map(map, bucket_count);
+        }
+
+        slot = find_free_slot(map, hash);
+        if (map->ctrl[slot] == ECS_MAP_DELETED) {
+            map->deleted --;
+        }
+
+        map->ctrl[slot] = hash & ECS_MAP_H2_MASK;
+        map->count ++;
+
+        uint64_t *slot_ptr = get_slot(map, slot);
+        *slot_ptr = key;
+
+        if (!data) {
+            memset(get_slot_data(slot_ptr), 0, map->data_size);
         }
     }
 
-    ecs_assert(node != NULL, ECS_INTERNAL_ERROR, NULL);
+    void *result = get_slot_data(get_slot(map, slot));
+
+    if (data && data != result) {
+        memcpy(result, data, map->data_size);
+    }
 
-    return get_node_data(node);
+    return result;
 }
 
 int ecs_map_remove(
@@ -348,37 +404,25 @@ int ecs_map_remove(
         return -1;
     }
 
-    uint32_t *bucket = get_bucket(map, key);
-
-    if (*bucket) {
-        ecs_map_node_t *node = get_node(map, bucket, key);
-        if (node) {
-            ecs_map_node_t *prev_node = node_from_index(map, map->nodes, node->prev);
-            ecs_map_node_t *next_node = node_from_index(map, map->nodes, node->next);
-
-            if (prev_node) {
-                assert(node_from_index(map, map->nodes, prev_node->next) == node);
-                prev_node->next = node->next;
-            } else {
-                *bucket = node->next;
-            }
-
-            if (next_node) {
-                assert(node_from_index(map, map->nodes, next_node->prev) == node);
-                next_node->prev = node->prev;
-            }
-
-            ecs_vector_params_t params = map->node_params;
-            params.move_ctx = map;
-
-            ecs_vector_remove(map->nodes, &params, node);
-            map->count --;
+    int32_t slot = find_slot(map, key, hash_key(key));
+    if (slot == -1) {
+        return -1;
+    }
 
-            return 0;
-        }
+    /* If the group still has an empty slot, no probe sequence continued past
+     * this group and the slot can be marked empty. Otherwise keep a tombstone
+     * so that lookups for keys in subsequent groups don't terminate early. */
+    int8_t *group = &map->ctrl[slot & ~(ECS_MAP_GROUP_SIZE - 1)];
+    if (group_match(group, ECS_MAP_EMPTY)) {
+        map->ctrl[slot] = ECS_MAP_EMPTY;
+    } else {
+        map->ctrl[slot] = ECS_MAP_DELETED;
+        map->deleted ++;
     }
 
-    return -1;
+    map->count --;
+
+    return 0;
 }
 
 void* ecs_map_get_ptr(
@@ -386,18 +430,15 @@ void* ecs_map_get_ptr(
     uint64_t key)
 {
     if (!map->count) {
-        return 0;
+        return NULL;
     }
 
-    uint32_t *bucket = get_bucket(map, key);
-    if (*bucket) {
-        ecs_map_node_t *elem = get_node(map, bucket, key);
-        if (elem) {
-            return get_node_data(elem);
-        }
+    int32_t slot = find_slot(map, key, hash_key(key));
+    if (slot != -1) {
+        return get_slot_data(get_slot(map, slot));
     }
 
-    return 0;
+    return NULL;
 }
 
 bool _ecs_map_has(
@@ -411,22 +452,20 @@ bool _ecs_map_has(
     if (!map) {
         return false;
     }
-    
+
     if (!map->count) {
         return false;
     }
 
-    ecs_assert(!value_out || (ecs_map_data_size(map) == size), ECS_INVALID_PARAMETER, NULL); 
+    ecs_assert(!value_out || (map->data_size == size), ECS_INVALID_PARAMETER, NULL);
 
-    uint32_t *bucket = get_bucket(map, key_hash);
-    if (*bucket) {
-        ecs_map_node_t *elem = get_node(map, bucket, key_hash);
-        if (elem) {
-            if (value_out) {
-                memcpy(value_out, get_node_data(elem), data_size(map));
-            }
-            return true;
+    int32_t slot = find_slot(map, key_hash, hash_key(key_hash));
+    if (slot != -1) {
+        if (value_out) {
+            memcpy(value_out, get_slot_data(get_slot(map, slot)),
+                map->data_size);
         }
+        return true;
     }
 
     return false;
@@ -448,16 +487,21 @@ uint32_t ecs_map_set_size(
     ecs_map_t *map,
     uint32_t size)
 {
-    uint32_t result = ecs_vector_set_size(&map->nodes, &map->node_params, size);
-    resize_map(map, size / FLECS_LOAD_FACTOR);
-    return result;
+    uint32_t bucket_count = slots_for_count(size);
+    if (bucket_count > map->bucket_count) {
+        resize_map(map, bucket_count);
+    }
+
+    return map->bucket_count * ECS_MAP_LOAD_NUM / ECS_MAP_LOAD_DEN;
 }
 
 uint32_t ecs_map_grow(
     ecs_map_t *map,
     uint32_t size)
 {
-    if (size > ecs_vector_size(map->nodes)) {
+    if ((uint64_t)size * ECS_MAP_LOAD_DEN >
+        (uint64_t)map->bucket_count * ECS_MAP_LOAD_NUM)
+    {
         return ecs_map_set_size(map, size);
     }
 
@@ -474,14 +518,11 @@ void ecs_map_memory(
     }
 
     if (total) {
-
-        *total += map->bucket_count * sizeof(uint32_t) + sizeof(ecs_map_t);
-        ecs_vector_memory(map->nodes, &map->node_params, total, NULL);
+        *total += map->bucket_count * (1 + map->slot_size) + sizeof(ecs_map_t);
     }
 
     if (used) {
-        *used += map->count * sizeof(uint32_t);
-        ecs_vector_memory(map->nodes, &map->node_params, NULL, used);
+        *used += map->count * (1 + map->slot_size);
     }
 }
 
@@ -490,8 +531,7 @@ ecs_map_iter_t ecs_map_iter(
 {
     ecs_map_iter_t result = {
         .map = map,
-        .bucket_index = -1,
-        .node = 0
+        .index = 0
     };
 
     return result;
@@ -505,34 +545,14 @@ bool ecs_map_hasnext(
         return false;
     }
 
-    if (!map->buckets) {
-        return false;
-    }
-
-    uint32_t bucket_index = iter_data->bucket_index;
-    uint32_t node = iter_data->node;
-
-    if (node) {
-        ecs_map_node_t *node_p = node_from_index(map, map->nodes, node);
-        node = node_p->next;
+    uint32_t i = iter_data->index;
+    while (i < map->bucket_count && map->ctrl[i] < 0) {
+        i ++;
     }
 
-    if (!node) {
-        bucket_index = next_bucket(map, bucket_index + 1);
-        if (bucket_index < map->bucket_count) {
-            node = map->buckets[bucket_index];
-        } else {
-            node = 0;
-        }
-    }
+    iter_data->index = i;
 
-    if (node) {
-        iter_data->node = node;
-        iter_data->bucket_index = bucket_index;
-        return true;
-    } else {
-        return false;
-    }
+    return i < map->bucket_count;
 }
 
 void* ecs_map_next_w_key_w_size(
@@ -543,12 +563,15 @@ void* ecs_map_next_w_key_w_size(
     (void)size;
 
     ecs_map_t *map = iter_data->map;
-    ecs_assert(!size || data_size(map) == size, ECS_INTERNAL_ERROR, NULL);
+    ecs_assert(!size || map->data_size == size, ECS_INTERNAL_ERROR, NULL);
+
+    bool has_next = ecs_map_hasnext(iter_data);
+    ecs_assert(has_next, ECS_INVALID_PARAMETER, NULL);
+    (void)has_next;
 
-    ecs_map_node_t *node_p = node_from_index(map, map->nodes, iter_data->node);
-    assert(node_p != NULL);
-    if (key_out) *key_out = node_p->key;
-    return get_node_data(node_p);
+    uint64_t *slot = get_slot(map, iter_data->index ++);
+    if (key_out) *key_out = *slot;
+    return get_slot_data(slot);
 }
 
 void* ecs_map_next_w_key(
@@ -574,5 +597,5 @@ void* ecs_map_next_w_size(
 uint32_t ecs_map_data_size(
     ecs_map_t *map)
 {
-    return data_size(map);
+    return map->data_size;
 }
@@ -0,0 +1,205 @@
+#include "flecs_private.h"
+
+static ecs_vector_params_t query_params = {
+    .element_size = sizeof(ecs_query_t*)
+};
+
+/* -- Private API -- */
+
+void ecs_notify_queries_of_table(
+    ecs_world_t *world,
+    ecs_table_t *table)
+{
+    ecs_query_t **queries = ecs_vector_first(world->queries);
+    uint32_t i, count = ecs_vector_count(world->queries);
+
+    for (i = 0; i < count; i ++) {
+        ecs_col_system_match_table(world, 0, &queries[i]->system, table);
+    }
+}
+
+void ecs_queries_remove_table(
+    ecs_world_t *world,
+    ecs_table_t *table)
+{
+    ecs_query_t **queries = ecs_vector_first(world->queries);
+    uint32_t i, count = ecs_vector_count(world->queries);
+
+    for (i = 0; i < count; i ++) {
+        ecs_col_system_unmatch_table(world, &queries[i]->system, table);
+    }
+}
+
+void ecs_rematch_queries(
+    ecs_world_t *world,
+    const ecs_rematch_t *rematch)
+{
+    ecs_query_t **queries = ecs_vector_first(world->queries);
+    uint32_t i, count = ecs_vector_count(world->queries);
+
+    for (i = 0; i < count; i ++) {
+        ecs_col_system_rematch(world, 0, &queries[i]->system, rematch);
+    }
+}
+
+void ecs_revalidate_query_refs(
+    ecs_world_t *world)
+{
+    ecs_query_t **queries = ecs_vector_first(world->queries);
+    uint32_t i, count = ecs_vector_count(world->queries);
+
+    for (i = 0; i < count; i ++) {
+        ecs_col_system_revalidate_refs(world, &queries[i]->system);
+    }
+}
+
+void ecs_queries_fini(
+    ecs_world_t *world)
+{
+    ecs_query_t **queries = ecs_vector_first(world->queries);
+    uint32_t i, count = ecs_vector_count(world->queries);
+
+    for (i = 0; i < count; i ++) {
+        ecs_col_system_deinit(world, &queries[i]->system);
+        ecs_os_free(queries[i]);
+    }
+
+    ecs_vector_free(world->queries);
+    world->queries = NULL;
+}
+
+/* -- Public API -- */
+
+ecs_query_t* ecs_query_new(
+    ecs_world_t *world,
+    const char *sig)
+{
+    ecs_assert(world != NULL, ECS_INVALID_PARAMETER, NULL);
+    ecs_assert(world->magic == ECS_WORLD_MAGIC, ECS_INVALID_FROM_WORKER, NULL);
+    ecs_assert(sig != NULL, ECS_INVALID_PARAMETER, NULL);
+
+    ecs_query_t *result = ecs_os_calloc(1, sizeof(ecs_query_t));
+    ecs_assert(result != NULL, ECS_OUT_OF_MEMORY, NULL);
+
+    result->world = world;
+    ecs_col_system_init(world, 0, &result->system, sig);
+
+    ecs_query_t **elem = ecs_vector_add(&world->queries, &query_params);
+    *elem = result;
+
+    return result;
+}
+
+void ecs_query_free(
+    ecs_query_t *query)
+{
+    ecs_world_t *world = query->world;
+    ecs_query_t **queries = ecs_vector_first(world->queries);
+    uint32_t i, count = ecs_vector_count(world->queries);
+
+    for (i = 0; i < count; i ++) {
+        if (queries[i] == query) {
+            ecs_vector_remove_index(world->queries, &query_params, i);
+            break;
+        }
+    }
+
+    ecs_col_system_deinit(world, &query->system);
+    ecs_os_free(query);
+}
+
+ecs_query_iter_t ecs_query_iter(
+    ecs_query_t *query)
+{
+    ecs_assert(query != NULL, ECS_INVALID_PARAMETER, NULL);
+
+    ecs_world_t *world = query->world;
+
+    return (ecs_query_iter_t){
+        .query = query,
+        .rows = {
+            .world = world,
+            .column_count = ecs_vector_count(query->system.base.columns),
+            .world_time = world->world_time
+        }
+    };
+}
+
+bool ecs_query_next(
+    ecs_query_iter_t *it)
+{
+    EcsColSystem *system_data = &it->query->system;
+    ecs_matched_table_t *tables = ecs_vector_first(system_data->tables);
+    uint32_t table_count = ecs_vector_count(system_data->tables);
+    ecs_rows_t *rows = &it->rows;
+
+    /* Each column can match at most one bitset, in addition to the bitset of
+     * disabled entities */
+    ecs_table_bitset_t **bitsets = ecs_os_alloca(
+        ecs_table_bitset_t*, rows->column_count + 1);
+
+    /* Frame offset counts the rows of previous iterations */
+    rows->frame_offset += rows->count;
+
+    while (true) {
+        /* Load the next table if all rows of the current table are visited */
+        if (it->row == it->count) {
+            if (it->index == table_count) {
+                return false;
+            }
+
+            ecs_matched_table_t *table = &tables[it->index ++];
+            ecs_table_t *world_table = table->table;
+
+            rows->table = world_table;
+            rows->columns = table->columns;
+            rows->components = table->components;
+            rows->references = ecs_vector_first(table->references);
+
+            /* Query has no columns that match tables */
+            if (!world_table) {
+                rows->table_columns = NULL;
+                rows->entities = NULL;
+                rows->offset = 0;
+                rows->count = 0;
+                return true;
+            }
+
+            rows->table_columns = world_table->columns;
+            it->row = 0;
+            it->count = ecs_table_count(world_table);
+            continue;
+        }
+
+        ecs_table_t *world_table = rows->table;
+        ecs_table_column_t *table_data = rows->table_columns;
+        uint32_t row = it->row;
+        uint32_t end = row + ecs_table_contiguous(
+            world_table, table_data, row, it->count - row);
+        uint32_t count = end - row;
+
+        if (world_table->bitsets) {
+            uint32_t bitset_count = ecs_col_system_get_bitsets(
+                system_data, &tables[it->index - 1], bitsets);
+
+            if (bitset_count) {
+                count = ecs_table_enabled_range(
+                    bitsets, bitset_count, &row, end);
+
+                /* No enabled rows left in this range */
+                if (!count) {
+                    it->row = end;
+                    continue;
+                }
+            }
+        }
+
+        ecs_entity_t *entities = ecs_vector_first(table_data[0].data);
+        rows->entities = &entities[row];
+        rows->offset = row;
+        rows->count = count;
+        it->row = row + count;
+
+        return true;
+    }
+}
@@ -0,0 +1,476 @@
+#include "types.h"
+
+/* Each allocation is preceded by a 16 byte header, so that memory returned by
+ * the slab keeps the alignment guaranteed by malloc on common platforms. */
+#define ECS_SLAB_HDR_SIZE (16)
+
+/* 8 classes up to 128 bytes, then 4 classes per power of two up to 8MB */
+#define ECS_SLAB_CLASS_COUNT (72)
+
+/* Classes up to this size are carved from blocks */
+#define ECS_SLAB_MAX_CARVED (ECS_SLAB_BLOCK_SIZE / 8)
+
+/* Size class of allocations that were made directly from the OS heap */
+#define ECS_SLAB_HEAP_CLASS (UINT32_MAX)
+
+/* Size class of allocations from a bump slab */
+#define ECS_SLAB_BUMP_CLASS (UINT32_MAX - 1)
+
+typedef struct ecs_slab_hdr_t {
+    union {
+        ecs_slab_t *slab;             /* Owner of allocation, while in use */
+        struct ecs_slab_hdr_t *next;  /* Next element, while in free list */
+    } is;
+    uint32_t size_class;
+    uint32_t size;                    /* Size of heap or bump allocation */
+} ecs_slab_hdr_t;
+
+struct ecs_slab_t {
+    ecs_slab_hdr_t *free_list[ECS_SLAB_CLASS_COUNT];
+    ecs_vector_t *blocks;       /* Blocks from which small classes are carved */
+    ecs_slab_t *arena;          /* Slab for allocations larger than max_size */
+    uint32_t max_size;          /* Largest allocation (with header) in slab */
+    ecs_slab_stats_t stats;
+
+    /* Bump allocation (see ecs_slab_new_bump) */
+    char *bump_ptr;             /* Next free byte in current block */
+    char *bump_end;             /* End of current block */
+    uint32_t block_size;        /* Size of first block */
+    bool is_bump;
+};
+
+static
+ecs_vector_params_t block_arr_params = {.element_size = sizeof(void*)};
+
+#define HDR(ptr) ((ecs_slab_hdr_t*)((char*)(ptr) - ECS_SLAB_HDR_SIZE))
+#define PAYLOAD(hdr) ECS_OFFSET(hdr, ECS_SLAB_HDR_SIZE)
+
+/** Return index of highest bit that is set in value */
+static
+uint32_t highest_bit(
+    uint32_t value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return 31 - __builtin_clz(value);
+#else
+    uint32_t result = 0;
+    while (value >>= 1) {
+        result ++;
+    }
+    return result;
+#endif
+}
+
+static
+uint32_t size_class(
+    uint32_t size)
+{
+    if (size <= 128) {
+        return (size - 1) >> 4;
+    }
+
+    uint32_t shift = highest_bit(size - 1);
+    return 8 + (shift - 7) * 4 + (((size - 1) >> (shift - 2)) & 3);
+}
+
+static
+uint32_t class_size(
+    uint32_t size_class)
+{
+    if (size_class < 8) {
+        return (size_class + 1) * 16;
+    }
+
+    uint32_t base = 128 << ((size_class - 8) >> 2);
+    return base + ((size_class & 3) + 1) * (base >> 2);
+}
+
+/** Add elements to the free list of a class. Small classes are carved from a
+ * new block, larger classes are allocated one element at a time. */
+static
+ecs_slab_hdr_t* refill(
+    ecs_slab_t *slab,
+    uint32_t size_class)
+{
+    uint32_t size = class_size(size_class);
+    slab->stats.os_alloc_count ++;
+
+    if (size > ECS_SLAB_MAX_CARVED) {
+        ecs_slab_hdr_t *result = ecs_os_malloc(size);
+        ecs_assert(result != NULL, ECS_OUT_OF_MEMORY, NULL);
+        result->is.next = NULL;
+        slab->stats.allocd += size;
+        return result;
+    }
+
+    char *block = ecs_os_malloc(ECS_SLAB_BLOCK_SIZE);
+    ecs_assert(block != NULL, ECS_OUT_OF_MEMORY, NULL);
+    void **elem = ecs_vector_add(&slab->blocks, &block_arr_params);
+    *elem = block;
+    slab->stats.allocd += ECS_SLAB_BLOCK_SIZE;
+
+    uint32_t i, count = ECS_SLAB_BLOCK_SIZE / size;
+    ecs_slab_hdr_t *next = NULL;
+    for (i = count; i > 0; i --) {
+        ecs_slab_hdr_t *hdr = (ecs_slab_hdr_t*)(block + (i - 1) * size);
+        hdr->is.next = next;
+        next = hdr;
+    }
+
+    return next;
+}
+
+static
+uint32_t payload_size(
+    ecs_slab_hdr_t *hdr)
+{
+    if (hdr->size_class >= ECS_SLAB_BUMP_CLASS) {
+        return hdr->size - ECS_SLAB_HDR_SIZE;
+    } else {
+        return class_size(hdr->size_class) - ECS_SLAB_HDR_SIZE;
+    }
+}
+
+/** Add a block to a bump slab that can store at least size bytes */
+static
+void bump_add_block(
+    ecs_slab_t *slab,
+    uint32_t size)
+{
+    if (size < slab->block_size) {
+        size = slab->block_size;
+    }
+
+    char *block = ecs_os_malloc(size);
+    ecs_assert(block != NULL, ECS_OUT_OF_MEMORY, NULL);
+    void **elem = ecs_vector_add(&slab->blocks, &block_arr_params);
+    *elem = block;
+
+    slab->bump_ptr = block;
+    slab->bump_end = block + size;
+    slab->stats.allocd += size;
+    slab->stats.os_alloc_count ++;
+}
+
+static
+void* bump_alloc(
+    ecs_slab_t *slab,
+    uint32_t size)
+{
+    /* Round up, so that the next allocation is aligned as well */
+    uint32_t total = (size + ECS_SLAB_HDR_SIZE + 15) & ~15u;
+
+    if ((uint32_t)(slab->bump_end - slab->bump_ptr) < total) {
+        bump_add_block(slab, total);
+    }
+
+    ecs_slab_hdr_t *hdr = (ecs_slab_hdr_t*)slab->bump_ptr;
+    slab->bump_ptr += total;
+
+    hdr->is.slab = slab;
+    hdr->size_class = ECS_SLAB_BUMP_CLASS;
+    hdr->size = total;
+    slab->stats.used += total;
+    slab->stats.alloc_count ++;
+
+    return PAYLOAD(hdr);
+}
+
+static
+void* bump_realloc(
+    ecs_slab_t *slab,
+    ecs_slab_hdr_t *hdr,
+    uint32_t size)
+{
+    uint32_t total = (size + ECS_SLAB_HDR_SIZE + 15) & ~15u;
+    char *start = (char*)hdr;
+
+    /* The last allocation can be resized in place */
+    if (start + hdr->size == slab->bump_ptr && 
+        (uint32_t)(slab->bump_end - start) >= total) 
+    {
+        slab->stats.used += total - hdr->size;
+        slab->bump_ptr = start + total;
+        hdr->size = total;
+        return PAYLOAD(hdr);
+    }
+
+    void *result = bump_alloc(slab, size);
+    uint32_t old_size = payload_size(hdr);
+    memcpy(result, PAYLOAD(hdr), old_size < size ? old_size : size);
+    return result;
+}
+
+
+/* -- Public functions -- */
+
+ecs_slab_t* ecs_slab_new(
+    uint32_t max_size)
+{
+    ecs_assert(sizeof(ecs_slab_hdr_t) <= ECS_SLAB_HDR_SIZE,
+        ECS_INTERNAL_ERROR, NULL);
+
+    ecs_slab_t *result = ecs_os_calloc(1, sizeof(ecs_slab_t));
+    ecs_assert(result != NULL, ECS_OUT_OF_MEMORY, NULL);
+
+    uint32_t largest = class_size(ECS_SLAB_CLASS_COUNT - 1);
+    if (max_size > largest) {
+        max_size = largest;
+    }
+
+    result->max_size = max_size;
+
+    return result;
+}
+
+ecs_slab_t* ecs_slab_new_bump(
+    uint32_t block_size)
+{
+    ecs_slab_t *result = ecs_slab_new(0);
+    result->block_size = (block_size + 15) & ~15u;
+    result->is_bump = true;
+    return result;
+}
+
+void ecs_slab_reset(
+    ecs_slab_t *slab)
+{
+    ecs_assert(slab->is_bump, ECS_INVALID_PARAMETER, NULL);
+
+    uint32_t i, count = ecs_vector_count(slab->blocks);
+    void **blocks = ecs_vector_first(slab->blocks);
+
+    /* If the data did not fit in one block, replace the blocks with a single
+     * block that is large enough, so that a frame that allocates the same
+     * amount of memory does not have to allocate blocks again. */
+    if (count > 1) {
+        uint32_t size = slab->block_size;
+        while (size < slab->stats.allocd) {
+            size *= 2;
+        }
+
+        for (i = 0; i < count; i ++) {
+            ecs_os_free(blocks[i]);
+        }
+
+        ecs_vector_clear(slab->blocks);
+        slab->stats.allocd = 0;
+        slab->block_size = size;
+        bump_add_block(slab, size);
+    } else if (count) {
+        slab->bump_ptr = blocks[0];
+    }
+
+    slab->stats.used = 0;
+}
+
+void ecs_slab_free(
+    ecs_slab_t *slab)
+{
+    uint32_t i, count = ecs_vector_count(slab->blocks);
+    void **blocks = ecs_vector_first(slab->blocks);
+    for (i = 0; i < count; i ++) {
+        ecs_os_free(blocks[i]);
+    }
+
+    /* Classes that are not carved from blocks are allocated per element */
+    for (i = 0; i < ECS_SLAB_CLASS_COUNT; i ++) {
+        if (class_size(i) <= ECS_SLAB_MAX_CARVED) {
+            continue;
+        }
+
+        ecs_slab_hdr_t *hdr = slab->free_list[i];
+        while (hdr) {
+            ecs_slab_hdr_t *next = hdr->is.next;
+            ecs_os_free(hdr);
+            hdr = next;
+        }
+    }
+
+    ecs_vector_free(slab->blocks);
+    ecs_os_free(slab);
+}
+
+void ecs_slab_set_arena(
+    ecs_slab_t *slab,
+    ecs_slab_t *arena)
+{
+    ecs_assert(slab != arena, ECS_INVALID_PARAMETER, NULL);
+    slab->arena = arena;
+}
+
+void* ecs_slab_alloc(
+    ecs_slab_t *slab,
+    uint32_t size)
+{
+    if (!slab) {
+        void *result = ecs_os_malloc(size);
+        ecs_assert(result != NULL, ECS_OUT_OF_MEMORY, NULL);
+        return result;
+    }
+
+    if (slab->is_bump) {
+        return bump_alloc(slab, size);
+    }
+
+    uint32_t total = size + ECS_SLAB_HDR_SIZE;
+    ecs_slab_hdr_t *hdr;
+
+    if (total > slab->max_size) {
+        if (slab->arena) {
+            return ecs_slab_alloc(slab->arena, size);
+        }
+
+        hdr = ecs_os_malloc(total);
+        ecs_assert(hdr != NULL, ECS_OUT_OF_MEMORY, NULL);
+        hdr->size_class = ECS_SLAB_HEAP_CLASS;
+        hdr->size = total;
+        slab->stats.allocd += total;
+        slab->stats.used += total;
+        slab->stats.os_alloc_count ++;
+    } else {
+        uint32_t c = size_class(total);
+        hdr = slab->free_list[c];
+        if (!hdr) {
+            hdr = refill(slab, c);
+        }
+
+        slab->free_list[c] = hdr->is.next;
+        hdr->size_class = c;
+        hdr->size = 0;
+        slab->stats.used += class_size(c);
+    }
+
+    hdr->is.slab = slab;
+    slab->stats.alloc_count ++;
+
+    return PAYLOAD(hdr);
+}
+
+void* ecs_slab_calloc(
+    ecs_slab_t *slab,
+    uint32_t size)
+{
+    void *result = ecs_slab_alloc(slab, size);
+    memset(result, 0, size);
+    return result;
+}
+
+void* ecs_slab_realloc(
+    ecs_slab_t *slab,
+    void *ptr,
+    uint32_t size)
+{
+    if (!slab) {
+        void *result = ecs_os_realloc(ptr, size);
+        ecs_assert(result != NULL, ECS_OUT_OF_MEMORY, NULL);
+        return result;
+    }
+
+    if (!ptr) {
+        return ecs_slab_alloc(slab, size);
+    }
+
+    ecs_slab_hdr_t *hdr = HDR(ptr);
+    ecs_slab_t *owner = hdr->is.slab;
+    uint32_t total = size + ECS_SLAB_HDR_SIZE;
+
+    if (hdr->size_class == ECS_SLAB_BUMP_CLASS) {
+        return bump_realloc(owner, hdr, size);
+    }
+
+    /* Allocation stays in the same size class */
+    if (hdr->size_class != ECS_SLAB_HEAP_CLASS && total <= owner->max_size &&
+        size_class(total) == hdr->size_class)
+    {
+        return ptr;
+    }
+
+    /* Heap allocations that remain too large for the slab are reallocated in
+     * place, which lets the OS heap avoid the copy */
+    if (hdr->size_class == ECS_SLAB_HEAP_CLASS && total > owner->max_size &&
+        !owner->arena)
+    {
+        uint32_t old_total = hdr->size;
+        hdr = ecs_os_realloc(hdr, total);
+        ecs_assert(hdr != NULL, ECS_OUT_OF_MEMORY, NULL);
+        hdr->size = total;
+        owner->stats.allocd += total - old_total;
+        owner->stats.used += total - old_total;
+        return PAYLOAD(hdr);
+    }
+
+    void *result = ecs_slab_alloc(owner, size);
+    uint32_t old_size = payload_size(hdr);
+    memcpy(result, ptr, old_size < size ? old_size : size);
+    ecs_slab_release(owner, ptr);
+
+    return result;
+}
+
+void ecs_slab_release(
+    ecs_slab_t *slab,
+    void *ptr)
+{
+    if (!slab) {
+        ecs_os_free(ptr);
+        return;
+    }
+
+    if (!ptr) {
+        return;
+    }
+
+    ecs_slab_hdr_t *hdr = HDR(ptr);
+    ecs_slab_t *owner = hdr->is.slab;
+    uint32_t c = hdr->size_class;
+
+    if (c == ECS_SLAB_BUMP_CLASS) {
+        /* Memory of a bump slab is released when the slab is reset */
+        return;
+    } else if (c == ECS_SLAB_HEAP_CLASS) {
+        owner->stats.allocd -= hdr->size;
+        owner->stats.used -= hdr->size;
+        ecs_os_free(hdr);
+    } else {
+        owner->stats.used -= class_size(c);
+        hdr->is.next = owner->free_list[c];
+        owner->free_list[c] = hdr;
+    }
+}
+
+ecs_slab_t* ecs_slab_owner(
+    void *ptr)
+{
+    return HDR(ptr)->is.slab;
+}
+
+void ecs_slab_get_stats(
+    ecs_slab_t *slab,
+    ecs_slab_stats_t *stats)
+{
+    if (slab) {
+        *stats = slab->stats;
+    } else {
+        memset(stats, 0, sizeof(ecs_slab_stats_t));
+    }
+}
+
+void ecs_slab_memory(
+    ecs_slab_t *slab,
+    uint32_t *allocd,
+    uint32_t *used)
+{
+    if (!slab) {
+        return;
+    }
+
+    if (allocd) {
+        *allocd += slab->stats.allocd + sizeof(ecs_slab_t) +
+            ecs_vector_size(slab->blocks) * sizeof(void*);
+    }
+
+    if (used) {
+        *used += slab->stats.used;
+    }
+}
@@ -0,0 +1,405 @@
+
+#include "flecs_private.h"
+
+/* Number of key bits that select an element within a page */
+#define ECS_SPARSE_PAGE_BITS (12)
+#define ECS_SPARSE_PAGE_SIZE (1 << ECS_SPARSE_PAGE_BITS)
+#define ECS_SPARSE_PAGE_MASK (ECS_SPARSE_PAGE_SIZE - 1)
+
+/* Keys from this value onwards (like ECS_SINGLETON) are stored in a map, as
+ * paging them would require a huge page directory. Keys below this value are
+ * paged by their lower 32 bits, the remaining 16 bits are a generation. */
+#define ECS_SPARSE_MAX_PAGED_KEY ((uint64_t)1 << 48)
+#define ECS_SPARSE_INDEX(key) ((uint32_t)(key))
+
+/* Element header is padded so that element data stays 8 byte aligned */
+#define ECS_SPARSE_HEADER_SIZE (sizeof(uint64_t))
+
+typedef struct ecs_sparse_elem_t {
+    uint32_t dense;         /* Index in dense array + 1, 0 if element is unset */
+} ecs_sparse_elem_t;
+
+struct ecs_sparse_t {
+    void **pages;           /* Page directory, indexed by key >> PAGE_BITS */
+    uint32_t page_count;    /* Number of entries in page directory */
+    ecs_vector_t *dense;    /* Keys of elements that are set */
+    ecs_map_t *overflow;    /* Elements with keys outside of the paged range */
+    uint32_t elem_size;     /* Size of element data */
+    uint32_t stride;        /* Size of element data + header */
+};
+
+static ecs_vector_params_t key_params = {.element_size = sizeof(uint64_t)};
+
+static
+void* elem_data(
+    ecs_sparse_elem_t *elem)
+{
+    return ECS_OFFSET(elem, ECS_SPARSE_HEADER_SIZE);
+}
+
+/** Get element for key, returns NULL if the page does not exist */
+static
+ecs_sparse_elem_t* get_elem(
+    ecs_sparse_t *sparse,
+    uint64_t key)
+{
+    if (key < ECS_SPARSE_MAX_PAGED_KEY) {
+        uint32_t page_index = ECS_SPARSE_INDEX(key) >> ECS_SPARSE_PAGE_BITS;
+        if (page_index >= sparse->page_count) {
+            return NULL;
+        }
+
+        void *page = sparse->pages[page_index];
+        if (!page) {
+            return NULL;
+        }
+
+        return ECS_OFFSET(page,
+            sparse->stride * (ECS_SPARSE_INDEX(key) & ECS_SPARSE_PAGE_MASK));
+    } else if (sparse->overflow) {
+        return ecs_map_get_ptr(sparse->overflow, key);
+    } else {
+        return NULL;
+    }
+}
+
+/** Get element for key if it is set. Elements are shared between generations
+ * of the same index, so check that the key stored in the dense array is the
+ * same as the requested key. */
+static
+ecs_sparse_elem_t* get_set_elem(
+    ecs_sparse_t *sparse,
+    uint64_t key)
+{
+    ecs_sparse_elem_t *elem = get_elem(sparse, key);
+    if (elem && elem->dense) {
+        uint64_t *keys = ecs_vector_first(sparse->dense);
+        if (keys[elem->dense - 1] == key) {
+            return elem;
+        }
+    }
+
+    return NULL;
+}
+
+/** Get element for key, allocate page if it does not exist yet */
+static
+ecs_sparse_elem_t* ensure_elem(
+    ecs_sparse_t *sparse,
+    uint64_t key)
+{
+    if (key < ECS_SPARSE_MAX_PAGED_KEY) {
+        uint32_t page_index = ECS_SPARSE_INDEX(key) >> ECS_SPARSE_PAGE_BITS;
+        uint32_t page_count = sparse->page_count;
+
+        if (page_index >= page_count) {
+            uint32_t new_count = page_count * 2;
+            if (new_count <= page_index) {
+                new_count = page_index + 1;
+            }
+
+            sparse->pages = ecs_os_realloc(
+                sparse->pages, new_count * sizeof(void*));
+            ecs_assert(sparse->pages != NULL, ECS_OUT_OF_MEMORY, NULL);
+
+            memset(&sparse->pages[page_count], 0,
+                (new_count - page_count) * sizeof(void*));
+
+            sparse->page_count = new_count;
+        }
+
+        void *page = sparse->pages[page_index];
+        if (!page) {
+            page = ecs_os_calloc(ECS_SPARSE_PAGE_SIZE, sparse->stride);
+            ecs_assert(page != NULL, ECS_OUT_OF_MEMORY, NULL);
+            sparse->pages[page_index] = page;
+        }
+
+        return ECS_OFFSET(page,
+            sparse->stride * (ECS_SPARSE_INDEX(key) & ECS_SPARSE_PAGE_MASK));
+    } else {
+        if (!sparse->overflow) {
+            sparse->overflow = ecs_map_new(0, sparse->stride);
+        }
+
+        ecs_sparse_elem_t *elem = ecs_map_get_ptr(sparse->overflow, key);
+        if (!elem) {
+            void *empty = _ecs_os_alloca(sparse->stride, 1);
+            memset(empty, 0, sparse->stride);
+            elem = _ecs_map_set(sparse->overflow, key, empty, sparse->stride);
+        }
+
+        return elem;
+    }
+}
+
+
+/* -- Public functions -- */
+
+ecs_sparse_t* ecs_sparse_new(
+    uint32_t size,
+    uint32_t elem_size)
+{
+    ecs_sparse_t *result = ecs_os_calloc(1, sizeof(ecs_sparse_t));
+    ecs_assert(result != NULL, ECS_OUT_OF_MEMORY, NULL);
+
+    if (!elem_size) {
+        elem_size = sizeof(uint64_t);
+    }
+
+    result->elem_size = elem_size;
+    result->stride = ECS_SPARSE_HEADER_SIZE +
+        ((elem_size + sizeof(uint64_t) - 1) & ~(sizeof(uint64_t) - 1));
+
+    if (size) {
+        result->dense = ecs_vector_new(&key_params, size);
+    }
+
+    return result;
+}
+
+void ecs_sparse_free(
+    ecs_sparse_t *sparse)
+{
+    uint32_t i;
+    for (i = 0; i < sparse->page_count; i ++) {
+        ecs_os_free(sparse->pages[i]);
+    }
+
+    ecs_os_free(sparse->pages);
+    ecs_vector_free(sparse->dense);
+
+    if (sparse->overflow) {
+        ecs_map_free(sparse->overflow);
+    }
+
+    ecs_os_free(sparse);
+}
+
+void ecs_sparse_clear(
+    ecs_sparse_t *sparse)
+{
+    /* Only reset elements that are set, so that clearing a sparse set with a
+     * few elements remains cheap. Pages are kept for reuse. */
+    uint64_t *keys = ecs_vector_first(sparse->dense);
+    uint32_t i, count = ecs_vector_count(sparse->dense);
+
+    for (i = 0; i < count; i ++) {
+        uint64_t key = keys[i];
+        if (key < ECS_SPARSE_MAX_PAGED_KEY) {
+            memset(get_elem(sparse, key), 0, sparse->stride);
+        }
+    }
+
+    ecs_vector_clear(sparse->dense);
+
+    if (sparse->overflow) {
+        ecs_map_clear(sparse->overflow);
+    }
+}
+
+void ecs_sparse_memory(
+    ecs_sparse_t *sparse,
+    uint32_t *allocd,
+    uint32_t *used)
+{
+    if (!sparse) {
+        return;
+    }
+
+    if (allocd) {
+        uint32_t i, page_count = 0;
+        for (i = 0; i < sparse->page_count; i ++) {
+            if (sparse->pages[i]) {
+                page_count ++;
+            }
+        }
+
+        *allocd += sizeof(ecs_sparse_t) + sparse->page_count * sizeof(void*);
+        *allocd += page_count * ECS_SPARSE_PAGE_SIZE * sparse->stride;
+        ecs_vector_memory(sparse->dense, &key_params, allocd, NULL);
+    }
+
+    if (used) {
+        *used += ecs_vector_count(sparse->dense) * sparse->stride;
+        ecs_vector_memory(sparse->dense, &key_params, NULL, used);
+    }
+
+    ecs_map_memory(sparse->overflow, allocd, used);
+}
+
+uint32_t ecs_sparse_count(
+    ecs_sparse_t *sparse)
+{
+    return ecs_vector_count(sparse->dense);
+}
+
+uint32_t ecs_sparse_set_size(
+    ecs_sparse_t *sparse,
+    uint32_t size)
+{
+    return ecs_vector_set_size(&sparse->dense, &key_params, size);
+}
+
+uint32_t ecs_sparse_grow(
+    ecs_sparse_t *sparse,
+    uint32_t size)
+{
+    if (size > ecs_vector_size(sparse->dense)) {
+        return ecs_sparse_set_size(sparse, size);
+    }
+
+    return 0;
+}
+
+void* _ecs_sparse_set(
+    ecs_sparse_t *sparse,
+    uint64_t key,
+    const void *data,
+    uint32_t size)
+{
+    (void)size;
+    ecs_assert(sparse->elem_size == size, ECS_INVALID_PARAMETER, NULL);
+
+    ecs_sparse_elem_t *elem = ensure_elem(sparse, key);
+    ecs_assert(elem != NULL, ECS_INTERNAL_ERROR, NULL);
+
+    if (!elem->dense) {
+        uint64_t *dense = ecs_vector_add(&sparse->dense, &key_params);
+        *dense = key;
+        elem->dense = ecs_vector_count(sparse->dense);
+    } else {
+        /* Only one generation of an index can be set at a time. A stale key
+         * must not overwrite the element of the key that reused its index. */
+        uint64_t *keys = ecs_vector_first(sparse->dense);
+        if (keys[elem->dense - 1] != key) {
+            return NULL;
+        }
+    }
+
+    void *result = elem_data(elem);
+    if (data) {
+        memcpy(result, data, sparse->elem_size);
+    }
+
+    return result;
+}
+
+bool _ecs_sparse_has(
+    ecs_sparse_t *sparse,
+    uint64_t key,
+    void *value_out,
+    uint32_t size)
+{
+    (void)size;
+
+    if (!sparse) {
+        return false;
+    }
+
+    ecs_assert(!value_out || (sparse->elem_size == size),
+        ECS_INVALID_PARAMETER, NULL);
+
+    ecs_sparse_elem_t *elem = get_set_elem(sparse, key);
+    if (elem) {
+        if (value_out) {
+            memcpy(value_out, elem_data(elem), sparse->elem_size);
+        }
+        return true;
+    }
+
+    return false;
+}
+
+void* ecs_sparse_get_ptr(
+    ecs_sparse_t *sparse,
+    uint64_t key)
+{
+    ecs_sparse_elem_t *elem = get_set_elem(sparse, key);
+    if (elem) {
+        return elem_data(elem);
+    }
+
+    return NULL;
+}
+
+bool ecs_sparse_is_stale(
+    ecs_sparse_t *sparse,
+    uint64_t key)
+{
+    ecs_sparse_elem_t *elem = get_elem(sparse, key);
+    if (elem && elem->dense) {
+        uint64_t *keys = ecs_vector_first(sparse->dense);
+        return keys[elem->dense - 1] != key;
+    }
+
+    return false;
+}
+
+int ecs_sparse_remove(
+    ecs_sparse_t *sparse,
+    uint64_t key)
+{
+    ecs_sparse_elem_t *elem = get_set_elem(sparse, key);
+    if (!elem) {
+        return -1;
+    }
+
+    /* Move last key in dense array to the slot of the removed key */
+    uint64_t *keys = ecs_vector_first(sparse->dense);
+    uint32_t index = elem->dense - 1;
+    uint32_t last = ecs_vector_count(sparse->dense) - 1;
+
+    if (index != last) {
+        uint64_t last_key = keys[last];
+        ecs_sparse_elem_t *last_elem = get_elem(sparse, last_key);
+        ecs_assert(last_elem != NULL, ECS_INTERNAL_ERROR, NULL);
+        last_elem->dense = index + 1;
+        keys[index] = last_key;
+    }
+
+    ecs_vector_remove_last(sparse->dense);
+
+    if (key < ECS_SPARSE_MAX_PAGED_KEY) {
+        memset(elem, 0, sparse->stride);
+    } else {
+        ecs_map_remove(sparse->overflow, key);
+    }
+
+    return 0;
+}
+
+ecs_sparse_iter_t ecs_sparse_iter(
+    ecs_sparse_t *sparse)
+{
+    return (ecs_sparse_iter_t){
+        .sparse = sparse,
+        .index = 0
+    };
+}
+
+bool ecs_sparse_hasnext(
+    ecs_sparse_iter_t *it)
+{
+    return it->index < ecs_vector_count(it->sparse->dense);
+}
+
+void* ecs_sparse_next(
+    ecs_sparse_iter_t *it)
+{
+    return ecs_sparse_next_w_key(it, NULL);
+}
+
+void* ecs_sparse_next_w_key(
+    ecs_sparse_iter_t *it,
+    uint64_t *key_out)
+{
+    uint64_t *keys = ecs_vector_first(it->sparse->dense);
+    uint64_t key = keys[it->index ++];
+
+    if (key_out) {
+        *key_out = key;
+    }
+
+    return elem_data(get_elem(it->sparse, key));
+}
@@ -0,0 +1,391 @@
+#include "flecs_private.h"
+
+static ecs_vector_params_t sparse_op_params = {
+    .element_size = sizeof(ecs_sparse_op_t)
+};
+
+/** Sparse storage cannot be written to directly while in progress, as systems
+ * may be iterating it and worker threads may be reading from it. Operations of
+ * the main thread and of worker threads are applied when the stage is merged. */
+static
+bool is_deferred(
+    ecs_world_t *world,
+    ecs_stage_t *stage)
+{
+    (void)stage;
+
+    if (world->in_progress) {
+        ecs_assert(stage != &world->main_stage, ECS_INTERNAL_ERROR, NULL);
+        return true;
+    }
+
+    return false;
+}
+
+static
+void stage_op(
+    ecs_stage_t *stage,
+    ecs_entity_t entity,
+    ecs_entity_t component,
+    ecs_sparse_storage_t *storage,
+    const void *value,
+    bool remove)
+{
+    ecs_sparse_op_t *op = ecs_vector_add(&stage->sparse_stage, &sparse_op_params);
+    op->entity = entity;
+    op->component = component;
+    op->remove = remove;
+    op->value = NULL;
+
+    /* Value is released when the arena of the stage is reset at merge */
+    if (value) {
+        op->value = ecs_slab_alloc(stage->arena, storage->size);
+        memcpy(op->value, value, storage->size);
+    }
+}
+
+/** Add component to entity, or get existing value. New values are zeroed.
+ * Returns NULL if the entity handle is stale. */
+static
+void* storage_add(
+    ecs_world_t *world,
+    ecs_sparse_storage_t *storage,
+    ecs_entity_t entity)
+{
+    void *ptr = ecs_sparse_get_ptr(storage->data, entity);
+    if (!ptr) {
+        /* Don't add components to a deleted handle of which the id is reused */
+        if (ecs_sparse_is_stale(world->main_stage.entity_index, entity)) {
+            return NULL;
+        }
+
+        uint32_t size = storage->size ? storage->size : sizeof(uint64_t);
+        ptr = _ecs_sparse_set(storage->data, entity, NULL, size);
+        if (!ptr) {
+            return NULL;
+        }
+
+        memset(ptr, 0, size);
+
+        /* An entity that only has sparse components is not stored in a table,
+         * but should still be alive. While in progress, new entities are
+         * registered in the stage by ecs_new. */
+        if (!world->in_progress) {
+            ecs_sparse_t *index = world->main_stage.entity_index;
+            if (!ecs_sparse_get_ptr(index, entity)) {
+                ecs_sparse_set(index, entity, &((ecs_row_t){0, 0}));
+            }
+        }
+    }
+
+    return ptr;
+}
+
+static
+void storage_clear(
+    ecs_world_t *world,
+    ecs_entity_t entity)
+{
+    ecs_map_iter_t it = ecs_map_iter(world->sparse_storage);
+    while (ecs_map_hasnext(&it)) {
+        ecs_sparse_storage_t *storage = ecs_map_nextptr(&it);
+        ecs_sparse_remove(storage->data, entity);
+    }
+}
+
+/* -- Private functions -- */
+
+ecs_sparse_storage_t* ecs_sparse_component_storage(
+    ecs_world_t *world,
+    ecs_entity_t component)
+{
+    ecs_sparse_storage_t *storage = NULL;
+
+    if (world->sparse_storage) {
+        ecs_map_has(world->sparse_storage, component, &storage);
+    }
+
+    return storage;
+}
+
+ecs_type_t ecs_sparse_component_split(
+    ecs_world_t *world,
+    ecs_stage_t *stage,
+    ecs_type_t type,
+    ecs_type_t *sparse_out)
+{
+    *sparse_out = NULL;
+
+    if (!world->sparse_storage || !type) {
+        return type;
+    }
+
+    ecs_entity_t *array = ecs_vector_first(type);
+    uint32_t i, count = ecs_vector_count(type);
+
+    for (i = 0; i < count; i ++) {
+        if (ecs_sparse_component_storage(world, array[i])) {
+            break;
+        }
+    }
+
+    /* Fast path: type contains no sparse components */
+    if (i == count) {
+        return type;
+    }
+
+    ecs_entity_t *table_buf = ecs_os_alloca(ecs_entity_t, count);
+    ecs_entity_t *sparse_buf = ecs_os_alloca(ecs_entity_t, count);
+    uint32_t table_count = 0, sparse_count = 0;
+
+    for (i = 0; i < count; i ++) {
+        if (ecs_sparse_component_storage(world, array[i])) {
+            sparse_buf[sparse_count ++] = array[i];
+        } else {
+            table_buf[table_count ++] = array[i];
+        }
+    }
+
+    *sparse_out = ecs_type_find_intern(world, stage, sparse_buf, sparse_count);
+
+    if (table_count) {
+        return ecs_type_find_intern(world, stage, table_buf, table_count);
+    } else {
+        return NULL;
+    }
+}
+
+void ecs_sparse_component_add_remove(
+    ecs_world_t *world,
+    ecs_stage_t *stage,
+    ecs_entity_t entity,
+    ecs_type_t to_add,
+    ecs_type_t to_remove)
+{
+    ecs_entity_t *array = ecs_vector_first(to_remove);
+    uint32_t i, count = ecs_vector_count(to_remove);
+
+    for (i = 0; i < count; i ++) {
+        ecs_sparse_storage_t *storage = ecs_sparse_component_storage(
+            world, array[i]);
+        ecs_assert(storage != NULL, ECS_INTERNAL_ERROR, NULL);
+
+        if (is_deferred(world, stage)) {
+            stage_op(stage, entity, array[i], storage, NULL, true);
+        } else {
+            ecs_sparse_remove(storage->data, entity);
+        }
+    }
+
+    array = ecs_vector_first(to_add);
+    count = ecs_vector_count(to_add);
+
+    for (i = 0; i < count; i ++) {
+        ecs_sparse_storage_t *storage = ecs_sparse_component_storage(
+            world, array[i]);
+        ecs_assert(storage != NULL, ECS_INTERNAL_ERROR, NULL);
+
+        if (is_deferred(world, stage)) {
+            stage_op(stage, entity, array[i], storage, NULL, false);
+        } else {
+            storage_add(world, storage, entity);
+        }
+    }
+}
+
+void ecs_sparse_component_set(
+    ecs_world_t *world,
+    ecs_stage_t *stage,
+    ecs_entity_t entity,
+    ecs_entity_t component,
+    ecs_sparse_storage_t *storage,
+    const void *ptr)
+{
+    if (is_deferred(world, stage)) {
+        stage_op(stage, entity, component, storage, ptr, false);
+    } else {
+        void *dst = storage_add(world, storage, entity);
+        if (dst && storage->size && dst != ptr) {
+            memcpy(dst, ptr, storage->size);
+        }
+    }
+}
+
+bool ecs_sparse_component_has(
+    ecs_world_t *world,
+    ecs_entity_t entity,
+    ecs_type_t type,
+    bool match_all)
+{
+    ecs_entity_t *array = ecs_vector_first(type);
+    uint32_t i, count = ecs_vector_count(type);
+
+    for (i = 0; i < count; i ++) {
+        ecs_sparse_storage_t *storage = ecs_sparse_component_storage(
+            world, array[i]);
+        ecs_assert(storage != NULL, ECS_INTERNAL_ERROR, NULL);
+
+        bool has = ecs_sparse_get_ptr(storage->data, entity) != NULL;
+        if (has != match_all) {
+            return has;
+        }
+    }
+
+    return match_all;
+}
+
+bool ecs_sparse_component_is_empty(
+    ecs_world_t *world,
+    ecs_entity_t entity)
+{
+    if (!world->sparse_storage) {
+        return true;
+    }
+
+    ecs_map_iter_t it = ecs_map_iter(world->sparse_storage);
+    while (ecs_map_hasnext(&it)) {
+        ecs_sparse_storage_t *storage = ecs_map_nextptr(&it);
+        if (ecs_sparse_get_ptr(storage->data, entity)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void ecs_sparse_component_clear(
+    ecs_world_t *world,
+    ecs_stage_t *stage,
+    ecs_entity_t entity)
+{
+    if (!world->sparse_storage) {
+        return;
+    }
+
+    if (is_deferred(world, stage)) {
+        stage_op(stage, entity, 0, NULL, NULL, true);
+    } else {
+        storage_clear(world, entity);
+    }
+}
+
+void ecs_sparse_component_clone(
+    ecs_world_t *world,
+    ecs_stage_t *stage,
+    ecs_entity_t src,
+    ecs_entity_t dst,
+    bool copy_value)
+{
+    if (!world->sparse_storage) {
+        return;
+    }
+
+    ecs_map_iter_t it = ecs_map_iter(world->sparse_storage);
+    while (ecs_map_hasnext(&it)) {
+        uint64_t component;
+        ecs_sparse_storage_t *storage = ecs_map_nextptr_w_key(&it, &component);
+
+        void *ptr = ecs_sparse_get_ptr(storage->data, src);
+        if (!ptr) {
+            continue;
+        }
+
+        if (copy_value && storage->size) {
+            ecs_sparse_component_set(
+                world, stage, dst, component, storage, ptr);
+        } else {
+            ecs_type_t type = ecs_type_find_intern(
+                world, stage, &(ecs_entity_t){component}, 1);
+            ecs_sparse_component_add_remove(world, stage, dst, type, NULL);
+        }
+    }
+}
+
+void ecs_sparse_component_merge(
+    ecs_world_t *world,
+    ecs_stage_t *stage)
+{
+    ecs_sparse_op_t *ops = ecs_vector_first(stage->sparse_stage);
+    uint32_t i, count = ecs_vector_count(stage->sparse_stage);
+
+    for (i = 0; i < count; i ++) {
+        ecs_sparse_op_t *op = &ops[i];
+
+        if (!op->component) {
+            storage_clear(world, op->entity);
+            continue;
+        }
+
+        ecs_sparse_storage_t *storage = ecs_sparse_component_storage(
+            world, op->component);
+
+        if (op->remove) {
+            ecs_sparse_remove(storage->data, op->entity);
+        } else {
+            void *dst = storage_add(world, storage, op->entity);
+            if (dst && op->value) {
+                memcpy(dst, op->value, storage->size);
+            }
+        }
+    }
+
+    ecs_vector_clear(stage->sparse_stage);
+}
+
+void ecs_sparse_component_stage_free(
+    ecs_stage_t *stage)
+{
+    ecs_vector_free(stage->sparse_stage);
+    stage->sparse_stage = NULL;
+}
+
+void ecs_sparse_component_fini(
+    ecs_world_t *world)
+{
+    if (!world->sparse_storage) {
+        return;
+    }
+
+    ecs_map_iter_t it = ecs_map_iter(world->sparse_storage);
+    while (ecs_map_hasnext(&it)) {
+        ecs_sparse_storage_t *storage = ecs_map_nextptr(&it);
+        ecs_sparse_free(storage->data);
+        ecs_os_free(storage);
+    }
+
+    ecs_map_free(world->sparse_storage);
+    world->sparse_storage = NULL;
+}
+
+/* -- Public functions -- */
+
+void _ecs_set_sparse_storage(
+    ecs_world_t *world,
+    ecs_entity_t component)
+{
+    ecs_assert(world->magic == ECS_WORLD_MAGIC, ECS_INVALID_FROM_WORKER, NULL);
+    ecs_assert(!world->in_progress, ECS_INVALID_WHILE_ITERATING, NULL);
+    ecs_assert(component != 0, ECS_INVALID_PARAMETER, NULL);
+
+    if (ecs_sparse_component_storage(world, component)) {
+        return;
+    }
+
+    /* Components that are already stored in tables cannot be moved */
+    ecs_assert(!_ecs_count(world, ecs_type_from_entity(world, component)),
+        ECS_INVALID_PARAMETER, 
+        "sparse storage must be enabled before component is added");
+
+    EcsComponent *cdata = ecs_get_ptr(world, component, EcsComponent);
+    ecs_sparse_storage_t *storage = ecs_os_malloc(sizeof(ecs_sparse_storage_t));
+    ecs_assert(storage != NULL, ECS_OUT_OF_MEMORY, NULL);
+
+    storage->size = cdata ? cdata->size : 0;
+    storage->data = ecs_sparse_new(0, storage->size);
+
+    if (!world->sparse_storage) {
+        world->sparse_storage = ecs_map_new(0, sizeof(ecs_sparse_storage_t*));
+    }
+
+    ecs_map_set(world->sparse_storage, component, &storage);
+}
@@ -30,29 +30,26 @@ void notify_new_tables(
     }
 }
 
+/** Release staged data. Staged columns, the staged maps and the values of
+ * sparse component operations are allocated from the stage arena, so they are
+ * all released by resetting it. The memory of the arena is kept for the next
+ * frame, which means that staging does not allocate in steady state. */
 static
 void clean_data_stage(
     ecs_stage_t *stage)
 {
-    ecs_map_iter_t it = ecs_map_iter(stage->data_stage);
-    while (ecs_map_hasnext(&it)) {
-        uint64_t keyval;
-        ecs_table_column_t *columns = 
-            *(ecs_table_column_t**)ecs_map_next_w_key(&it, &keyval);
-        
-        ecs_type_t type = (ecs_type_t)(uintptr_t)keyval;
-        uint32_t i, count = ecs_vector_count(type);
-        
-        for(i = 0; i < count + 1; i ++) {
-            ecs_vector_free(columns[i].data);
-        }
+    uint32_t data_count = ecs_map_count(stage->data_stage);
+    uint32_t remove_count = ecs_map_count(stage->remove_merge);
 
-        ecs_os_free(columns);
-    }
+    ecs_slab_reset(stage->arena);
+
+    /* Size maps for the number of elements in the previous frame */
+    stage->data_stage = ecs_map_new_w_slab(
+        data_count, sizeof(ecs_table_column_t*), stage->arena);
+    stage->remove_merge = ecs_map_new_w_slab(
+        remove_count, sizeof(ecs_type_t), stage->arena);
 
-    ecs_map_clear(stage->entity_index);
-    ecs_map_clear(stage->remove_merge);
-    ecs_map_clear(stage->data_stage);
+    ecs_sparse_clear(stage->entity_index);
 }
 
 static
@@ -60,28 +57,56 @@ void merge_commits(
     ecs_world_t *world,
     ecs_stage_t *stage)
 {  
-    if (!ecs_map_count(stage->entity_index)) {
+    if (!ecs_sparse_count(stage->entity_index)) {
         return;
     }
 
-    ecs_map_iter_t it = ecs_map_iter(stage->entity_index);
+    ecs_sparse_iter_t it = ecs_sparse_iter(stage->entity_index);
 
-    while (ecs_map_hasnext(&it)) {
+    while (ecs_sparse_hasnext(&it)) {
         ecs_entity_t entity;
-        ecs_row_t *row = ecs_map_next_w_key(&it, &entity);
+        ecs_row_t *row = ecs_sparse_next_w_key(&it, &entity);
         ecs_merge_entity(world, stage, entity, *row);
     }
-    
-    clean_data_stage(stage);
+}
+
+/** Add entities that were named in the stage to the name index */
+static
+void merge_names(
+    ecs_world_t *world,
+    ecs_stage_t *stage)
+{
+    ecs_entity_t *buffer = ecs_vector_first(stage->name_stage);
+    uint32_t i, count = ecs_vector_count(stage->name_stage);
+
+    for (i = 0; i < count; i ++) {
+        ecs_world_index_name(world, buffer[i], ecs_get_id(world, buffer[i]));
+    }
+
+    ecs_vector_clear(stage->name_stage);
+}
+
+static
+void merge_deletes(
+    ecs_world_t *world,
+    ecs_stage_t *stage)
+{
+    ecs_entity_t *buffer = ecs_vector_first(stage->delete_stage);
+    uint32_t i, count = ecs_vector_count(stage->delete_stage);
+
+    for (i = 0; i < count; i ++) {
+        ecs_merge_delete(world, buffer[i]);
+    }
+
+    ecs_vector_clear(stage->delete_stage);
 }
 
 static
 void clean_types(
     ecs_stage_t *stage)
 {
-    (void)stage;
-    
-    /* TODO: clean types */
+    ecs_type_db_free(&stage->type_db);
+    stage->last_link = NULL;
 }
 
 static
@@ -99,6 +124,18 @@ void clean_tables(
 
 /* -- Private functions -- */
 
+ecs_slab_t* ecs_stage_get_slab(
+    ecs_world_t *world,
+    ecs_stage_t *stage)
+{
+    /* Worker stages allocate from the heap, as the slab is not thread safe */
+    if (stage == &world->main_stage || stage == &world->temp_stage) {
+        return world->slab;
+    } else {
+        return NULL;
+    }
+}
+
 void ecs_stage_init(
     ecs_world_t *world,
     ecs_stage_t *stage)
@@ -108,12 +145,11 @@ void ecs_stage_init(
 
     memset(stage, 0, sizeof(ecs_stage_t));
 
-    stage->entity_index = ecs_map_new(0, sizeof(ecs_row_t));
+    stage->entity_index = ecs_sparse_new(0, sizeof(ecs_row_t));
 
     if (is_main_stage) {
-        stage->last_link = &world->main_stage.type_root.link;
+        stage->last_link = &world->main_stage.type_db.link;
     } else if (is_temp_stage) {
-        stage->type_root = world->main_stage.type_root;
         stage->last_link = NULL;
     } else {
     }
@@ -126,8 +162,11 @@ void ecs_stage_init(
     }
 
     if (!is_main_stage) {
-        stage->data_stage = ecs_map_new(0, sizeof(ecs_table_column_t*));
-        stage->remove_merge = ecs_map_new(0, sizeof(ecs_type_t));
+        stage->arena = ecs_slab_new_bump(ECS_STAGE_ARENA_SIZE);
+        stage->data_stage = ecs_map_new_w_slab(
+            0, sizeof(ecs_table_column_t*), stage->arena);
+        stage->remove_merge = ecs_map_new_w_slab(
+            0, sizeof(ecs_type_t), stage->arena);
     }
 
     stage->commit_count = 0;
@@ -141,22 +180,26 @@ void ecs_stage_deinit(
     ecs_stage_t *stage)
 {
     bool is_main_stage = stage == &world->main_stage;
-    bool is_temp_stage = stage == &world->temp_stage;
-
-    if (!is_temp_stage) {
-        clean_types(stage);
-    }
 
     if (!is_main_stage) {
-        clean_data_stage(stage);
-        ecs_map_free(stage->data_stage);
-        ecs_map_free(stage->remove_merge);
+        ecs_vector_free(stage->delete_stage);
+        ecs_vector_free(stage->name_stage);
+        ecs_sparse_component_stage_free(stage);
+        ecs_slab_free(stage->arena);
     }
 
+    ecs_slab_release(ecs_stage_get_slab(world, stage), stage->merge_cache);
+
     clean_tables(world, stage);
     ecs_chunked_free(stage->tables);
     ecs_map_free(stage->table_index);
-    ecs_map_free(stage->entity_index);
+    ecs_sparse_free(stage->entity_index);
+
+    /* Types are only stored in the main stage. Other stages share the type
+     * database of the main stage, so it must be freed last. */
+    if (is_main_stage) {
+        clean_types(stage);
+    }
 }
 
 void ecs_stage_merge(
@@ -175,6 +218,19 @@ void ecs_stage_merge(
      * is found after merging the staged type with the non-staged type. */
     merge_commits(world, stage);
 
+    /* Index names of merged entities */
+    merge_names(world, stage);
+
+    /* Apply changes to sparse components made by worker threads */
+    ecs_sparse_component_merge(world, stage);
+
+    /* Recycle ids of entities deleted in stage. This must happen after merging
+     * the commits, as they determine whether the entity is still alive. */
+    merge_deletes(world, stage);
+
+    /* All staged data has been applied */
+    clean_data_stage(stage);
+
     /* Clear temporary tables used by stage */
     clean_tables(world, stage);
     ecs_chunked_clear(stage->tables);
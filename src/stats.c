@@ -18,17 +18,7 @@ void calculate_type_stats(
     uint32_t *allocd,
     uint32_t *used)
 {
-    (void)world;
-    (void)allocd;
-    (void)used;
-
-    /* TODO: compute memory for type storage */
-
-    /*ecs_map_iter_t it = ecs_map_iter(world->main_stage.type_index);
-    while (ecs_map_hasnext(&it)) {
-        ecs_vector_t *type = ecs_map_next_ptr(&it);
-        ecs_vector_memory(type, &handle_arr_params, allocd, used);
-    }*/
+    ecs_type_db_memory(&world->main_stage.type_db, allocd, used);
 }
 
 static
@@ -103,19 +93,21 @@ void calculate_stage_stats(
     uint32_t *used)
 {
     bool is_main_stage = stage == &world->main_stage;
-    bool is_temp_stage = stage == &world->temp_stage;
 
     if (!is_main_stage) {
-        ecs_map_memory(stage->entity_index, allocd, used);
+        ecs_sparse_memory(stage->entity_index, allocd, used);
     }
 
-    if (!is_temp_stage) {
-        /* ecs_map_memory(stage->type_index, allocd, used); */
-    }
-    
     ecs_chunked_memory(stage->tables, allocd, used);
     ecs_map_memory(stage->table_index, allocd, used);
 
+    if (stage->merge_cache) {
+        uint32_t size = 
+            ECS_TYPE_MERGE_CACHE_SIZE * sizeof(ecs_type_merge_entry_t);
+        *allocd += size;
+        *used += size;
+    }
+
     if (!is_main_stage) {
         ecs_map_memory(stage->remove_merge, allocd, used);
         ecs_map_memory(stage->data_stage, allocd, used);
@@ -136,6 +128,33 @@ void calculate_stages_stats(
     }
 }
 
+static
+void add_type_merge_stats(
+    ecs_stage_t *stage,
+    ecs_world_stats_t *stats)
+{
+    stats->type_merge_hits += stage->merge_cache_hits;
+    stats->type_merge_misses += stage->merge_cache_misses;
+}
+
+static
+void get_type_merge_stats(
+    ecs_world_t *world,
+    ecs_world_stats_t *stats)
+{
+    stats->type_merge_hits = 0;
+    stats->type_merge_misses = 0;
+
+    add_type_merge_stats(&world->main_stage, stats);
+    add_type_merge_stats(&world->temp_stage, stats);
+
+    ecs_stage_t *buffer = ecs_vector_first(world->worker_stages);
+    uint32_t i, count = ecs_vector_count(world->worker_stages);
+    for (i = 0; i < count; i ++) {
+        add_type_merge_stats(&buffer[i], stats);
+    }
+}
+
 static
 void get_memory_stats(
     ecs_world_t *world,
@@ -184,7 +203,7 @@ void get_memory_stats(
     calculate_stage_stats(world, &world->temp_stage, &memory->stage.allocd, &memory->stage.used);
     calculate_stages_stats(world, &memory->stage.allocd, &memory->stage.used);
 
-    ecs_map_memory(world->main_stage.entity_index, &memory->entities.allocd, &memory->entities.used);
+    ecs_sparse_memory(world->main_stage.entity_index, &memory->entities.allocd, &memory->entities.used);
 
     ecs_vector_memory(world->worker_threads, &table_arr_params, &memory->world.allocd, &memory->world.used);
     stats->memory.world.allocd += sizeof(ecs_world_t) - sizeof(ecs_stage_t);
@@ -325,6 +344,7 @@ void add_component_measurement(
     ecs_world_stats_t *stats,
     ecs_entity_t component,
     ecs_table_column_t *column,
+    uint32_t row_count,
     uint32_t *memory_allocd,
     uint32_t *memory_used)
 {
@@ -361,11 +381,11 @@ void add_component_measurement(
         }
     }
 
-    ecs_vector_params_t param = {.element_size = c[i].size};
-    ecs_vector_memory(column->data, &param, &c[i].memory_allocd, &c[i].memory_used);
-    ecs_vector_memory(column->data, &param, memory_allocd, memory_used);
+    ecs_table_column_memory(
+        column, row_count, &c[i].memory_allocd, &c[i].memory_used);
+    ecs_table_column_memory(column, row_count, memory_allocd, memory_used);
 
-    c[i].entities += ecs_vector_count(column->data);
+    c[i].entities += row_count;
     c[i].tables ++;
 }
 
@@ -384,10 +404,12 @@ void collect_comp_stats(
         ecs_entity_t *components = ecs_vector_first(table->type);
 
         uint32_t c, c_count = ecs_vector_count(table->type);
+        uint32_t row_count = ecs_table_count(table);
 
         for (c = 0; c < c_count; c ++) {
             add_component_measurement(world, stats, components[c], 
-                    &table->columns[c], memory_allocd, memory_used);
+                    &table->columns[c + 1], row_count, memory_allocd, 
+                    memory_used);
         }
     }
 }
@@ -482,6 +504,10 @@ void ecs_get_stats(
     stats->memory.components.allocd = mem_allocd;
     get_memory_stats(world, stats);
 
+    ecs_slab_get_stats(world->slab, &stats->allocator);
+    ecs_slab_get_stats(world->column_arena, &stats->column_arena);
+    get_type_merge_stats(world, stats);
+
     uint32_t system_memory =
       table_sys_count * (sizeof(EcsColSystem) + sizeof(EcsId)) +
       row_sys_count * (sizeof(EcsRowSystem) + sizeof(EcsId));
@@ -497,7 +523,7 @@ void ecs_get_stats(
     stats->memory.families.used += type_memory;
     stats->memory.families.allocd += type_memory; */
 
-    stats->entity_count = ecs_map_count(world->main_stage.entity_index);
+    stats->entity_count = ecs_sparse_count(world->main_stage.entity_index);
     stats->tick_count = world->tick;
 
     if (world->tick) {
@@ -47,7 +47,7 @@ void match_families(
     ecs_entity_t system,
     EcsRowSystem *system_data)
 {
-    ecs_type_link_t *link = &world->main_stage.type_root.link;
+    ecs_type_link_t *link = &world->main_stage.type_db.link;
 
     do {
         match_type(world, system, system_data, link->type);
@@ -101,6 +101,7 @@ ecs_entity_t new_row_system(
     ecs_assert(id_data != NULL, ECS_INTERNAL_ERROR, NULL);
 
     *id_data = id;
+    ecs_world_index_name(world, result, id);
 
     EcsRowSystem *system_data = ecs_get_ptr(world, result, EcsRowSystem);
     memset(system_data, 0, sizeof(EcsRowSystem));
@@ -152,6 +153,10 @@ ecs_entity_t new_row_system(
 
     ecs_system_compute_and_families(world, &system_data->base);
 
+    /* Row systems are invoked for tables, which don't store sparse components */
+    ecs_assert(!system_data->base.sparse_columns, ECS_UNSUPPORTED, 
+        "row systems cannot match sparse components");
+
     ecs_system_init_base(world, &system_data->base);
 
     if (needs_tables) {
@@ -214,6 +219,32 @@ void ecs_system_compute_and_families(
         ecs_system_expr_elem_kind_t elem_kind = elem->kind;
         ecs_system_expr_oper_kind_t oper_kind = elem->oper_kind;
 
+        /* Sparse components are not stored in tables, so they can't be used
+         * to match tables. They are tested per entity when running the system */
+        if (oper_kind != EcsOperOr && (elem_kind == EcsFromSelf || 
+            elem_kind == EcsFromOwned || 
+            (elem_kind == EcsFromEmpty && oper_kind == EcsOperNot)))
+        {
+            ecs_sparse_storage_t *storage = ecs_sparse_component_storage(
+                world, elem->is.component);
+
+            if (storage) {
+                ecs_sparse_column_t *sc = ecs_vector_add(
+                    &system_data->sparse_columns, &sparse_column_params);
+                sc->column = i;
+                sc->storage = storage;
+                sc->oper_kind = oper_kind;
+                continue;
+            }
+        }
+
+        /* Used to find systems affected by changes to watched entities */
+        if (oper_kind == EcsOperOr) {
+            system_data->columns_bloom |= ecs_type_bloom(elem->is.type);
+        } else {
+            system_data->columns_bloom |= ecs_bloom_bit(elem->is.component);
+        }
+
         if (elem_kind == EcsFromSelf) {
             if (oper_kind == EcsOperAnd) {
                 system_data->and_from_self = ecs_type_add_intern(
@@ -242,6 +273,11 @@ void ecs_system_compute_and_families(
             system_data->cascade_by = i + 1;
         }
     }
+
+    system_data->and_from_self_bloom = 
+        ecs_type_bloom(system_data->and_from_self);
+    system_data->and_from_owned_bloom = 
+        ecs_type_bloom(system_data->and_from_owned);
 }
 
 /** Parse callback that adds component to the components array for a system */
@@ -269,6 +305,18 @@ int ecs_parse_signature_action(
         }
     }
 
+    /* Sparse components can only be matched on the entity itself, as they are
+     * tested per entity while the system is running */
+    bool is_sparse = ecs_sparse_component_storage(world, component) != NULL;
+    if (is_sparse) {
+        bool from_self = elem_kind == EcsFromSelf || elem_kind == EcsFromOwned;
+        if (oper_kind == EcsOperOr || (!from_self && 
+            (oper_kind == EcsOperNot || elem_kind != EcsFromEmpty)))
+        {
+            ecs_abort(ECS_UNSUPPORTED, component_id);
+        }
+    }
+
     /* If retrieving a component from a system, only the AND operator is
      * supported. The set of system components is expected to be constant, and
      * thus no conditional operators are needed. */
@@ -296,6 +344,10 @@ int ecs_parse_signature_action(
     } else if (oper_kind == EcsOperOr) {
         elem = ecs_vector_last(system_data->columns, &system_column_params);
         if (elem->oper_kind == EcsOperAnd) {
+            if (ecs_sparse_component_storage(world, elem->is.component)) {
+                ecs_abort(ECS_UNSUPPORTED, component_id);
+            }
+
             elem->is.type = ecs_type_add_intern(
                 world, NULL, 0, elem->is.component);
         } else {
@@ -319,7 +371,9 @@ int ecs_parse_signature_action(
         elem->oper_kind = EcsOperNot;
         elem->is.component = component;
 
-        if (elem_kind == EcsFromSelf) {
+        if (is_sparse) {
+            /* Tested per entity */
+        } else if (elem_kind == EcsFromSelf) {
             system_data->not_from_self =
                 ecs_type_add_intern(
                     world, NULL, system_data->not_from_self, component);
@@ -455,14 +509,32 @@ ecs_type_t ecs_notify_row_system(
         rows.references = references;
     }
 
-    /* Obtain pointer to vector with entity identifiers */
     if (table_columns) {
+        /* Obtain pointer to vector with entity identifiers */
         ecs_entity_t *entities = ecs_vector_first(table_columns[0].data);
-        rows.entities = &entities[rows.offset];
-    }
 
-    /* Run system */
-    action(&rows);
+        /* Run system for each range of rows that is stored contiguously, so
+         * that the system can access component data as arrays */
+        while (limit) {
+            uint32_t count = limit;
+            if (table) {
+                count = ecs_table_contiguous(table, table_columns, offset, limit);
+            }
+
+            rows.entities = &entities[offset];
+            rows.offset = offset;
+            rows.count = count;
+
+            action(&rows);
+
+            rows.frame_offset += count;
+            offset += count;
+            limit -= count;
+        }
+    } else {
+        /* Run system */
+        action(&rows);
+    }
 
     /* Return the components that the system promised to init/read/fini */
     return system_data->base.and_from_self;
@@ -645,6 +717,64 @@ void ecs_set_period(
     }
 }
 
+void _ecs_set_system_sort(
+    ecs_world_t *world,
+    ecs_entity_t system,
+    ecs_entity_t component,
+    ecs_compare_action_t compare)
+{
+    ecs_assert(world->magic == ECS_WORLD_MAGIC, ECS_INVALID_FROM_WORKER, NULL);
+    ecs_assert(!compare || component, ECS_INVALID_PARAMETER, NULL);
+
+    EcsColSystem *system_data = ecs_get_ptr(world, system, EcsColSystem);
+    ecs_assert(system_data != NULL, ECS_INVALID_PARAMETER, NULL);
+
+    ecs_entity_t *buffer = ecs_vector_first(world->sorted_systems);
+    uint32_t i, count = ecs_vector_count(world->sorted_systems);
+    for (i = 0; i < count; i ++) {
+        if (buffer[i] == system) {
+            break;
+        }
+    }
+
+    if (compare && i == count) {
+        ecs_entity_t *elem = ecs_vector_add(
+            &world->sorted_systems, &handle_arr_params);
+        *elem = system;
+    } else if (!compare && i != count) {
+        ecs_vector_remove_index(world->sorted_systems, &handle_arr_params, i);
+    }
+
+    system_data->sort_component = component;
+    system_data->sort_compare = compare;
+}
+
+void _ecs_set_system_writes(
+    ecs_world_t *world,
+    ecs_entity_t system,
+    ecs_type_t type)
+{
+    ecs_assert(world->magic == ECS_WORLD_MAGIC, ECS_INVALID_FROM_WORKER, NULL);
+
+    EcsColSystem *system_data = ecs_get_ptr(world, system, EcsColSystem);
+    ecs_assert(system_data != NULL, ECS_INVALID_PARAMETER, NULL);
+
+    system_data->writes = type;
+}
+
+void ecs_set_system_on_change(
+    ecs_world_t *world,
+    ecs_entity_t system,
+    bool enabled)
+{
+    ecs_assert(world->magic == ECS_WORLD_MAGIC, ECS_INVALID_FROM_WORKER, NULL);
+
+    EcsColSystem *system_data = ecs_get_ptr(world, system, EcsColSystem);
+    ecs_assert(system_data != NULL, ECS_INVALID_PARAMETER, NULL);
+
+    system_data->on_change = enabled;
+}
+
 static
 void* get_owned_column(
     ecs_rows_t *rows,
@@ -657,6 +787,11 @@ void* get_owned_column(
     ecs_table_column_t *column = &((ecs_table_column_t*)rows->table_columns)[table_column];
     ecs_assert(column->size != 0, ECS_COLUMN_HAS_NO_DATA, NULL);
     ecs_assert(!size || column->size == size, ECS_COLUMN_TYPE_MISMATCH, NULL);
+
+    if (column->chunk_shift) {
+        return ecs_table_column_get(column, rows->offset);
+    }
+
     void *buffer = ecs_vector_first(column->data);
     return ECS_OFFSET(buffer, column->size * rows->offset);
 }
@@ -823,7 +958,21 @@ void* ecs_table_column(
     uint32_t column)
 {
     ecs_table_t *table = rows->table;
-    return ecs_vector_first(table->columns[column + 1].data);
+    ecs_table_column_t *table_column = &table->columns[column + 1];
+
+    if (!table_column->chunk_shift) {
+        return ecs_vector_first(table_column->data);
+    }
+
+    if (!rows->count) {
+        return NULL;
+    }
+
+    /* Rows of a chunked table are only contiguous within the chunk that is
+     * being iterated. Offset the pointer to that chunk, so that it can be
+     * indexed with rows->offset like the array of a contiguous column. */
+    void *ptr = ecs_table_column_get(table_column, rows->offset);
+    return ECS_OFFSET(ptr, -(int64_t)(table_column->size * rows->offset));
 }
 
 static
@@ -1,5 +1,14 @@
 #include "flecs_private.h"
 
+static
+ecs_vector_params_t chunk_arr_params = {.element_size = sizeof(ecs_vector_t*)};
+
+static
+ecs_vector_params_t bitset_arr_params = {.element_size = sizeof(ecs_table_bitset_t)};
+
+static
+ecs_vector_params_t word_arr_params = {.element_size = sizeof(uint64_t)};
+
 /** Notify systems that a table has changed its active state */
 static
 void activate_table(
@@ -28,21 +37,23 @@ ecs_table_column_t* new_columns(
     ecs_world_t *world,
     ecs_stage_t *stage,
     ecs_table_t *table,
-    ecs_type_t type)
+    ecs_type_t type,
+    ecs_slab_t *slab)
 {
-    ecs_table_column_t *result = ecs_os_calloc(
-        sizeof(ecs_table_column_t), ecs_vector_count(type) + 1);
-
-    ecs_assert(result != NULL, ECS_OUT_OF_MEMORY, NULL);
-
     ecs_entity_t *buf = ecs_vector_first(type);
     uint32_t i, count = ecs_vector_count(type);
 
+    ecs_table_column_t *result = ecs_slab_calloc(
+        slab, sizeof(ecs_table_column_t) * (count + 1));
+
     /* First column is reserved for storing entity id's */
     result[0].size = sizeof(ecs_entity_t);
     result[0].data = NULL;
+    result[0].slab = slab;
 
     for (i = 0; i < count; i ++) {
+        result[i + 1].slab = slab;
+
         ecs_entity_info_t info = {.entity = buf[i]};
         EcsComponent *component = ecs_get_ptr_intern(
             world, stage, &info, EEcsComponent, false, false);
@@ -51,17 +62,378 @@ ecs_table_column_t* new_columns(
             if (component->size) {
                 /* Regular column data */
                 result[i + 1].size = component->size;
+                result[i + 1].alignment = ECS_COLUMN_ALIGNMENT;
+                if (component->alignment > ECS_COLUMN_ALIGNMENT) {
+                    result[i + 1].alignment = component->alignment;
+                }
             }
         }
 
         if (table && buf[i] == EEcsPrefab) {
             table->flags |= EcsTableIsPrefab;
         }
+
+        /* Components of the table may be inherited from a prefab */
+        if (table && buf[i] & ECS_INSTANCEOF) {
+            table->flags |= EcsTableHasPrefab;
+        }
     }
     
     return result;
 }
 
+/** Get parameters for the data vector of a column */
+static
+ecs_vector_params_t column_params(
+    ecs_table_column_t *column)
+{
+    return (ecs_vector_params_t){
+        .element_size = column->size, 
+        .alignment = column->alignment,
+        .slab = column->slab
+    };
+}
+
+/** Configure columns to store data in chunks of (at most) chunk_size bytes.
+ * All chunked columns of a table store the same number of rows per chunk, so
+ * that a range of rows that is contiguous in one column is contiguous in all
+ * columns. The entity column is never chunked. */
+static
+void set_chunked(
+    ecs_table_column_t *columns,
+    uint32_t column_count,
+    uint32_t chunk_size)
+{
+    uint32_t i, max_size = 0;
+    for (i = 1; i < column_count + 1; i ++) {
+        if (columns[i].size > max_size) {
+            max_size = columns[i].size;
+        }
+    }
+
+    /* Table has no columns with data */
+    if (!max_size) {
+        return;
+    }
+
+    /* Store at least two rows per chunk, as a shift of 0 means not chunked */
+    uint8_t shift = 1;
+    while (shift < 30 && ((uint64_t)max_size << (shift + 1)) <= chunk_size) {
+        shift ++;
+    }
+
+    for (i = 1; i < column_count + 1; i ++) {
+        if (columns[i].size) {
+            columns[i].chunk_shift = shift;
+        }
+    }
+}
+
+/** Make sure a chunked column has enough chunks to store count rows */
+static
+void reserve_chunks(
+    ecs_table_column_t *column,
+    uint32_t count)
+{
+    uint8_t shift = column->chunk_shift;
+    uint32_t needed = (count + (1 << shift) - 1) >> shift;
+    uint32_t cur = ecs_vector_count(column->data);
+
+    if (cur >= needed) {
+        return;
+    }
+
+    ecs_vector_params_t params = column_params(column);
+
+    for (; cur < needed; cur ++) {
+        ecs_vector_t **chunk = ecs_vector_add(&column->data, &chunk_arr_params);
+        *chunk = ecs_vector_new(&params, 1 << shift);
+    }
+}
+
+/** Free chunks that are no longer needed to store count rows, except for the
+ * specified number of spare chunks. */
+static
+void trim_chunks(
+    ecs_table_column_t *column,
+    uint32_t count,
+    uint32_t spare)
+{
+    uint8_t shift = column->chunk_shift;
+    uint32_t needed = (count + (1 << shift) - 1) >> shift;
+    uint32_t cur = ecs_vector_count(column->data);
+
+    for (; cur > needed + spare; cur --) {
+        ecs_vector_t *chunk;
+        ecs_vector_pop(column->data, &chunk_arr_params, &chunk);
+        ecs_vector_free(chunk);
+    }
+}
+
+/** Add n rows to a column that currently has count rows. Returns true if the
+ * existing data in the column was moved to a different address. */
+static
+bool column_addn(
+    ecs_table_column_t *column,
+    uint32_t count,
+    uint32_t n)
+{
+    if (column->chunk_shift) {
+        reserve_chunks(column, count + n);
+        return false;
+    }
+
+    ecs_vector_params_t params = column_params(column);
+
+    void *old_vector = column->data;
+    ecs_vector_addn(&column->data, &params, n);
+
+    return old_vector != column->data;
+}
+
+/** Remove row from a column that currently has count rows, by moving the last
+ * row into the removed row. */
+static
+void column_remove(
+    ecs_table_column_t *column,
+    uint32_t count,
+    uint32_t index)
+{
+    uint32_t last = count - 1;
+
+    if (column->chunk_shift) {
+        if (index != last) {
+            memcpy(ecs_table_column_get(column, index), 
+                ecs_table_column_get(column, last), column->size);
+        }
+
+        /* Keep one spare chunk, so that a table that repeatedly grows and
+         * shrinks across a chunk boundary does not allocate each time. */
+        trim_chunks(column, last, 1);
+    } else if (index != last) {
+        ecs_vector_params_t params = column_params(column);
+        ecs_vector_remove_index(column->data, &params, index);
+    } else {
+        ecs_vector_remove_last(column->data);
+    }
+}
+
+/** Make sure column can store count rows without allocating */
+static
+void column_set_size(
+    ecs_table_column_t *column,
+    uint32_t count)
+{
+    if (column->chunk_shift) {
+        reserve_chunks(column, count);
+    } else {
+        ecs_vector_params_t params = column_params(column);
+        uint32_t size = ecs_vector_set_size(&column->data, &params, count);
+        ecs_assert(size != 0, ECS_INTERNAL_ERROR, NULL);
+        (void)size;
+    }
+}
+
+/** Set the number of rows in a column. For chunked columns, the number of rows
+ * is stored in the entity column, so only storage is allocated. */
+static
+void column_set_count(
+    ecs_table_column_t *column,
+    uint32_t count)
+{
+    if (column->chunk_shift) {
+        reserve_chunks(column, count);
+    } else {
+        ecs_vector_params_t params = column_params(column);
+        ecs_vector_set_count(&column->data, &params, count);
+    }
+}
+
+/** Release memory that is not used to store count rows. Returns true if the
+ * existing data in the column was moved to a different address. */
+static
+bool column_reclaim(
+    ecs_table_column_t *column,
+    uint32_t count)
+{
+    if (!column->data) {
+        return false;
+    }
+
+    if (column->chunk_shift) {
+        trim_chunks(column, count, 0);
+        ecs_vector_reclaim(&column->data, &chunk_arr_params);
+        return false;
+    }
+
+    ecs_vector_params_t params = column_params(column);
+
+    void *old_vector = column->data;
+    ecs_vector_reclaim(&column->data, &params);
+
+    return old_vector != column->data;
+}
+
+/** Copy rows between two columns, which do not need to use the same storage */
+static
+void column_copy(
+    ecs_table_column_t *dst,
+    uint32_t dst_index,
+    ecs_table_column_t *src,
+    uint32_t src_index,
+    uint32_t count)
+{
+    uint32_t size = dst->size;
+
+    while (count) {
+        uint32_t n = ecs_table_column_contiguous(dst, dst_index, count);
+        n = ecs_table_column_contiguous(src, src_index, n);
+
+        memcpy(ecs_table_column_get(dst, dst_index), 
+            ecs_table_column_get(src, src_index), size * n);
+
+        dst_index += n;
+        src_index += n;
+        count -= n;
+    }
+}
+
+/** Remove n rows starting at index from a column with count rows. The gap is
+ * filled with the last rows of the column, so that (as with deleting a single
+ * row) at most n rows have to be moved. */
+static
+void column_remove_range(
+    ecs_table_column_t *column,
+    uint32_t count,
+    uint32_t index,
+    uint32_t n)
+{
+    uint32_t tail = count - index - n;
+    uint32_t moved = tail < n ? tail : n;
+    uint32_t new_count = count - n;
+
+    if (moved) {
+        column_copy(column, index, column, count - moved, moved);
+    }
+
+    if (column->chunk_shift) {
+        trim_chunks(column, new_count, 1);
+    } else {
+        column_set_count(column, new_count);
+    }
+}
+
+/** Copy the enabled state of row src to row dst for all bitsets of a table */
+static
+void bitsets_copy(
+    ecs_table_t *table,
+    uint32_t dst,
+    uint32_t src)
+{
+    ecs_table_bitset_t *bitsets = ecs_vector_first(table->bitsets);
+    uint32_t i, count = ecs_vector_count(table->bitsets);
+
+    for (i = 0; i < count; i ++) {
+        ecs_table_bitset_set(
+            &bitsets[i], dst, ecs_table_bitset_get(&bitsets[i], src));
+    }
+}
+
+/** Enable rows from index up to (not including) end for all bitsets */
+static
+void bitsets_clear(
+    ecs_table_t *table,
+    uint32_t index,
+    uint32_t end)
+{
+    ecs_table_bitset_t *bitsets = ecs_vector_first(table->bitsets);
+    uint32_t i, row, count = ecs_vector_count(table->bitsets);
+
+    for (i = 0; i < count; i ++) {
+        if (!index) {
+            ecs_vector_clear(bitsets[i].words);
+        } else {
+            for (row = index; row < end; row ++) {
+                ecs_table_bitset_set(&bitsets[i], row, false);
+            }
+        }
+    }
+}
+
+/** Same as column_remove_range, for the bitsets of a table */
+static
+void bitsets_remove_range(
+    ecs_table_t *table,
+    uint32_t count,
+    uint32_t index,
+    uint32_t n)
+{
+    if (!table->bitsets) {
+        return;
+    }
+
+    uint32_t tail = count - index - n;
+    uint32_t i, moved = tail < n ? tail : n;
+
+    for (i = 0; i < moved; i ++) {
+        bitsets_copy(table, index + i, count - moved + i);
+    }
+
+    bitsets_clear(table, count - n, count);
+}
+
+static
+void bitsets_free(
+    ecs_table_t *table)
+{
+    ecs_table_bitset_t *bitsets = ecs_vector_first(table->bitsets);
+    uint32_t i, count = ecs_vector_count(table->bitsets);
+
+    for (i = 0; i < count; i ++) {
+        ecs_vector_free(bitsets[i].words);
+    }
+
+    ecs_vector_free(table->bitsets);
+    table->bitsets = NULL;
+}
+
+/** Return index of lowest bit that is set in word */
+static
+uint32_t first_bit(
+    uint64_t word)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(word);
+#else
+    uint32_t result = 0;
+    while (!(word & 1)) {
+        word >>= 1;
+        result ++;
+    }
+    return result;
+#endif
+}
+
+/** Return disabled rows in a word for any of the provided bitsets */
+static
+uint64_t bitsets_word(
+    ecs_table_bitset_t **bitsets,
+    uint32_t count,
+    uint32_t word)
+{
+    uint64_t result = 0;
+    uint32_t i;
+
+    for (i = 0; i < count; i ++) {
+        ecs_vector_t *words = bitsets[i]->words;
+        if (word < ecs_vector_count(words)) {
+            result |= ((uint64_t*)ecs_vector_first(words))[word];
+        }
+    }
+
+    return result;
+}
+
 /* -- Private functions -- */
 
 ecs_table_column_t* ecs_table_get_columns(
@@ -76,8 +448,9 @@ ecs_table_column_t* ecs_table_get_columns(
         ecs_table_column_t *columns;
 
         if (!ecs_map_has(stage->data_stage, (uintptr_t)type, &columns)) {
+            /* Staged columns are released when the stage is merged */
             ecs_type_t type = table->type;
-            columns = new_columns(world, stage, table, type);
+            columns = new_columns(world, stage, table, type, stage->arena);
             ecs_map_set(stage->data_stage, (uintptr_t)type, &columns);
         }
 
@@ -91,8 +464,21 @@ void ecs_table_init(
     ecs_table_t *table)
 {
     table->frame_systems = NULL;
+    table->edges = NULL;
+    table->bitsets = NULL;
+    table->bloom = ecs_type_bloom(table->type);
     table->flags = 0;
-    table->columns = new_columns(world, stage, table, table->type);
+    table->low_occupancy_frames = 0;
+    table->empty_frames = 0;
+    table->columns = new_columns(world, stage, table, table->type, 
+        ecs_stage_get_slab(world, stage));
+
+    /* Only tables in the main stage are chunked. Tables in other stages are
+     * temporary, and their data is merged into the main stage. */
+    if (world->table_chunk_size && stage == &world->main_stage) {
+        set_chunked(table->columns, ecs_vector_count(table->type), 
+            world->table_chunk_size);
+    }
 }
 
 void ecs_table_deinit(
@@ -114,9 +500,10 @@ void ecs_table_free_columns(
     uint32_t i, column_count = ecs_vector_count(table->type);
     
     for (i = 0; i < column_count + 1; i ++) {
-        ecs_vector_free(table->columns[i].data);
-        table->columns[i].data = NULL;
+        ecs_table_column_free(&table->columns[i]);
     }
+
+    bitsets_free(table);
 }
 
 void ecs_table_clear(
@@ -127,14 +514,113 @@ void ecs_table_clear(
     ecs_table_free_columns(table);
 }
 
+void ecs_table_shrink(
+    ecs_world_t *world,
+    ecs_table_t *table)
+{
+    ecs_table_column_t *columns = table->columns;
+    uint32_t count = ecs_vector_count(columns[0].data);
+
+    table->low_occupancy_frames = 0;
+
+    /* If table is empty, release all memory. No systems can have references to
+     * components in an empty table, so references don't need to be resolved */
+    if (!count) {
+        ecs_table_free_columns(table);
+        return;
+    }
+
+    ecs_vector_reclaim(&columns[0].data, &handle_arr_params);
+
+    uint32_t i, column_count = ecs_vector_count(table->type);
+    bool reallocd = false;
+
+    for (i = 1; i < column_count + 1; i ++) {
+        if (columns[i].size) {
+            reallocd |= column_reclaim(&columns[i], count);
+        }
+    }
+
+    if (reallocd) {
+        world->should_resolve = true;
+    }
+}
+
 void ecs_table_free(
     ecs_world_t *world,
     ecs_table_t *table)
 {
     (void)world;
     ecs_table_free_columns(table);
-    ecs_os_free(table->columns);
+    ecs_slab_release(table->columns[0].slab, table->columns);
     ecs_vector_free(table->frame_systems);
+
+    if (table->edges) {
+        ecs_map_free(table->edges);
+    }
+}
+
+ecs_table_t* ecs_table_get_edge(
+    ecs_table_t *table,
+    ecs_entity_t component,
+    bool is_add)
+{
+    if (!table->edges) {
+        return NULL;
+    }
+
+    ecs_table_edge_t *edge = ecs_map_get_ptr(table->edges, component);
+    if (!edge) {
+        return NULL;
+    }
+
+    return is_add ? edge->add : edge->remove;
+}
+
+void ecs_table_set_edge(
+    ecs_world_t *world,
+    ecs_table_t *table,
+    ecs_entity_t component,
+    ecs_table_t *dst_table,
+    bool is_add)
+{
+    if (!table->edges) {
+        table->edges = ecs_map_new_w_slab(
+            0, sizeof(ecs_table_edge_t), world->slab);
+    }
+
+    ecs_table_edge_t *edge = ecs_map_get_ptr(table->edges, component);
+    if (!edge) {
+        edge = _ecs_map_set(
+            table->edges, component, NULL, sizeof(ecs_table_edge_t));
+    }
+
+    if (is_add) {
+        edge->add = dst_table;
+    } else {
+        edge->remove = dst_table;
+    }
+}
+
+void ecs_table_clear_garbage_edges(
+    ecs_table_t *table)
+{
+    if (!table->edges) {
+        return;
+    }
+
+    ecs_map_iter_t it = ecs_map_iter(table->edges);
+    while (ecs_map_hasnext(&it)) {
+        ecs_table_edge_t *edge = ecs_map_next(&it);
+
+        if (edge->add && edge->add->flags & EcsTableIsGarbage) {
+            edge->add = NULL;
+        }
+
+        if (edge->remove && edge->remove->flags & EcsTableIsGarbage) {
+            edge->remove = NULL;
+        }
+    }
 }
 
 void ecs_table_register_system(
@@ -160,31 +646,24 @@ uint32_t ecs_table_insert(
     uint32_t column_count = ecs_vector_count(table->type);
 
     /* Fist add entity to column with entity ids */
-    ecs_entity_t *e = ecs_vector_add(&columns[0].data, &handle_arr_params);
+    ecs_vector_params_t params = column_params(&columns[0]);
+    ecs_entity_t *e = ecs_vector_add(&columns[0].data, &params);
     ecs_assert(e != NULL, ECS_INTERNAL_ERROR, NULL);
 
     *e = entity;
 
+    uint32_t index = ecs_vector_count(columns[0].data) - 1;
+
     /* Add elements to each column array */
     uint32_t i;
     bool reallocd = false;
 
     for (i = 1; i < column_count + 1; i ++) {
-        uint32_t size = columns[i].size;
-        if (size) {
-            ecs_vector_params_t params = {.element_size = size};
-            void *old_vector = columns[i].data;
-
-            ecs_vector_add(&columns[i].data, &params);
-            
-            if (old_vector != columns[i].data) {
-                reallocd = true;
-            }
+        if (columns[i].size) {
+            reallocd |= column_addn(&columns[i], index, 1);
         }
     }
 
-    uint32_t index = ecs_vector_count(columns[0].data) - 1;
-
     if (!world->in_progress && !index) {
         activate_table(world, table, 0, true);
     }
@@ -193,6 +672,8 @@ uint32_t ecs_table_insert(
         world->should_resolve = true;
     }
 
+    columns[0].change_tick = world->change_tick;
+
     /* Return index of last added entity */
     return index + 1;
 }
@@ -231,8 +712,7 @@ void ecs_table_delete(
 
         for (i = 1; i < column_last; i ++) {
             if (columns[i].size) {
-                ecs_vector_params_t params = {.element_size = columns[i].size};
-                ecs_vector_remove_index(columns[i].data, &params, index);
+                column_remove(&columns[i], count + 1, index);
             }
         }
 
@@ -240,7 +720,7 @@ void ecs_table_delete(
         ecs_row_t row;
         row.type = table->type;
         row.index = index + 1;
-        ecs_map_set(world->main_stage.entity_index, to_move, &row);
+        ecs_sparse_set(world->main_stage.entity_index, to_move, &row);
 
         /* Decrease size of entity column */
         ecs_vector_remove_last(entity_column);
@@ -251,16 +731,96 @@ void ecs_table_delete(
 
         for (i = 1; i < column_last; i ++) {
             if (columns[i].size) {
-                ecs_vector_remove_last(columns[i].data);
+                column_remove(&columns[i], count + 1, index);
             }
         }
     }
+
+    bitsets_remove_range(table, count + 1, index, 1);
+    columns[0].change_tick = world->change_tick;
     
     if (!world->in_progress && !count) {
         activate_table(world, table, 0, false);
     }
 }
 
+void ecs_table_delete_n(
+    ecs_world_t *world,
+    ecs_table_t *table,
+    uint32_t *rows,
+    uint32_t count)
+{
+    ecs_table_column_t *columns = table->columns;
+    uint32_t row_count = ecs_vector_count(columns[0].data);
+
+    ecs_assert(count <= row_count, ECS_INTERNAL_ERROR, NULL);
+
+    if (!count) {
+        return;
+    }
+
+    ecs_sparse_t *entity_index = world->main_stage.entity_index;
+    ecs_entity_t *entities = ecs_vector_first(columns[0].data);
+    uint32_t new_count = row_count - count;
+    uint32_t column_count = ecs_vector_count(table->type);
+    uint32_t i, c, last = row_count, last_deleted = count - 1;
+
+    /* Fill deleted rows that are below the new row count with the last rows of
+     * the table that are not deleted. Deleted rows at the end of the table are
+     * skipped. This can't run past the current row, as it is deleted and lower
+     * than any row that is not deleted at the end of the table. */
+    for (i = 0; i < count && rows[i] < new_count; i ++) {
+        uint32_t index = rows[i];
+
+        last --;
+        while (rows[last_deleted] == last) {
+            last_deleted --;
+            last --;
+        }
+
+        ecs_entity_t to_move = entities[last];
+        entities[index] = to_move;
+
+        for (c = 1; c < column_count + 1; c ++) {
+            ecs_table_column_t *column = &columns[c];
+            if (column->size) {
+                memcpy(ecs_table_column_get(column, index),
+                    ecs_table_column_get(column, last), column->size);
+            }
+        }
+
+        if (table->bitsets) {
+            bitsets_copy(table, index, last);
+        }
+
+        ecs_row_t *row = ecs_sparse_get_ptr(entity_index, to_move);
+        ecs_assert(row != NULL, ECS_INTERNAL_ERROR, NULL);
+
+        if (row->index < 0) {
+            row->index = -(index + 1);
+        } else {
+            row->index = index + 1;
+        }
+    }
+
+    /* All rows at or above the new count are either deleted or moved */
+    for (c = 0; c < column_count + 1; c ++) {
+        if (columns[c].size) {
+            column_remove_range(&columns[c], row_count, new_count, count);
+        }
+    }
+
+    if (table->bitsets) {
+        bitsets_clear(table, new_count, row_count);
+    }
+
+    columns[0].change_tick = world->change_tick;
+
+    if (!world->in_progress && !new_count) {
+        activate_table(world, table, 0, false);
+    }
+}
+
 uint32_t ecs_table_grow(
     ecs_world_t *world,
     ecs_table_t *table,
@@ -271,7 +831,8 @@ uint32_t ecs_table_grow(
     uint32_t column_count = ecs_vector_count(table->type);
 
     /* Fist add entity to column with entity ids */
-    ecs_entity_t *e = ecs_vector_addn(&columns[0].data, &handle_arr_params, count);
+    ecs_vector_params_t params = column_params(&columns[0]);
+    ecs_entity_t *e = ecs_vector_addn(&columns[0].data, &params, count);
     ecs_assert(e != NULL, ECS_INTERNAL_ERROR, NULL);
 
     uint32_t i;
@@ -280,23 +841,15 @@ uint32_t ecs_table_grow(
     }
 
     bool reallocd = false;
+    uint32_t row_count = ecs_vector_count(columns[0].data);
 
     /* Add elements to each column array */
     for (i = 1; i < column_count + 1; i ++) {
-        ecs_vector_params_t params = {.element_size = columns[i].size};
-        if (!params.element_size) {
-            continue;
-        }
-        void *old_vector = columns[i].data;
-
-        ecs_vector_addn(&columns[i].data, &params, count);
-
-        if (old_vector != columns[i].data) {
-            reallocd = true;
+        if (columns[i].size) {
+            reallocd |= column_addn(&columns[i], row_count - count, count);
         }
     }
 
-    uint32_t row_count = ecs_vector_count(columns[0].data);
     if (!world->in_progress && row_count == count) {
         activate_table(world, table, 0, true);
     }
@@ -305,6 +858,8 @@ uint32_t ecs_table_grow(
         world->should_resolve = true;
     }
 
+    columns[0].change_tick = world->change_tick;
+
     /* Return index of first added entity */
     return row_count - count + 1;
 }
@@ -320,20 +875,15 @@ int16_t ecs_table_dim(
 
     uint32_t column_count = ecs_vector_count(table->type);
 
-    uint32_t size = ecs_vector_set_size(
-        &columns[0].data, &handle_arr_params, count);
+    ecs_vector_params_t params = column_params(&columns[0]);
+    uint32_t size = ecs_vector_set_size(&columns[0].data, &params, count);
     ecs_assert(size != 0, ECS_INTERNAL_ERROR, NULL);
     (void)size;
 
     uint32_t i;
     for (i = 1; i < column_count + 1; i ++) {
-        uint32_t column_size = columns[i].size;
-
-        if (column_size) {
-            ecs_vector_params_t params = {.element_size = column_size};
-            uint32_t size = ecs_vector_set_size(&columns[i].data, &params, count);
-            ecs_assert(size != 0, ECS_INTERNAL_ERROR, NULL);
-            (void)size;
+        if (columns[i].size) {
+            column_set_size(&columns[i], count);
         } else {
             ecs_assert(columns[i].data == NULL, ECS_INTERNAL_ERROR, NULL);
         }
@@ -348,6 +898,257 @@ uint64_t ecs_table_count(
     return ecs_vector_count(table->columns[0].data);
 }
 
+void* ecs_table_column_get(
+    ecs_table_column_t *column,
+    uint32_t index)
+{
+    uint8_t shift = column->chunk_shift;
+
+    if (!shift) {
+        ecs_vector_params_t params = {.element_size = column->size};
+        return ecs_vector_get(column->data, &params, index);
+    }
+
+    ecs_assert(index >> shift < ecs_vector_count(column->data), 
+        ECS_INTERNAL_ERROR, NULL);
+
+    ecs_vector_t **chunks = ecs_vector_first(column->data);
+    void *buffer = ecs_vector_first(chunks[index >> shift]);
+    return ECS_OFFSET(buffer, column->size * (index & ((1 << shift) - 1)));
+}
+
+uint32_t ecs_table_column_contiguous(
+    ecs_table_column_t *column,
+    uint32_t index,
+    uint32_t count)
+{
+    uint8_t shift = column->chunk_shift;
+
+    if (!shift) {
+        return count;
+    }
+
+    uint32_t left = (1 << shift) - (index & ((1 << shift) - 1));
+    return left < count ? left : count;
+}
+
+uint32_t ecs_table_contiguous(
+    ecs_table_t *table,
+    ecs_table_column_t *columns,
+    uint32_t index,
+    uint32_t count)
+{
+    uint32_t i, column_count = ecs_vector_count(table->type);
+
+    /* All columns with data in a table use the same chunk size */
+    for (i = 1; i < column_count + 1; i ++) {
+        if (columns[i].size) {
+            return ecs_table_column_contiguous(&columns[i], index, count);
+        }
+    }
+
+    return count;
+}
+
+void ecs_table_column_free(
+    ecs_table_column_t *column)
+{
+    if (column->chunk_shift) {
+        ecs_vector_t **chunks = ecs_vector_first(column->data);
+        uint32_t i, count = ecs_vector_count(column->data);
+        for (i = 0; i < count; i ++) {
+            ecs_vector_free(chunks[i]);
+        }
+    }
+
+    ecs_vector_free(column->data);
+    column->data = NULL;
+}
+
+void ecs_table_mark_changed(
+    ecs_world_t *world,
+    ecs_table_t *table,
+    ecs_table_column_t *columns)
+{
+    uint32_t i, column_count = ecs_vector_count(table->type);
+
+    for (i = 0; i < column_count + 1; i ++) {
+        columns[i].change_tick = world->change_tick;
+    }
+}
+
+ecs_table_bitset_t* ecs_table_get_bitset(
+    ecs_table_t *table,
+    ecs_entity_t component,
+    bool create)
+{
+    ecs_table_bitset_t *bitsets = ecs_vector_first(table->bitsets);
+    uint32_t i, count = ecs_vector_count(table->bitsets);
+
+    for (i = 0; i < count; i ++) {
+        if (bitsets[i].component == component) {
+            return &bitsets[i];
+        }
+    }
+
+    if (!create) {
+        return NULL;
+    }
+
+    ecs_table_bitset_t *result = ecs_vector_add(
+        &table->bitsets, &bitset_arr_params);
+    result->component = component;
+    result->words = NULL;
+
+    return result;
+}
+
+bool ecs_table_bitset_get(
+    ecs_table_bitset_t *bitset,
+    uint32_t row)
+{
+    uint32_t word = row >> 6;
+
+    if (word >= ecs_vector_count(bitset->words)) {
+        return false;
+    }
+
+    uint64_t *words = ecs_vector_first(bitset->words);
+    return (words[word] >> (row & 63)) & 1;
+}
+
+void ecs_table_bitset_set(
+    ecs_table_bitset_t *bitset,
+    uint32_t row,
+    bool disabled)
+{
+    uint32_t word = row >> 6;
+    uint32_t count = ecs_vector_count(bitset->words);
+
+    if (word >= count) {
+        /* Rows that are not covered by words are enabled */
+        if (!disabled) {
+            return;
+        }
+
+        uint64_t *added = ecs_vector_addn(
+            &bitset->words, &word_arr_params, word - count + 1);
+        memset(added, 0, (word - count + 1) * sizeof(uint64_t));
+    }
+
+    uint64_t *words = ecs_vector_first(bitset->words);
+    uint64_t mask = (uint64_t)1 << (row & 63);
+
+    if (disabled) {
+        words[word] |= mask;
+    } else {
+        words[word] &= ~mask;
+    }
+}
+
+void ecs_table_copy_bitsets(
+    ecs_table_t *dst_table,
+    uint32_t dst_row,
+    ecs_table_t *src_table,
+    uint32_t src_row)
+{
+    ecs_table_bitset_t *bitsets = ecs_vector_first(src_table->bitsets);
+    uint32_t i, count = ecs_vector_count(src_table->bitsets);
+
+    for (i = 0; i < count; i ++) {
+        ecs_entity_t component = bitsets[i].component;
+
+        if (!ecs_table_bitset_get(&bitsets[i], src_row)) {
+            continue;
+        }
+
+        /* The enabled state of a component is lost when it is removed */
+        if (component && ecs_type_index_of(dst_table->type, component) == -1) {
+            continue;
+        }
+
+        ecs_table_bitset_t *dst = ecs_table_get_bitset(
+            dst_table, component, true);
+        ecs_table_bitset_set(dst, dst_row, true);
+    }
+}
+
+uint32_t ecs_table_enabled_range(
+    ecs_table_bitset_t **bitsets,
+    uint32_t count,
+    uint32_t *row,
+    uint32_t end)
+{
+    uint32_t first = *row;
+
+    /* Skip disabled rows a word at a time */
+    while (first < end) {
+        uint32_t word = first >> 6;
+        uint64_t enabled = ~bitsets_word(bitsets, count, word) & 
+            (~(uint64_t)0 << (first & 63));
+
+        if (enabled) {
+            first = (word << 6) + first_bit(enabled);
+            break;
+        }
+
+        first = (word + 1) << 6;
+    }
+
+    if (first >= end) {
+        *row = end;
+        return 0;
+    }
+
+    /* Find the first disabled row after the first enabled row */
+    uint32_t last = first;
+    while (last < end) {
+        uint32_t word = last >> 6;
+        uint64_t disabled = bitsets_word(bitsets, count, word) & 
+            (~(uint64_t)0 << (last & 63));
+
+        if (disabled) {
+            last = (word << 6) + first_bit(disabled);
+            break;
+        }
+
+        last = (word + 1) << 6;
+    }
+
+    if (last > end) {
+        last = end;
+    }
+
+    *row = first;
+    return last - first;
+}
+
+void ecs_table_column_memory(
+    ecs_table_column_t *column,
+    uint32_t count,
+    uint32_t *allocd,
+    uint32_t *used)
+{
+    ecs_vector_params_t params = column_params(column);
+
+    if (!column->chunk_shift) {
+        ecs_vector_memory(column->data, &params, allocd, used);
+        return;
+    }
+
+    ecs_vector_t **chunks = ecs_vector_first(column->data);
+    uint32_t i, chunk_count = ecs_vector_count(column->data);
+
+    ecs_vector_memory(column->data, &chunk_arr_params, allocd, NULL);
+    for (i = 0; i < chunk_count; i ++) {
+        ecs_vector_memory(chunks[i], &params, allocd, NULL);
+    }
+
+    if (used) {
+        *used += count * column->size;
+    }
+}
+
 void ecs_table_swap(
     ecs_stage_t *stage,
     ecs_table_t *table,
@@ -367,37 +1168,51 @@ void ecs_table_swap(
 
     /* Get pointers to records in entity index */
     if (!row_ptr_1) {
-        row_ptr_1 = ecs_map_get_ptr(stage->entity_index, e1);
+        row_ptr_1 = ecs_sparse_get_ptr(stage->entity_index, e1);
     }
 
     if (!row_ptr_2) {
-        row_ptr_2 = ecs_map_get_ptr(stage->entity_index, e2);
+        row_ptr_2 = ecs_sparse_get_ptr(stage->entity_index, e2);
     }
 
-    /* Swap entities */
+    /* Swap entities. Rows in the entity index start from 1, and are negative
+     * if the entity is watched. */
     entities[row_1] = e2;
     entities[row_2] = e1;
-    row_ptr_1->index = row_2;
-    row_ptr_2->index = row_1;
+    row_ptr_1->index = row_ptr_1->index < 0 ? -(row_2 + 1) : row_2 + 1;
+    row_ptr_2->index = row_ptr_2->index < 0 ? -(row_1 + 1) : row_1 + 1;
 
     /* Swap columns */
     uint32_t i, column_count = ecs_vector_count(table->type);
     
     for (i = 0; i < column_count; i ++) {
-        void *data = ecs_vector_first(columns[i + 1].data);
-        uint32_t size = columns[i + 1].size;
+        ecs_table_column_t *column = &columns[i + 1];
+        uint32_t size = column->size;
 
         if (size) {
             void *tmp = _ecs_os_alloca(size, 1);
 
-            void *el_1 = ECS_OFFSET(data, size * row_1);
-            void *el_2 = ECS_OFFSET(data, size * row_2);
+            void *el_1 = ecs_table_column_get(column, row_1);
+            void *el_2 = ecs_table_column_get(column, row_2);
 
             memcpy(tmp, el_1, size);
             memcpy(el_1, el_2, size);
             memcpy(el_2, tmp, size);
         }
     }
+
+    /* Staged columns don't have bitsets */
+    if (table->bitsets && columns == table->columns) {
+        ecs_table_bitset_t *bitsets = ecs_vector_first(table->bitsets);
+        uint32_t count = ecs_vector_count(table->bitsets);
+
+        for (i = 0; i < count; i ++) {
+            bool disabled = ecs_table_bitset_get(&bitsets[i], row_1);
+            ecs_table_bitset_set(&bitsets[i], row_1, 
+                ecs_table_bitset_get(&bitsets[i], row_2));
+            ecs_table_bitset_set(&bitsets[i], row_2, disabled);
+        }
+    }
 }
 
 void ecs_table_move_back_and_swap(
@@ -417,147 +1232,355 @@ void ecs_table_move_back_and_swap(
         ecs_entity_t cur = entities[row + i];
         entities[row + i - 1] = cur;
 
-        ecs_row_t *row_ptr = ecs_map_get_ptr(stage->entity_index, cur);
+        ecs_row_t *row_ptr = ecs_sparse_get_ptr(stage->entity_index, cur);
         row_ptr->index = row + i;
     }
     entities[row + count - 1] = e;
-    ecs_row_t *row_ptr = ecs_map_get_ptr(stage->entity_index, e);
+    ecs_row_t *row_ptr = ecs_sparse_get_ptr(stage->entity_index, e);
     row_ptr->index = row + count - 1;
 
     /* Move back and swap columns */
     uint32_t column_count = ecs_vector_count(table->type);
     
     for (i = 0; i < column_count; i ++) {
-        void *data = ecs_vector_first(columns[i + 1].data);
-        uint32_t size = columns[i + 1].size;
+        ecs_table_column_t *column = &columns[i + 1];
+        uint32_t size = column->size;
 
         if (size) {
             /* Backup first element */
             void *tmp = _ecs_os_alloca(size, 1);
-            void *el = ECS_OFFSET(data, size * row);
+            void *el = ecs_table_column_get(column, row);
             memcpy(tmp, el, size);
 
             /* Move component values */
             for (i = 0; i < count; i ++) {
-                void *dst = ECS_OFFSET(data, size * (row + i - 1));
-                void *src = ECS_OFFSET(data, size * (row + i));
+                void *dst = ecs_table_column_get(column, row + i - 1);
+                void *src = ecs_table_column_get(column, row + i);
                 memcpy(dst, src, size);
             }
 
             /* Move first element to last element */
-            void *dst = ECS_OFFSET(data, size * (row + count - 1));
+            void *dst = ecs_table_column_get(column, row + count - 1);
             memcpy(dst, tmp, size);
         }
     }
+
+    if (table->bitsets && columns == table->columns) {
+        ecs_table_bitset_t *bitsets = ecs_vector_first(table->bitsets);
+        uint32_t b, bitset_count = ecs_vector_count(table->bitsets);
+
+        for (b = 0; b < bitset_count; b ++) {
+            bool disabled = ecs_table_bitset_get(&bitsets[b], row - 1);
+            for (i = 0; i < count; i ++) {
+                ecs_table_bitset_set(&bitsets[b], row + i - 1, 
+                    ecs_table_bitset_get(&bitsets[b], row + i));
+            }
+            ecs_table_bitset_set(&bitsets[b], row + count - 1, disabled);
+        }
+    }
 }
 
-void ecs_table_merge(
-    ecs_world_t *world,
-    ecs_table_t *new_table,
-    ecs_table_t *old_table)
+/** Compare two rows of a column with the sort comparator */
+static
+int compare_rows(
+    ecs_entity_t *entities,
+    ecs_table_column_t *column,
+    ecs_compare_action_t compare,
+    uint32_t row_1,
+    uint32_t row_2)
+{
+    return compare(
+        entities[row_1], ecs_table_column_get(column, row_1),
+        entities[row_2], ecs_table_column_get(column, row_2));
+}
+
+/** Stable (bottom-up merge) sort of the row numbers in rows. The sort is
+ * stable so that rows with equal values do not move each time a table is
+ * sorted. */
+static
+void sort_rows(
+    ecs_entity_t *entities,
+    ecs_table_column_t *column,
+    ecs_compare_action_t compare,
+    uint32_t *rows,
+    uint32_t *tmp,
+    uint32_t count)
 {
-    ecs_assert(old_table != NULL, ECS_INTERNAL_ERROR, NULL);
-    ecs_assert(new_table != old_table, ECS_INTERNAL_ERROR, NULL);
+    uint32_t width, i;
 
-    ecs_type_t new_type = new_table ? new_table->type : NULL;
-    ecs_type_t old_type = old_table->type;
-    ecs_assert(new_type != old_type, ECS_INTERNAL_ERROR, NULL);
+    for (width = 1; width < count; width *= 2) {
+        for (i = 0; i < count; i += 2 * width) {
+            uint32_t mid = i + width, right = i + 2 * width;
+            if (mid > count) {
+                mid = count;
+            }
+            if (right > count) {
+                right = count;
+            }
 
-    ecs_table_column_t *new_columns = new_table ? new_table->columns : NULL;
-    ecs_table_column_t *old_columns = old_table->columns;
-    ecs_assert(old_columns != NULL, ECS_INTERNAL_ERROR, NULL);
+            uint32_t l = i, r = mid, k = i;
+            while (l < mid && r < right) {
+                if (compare_rows(
+                    entities, column, compare, rows[r], rows[l]) < 0) 
+                {
+                    tmp[k ++] = rows[r ++];
+                } else {
+                    tmp[k ++] = rows[l ++];
+                }
+            }
 
-    uint32_t old_count = old_columns->data ? ecs_vector_count(old_columns->data) : 0;
-    uint32_t new_count = 0;
-    if (new_columns) {
-        new_count = new_columns->data ? ecs_vector_count(new_columns->data) : 0;
+            while (l < mid) {
+                tmp[k ++] = rows[l ++];
+            }
+            while (r < right) {
+                tmp[k ++] = rows[r ++];
+            }
+        }
+
+        memcpy(rows, tmp, count * sizeof(uint32_t));
     }
+}
 
-    /* First, update entity index so old entities point to new type */
-    ecs_entity_t *old_entities = ecs_vector_first(old_columns[0].data);
-    uint32_t i;
-    for(i = 0; i < old_count; i ++) {
-        ecs_row_t row = {.type = new_type, .index = i + new_count};
-        ecs_map_set(world->main_stage.entity_index, old_entities[i], &row);
+bool ecs_table_sort(
+    ecs_world_t *world,
+    ecs_table_t *table,
+    ecs_entity_t component,
+    ecs_compare_action_t compare)
+{
+    ecs_table_column_t *columns = table->columns;
+    uint32_t i, count = ecs_vector_count(columns[0].data);
+
+    if (count < 2) {
+        return false;
     }
 
-    if (!new_table) {
-        ecs_table_clear(world, old_table);
-        return;
+    /* Tables that don't own the component can't be sorted by it */
+    int16_t index = ecs_type_index_of(table->type, component);
+    if (index == -1 || !columns[index + 1].size) {
+        return false;
     }
 
-    uint16_t i_new, new_component_count = ecs_vector_count(new_type);
-    uint16_t i_old = 0, old_component_count = ecs_vector_count(old_type);
-    ecs_entity_t *new_components = ecs_vector_first(new_type);
-    ecs_entity_t *old_components = ecs_vector_first(old_type);
+    ecs_table_column_t *column = &columns[index + 1];
+    ecs_entity_t *entities = ecs_vector_first(columns[0].data);
 
-    if (!old_count) {
-        return;
+    /* Tables are typically sorted already, or only a few rows changed since
+     * the last sort, so test first if there is anything to do */
+    for (i = 1; i < count; i ++) {
+        if (compare_rows(entities, column, compare, i - 1, i) > 0) {
+            break;
+        }
     }
 
-    for (i_new = 0; i_new <= new_component_count; ) {
-        if (i_old == old_component_count) {
-            break;
+    if (i == count) {
+        return false;
+    }
+
+    /* Sort the row numbers, then swap rows into place. The pos and at arrays
+     * track where the rows are while they are swapped, so that each row moves
+     * at most once. */
+    uint32_t *buffer = ecs_os_malloc(4 * count * sizeof(uint32_t));
+    ecs_assert(buffer != NULL, ECS_OUT_OF_MEMORY, NULL);
+
+    uint32_t *rows = buffer;
+    uint32_t *pos = &buffer[count];
+    uint32_t *at = &buffer[2 * count];
+
+    for (i = 0; i < count; i ++) {
+        rows[i] = i;
+        pos[i] = i;
+        at[i] = i;
+    }
+
+    sort_rows(entities, column, compare, rows, &buffer[3 * count], count);
+
+    for (i = 0; i < count; i ++) {
+        uint32_t row = rows[i], cur = pos[row];
+
+        if (cur != i) {
+            ecs_table_swap(
+                &world->main_stage, table, columns, i, cur, NULL, NULL);
+
+            uint32_t swapped = at[i];
+            at[cur] = swapped;
+            pos[swapped] = cur;
+            at[i] = row;
+            pos[row] = i;
         }
+    }
+
+    ecs_os_free(buffer);
 
-        ecs_entity_t new_component = 0;
-        ecs_entity_t old_component = 0;
-        uint32_t size = 0;
+    /* References to components of entities in the table are no longer valid */
+    world->should_resolve = true;
+    columns[0].change_tick = world->change_tick;
 
-        if (i_new) {
-            new_component = new_components[i_new - 1];
-            old_component = old_components[i_old - 1];
-            size = new_columns[i_new].size;
+    return true;
+}
+
+uint32_t ecs_table_move(
+    ecs_world_t *world,
+    ecs_table_t *dst_table,
+    ecs_table_t *src_table,
+    uint32_t offset,
+    uint32_t count)
+{
+    ecs_assert(src_table != NULL, ECS_INTERNAL_ERROR, NULL);
+    ecs_assert(dst_table != src_table, ECS_INTERNAL_ERROR, NULL);
+    ecs_assert(!world->in_progress, ECS_INTERNAL_ERROR, NULL);
+
+    ecs_table_column_t *src_columns = src_table->columns;
+    uint32_t src_count = ecs_vector_count(src_columns[0].data);
+    ecs_assert(offset + count <= src_count, ECS_INTERNAL_ERROR, NULL);
+
+    if (!count) {
+        return 0;
+    }
+
+    ecs_type_t src_type = src_table->type;
+    ecs_type_t dst_type = dst_table ? dst_table->type : NULL;
+    ecs_entity_t *src_entities = ecs_vector_first(src_columns[0].data);
+    uint32_t dst_count = 0;
+
+    /* If all rows are moved to an empty table, the columns of the source table
+     * can be moved to the destination table without copying */
+    bool move_all = offset == 0 && count == src_count;
+
+    if (dst_table) {
+        ecs_table_column_t *dst_columns = dst_table->columns;
+        dst_count = ecs_vector_count(dst_columns[0].data);
+        bool steal = move_all && !dst_count;
+
+        if (steal) {
+            ecs_table_column_free(&dst_columns[0]);
+            dst_columns[0].data = src_columns[0].data;
+            src_columns[0].data = NULL;
         } else {
-            size = sizeof(ecs_entity_t);
+            ecs_vector_params_t params = column_params(&dst_columns[0]);
+            ecs_entity_t *e = ecs_vector_addn(
+                &dst_columns[0].data, &params, count);
+            memcpy(e, &src_entities[offset], count * sizeof(ecs_entity_t));
         }
 
-        if ((new_component & ECS_ENTITY_FLAGS_MASK) || 
-            (old_component & ECS_ENTITY_FLAGS_MASK)) 
-        {
-            break;
-        }
+        ecs_entity_t *dst_components = ecs_vector_first(dst_type);
+        ecs_entity_t *src_components = ecs_vector_first(src_type);
+        uint32_t i_dst, dst_column_count = ecs_vector_count(dst_type);
+        uint32_t i_src = 0, src_column_count = ecs_vector_count(src_type);
+        bool reallocd = false;
+
+        /* Walk both (sorted) types, and copy the columns that occur in both
+         * tables with one copy per contiguous range of rows */
+        for (i_dst = 0; i_dst < dst_column_count; i_dst ++) {
+            ecs_entity_t component = dst_components[i_dst];
+            ecs_table_column_t *dst = &dst_columns[i_dst + 1];
+
+            while (i_src < src_column_count && 
+                src_components[i_src] < component) 
+            {
+                i_src ++;
+            }
 
-        if (new_component == old_component) {
-            /* If the new table is empty, move column to new table */
-            if (!new_count) {
-                if (new_columns[i_new].data) {
-                    ecs_vector_free(new_columns[i_new].data);
-                }
-                new_columns[i_new].data = old_columns[i_old].data;
-                old_columns[i_old].data = NULL;
-            
-            /* If the new table is not empty, copy the contents from the
-             * smallest into the largest vector. */
+            if (!dst->size) {
+                continue;
+            }
+
+            ecs_table_column_t *src = NULL;
+            if (i_src < src_column_count && src_components[i_src] == component) {
+                src = &src_columns[i_src + 1];
+            }
+
+            if (src && steal && dst->chunk_shift == src->chunk_shift) {
+                ecs_table_column_free(dst);
+                dst->data = src->data;
+                src->data = NULL;
+                reallocd = true;
             } else {
-                ecs_vector_t *dst = new_columns[i_new].data;
-                ecs_vector_t *src = old_columns[i_old].data;
+                reallocd |= column_addn(dst, dst_count, count);
+                if (src) {
+                    column_copy(dst, dst_count, src, offset, count);
+                }
+            }
+        }
+
+        if (src_table->bitsets) {
+            uint32_t r;
+            for (r = 0; r < count; r ++) {
+                ecs_table_copy_bitsets(
+                    dst_table, dst_count + r, src_table, offset + r);
+            }
+        }
 
-                ecs_vector_params_t params = {.element_size = size};
-                ecs_vector_set_count(&dst, &params, new_count + old_count);
-                
-                void *dst_ptr = ecs_vector_first(dst);
-                void *src_ptr = ecs_vector_first(src);
+        dst_columns[0].change_tick = world->change_tick;
 
-                dst_ptr = ECS_OFFSET(dst_ptr, size * old_count);
-                memcpy(dst_ptr, src_ptr, size * old_count);
+        if (!dst_count) {
+            activate_table(world, dst_table, 0, true);
+        }
+
+        if (reallocd) {
+            world->should_resolve = true;
+        }
+    }
 
-                ecs_vector_free(src);
-                old_columns[i_old].data = NULL;
-                new_columns[i_new].data = dst;
+    /* Update the entity index of the moved entities in a single pass */
+    ecs_sparse_t *entity_index = world->main_stage.entity_index;
+    uint32_t i;
+
+    for (i = 0; i < count; i ++) {
+        ecs_row_t *row = ecs_sparse_get_ptr(
+            entity_index, src_entities[offset + i]);
+        ecs_assert(row != NULL, ECS_INTERNAL_ERROR, NULL);
+
+        bool is_watched = row->index < 0;
+
+        if (dst_type) {
+            row->type = dst_type;
+            row->index = dst_count + i + 1;
+            if (is_watched) {
+                row->index *= -1;
+                ecs_world_watch_changed(
+                    world, src_entities[offset + i], src_type, dst_type);
             }
-            
-            i_new ++;
-            i_old ++;
-        } else if (new_component < old_component) {
-            /* This should not happen. A table should never be merged to
-             * another table of which the type is not a subset. */
-            ecs_abort(ECS_INTERNAL_ERROR, NULL);
-        } else if (new_component > old_component) {
-            /* Old column does not occur in new table, remove */
-            ecs_vector_free(old_columns[i_old].data);
-            old_columns[i_old].data = NULL;
-            i_old ++;
+        } else {
+            *row = (ecs_row_t){0, 0};
         }
     }
+
+    /* Remove the rows from the source table */
+    if (move_all) {
+        ecs_table_free_columns(src_table);
+    } else {
+        /* Fill the gap with the last rows of the table */
+        uint32_t tail = src_count - offset - count;
+        uint32_t moved = tail < count ? tail : count;
+        uint32_t column_count = ecs_vector_count(src_type);
+
+        for (i = 0; i < column_count + 1; i ++) {
+            if (src_columns[i].size) {
+                column_remove_range(&src_columns[i], src_count, offset, count);
+            }
+        }
+
+        bitsets_remove_range(src_table, src_count, offset, count);
+
+        src_entities = ecs_vector_first(src_columns[0].data);
+        for (i = 0; i < moved; i ++) {
+            ecs_row_t *row = ecs_sparse_get_ptr(
+                entity_index, src_entities[offset + i]);
+            ecs_assert(row != NULL, ECS_INTERNAL_ERROR, NULL);
+
+            if (row->index < 0) {
+                row->index = -(offset + i + 1);
+            } else {
+                row->index = offset + i + 1;
+            }
+        }
+    }
+
+    src_columns[0].change_tick = world->change_tick;
+
+    if (count == src_count) {
+        activate_table(world, src_table, 0, false);
+    }
+
+    /* Return index of first moved entity in destination table */
+    return dst_count + 1;
 }
@@ -4,23 +4,11 @@ const ecs_vector_params_t char_arr_params = {
     .element_size = sizeof(char)
 };
 
-const ecs_vector_params_t type_node_params = {
-    .element_size = sizeof(ecs_type_node_t)
-};
-
-const ecs_vector_params_t ptr_params = {
-    .element_size = sizeof(void*)
-};
-
-const ecs_vector_params_t link_params = {
-    .element_size = sizeof(ecs_type_link_t*)
-};
-
 static
 ecs_type_t find_or_create_type(
     ecs_world_t *world,
     ecs_stage_t *stage,
-    ecs_type_node_t *root,
+    ecs_type_db_t *db,
     ecs_entity_t *array,
     uint32_t count,
     bool create,
@@ -174,11 +162,11 @@ ecs_type_t ecs_type_from_array(
  * prefabs / containers) become more expensive (O(1) to O(n)).
  * To move this complexity out of the main loop, the algorithm that ensures each
  * entity only occurs once in a type (this function) is only performed when a
- * new type is registered. The result of this operation is that the type tree
+ * new type is registered. The result of this operation is that the type database
  * contains an entry for the non-normalized type which points to the normalized
  * type. This ensures that a type merge can produce a non-normalized array,
  * which when looked up, is guaranteed to return a normalized type.
- * This results in some extra memory usage for extra entries in the type tree.
+ * This results in some extra memory usage for extra entries in the database.
  * For example, a type [A] may occur multiple times:
  *
  * - [A]
@@ -230,8 +218,12 @@ ecs_type_t ecs_type_from_array_normalize(
         }
     }
 
+    /* Always register normalized types in the main stage. Stages other than
+     * the main stage do not own their type database, and types are referenced
+     * after the stage they were created in is merged. */
     return find_or_create_type(
-        world, stage, &stage->type_root, dst_array, dst_count, true, true);
+        world, stage, &world->main_stage.type_db, dst_array, dst_count, 
+        true, true);
 }
 
 static
@@ -253,29 +245,23 @@ void mark_parents(
     }   
 }
 
+/** Register a new normalized type */
 static
 ecs_type_t register_type(
     ecs_world_t *world,
     ecs_stage_t *stage,
     ecs_type_link_t *link,
     ecs_entity_t *array,
-    uint32_t count,
-    bool normalized)
+    uint32_t count)
 {
     ecs_assert(stage != NULL, ECS_INTERNAL_ERROR, NULL);
     ecs_assert(count < ECS_MAX_ENTITIES_IN_TYPE, ECS_TYPE_TOO_LARGE, NULL);
 
-    ecs_type_t result;
-    bool has_flags = (array[count - 1] & ECS_ENTITY_FLAGS_MASK) != 0;
-    
-    if (!normalized && has_flags) {
-        result = ecs_type_from_array_normalize(world, stage, array, count);
-    } else {
-        result = ecs_type_from_array(array, count);
+    ecs_type_t result = ecs_type_from_array(array, count);
+    ecs_assert(result != NULL, ECS_INTERNAL_ERROR, NULL);
 
-        if (has_flags) {
-            mark_parents(world, stage, array, count);
-        }
+    if (array[count - 1] & ECS_ENTITY_FLAGS_MASK) {
+        mark_parents(world, stage, array, count);
     }
 
     link->type = result;
@@ -289,156 +275,174 @@ ecs_type_t register_type(
     stage->last_link->next = link;
     stage->last_link = link;
 
-    ecs_assert(result != NULL, ECS_INTERNAL_ERROR, NULL);
-
     notify_systems_of_type(world, stage, result);
     
     return result;
 }
 
 static
-ecs_type_t find_type_in_vector(
-    ecs_world_t *world,
-    ecs_stage_t *stage,
-    ecs_vector_t **vector,
+bool entry_has_own_key(
+    ecs_type_entry_t *entry)
+{
+    return entry->key == (ecs_entity_t*)(entry + 1);
+}
+
+/** Find slot for an entry. Returns an empty slot if the entry does not exist */
+static
+ecs_type_entry_t** find_slot(
+    ecs_type_db_t *db,
     ecs_entity_t *array,
     uint32_t count,
-    bool create,
-    bool normalized)
+    uint32_t hash)
 {
-    uint32_t i, types_count = ecs_vector_count(*vector);
-    ecs_type_link_t **type_array = ecs_vector_first(*vector);
+    uint32_t mask = db->size - 1;
+    uint32_t index = hash & mask;
+    ecs_type_entry_t *entry;
 
-    for (i = 0; i < types_count; i ++) {
-        ecs_type_t type = type_array[i]->type;
-        if (!type) {
-            continue;
+    while ((entry = db->entries[index])) {
+        if (entry->hash == hash && entry->count == count &&
+            !memcmp(entry->key, array, count * sizeof(ecs_entity_t))) 
+        {
+            break;
         }
 
-        uint32_t type_count = ecs_vector_count(type);
+        index = (index + 1) & mask;
+    }
 
-        if (type_count != count) {
-            continue;
-        }
+    return &db->entries[index];
+}
+
+static
+void grow_type_db(
+    ecs_type_db_t *db)
+{
+    uint32_t i, old_size = db->size;
+    ecs_type_entry_t **old_entries = db->entries;
 
-        ecs_entity_t *type_array = ecs_vector_first(type);
+    db->size = old_size ? old_size * 2 : ECS_TYPE_DB_MIN_SIZE;
+    db->entries = ecs_os_calloc(db->size, sizeof(ecs_type_entry_t*));
+    ecs_assert(db->entries != NULL, ECS_OUT_OF_MEMORY, NULL);
 
-        uint32_t j;
-        for (j = 0; j < type_count; j ++) {
-            if (type_array[j] != array[j]) {
-                break;
+    uint32_t mask = db->size - 1;
+
+    for (i = 0; i < old_size; i ++) {
+        ecs_type_entry_t *entry = old_entries[i];
+        if (entry) {
+            uint32_t index = entry->hash & mask;
+            while (db->entries[index]) {
+                index = (index + 1) & mask;
             }
-        }
 
-        if (j == type_count) {
-            return type;
+            db->entries[index] = entry;
         }
     }
 
-    /* Type has not been found, add it */
-    if (create) {
-        ecs_type_link_t **link = ecs_vector_add(vector, &link_params);
-        *link = ecs_os_calloc(1, sizeof(ecs_type_link_t));
-        return register_type(world, stage, *link, array, count, normalized);
+    ecs_os_free(old_entries);
+}
+
+/** Allocate entry. If own_key is true, the entry stores a copy of the array */
+static
+ecs_type_entry_t* new_entry(
+    ecs_entity_t *array,
+    uint32_t count,
+    uint32_t hash,
+    bool own_key)
+{
+    size_t size = sizeof(ecs_type_entry_t);
+    if (own_key) {
+        size += count * sizeof(ecs_entity_t);
     }
-    
-    return NULL;
+
+    ecs_type_entry_t *entry = ecs_os_calloc(1, size);
+    ecs_assert(entry != NULL, ECS_OUT_OF_MEMORY, NULL);
+
+    entry->count = count;
+    entry->hash = hash;
+
+    if (own_key) {
+        entry->key = (ecs_entity_t*)(entry + 1);
+        memcpy(entry->key, array, count * sizeof(ecs_entity_t));
+    }
+
+    return entry;
+}
+
+static
+void insert_entry(
+    ecs_type_db_t *db,
+    ecs_type_entry_t *entry)
+{
+    /* Keep load factor below 0.75, so probe sequences stay short */
+    if ((db->count + 1) * 4 > db->size * 3) {
+        grow_type_db(db);
+    }
+
+    ecs_type_entry_t **slot = find_slot(
+        db, entry->key, entry->count, entry->hash);
+
+    ecs_assert(*slot == NULL, ECS_INTERNAL_ERROR, NULL);
+
+    *slot = entry;
+    db->count ++;
 }
 
 static
 ecs_type_t find_or_create_type(
     ecs_world_t *world,
     ecs_stage_t *stage,
-    ecs_type_node_t *root,
+    ecs_type_db_t *db,
     ecs_entity_t *array,
     uint32_t count,
     bool create,
     bool normalized)
 {
-    ecs_type_node_t *node = root;
-    ecs_type_t type = NULL;
-    ecs_entity_t offset = 0;
-    uint32_t i;
-
+    ecs_assert(count != 0, ECS_INTERNAL_ERROR, NULL);
     ecs_assert(count < ECS_MAX_ENTITIES_IN_TYPE, ECS_TYPE_TOO_LARGE, NULL);
 
-    for (i = 0; i < count; i ++) {
-        ecs_entity_t e = array[i];
-        ecs_entity_t rel = e - offset;
-
-        /* Lookup next node in nodes array */
-        if (rel < ECS_TYPE_DB_MAX_CHILD_NODES) {
-            ecs_type_node_t *node_array = NULL;
+    uint32_t hash = hash_array(array, count);
 
-            if (!node->nodes && create) {
-                /* Create vector */
-                ecs_vector_set_count(&node->nodes, &type_node_params, 
-                    ECS_TYPE_DB_MAX_CHILD_NODES);
-
-                node_array = ecs_vector_first(node->nodes);
+    if (db->size) {
+        ecs_type_entry_t *entry = *find_slot(db, array, count, hash);
+        if (entry) {
+            return entry->link.type;
+        }
+    }
 
-                memset(node_array, 0, 
-                    ECS_TYPE_DB_MAX_CHILD_NODES * sizeof(ecs_type_node_t));
-            } else {
-                node_array = ecs_vector_first(node->nodes);
-            }
-            
-            if (node_array) {
-                node = &node_array[rel];
-                type = node->link.type;
-                
-                if (!type && create) {
-                    type = register_type(
-                        world, stage, &node->link, array, i + 1, normalized);
-
-                    ecs_assert(
-                        ecs_vector_count(type) == i + 1, 
-                        ECS_INTERNAL_ERROR, 
-                        NULL);
-                }
-            } else {
-                type = NULL;
-            }
+    if (!create) {
+        return NULL;
+    }
 
-        } else {
-            if (!node->types) {
-                if (create) {
-                    node->types = ecs_os_calloc(
-                        ECS_TYPE_DB_BUCKET_COUNT, sizeof(ecs_vector_t*));
-                } else {
-                    return NULL;
-                }
-            }
+    ecs_type_entry_t *entry;
+    ecs_type_t type;
 
-            uint32_t hash = hash_array(&array[i], count - i);
-            uint32_t index = hash % ECS_TYPE_DB_BUCKET_COUNT;
+    bool has_flags = (array[count - 1] & ECS_ENTITY_FLAGS_MASK) != 0;
 
-            if (!node->types[index]) {
-                if (create) {
-                    node->types[index] = ecs_vector_new(&link_params, 1);
-                } else {
-                    return NULL;
-                }
-            }
+    if (!normalized && has_flags) {
+        /* Normalizing modifies the array, so copy it to the entry first */
+        entry = new_entry(array, count, hash, true);
+        type = ecs_type_from_array_normalize(world, stage, array, count);
+
+        /* If the array was already normalized, the type is stored in the
+         * database by ecs_type_from_array_normalize */
+        if (ecs_vector_count(type) == count && !memcmp(
+            ecs_vector_first(type), entry->key, count * sizeof(ecs_entity_t)))
+        {
+            ecs_os_free(entry);
+            return type;
+        }
 
-            type = find_type_in_vector(
-                world, stage, &node->types[index], array, count, create, 
-                normalized);
+        /* Aliases are not linked, as the normalized type is already linked */
+        entry->link.type = type;
+    } else {
+        entry = new_entry(array, count, hash, false);
+        type = register_type(world, stage, &entry->link, array, count);
+        entry->key = ecs_vector_first(type);
+    }
 
-            if (type) {
-                break;
-            }
+    insert_entry(db, entry);
 
-            if (create && !type) {
-                return NULL;
-            }
-        }
-        
-        offset = e;
-    }
-    
-    ecs_assert(!create || type != NULL, ECS_INTERNAL_ERROR, NULL);
-    ecs_assert(!create || !normalized || ecs_vector_count(type) == count, ECS_INTERNAL_ERROR, NULL);
+    ecs_assert(!normalized || ecs_vector_count(type) == count, 
+        ECS_INTERNAL_ERROR, NULL);
 
     return type;
 }
@@ -491,6 +495,114 @@ ecs_entity_t ecs_find_entity_in_prefabs(
 
 /* -- Private functions -- */
 
+uint64_t ecs_type_bloom(
+    ecs_type_t type)
+{
+    ecs_entity_t *array = ecs_vector_first(type);
+    uint32_t i, count = ecs_vector_count(type);
+    uint64_t result = 0;
+
+    /* Entity ids are mostly allocated sequentially, so that the low bits of
+     * entities in a world with few components are all different. Flags are
+     * masked out, as ecs_type_contains ignores them. */
+    for (i = 0; i < count; i ++) {
+        result |= ecs_bloom_bit(array[i]);
+    }
+
+    return result;
+}
+
+uint64_t ecs_type_diff_bloom(
+    ecs_type_t type_1,
+    ecs_type_t type_2)
+{
+    ecs_entity_t *array_1 = ecs_vector_first(type_1);
+    ecs_entity_t *array_2 = ecs_vector_first(type_2);
+    uint32_t i_1 = 0, count_1 = ecs_vector_count(type_1);
+    uint32_t i_2 = 0, count_2 = ecs_vector_count(type_2);
+    uint64_t result = 0;
+
+    /* Types are sorted, so both types can be walked in a single pass */
+    while (i_1 < count_1 || i_2 < count_2) {
+        if (i_2 == count_2 || (i_1 < count_1 && array_1[i_1] < array_2[i_2])) {
+            result |= ecs_bloom_bit(array_1[i_1 ++]);
+        } else if (i_1 == count_1 || array_2[i_2] < array_1[i_1]) {
+            result |= ecs_bloom_bit(array_2[i_2 ++]);
+        } else {
+            i_1 ++;
+            i_2 ++;
+        }
+    }
+
+    return result;
+}
+
+uint64_t ecs_type_filter_bloom(
+    ecs_type_filter_t *filter)
+{
+    if (!filter || !filter->include) {
+        return 0;
+    }
+
+    /* Only a type that has all components of include can be tested */
+    if (filter->include_kind == EcsMatchAny || 
+        filter->include_kind == EcsMatchExact) 
+    {
+        return 0;
+    }
+
+    return ecs_type_bloom(filter->include);
+}
+
+void ecs_type_db_free(
+    ecs_type_db_t *db)
+{
+    uint32_t i;
+    for (i = 0; i < db->size; i ++) {
+        ecs_type_entry_t *entry = db->entries[i];
+        if (entry) {
+            /* Aliases point to a type that is owned by another entry */
+            if (!entry_has_own_key(entry)) {
+                ecs_vector_free((ecs_vector_t*)entry->link.type);
+            }
+
+            ecs_os_free(entry);
+        }
+    }
+
+    ecs_os_free(db->entries);
+    memset(db, 0, sizeof(ecs_type_db_t));
+}
+
+void ecs_type_db_memory(
+    ecs_type_db_t *db,
+    uint32_t *allocd,
+    uint32_t *used)
+{
+    *allocd += db->size * sizeof(ecs_type_entry_t*);
+    *used += db->count * sizeof(ecs_type_entry_t*);
+
+    uint32_t i;
+    for (i = 0; i < db->size; i ++) {
+        ecs_type_entry_t *entry = db->entries[i];
+        if (!entry) {
+            continue;
+        }
+
+        uint32_t size = sizeof(ecs_type_entry_t);
+
+        if (entry_has_own_key(entry)) {
+            size += entry->count * sizeof(ecs_entity_t);
+        } else {
+            ecs_vector_memory(entry->link.type, &handle_arr_params, 
+                allocd, used);
+        }
+
+        *allocd += size;
+        *used += size;
+    }
+}
+
 ecs_type_t ecs_type_find_intern(
     ecs_world_t *world,
     ecs_stage_t *stage,
@@ -503,17 +615,20 @@ ecs_type_t ecs_type_find_intern(
         stage = &world->main_stage;
     }
 
-    if (stage == &world->main_stage) {
-        type = find_or_create_type(
-            world, stage, &world->main_stage.type_root, array, count, true, false);
-    } else {
-        type = find_or_create_type(
-            world, stage, &world->main_stage.type_root, array, count, false, false);
+    /* Worker threads share the type database of the main stage. The database
+     * can grow while it is searched, so threads cannot search it concurrently */
+    bool is_worker = stage != &world->main_stage && 
+        stage != &world->temp_stage;
+
+    if (is_worker) {
+        ecs_os_mutex_lock(world->type_mutex);
     }
 
-    if (!type && stage != &world->main_stage) {
-        type = find_or_create_type(
-            world, stage, &world->main_stage.type_root, array, count, true, false);
+    type = find_or_create_type(
+        world, stage, &world->main_stage.type_db, array, count, true, false);
+
+    if (is_worker) {
+        ecs_os_mutex_unlock(world->type_mutex);
     }
 
     ecs_assert(type != NULL, ECS_INTERNAL_ERROR, NULL);
@@ -564,27 +679,14 @@ ecs_type_t ecs_type_add_intern(
     return result;
 }
 
-ecs_type_t ecs_type_merge_intern(
+static
+ecs_type_t merge_types(
     ecs_world_t *world,
     ecs_stage_t *stage,
     ecs_type_t arr_cur,
     ecs_type_t to_add,
     ecs_type_t to_del)
 {
-    ecs_assert(world != NULL, ECS_INTERNAL_ERROR, NULL);
-
-    if (!to_del) {
-        if (arr_cur && !to_add) {
-            return arr_cur;
-        } else if (to_add && !arr_cur) {
-            return to_add;
-        } else if (to_add == arr_cur) {
-            return arr_cur;
-        }
-    } else if (to_del == arr_cur) {
-        return to_add;
-    }
-
     ecs_entity_t *buf_add = NULL, *buf_del = NULL, *buf_cur = NULL;
     ecs_entity_t cur = 0, add = 0, del = 0;
     uint32_t i_cur = 0, i_add = 0, i_del = 0;
@@ -689,6 +791,76 @@ ecs_type_t ecs_type_merge_intern(
     }
 }
 
+/** Get slot in merge cache for a combination of types */
+static
+ecs_type_merge_entry_t* merge_cache_slot(
+    ecs_world_t *world,
+    ecs_stage_t *stage,
+    ecs_type_t arr_cur,
+    ecs_type_t to_add,
+    ecs_type_t to_del)
+{
+    if (!stage->merge_cache) {
+        stage->merge_cache = ecs_slab_calloc(ecs_stage_get_slab(world, stage), 
+            ECS_TYPE_MERGE_CACHE_SIZE * sizeof(ecs_type_merge_entry_t));
+    }
+
+    uint64_t hash = (uint64_t)(uintptr_t)arr_cur;
+    hash = hash * 31 + (uint64_t)(uintptr_t)to_add;
+    hash = hash * 31 + (uint64_t)(uintptr_t)to_del;
+    hash *= 0x9E3779B97F4A7C15ull;
+
+    return &stage->merge_cache[hash >> (64 - ECS_TYPE_MERGE_CACHE_BITS)];
+}
+
+ecs_type_t ecs_type_merge_intern(
+    ecs_world_t *world,
+    ecs_stage_t *stage,
+    ecs_type_t arr_cur,
+    ecs_type_t to_add,
+    ecs_type_t to_del)
+{
+    ecs_assert(world != NULL, ECS_INTERNAL_ERROR, NULL);
+
+    if (!to_del) {
+        if (arr_cur && !to_add) {
+            return arr_cur;
+        } else if (to_add && !arr_cur) {
+            return to_add;
+        } else if (to_add == arr_cur) {
+            return arr_cur;
+        }
+    } else if (to_del == arr_cur) {
+        return to_add;
+    }
+
+    if (!stage) {
+        stage = &world->main_stage;
+    }
+
+    /* Types are interned, so a merge can be looked up by type pointers */
+    ecs_type_merge_entry_t *entry = merge_cache_slot(
+        world, stage, arr_cur, to_add, to_del);
+
+    if (entry->type == arr_cur && entry->to_add == to_add && 
+        entry->to_del == to_del) 
+    {
+        stage->merge_cache_hits ++;
+        return entry->result;
+    }
+
+    stage->merge_cache_misses ++;
+
+    ecs_type_t result = merge_types(world, stage, arr_cur, to_add, to_del);
+
+    entry->type = arr_cur;
+    entry->to_add = to_add;
+    entry->to_del = to_del;
+    entry->result = result;
+
+    return result;
+}
+
 /* O(n) algorithm to check whether type 1 is equal or superset of type 2 */
 ecs_entity_t ecs_type_contains(
     ecs_world_t *world,
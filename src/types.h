@@ -34,10 +34,13 @@
 #define ECS_WORLD_INITIAL_REMOVE_SYSTEM_COUNT (0)
 #define ECS_WORLD_INITIAL_SET_SYSTEM_COUNT (0)
 #define ECS_WORLD_INITIAL_PREFAB_COUNT (0)
-#define ECS_MAP_INITIAL_NODE_COUNT (4)
 #define ECS_TABLE_INITIAL_ROW_COUNT (0)
 #define ECS_SYSTEM_INITIAL_TABLE_COUNT (0)
 #define ECS_MAX_JOBS_PER_WORKER (16)
+#define ECS_ENTITY_ID_BLOCK_SIZE (4096)
+#define ECS_WORLD_SLAB_SIZE (16 * 1024)
+#define ECS_COLUMN_ARENA_SIZE (8 * 1024 * 1024)
+#define ECS_STAGE_ARENA_SIZE (16 * 1024)
 
 /* This is _not_ the max number of entities that can be of a given type. This 
  * constant defines the maximum number of components, prefabs and parents can be
@@ -46,6 +49,10 @@
  * using alloca for temporary buffers). */
 #define ECS_MAX_ENTITIES_IN_TYPE (256)
 
+/* Maximum depth of prefabs that is followed when collecting the components that
+ * an entity inherits. This prevents a cycle of prefabs from recursing forever. */
+#define ECS_MAX_INHERIT_DEPTH (64)
+
 #define ECS_WORLD_MAGIC (0x65637377)
 #define ECS_THREAD_MAGIC (0x65637374)
 
@@ -131,15 +138,50 @@ typedef struct ecs_system_column_t {
     ecs_entity_t source;             /* Source entity (used with FromEntity) */
 } ecs_system_column_t;
 
-/** A table column describes a single column in a table (archetype) */
+/** A table column describes a single column in a table (archetype). When a
+ * column is chunked, data is a vector of fixed-size chunks that each hold
+ * (1 << chunk_shift) rows. Chunks are never reallocated, so rows in a chunked
+ * column do not move in memory when the table grows. */
 typedef struct ecs_table_column_t {
-    ecs_vector_t *data;              /* Column data */
+    ecs_vector_t *data;              /* Column data (or chunks, if chunked) */
     uint16_t size;                   /* Column size (saves component lookups) */
+    uint16_t alignment;              /* Alignment of first element in column */
+    uint8_t chunk_shift;             /* Log2 of rows per chunk (0 if not chunked) */
+    uint32_t change_tick;            /* Tick at which column was last written */
+    ecs_slab_t *slab;                /* Allocator for column data (or NULL) */
 } ecs_table_column_t;
 
+/** Per-row enabled state of a component in a table. A set bit means that the
+ * component is disabled for the entity stored in that row. Rows that are not
+ * covered by words are enabled, and bits of rows past the end of the table are
+ * always cleared, so that new rows start out enabled. */
+typedef struct ecs_table_bitset_t {
+    ecs_entity_t component;          /* Component (0 for entity) */
+    ecs_vector_t *words;             /* 64 rows per word */
+} ecs_table_bitset_t;
+
 #define EcsTableIsStaged  (1)
 #define EcsTableIsPrefab (2)
 #define EcsTableHasPrefab (4)
+#define EcsTableIsGarbage (8)
+
+/** Test whether bloom signature 1 has all bits of bloom signature 2. If not,
+ * the type of signature 1 does not contain all entities of the type of
+ * signature 2. The reverse is not guaranteed, and must be tested on the type. */
+#define ecs_bloom_contains(bloom_1, bloom_2)\
+    (((bloom_1) & (bloom_2)) == (bloom_2))
+
+/** Bit of an entity in a bloom signature. Flags are masked out. */
+#define ecs_bloom_bit(entity)\
+    ((uint64_t)1 << (((entity) & ECS_ENTITY_MASK) & 63))
+
+/** Destination tables for adding a single component to, or removing a single
+ * component from a table. Edges are stored in the source table, and are 
+ * populated the first time a component is added or removed. */
+typedef struct ecs_table_edge_t {
+    struct ecs_table_t *add;         /* Table with component added */
+    struct ecs_table_t *remove;      /* Table with component removed */
+} ecs_table_edge_t;
 
 /** A table is the Flecs equivalent of an archetype. Tables store all entities
  * with a specific set of components. Tables are automatically created when an
@@ -149,9 +191,28 @@ typedef struct ecs_table_t {
     ecs_table_column_t *columns;      /* Columns storing components of array */
     ecs_vector_t *frame_systems;      /* Frame systems matched with table */
     ecs_type_t type;                  /* Identifies table type in type_index */
+    ecs_map_t *edges;                 /* Cached add/remove destination tables */
+    ecs_vector_t *bitsets;            /* Disabled rows per component */
+    uint64_t bloom;                   /* Bloom signature of type */
     uint32_t flags;                   /* Flags for testing table properties */
+    uint32_t low_occupancy_frames;    /* Frames below autoshrink threshold */
+    uint32_t empty_frames;            /* Frames the table has been empty */
+    uint32_t id;                      /* Order in which table was created */
  } ecs_table_t;
 
+/** Iterator over the tables that may match a set of components. Tables are
+ * either selected from the index of the rarest component, or when no component
+ * could be selected, from all tables in the main stage. */
+typedef struct ecs_table_iter_t {
+    ecs_world_t *world;
+    ecs_chunked_t *tables;            /* All tables (if not using the index) */
+    ecs_entity_t component;           /* Component used to select tables */
+    uint32_t count;                   /* Number of selected tables */
+    uint32_t index;                   /* Index of next selected table */
+    uint32_t prefab_count;            /* Number of tables with prefabs */
+    uint32_t prefab_index;            /* Index of next table with prefabs */
+} ecs_table_iter_t;
+
 /** Type containing data for a table matched with a system */
 typedef struct ecs_matched_table_t {
     ecs_table_t *table;             /* Reference to the table */
@@ -161,6 +222,23 @@ typedef struct ecs_matched_table_t {
     int32_t depth;                  /* Depth of table (when using CASCADE) */
 } ecs_matched_table_t;
 
+/** Storage for a component that is stored in a sparse set keyed by entity,
+ * instead of in table columns. Adding or removing such a component does not
+ * move the entity to another table. */
+typedef struct ecs_sparse_storage_t {
+    ecs_sparse_t *data;           /* Component values (or flags for tags) */
+    uint32_t size;                /* Size of component (0 if tag) */
+} ecs_sparse_storage_t;
+
+/** A system column for a component that is stored in a sparse set. Such columns
+ * cannot be evaluated when matching tables, and are tested per entity when the
+ * system is ran. */
+typedef struct ecs_sparse_column_t {
+    uint32_t column;                /* Index of column in signature */
+    ecs_sparse_storage_t *storage;  /* Storage of the component */
+    ecs_system_expr_oper_kind_t oper_kind; /* And, Not or Optional */
+} ecs_sparse_column_t;
+
 /** Base type for a system */
 typedef struct EcsSystem {
     ecs_system_action_t action;    /* Callback to be invoked for matching rows */
@@ -177,6 +255,10 @@ typedef struct EcsSystem {
     ecs_type_t and_from_owned;      /* Which components are required from entity */
     ecs_type_t and_from_shared;      /* Which components are required from entity */
     ecs_type_t and_from_system;    /* Used to auto-add components to system */
+    uint64_t and_from_self_bloom;  /* Bloom signature of and_from_self */
+    uint64_t and_from_owned_bloom; /* Bloom signature of and_from_owned */
+    uint64_t columns_bloom;        /* Bloom signature of all column components */
+    ecs_vector_t *sparse_columns;  /* Columns with sparse components */
     
     int32_t cascade_by;            /* CASCADE column index */
     EcsSystemKind kind;            /* Kind of system */
@@ -237,8 +319,47 @@ typedef struct EcsColSystem {
     ecs_vector_params_t ref_params;       /* Parameters for refs */
     float period;                         /* Minimum period inbetween system invocations */
     float time_passed;                    /* Time passed since last invocation */
+    ecs_entity_t sort_component;          /* Component to sort matched tables by */
+    ecs_compare_action_t sort_compare;    /* Comparator for sorting tables */
+    ecs_type_t writes;                    /* Components written by system */
+    uint32_t last_tick;                   /* Change tick of previous run */
+    uint32_t run_tick;                    /* Change tick of current run */
+    uint32_t tables_version;              /* Incremented when tables change */
+    bool on_change;                       /* Only run on changed tables */
 } EcsColSystem;
 
+/** A filter caches which of the matched tables of a system contain the
+ * components of the filter type. Tables are stored as indices in the tables
+ * vector of the system. Tables that inherit from prefabs are stored as negative
+ * indices (-index - 1), and are tested on every run, as the components of a
+ * prefab can change. */
+struct ecs_filter_t {
+    ecs_type_t type;                /* Components tables must have */
+    uint64_t bloom;                 /* Bloom signature of type */
+    ecs_entity_t system;            /* System for which tables are cached */
+    uint32_t tables_version;        /* Version of system tables in cache */
+    ecs_vector_t *tables;           /* Indices of tables that pass filter */
+};
+
+/** A query caches the tables that match a signature. It is matched in the same
+ * way as a column system, but is not registered with tables. All matched tables
+ * are stored in the tables vector, and empty tables are skipped while the
+ * query is iterated. */
+struct ecs_query_t {
+    ecs_world_t *world;             /* World the query was created for */
+    EcsColSystem system;            /* Parsed signature and matched tables */
+};
+
+/** Watched entities (containers, prefabs and column sources) that changed type
+ * since systems were last matched. Only systems of which the columns have a
+ * component in the bloom signature of the changed components are rematched,
+ * and only with the tables that depend on the changed entities. */
+typedef struct ecs_rematch_t {
+    ecs_map_t *entities;            /* Bloom of changed components per entity */
+    uint64_t bloom;                 /* Bloom of changed components */
+    ecs_vector_t *tables;           /* Tables that depend on changed entities */
+} ecs_rematch_t;
+
 /** A row system is a system that is ran on 1..n entities for which a certain 
  * operation has been invoked. The system kind determines on what kind of
  * operation the row system is invoked. Example operations are ecs_add,
@@ -256,32 +377,55 @@ typedef struct ecs_row_t {
     int32_t index;                /* Index of the entity in its table */
 } ecs_row_t;
 
-#define ECS_TYPE_DB_MAX_CHILD_NODES (256)
-#define ECS_TYPE_DB_BUCKET_COUNT (256)
+/** Operation on a sparse component that was done by a worker thread, and that
+ * is applied when the thread stage is merged. */
+typedef struct ecs_sparse_op_t {
+    ecs_entity_t entity;          /* Entity to add to or remove from */
+    ecs_entity_t component;       /* Component (0 removes all components) */
+    void *value;                  /* Value to set (NULL if not set) */
+    bool remove;                  /* Remove instead of add */
+} ecs_sparse_op_t;
 
-/** The ecs_type_node_t type is a node in a hierarchical structure that allows
- * for quick lookups of types. A node represents a type, and its direct children
- * represent types with one additional entity. For example, given a node [A],
- * [A, B] would be a child node.
- * 
- * Child nodes are looked up directly using the entity id. For example, node [A]
- * will be stored at root.nodes[A]. Children entity ids are offset by their 
- * parent, such that [A, B] is stored at root.nodes[A].nodes[B - A].
- * 
- * If the offset exceeds ECS_TYPE_DB_MAX_CHILD_NODES, the type will be stored in
- * the types map. This map is keyed by the hash of the type relative to its
- * parent. For example, the hash for type [A, B, C] will be computed on [B, C]
- * if its parent is [A]. */
+#define ECS_TYPE_DB_MIN_SIZE (64)
+
+/** Types are stored in a list of links, so that all types can be iterated in
+ * the order in which they were registered. */
 typedef struct ecs_type_link_t {
     ecs_type_t type;                /* type of current node */
     struct ecs_type_link_t *next;   /* next link (for iterating linearly) */
 } ecs_type_link_t;
 
-typedef struct ecs_type_node_t {
-    ecs_vector_t *nodes;    /* child nodes - <ecs_entity_t, ecs_type_node_t> */
-    ecs_vector_t **types;   /* child types w/large entity offsets - <hash, vector<ecs_type_link_t>> */
-    ecs_type_link_t link;     
-} ecs_type_node_t;
+/** An entry in the type database. Entries are keyed by a sorted array of
+ * entity ids. If the array is not normalized (see ecs_type_from_array_normalize)
+ * the entry is an alias for the normalized type, and stores its own copy of the
+ * array. Otherwise the key points to the elements of the type. */
+typedef struct ecs_type_entry_t {
+    ecs_type_link_t link;   /* Type of entry (not linked if alias) */
+    ecs_entity_t *key;      /* Sorted entity ids */
+    uint32_t count;         /* Number of entity ids in key */
+    uint32_t hash;          /* Hash of key */
+} ecs_type_entry_t;
+
+/** The type database is an open addressed hash set of type entries. Lookups
+ * compare the precomputed hash before comparing the entity ids. */
+typedef struct ecs_type_db_t {
+    ecs_type_entry_t **entries;     /* Hash set with linear probing */
+    uint32_t size;                  /* Number of slots (power of two) */
+    uint32_t count;                 /* Number of entries */
+    ecs_type_link_t link;           /* First link (has no type) */
+} ecs_type_db_t;
+
+#define ECS_TYPE_MERGE_CACHE_BITS (8)
+#define ECS_TYPE_MERGE_CACHE_SIZE (1 << ECS_TYPE_MERGE_CACHE_BITS)
+
+/** Cached result of ecs_type_merge_intern. Types are never freed while the
+ * world is alive, so cached entries do not have to be invalidated. */
+typedef struct ecs_type_merge_entry_t {
+    ecs_type_t type;                /* Original type */
+    ecs_type_t to_add;              /* Added type */
+    ecs_type_t to_del;              /* Removed type */
+    ecs_type_t result;              /* Result of merge */
+} ecs_type_merge_entry_t;
 
 /** A stage is a data structure in which delta's are stored until it is safe to
  * merge those delta's with the main world stage. A stage allows flecs systems
@@ -292,21 +436,36 @@ typedef struct ecs_stage_t {
     /* If this is not main stage, 
      * changes to the entity index 
      * are buffered here */
-    ecs_map_t *entity_index;       /* Entity lookup table for (table, row) */
+    ecs_sparse_t *entity_index;    /* Entity lookup table for (table, row) */
 
     /* If this is not a thread
      * stage, these are the same
      * as the main stage */
-    ecs_type_node_t type_root;     /* Hierarchical type store (& first link) */
+    ecs_type_db_t type_db;         /* Type database (& first link) */
     ecs_type_link_t *last_link;    /* Link to last registered type */
     ecs_chunked_t *tables;         /* Tables created while >1 threads running */
     ecs_map_t *table_index;        /* Lookup table by type */
 
+    /* Direct mapped cache with
+     * recent type merges */
+    ecs_type_merge_entry_t *merge_cache;
+    uint32_t merge_cache_hits;
+    uint32_t merge_cache_misses;
+
     /* These occur only in
      * temporary stages, and
      * not on the main stage */
+    ecs_slab_t *arena;             /* Staged data, reset at merge */
     ecs_map_t *data_stage;         /* Arrays with staged component values */
     ecs_map_t *remove_merge;       /* All removed components before merge */
+    ecs_vector_t *delete_stage;    /* Entities deleted while in progress */
+    ecs_vector_t *name_stage;      /* Entities named while in progress */
+    ecs_vector_t *sparse_stage;    /* Sparse component ops of worker thread */
+
+    /* Block of entity ids reserved
+     * by a worker thread stage */
+    ecs_entity_t id_block_next;    /* Next id to issue from block */
+    ecs_entity_t id_block_end;     /* End of block (exclusive) */
 
     /* Keep track of changes so
      * code knows when entity
@@ -378,6 +537,8 @@ struct ecs_world {
     ecs_vector_t *on_store_systems;   
     ecs_vector_t *on_demand_systems;  
     ecs_vector_t *inactive_systems;   
+    ecs_vector_t *sorted_systems;     /* Systems that sort their tables */
+    ecs_vector_t *queries;            /* Queries created for the world */
 
 
     /* -- Row systems -- */
@@ -399,6 +560,12 @@ struct ecs_world {
     ecs_map_t *type_sys_remove_index; /* Index to find remove row systems for type*/
     ecs_map_t *type_sys_set_index;    /* Index to find set row systems for type */
     ecs_map_t *type_handles;          /* Handles to named families */
+    ecs_map_t *name_index;            /* Index to find entities by name */
+    ecs_map_t *name_keys;             /* Name index key of indexed entities */
+    ecs_map_t *sparse_storage;        /* Storage of sparse components */
+    ecs_map_t *watch_changes;         /* Watched entities that changed type */
+    ecs_map_t *component_tables;      /* Index to find tables for component */
+    ecs_vector_t *prefab_tables;      /* Tables with components from prefabs */
 
 
     /* -- Staging -- */
@@ -417,10 +584,14 @@ struct ecs_world {
     ecs_os_mutex_t job_mutex;        /* Mutex for protecting job counter */
     uint32_t jobs_finished;          /* Number of jobs finished */
     uint32_t threads_running;        /* Number of threads running */
+    ecs_os_mutex_t id_mutex;         /* Mutex for reserving entity id blocks */
+    ecs_os_mutex_t type_mutex;       /* Mutex for finding types in threads */
 
     ecs_entity_t last_handle;        /* Last issued handle */
+    ecs_vector_t *free_handles;      /* Handles of deleted entities */
     ecs_entity_t min_handle;         /* First allowed handle */
     ecs_entity_t max_handle;         /* Last allowed handle */
+    uint32_t last_table_id;          /* Last issued table id */
 
 
     /* -- Handles to builtin components families -- */
@@ -436,6 +607,7 @@ struct ecs_world {
     /* -- Time management -- */
 
     uint32_t tick;                /* Number of computed frames by world */
+    uint32_t change_tick;         /* Stamped on columns when they are written */
     ecs_time_t frame_start;       /* Starting timestamp of frame */
     float frame_time;             /* Time spent processing a frame */
     float system_time;            /* Time spent processing systems */
@@ -451,6 +623,16 @@ struct ecs_world {
     int arg_threads;
 
 
+    /* -- Storage settings -- */
+
+    uint32_t table_chunk_size;    /* Size of column chunks in bytes (0 if off) */
+    float shrink_threshold;       /* Occupancy below which tables are shrunk */
+    uint32_t shrink_frames;       /* Frames before a table is shrunk (0 if off) */
+    uint32_t gc_frames;           /* Frames before empty table is deleted (0 if off) */
+    ecs_slab_t *slab;             /* Allocator for storage owned by main thread */
+    ecs_slab_t *column_arena;     /* Allocator for large column buffers */
+
+
     /* -- World state -- */
 
     bool valid_schedule;          /* Is job schedule still valid */
@@ -461,7 +643,6 @@ struct ecs_world {
     bool measure_frame_time;      /* Time spent on each frame */
     bool measure_system_time;     /* Time spent by each system */
     bool should_quit;             /* Did a system signal that app should quit */
-    bool should_match;            /* Should tablea be rematched */
     bool should_resolve;          /* If a table reallocd, resolve system refs */
 }; 
 
@@ -477,5 +658,6 @@ extern const ecs_vector_params_t system_column_params;
 extern const ecs_vector_params_t matched_table_params;
 extern const ecs_vector_params_t matched_column_params;
 extern const ecs_vector_params_t reference_params;
+extern const ecs_vector_params_t sparse_column_params;
 
 #endif
@@ -1,20 +1,108 @@
 #include "types.h"
 
+/* The header is 16 bytes so that the buffer of an unaligned vector keeps the
+ * alignment guaranteed by malloc on common platforms. */
 struct ecs_vector_t {
     uint32_t count;
     uint32_t size;
+    uint16_t offset;    /* Offset of header from start of allocation */
+    uint16_t alignment; /* Alignment of buffer (0 if not aligned) */
+    bool from_slab;     /* Allocated from a slab (see ecs_slab_owner) */
 };
 
 #define ARRAY_BUFFER(array) ECS_OFFSET(array, sizeof(ecs_vector_t))
 
+/** Allocate a buffer that is aligned to params->alignment. The header is stored
+ * right before the aligned buffer, and the offset of the header from the start
+ * of the allocation is stored so that the vector can be freed. */
+static
+ecs_vector_t* alloc_aligned(
+    ecs_slab_t *slab,
+    uint32_t alignment,
+    uint32_t size)
+{
+    ecs_assert(!(alignment & (alignment - 1)), ECS_INVALID_PARAMETER, NULL);
+    ecs_assert(alignment <= UINT16_MAX, ECS_INVALID_PARAMETER, NULL);
+
+    char *mem = ecs_slab_alloc(slab, sizeof(ecs_vector_t) + size + alignment);
+
+    uintptr_t buffer = ((uintptr_t)mem + sizeof(ecs_vector_t) + alignment - 1) & 
+        ~(uintptr_t)(alignment - 1);
+
+    ecs_vector_t *result = (ecs_vector_t*)(buffer - sizeof(ecs_vector_t));
+    result->offset = (char*)result - mem;
+    result->alignment = alignment;
+    result->from_slab = slab != NULL;
+    return result;
+}
+
+/** Get the slab from which the buffer of a vector was allocated */
+static
+ecs_slab_t* get_slab(
+    ecs_vector_t *array)
+{
+    if (array->from_slab) {
+        return ecs_slab_owner((char*)array - array->offset);
+    } else {
+        return NULL;
+    }
+}
+
+static
+bool is_aligned(
+    const ecs_vector_params_t *params)
+{
+    return params->alignment > sizeof(ecs_vector_t);
+}
+
+static
+ecs_vector_t* alloc(
+    const ecs_vector_params_t *params,
+    uint32_t size)
+{
+    if (is_aligned(params)) {
+        return alloc_aligned(params->slab, params->alignment, size);
+    } else {
+        ecs_vector_t *result = ecs_slab_alloc(
+            params->slab, sizeof(ecs_vector_t) + size);
+        result->offset = 0;
+        result->alignment = 0;
+        result->from_slab = params->slab != NULL;
+        return result;
+    }
+}
+
 /** Resize the array buffer */
 static
 ecs_vector_t* resize(
     ecs_vector_t *array,
+    const ecs_vector_params_t *params,
     uint32_t size)
 {
-    ecs_vector_t *result = ecs_os_realloc(array, sizeof(ecs_vector_t) + size);
-    ecs_assert(result != NULL, ECS_OUT_OF_MEMORY, 0);
+    ecs_slab_t *slab = get_slab(array);
+
+    if (!array->alignment) {
+        return ecs_slab_realloc(slab, array, sizeof(ecs_vector_t) + size);
+    }
+
+    /* Realloc does not preserve alignment, so copy to a new aligned buffer */
+    ecs_vector_t *result = alloc_aligned(slab, array->alignment, size);
+
+    /* The count may already exceed the old size (see ecs_vector_set_count) */
+    uint32_t used = array->count;
+    if (used > array->size) {
+        used = array->size;
+    }
+    used *= params->element_size;
+    if (used > size) {
+        used = size;
+    }
+
+    result->count = array->count;
+    result->size = array->size;
+    memcpy(ARRAY_BUFFER(result), ARRAY_BUFFER(array), used);
+    ecs_slab_release(slab, (char*)array - array->offset);
+
     return result;
 }
 
@@ -27,8 +115,7 @@ ecs_vector_t* ecs_vector_new(
 {
     ecs_assert(params->element_size != 0, ECS_INTERNAL_ERROR, NULL);
     
-    ecs_vector_t *result = ecs_os_malloc(sizeof(ecs_vector_t) + size * params->element_size);
-    ecs_assert(result != NULL, ECS_OUT_OF_MEMORY, NULL);
+    ecs_vector_t *result = alloc(params, size * params->element_size);
 
     result->count = 0;
     result->size = size;
@@ -38,7 +125,9 @@ ecs_vector_t* ecs_vector_new(
 void ecs_vector_free(
     ecs_vector_t *array)
 {
-    ecs_os_free(array);
+    if (array) {
+        ecs_slab_release(get_slab(array), (char*)array - array->offset);
+    }
 }
 
 void ecs_vector_clear(
@@ -74,7 +163,7 @@ void* ecs_vector_addn(
             }
         }
 
-        array = resize(array, size * element_size);
+        array = resize(array, params, size * element_size);
         array->size = size;
         *array_inout = array;
     }
@@ -198,13 +287,17 @@ void ecs_vector_reclaim(
     const ecs_vector_params_t *params)
 {
     ecs_vector_t *array = *array_inout;
+    if (!array) {
+        return;
+    }
+
     uint32_t size = array->size;
     uint32_t count = array->count;
     uint32_t element_size = params->element_size;
 
     if (count < size) {
         size = count;
-        array = resize(array, size * element_size);
+        array = resize(array, params, size * element_size);
         array->size = size;
         *array_inout = array;
     }
@@ -245,7 +338,7 @@ uint32_t ecs_vector_set_size(
         }
 
         if (result < size) {
-            array = resize(array, size * params->element_size);
+            array = resize(array, params, size * params->element_size);
             array->size = size;
             *array_inout = array;
             result = size;
@@ -342,7 +435,8 @@ void ecs_vector_memory(
 {
     if (!array) return;
     if (allocd) {
-        *allocd += array->size * params->element_size + sizeof(ecs_vector_t);
+        *allocd += array->size * params->element_size + sizeof(ecs_vector_t) +
+            array->alignment;
     }
     if (used) {
         *used += array->count * params->element_size;
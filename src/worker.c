@@ -240,6 +240,8 @@ void ecs_prepare_jobs(
     ecs_vector_t *jobs = system_data->jobs;
     uint32_t i;
 
+    ecs_col_system_begin_run(world, system_data);
+
     uint32_t thread_count = ecs_vector_count(jobs);
 
     for (i = 0; i < thread_count; i++) {
@@ -303,6 +305,8 @@ void ecs_set_threads(
             ecs_os_mutex_free(world->thread_mutex);
             ecs_os_cond_free(world->job_cond);
             ecs_os_mutex_free(world->job_mutex);
+            ecs_os_mutex_free(world->id_mutex);
+            ecs_os_mutex_free(world->type_mutex);
         }
 
         if (threads > 1) {
@@ -310,6 +314,8 @@ void ecs_set_threads(
             world->thread_mutex = ecs_os_mutex_new();
             world->job_cond = ecs_os_cond_new();
             world->job_mutex = ecs_os_mutex_new();
+            world->id_mutex = ecs_os_mutex_new();
+            world->type_mutex = ecs_os_mutex_new();
             start_threads(world, threads);
         }
 
@@ -18,6 +18,10 @@ const ecs_vector_params_t builder_params = {
     .element_size = sizeof(ecs_builder_op_t)
 };
 
+static ecs_vector_params_t table_ptr_params = {
+    .element_size = sizeof(ecs_table_t*)
+};
+
 /* -- Global variables -- */
 
 ecs_type_t TEcsComponent;
@@ -105,6 +109,96 @@ void bootstrap_types(
     ecs_assert(ecs_vector_count(world->t_col_system) == 2, ECS_INTERNAL_ERROR, NULL);
 }
 
+/** Get tables that have a component (owned, or as CHILDOF / INSTANCEOF) */
+static
+ecs_vector_t* component_tables(
+    ecs_world_t *world,
+    ecs_entity_t component)
+{
+    ecs_vector_t *result = NULL;
+    ecs_map_has(world->component_tables, component, &result);
+    return result;
+}
+
+/** Add table to the index of each of its components. Flags are masked out, as
+ * they are ignored when testing whether a type contains a component. */
+static
+void register_table(
+    ecs_world_t *world,
+    ecs_table_t *table)
+{
+    ecs_entity_t *array = ecs_vector_first(table->type);
+    uint32_t i, count = ecs_vector_count(table->type);
+
+    /* Index is allocated from the world slab, like the columns of tables */
+    ecs_vector_params_t params = {
+        .element_size = sizeof(ecs_table_t*),
+        .slab = world->slab
+    };
+
+    for (i = 0; i < count; i ++) {
+        ecs_entity_t component = array[i] & ECS_ENTITY_MASK;
+        ecs_vector_t *tables = component_tables(world, component);
+
+        /* A type can contain the same entity with different flags */
+        if (ecs_vector_count(tables)) {
+            ecs_table_t **last = ecs_vector_last(tables, &params);
+            if (*last == table) {
+                continue;
+            }
+        }
+
+        ecs_table_t **elem = ecs_vector_add(&tables, &params);
+        *elem = table;
+        ecs_map_set(world->component_tables, component, &tables);
+    }
+
+    if (table->flags & EcsTableHasPrefab) {
+        ecs_table_t **elem = ecs_vector_add(&world->prefab_tables, &params);
+        *elem = table;
+    }
+}
+
+static
+void remove_table_ptr(
+    ecs_vector_t *tables,
+    ecs_table_t *table)
+{
+    ecs_table_t **buffer = ecs_vector_first(tables);
+    uint32_t i, count = ecs_vector_count(tables);
+
+    /* Keep the order of the remaining tables, which is the order in which
+     * they were created */
+    for (i = 0; i < count; i ++) {
+        if (buffer[i] == table) {
+            memmove(&buffer[i], &buffer[i + 1], 
+                (count - i - 1) * sizeof(ecs_table_t*));
+            ecs_vector_remove_last(tables);
+            break;
+        }
+    }
+}
+
+/** Remove table from the component index before it is deleted */
+static
+void unregister_table(
+    ecs_world_t *world,
+    ecs_table_t *table)
+{
+    ecs_entity_t *array = ecs_vector_first(table->type);
+    uint32_t i, count = ecs_vector_count(table->type);
+
+    for (i = 0; i < count; i ++) {
+        ecs_vector_t *tables = component_tables(
+            world, array[i] & ECS_ENTITY_MASK);
+        remove_table_ptr(tables, table);
+    }
+
+    if (table->flags & EcsTableHasPrefab) {
+        remove_table_ptr(world->prefab_tables, table);
+    }
+}
+
 /** Initialize component table. This table is manually constructed to bootstrap
  * flecs. After this function has been called, the builtin components can be
  * created. */
@@ -118,19 +212,45 @@ ecs_table_t* bootstrap_component_table(
     ecs_table_t *result = ecs_chunked_add(stage->tables, ecs_table_t);
     result->type = world->t_component;
     result->frame_systems = NULL;
+    result->edges = NULL;
+    result->bitsets = NULL;
     result->flags = 0;
-    result->columns = ecs_os_malloc(sizeof(ecs_table_column_t) * 3);
-    
-    ecs_assert(result->columns != NULL, ECS_OUT_OF_MEMORY, NULL);
-
-    result->columns[0].data = ecs_vector_new(&handle_arr_params, 12);
+    result->low_occupancy_frames = 0;
+    result->empty_frames = 0;
+    result->id = 0;
+    result->columns = ecs_slab_calloc(
+        world->slab, sizeof(ecs_table_column_t) * 3);
+
+    ecs_vector_params_t entity_params = {
+        .element_size = sizeof(ecs_entity_t),
+        .slab = world->slab
+    };
+    ecs_vector_params_t component_params = {
+        .element_size = sizeof(EcsComponent), 
+        .alignment = ECS_COLUMN_ALIGNMENT,
+        .slab = world->slab
+    };
+    ecs_vector_params_t id_params = {
+        .element_size = sizeof(EcsId), 
+        .alignment = ECS_COLUMN_ALIGNMENT,
+        .slab = world->slab
+    };
+
+    result->columns[0].data = ecs_vector_new(&entity_params, 12);
     result->columns[0].size = sizeof(ecs_entity_t);
-    result->columns[1].data = ecs_vector_new(&handle_arr_params, 12);
+    result->columns[0].alignment = 0;
+    result->columns[0].slab = world->slab;
+    result->columns[1].data = ecs_vector_new(&component_params, 12);
     result->columns[1].size = sizeof(EcsComponent);
-    result->columns[2].data = ecs_vector_new(&handle_arr_params, 12);
+    result->columns[1].alignment = ECS_COLUMN_ALIGNMENT;
+    result->columns[1].slab = world->slab;
+    result->columns[2].data = ecs_vector_new(&id_params, 12);
     result->columns[2].size = sizeof(EcsId);
+    result->columns[2].alignment = ECS_COLUMN_ALIGNMENT;
+    result->columns[2].slab = world->slab;
 
     set_table(stage, world->t_component, result);
+    register_table(world, result);
 
     return result;
 }
@@ -151,14 +271,17 @@ void bootstrap_component(
 
     /* Create record in entity index */
     ecs_row_t row = {.type = world->t_component, .index = index};
-    ecs_map_set(stage->entity_index, entity, &row);
+    ecs_sparse_set(stage->entity_index, entity, &row);
 
     /* Set size and id */
     EcsComponent *component_data = ecs_vector_first(table->columns[1].data);
     EcsId *id_data = ecs_vector_first(table->columns[2].data);
     
     component_data[index - 1].size = size;
+    component_data[index - 1].alignment = 0;
     id_data[index - 1] = id;
+
+    ecs_world_index_name(world, entity, id);
 }
 
 static
@@ -189,6 +312,7 @@ void ecs_notify_systems_of_table(
     notify_create_table(world, world->on_update_systems, table);
     notify_create_table(world, world->inactive_systems, table);
     notify_create_table(world, world->on_demand_systems, table);
+    ecs_notify_queries_of_table(world, table);
 }
 
 /** Create a new table and register it with the world and systems. A table in
@@ -212,8 +336,13 @@ ecs_table_t* create_table(
 
     set_table(stage, type, result);
 
-    if (stage == &world->main_stage && !world->is_merging) {
-        ecs_notify_systems_of_table(world, result);
+    if (stage == &world->main_stage) {
+        result->id = ++ world->last_table_id;
+        register_table(world, result);
+
+        if (!world->is_merging) {
+            ecs_notify_systems_of_table(world, result);
+        }
     }
 
     assert(result != NULL);
@@ -344,15 +473,235 @@ void ecs_world_activate_system(
 
     if (active) {
          *ecs_system_array(world, kind) = dst_array;
-         qsort(dst_array, ecs_vector_count(dst_array) + 1,
-          sizeof(ecs_entity_t), compare_handle);
+         ecs_vector_sort(dst_array, &handle_arr_params, compare_handle);
     } else {
         world->inactive_systems = dst_array;
-        qsort(src_array, ecs_vector_count(src_array) + 1,
-          sizeof(ecs_entity_t), compare_handle);
+        ecs_vector_sort(src_array, &handle_arr_params, compare_handle);
     }
 }
 
+/** Get flags with which an entity is stored in a type (CHILDOF, INSTANCEOF) */
+static
+ecs_entity_t type_entity_flags(
+    ecs_type_t type,
+    ecs_entity_t entity)
+{
+    ecs_entity_t *array = ecs_vector_first(type);
+    int32_t i, count = ecs_vector_count(type);
+    ecs_entity_t result = 0;
+
+    /* Entities with flags are stored at the end of a type */
+    for (i = count - 1; i >= 0; i --) {
+        ecs_entity_t e = array[i];
+
+        if (!(e & ECS_ENTITY_FLAGS_MASK)) {
+            break;
+        }
+
+        if ((e & ECS_ENTITY_MASK) == entity) {
+            result |= e & ECS_ENTITY_FLAGS_MASK;
+        }
+    }
+
+    return result;
+}
+
+/** Get bloom of the components that a type inherits from its prefabs */
+static
+uint64_t inherited_bloom(
+    ecs_world_t *world,
+    ecs_type_t type,
+    uint32_t depth)
+{
+    ecs_entity_t *array = ecs_vector_first(type);
+    int32_t i, count = ecs_vector_count(type);
+    uint64_t result = 0;
+
+    if (depth == ECS_MAX_INHERIT_DEPTH) {
+        return 0;
+    }
+
+    for (i = count - 1; i >= 0; i --) {
+        ecs_entity_t e = array[i];
+
+        if (!(e & ECS_ENTITY_FLAGS_MASK)) {
+            break;
+        }
+
+        if (e & ECS_INSTANCEOF) {
+            ecs_type_t base_type = ecs_get_type(world, e & ECS_ENTITY_MASK);
+            result |= ecs_type_bloom(base_type);
+            result |= inherited_bloom(world, base_type, depth + 1);
+        }
+    }
+
+    return result;
+}
+
+/** Get bloom of the components inherited from prefabs that are in type, but
+ * not in other */
+static
+uint64_t changed_bases_bloom(
+    ecs_world_t *world,
+    ecs_type_t type,
+    ecs_type_t other)
+{
+    ecs_entity_t *array = ecs_vector_first(type);
+    int32_t i, count = ecs_vector_count(type);
+    uint64_t result = 0;
+
+    for (i = count - 1; i >= 0; i --) {
+        ecs_entity_t e = array[i];
+
+        if (!(e & ECS_ENTITY_FLAGS_MASK)) {
+            break;
+        }
+
+        if (!(e & ECS_INSTANCEOF)) {
+            continue;
+        }
+
+        e &= ECS_ENTITY_MASK;
+
+        if (!(type_entity_flags(other, e) & ECS_INSTANCEOF)) {
+            ecs_type_t base_type = ecs_get_type(world, e);
+            result |= ecs_type_bloom(base_type);
+            result |= inherited_bloom(world, base_type, 1);
+        }
+    }
+
+    return result;
+}
+
+/** Systems are rematched at the start of the next frame. Only the components
+ * that were added or removed are stored, as only systems that use them can
+ * match differently with tables that depend on the entity. When a prefab is
+ * added or removed, the components it provides change as well. */
+void ecs_world_watch_changed(
+    ecs_world_t *world,
+    ecs_entity_t entity,
+    ecs_type_t old_type,
+    ecs_type_t new_type)
+{
+    uint64_t bloom = ecs_type_diff_bloom(old_type, new_type);
+    if (!bloom) {
+        return;
+    }
+
+    /* Components of prefabs that were added or removed are not in the diff */
+    bloom |= changed_bases_bloom(world, old_type, new_type);
+    bloom |= changed_bases_bloom(world, new_type, old_type);
+
+    uint64_t *ptr = ecs_map_get_ptr(world->watch_changes, entity);
+    if (ptr) {
+        *ptr |= bloom;
+    } else {
+        ecs_map_set(world->watch_changes, entity, &bloom);
+    }
+}
+
+/** Select the component with the fewest tables. Components in self may be
+ * inherited, so for those all tables with prefabs are iterated as well. */
+ecs_table_iter_t ecs_world_tables_iter(
+    ecs_world_t *world,
+    ecs_type_t owned,
+    ecs_type_t self)
+{
+    ecs_table_iter_t result = {
+        .world = world,
+        .tables = world->main_stage.tables,
+        .count = ecs_chunked_count(world->main_stage.tables)
+    };
+
+    ecs_entity_t *array = ecs_vector_first(owned);
+    uint32_t i, count = ecs_vector_count(owned);
+
+    for (i = 0; i < count; i ++) {
+        ecs_entity_t component = array[i] & ECS_ENTITY_MASK;
+        uint32_t table_count = ecs_vector_count(
+            component_tables(world, component));
+
+        if (!result.component || table_count < result.count) {
+            result.component = component;
+            result.count = table_count;
+        }
+    }
+
+    uint32_t prefab_count = ecs_vector_count(world->prefab_tables);
+    array = ecs_vector_first(self);
+    count = ecs_vector_count(self);
+
+    for (i = 0; i < count; i ++) {
+        ecs_entity_t component = array[i] & ECS_ENTITY_MASK;
+        uint32_t table_count = ecs_vector_count(
+            component_tables(world, component));
+
+        if (!result.component ||
+            table_count + prefab_count < result.count + result.prefab_count)
+        {
+            result.component = component;
+            result.count = table_count;
+            result.prefab_count = prefab_count;
+        }
+    }
+
+    if (result.component) {
+        result.tables = NULL;
+    }
+
+    return result;
+}
+
+/** Tables with prefabs are not visited from the index of the component when
+ * the tables with prefabs are iterated, so that no table is visited twice.
+ * The two lists are merged by table id, which preserves the order in which
+ * tables were created. */
+ecs_table_t* ecs_world_tables_next(
+    ecs_table_iter_t *it)
+{
+    if (it->tables) {
+        if (it->index == it->count) {
+            return NULL;
+        }
+
+        return ecs_chunked_get(it->tables, ecs_table_t, it->index ++);
+    }
+
+    ecs_world_t *world = it->world;
+    ecs_table_t *table = NULL;
+
+    /* Table lists are looked up every time, as tables that are created while
+     * iterating can reallocate them */
+    if (it->index < it->count) {
+        ecs_table_t **tables = ecs_vector_first(
+            component_tables(world, it->component));
+
+        do {
+            ecs_table_t *t = tables[it->index];
+            if (!it->prefab_count || !(t->flags & EcsTableHasPrefab)) {
+                table = t;
+                break;
+            }
+        } while (++ it->index < it->count);
+    }
+
+    if (it->prefab_index < it->prefab_count) {
+        ecs_table_t **prefab_tables = ecs_vector_first(world->prefab_tables);
+        ecs_table_t *t = prefab_tables[it->prefab_index];
+
+        if (!table || t->id < table->id) {
+            it->prefab_index ++;
+            return t;
+        }
+    }
+
+    if (table) {
+        it->index ++;
+    }
+
+    return table;
+}
+
 ecs_stage_t *ecs_get_stage(
     ecs_world_t **world_ptr)
 {
@@ -388,24 +737,7 @@ void col_systems_deinit(
 
     for (i = 0; i < count; i ++) {
         EcsColSystem *ptr = ecs_get_ptr(world, buffer[i], EcsColSystem);
-        ecs_vector_free(ptr->base.columns);
-        ecs_vector_free(ptr->jobs);
-
-        uint32_t t;
-        ecs_matched_table_t *tables = ecs_vector_first(ptr->inactive_tables);
-        for (t = 0; t < ecs_vector_count(ptr->inactive_tables); t ++) {
-            ecs_os_free(tables[t].columns);
-            ecs_os_free(tables[t].components);
-        }
-
-        tables = ecs_vector_first(ptr->tables);
-        for (t = 0; t < ecs_vector_count(ptr->tables); t ++) {
-            ecs_os_free(tables[t].columns);
-            ecs_os_free(tables[t].components);
-        }
-
-        ecs_vector_free(ptr->inactive_tables);
-        ecs_vector_free(ptr->tables);
+        ecs_col_system_deinit(world, ptr);
     }
 }
 
@@ -631,6 +963,8 @@ ecs_world_t *ecs_init(void) {
     world->on_store_systems = ecs_vector_new( &handle_arr_params, 0);
     world->inactive_systems = ecs_vector_new(&handle_arr_params, 0);
     world->on_demand_systems = ecs_vector_new(&handle_arr_params, 0);
+    world->sorted_systems = NULL;
+    world->queries = NULL;
 
     world->add_systems = ecs_vector_new(&handle_arr_params, 0);
     world->remove_systems = ecs_vector_new(&handle_arr_params, 0);
@@ -642,6 +976,12 @@ ecs_world_t *ecs_init(void) {
     world->type_sys_set_index = ecs_map_new(0, sizeof(ecs_vector_t*));
     world->type_handles = ecs_map_new(0, sizeof(ecs_entity_t));
     world->prefab_parent_index = ecs_map_new(0, sizeof(ecs_entity_t));
+    world->sparse_storage = NULL;
+    world->name_index = ecs_map_new(0, sizeof(ecs_vector_t*));
+    world->name_keys = ecs_map_new(0, sizeof(uint64_t));
+    world->watch_changes = ecs_map_new(0, sizeof(uint64_t));
+    world->component_tables = ecs_map_new(0, sizeof(ecs_vector_t*));
+    world->prefab_tables = NULL;
 
     world->worker_stages = NULL;
     world->worker_threads = NULL;
@@ -655,8 +995,9 @@ ecs_world_t *ecs_init(void) {
     world->measure_frame_time = false;
     world->measure_system_time = false;
     world->last_handle = 0;
+    world->last_table_id = 0;
+    world->free_handles = NULL;
     world->should_quit = false;
-    world->should_match = false;
 
     world->frame_start = (ecs_time_t){0, 0};
     world->frame_time = 0;
@@ -666,12 +1007,20 @@ ecs_world_t *ecs_init(void) {
     world->target_fps = 0;
     world->fps_sleep = 0;
     world->tick = 0;
+    world->change_tick = 1;
 
     world->context = NULL;
 
     world->arg_fps = 0;
     world->arg_threads = 0;
 
+    world->table_chunk_size = 0;
+    world->shrink_threshold = 0;
+    world->shrink_frames = 0;
+    world->gc_frames = 0;
+    world->slab = ecs_slab_new(ECS_WORLD_SLAB_SIZE);
+    world->column_arena = NULL;
+
     ecs_stage_init(world, &world->main_stage);
     ecs_stage_init(world, &world->temp_stage);
 
@@ -800,6 +1149,7 @@ int ecs_fini(
 
     deinit_tables(world);
 
+    ecs_queries_fini(world);
     col_systems_deinit(world, world->on_update_systems);
     col_systems_deinit(world, world->on_validate_systems);
     col_systems_deinit(world, world->pre_update_systems);
@@ -820,9 +1170,16 @@ int ecs_fini(
     row_index_deinit(world->type_sys_set_index);
     ecs_map_free(world->type_handles);
     ecs_map_free(world->prefab_parent_index);
+    ecs_map_free(world->watch_changes);
+    row_index_deinit(world->component_tables);
+    row_index_deinit(world->name_index);
+    ecs_map_free(world->name_keys);
+    ecs_vector_free(world->prefab_tables);
+    ecs_vector_free(world->free_handles);
 
-    ecs_stage_deinit(world, &world->main_stage);
     ecs_stage_deinit(world, &world->temp_stage);
+    ecs_stage_deinit(world, &world->main_stage);
+    ecs_sparse_component_fini(world);
 
     ecs_vector_free(world->on_update_systems);
     ecs_vector_free(world->on_validate_systems);
@@ -835,12 +1192,19 @@ int ecs_fini(
 
     ecs_vector_free(world->inactive_systems);
     ecs_vector_free(world->on_demand_systems);
+    ecs_vector_free(world->sorted_systems);
     ecs_vector_free(world->fini_tasks);
 
     ecs_vector_free(world->add_systems);
     ecs_vector_free(world->remove_systems);
     ecs_vector_free(world->set_systems);
 
+    /* Free allocators last, as other storage may use them */
+    ecs_slab_free(world->slab);
+    if (world->column_arena) {
+        ecs_slab_free(world->column_arena);
+    }
+
     world->magic = 0;
 
     ecs_os_free(world);
@@ -857,7 +1221,7 @@ void ecs_dim(
     uint32_t entity_count)
 {
     assert(world->magic == ECS_WORLD_MAGIC);
-    ecs_map_set_size(world->main_stage.entity_index, entity_count);
+    ecs_sparse_set_size(world->main_stage.entity_index, entity_count);
 }
 
 void _ecs_dim_type(
@@ -874,6 +1238,242 @@ void _ecs_dim_type(
     }
 }
 
+/** Delete tables that have been empty for at least the specified number of
+ * frames. Deleted tables are removed from the systems they were matched with,
+ * and from the add/remove edges of other tables. */
+static
+void collect_tables(
+    ecs_world_t *world,
+    uint32_t frames)
+{
+    ecs_stage_t *stage = &world->main_stage;
+    ecs_chunked_t *tables = stage->tables;
+    uint32_t garbage_count = 0;
+    int32_t i, count = ecs_chunked_count(tables);
+
+    for (i = 0; i < count; i ++) {
+        ecs_table_t *table = ecs_chunked_get(tables, ecs_table_t, i);
+
+        if (ecs_vector_count(table->columns[0].data)) {
+            table->empty_frames = 0;
+            continue;
+        }
+
+        table->empty_frames ++;
+        if (table->empty_frames >= frames) {
+            table->flags |= EcsTableIsGarbage;
+            garbage_count ++;
+        }
+    }
+
+    if (!garbage_count) {
+        return;
+    }
+
+    /* Remove edges to garbage tables before the tables are freed, as the flags
+     * of the destination tables need to be tested */
+    for (i = 0; i < count; i ++) {
+        ecs_table_t *table = ecs_chunked_get(tables, ecs_table_t, i);
+        if (!(table->flags & EcsTableIsGarbage)) {
+            ecs_table_clear_garbage_edges(table);
+        }
+    }
+
+    /* Iterate backwards, as removing a table moves the last table in the dense
+     * array to the index of the removed table */
+    for (i = count - 1; i >= 0; i --) {
+        ecs_table_t *table = ecs_chunked_get(tables, ecs_table_t, i);
+        if (!(table->flags & EcsTableIsGarbage)) {
+            continue;
+        }
+
+        ecs_entity_t *systems = ecs_vector_first(table->frame_systems);
+        uint32_t s, system_count = ecs_vector_count(table->frame_systems);
+        for (s = 0; s < system_count; s ++) {
+            ecs_col_system_remove_table(world, systems[s], table);
+        }
+
+        ecs_queries_remove_table(world, table);
+        unregister_table(world, table);
+
+        ecs_map_remove(stage->table_index, (uintptr_t)table->type);
+        ecs_table_free(world, table);
+        ecs_chunked_remove(tables, ecs_table_t, ecs_chunked_indices(tables)[i]);
+    }
+}
+
+void ecs_shrink(
+    ecs_world_t *world)
+{
+    ecs_assert(world->magic == ECS_WORLD_MAGIC, ECS_INVALID_FROM_WORKER, NULL);
+    ecs_assert(!world->in_progress, ECS_INVALID_WHILE_ITERATING, NULL);
+
+    ecs_chunked_t *tables = world->main_stage.tables;
+    uint32_t i, count = ecs_chunked_count(tables);
+
+    for (i = 0; i < count; i ++) {
+        ecs_table_t *table = ecs_chunked_get(tables, ecs_table_t, i);
+        ecs_table_shrink(world, table);
+    }
+}
+
+void ecs_gc(
+    ecs_world_t *world)
+{
+    ecs_assert(world->magic == ECS_WORLD_MAGIC, ECS_INVALID_FROM_WORKER, NULL);
+    ecs_assert(!world->in_progress, ECS_INVALID_WHILE_ITERATING, NULL);
+
+    collect_tables(world, 0);
+}
+
+void _ecs_shrink_type(
+    ecs_world_t *world,
+    ecs_type_t type)
+{
+    ecs_assert(world->magic == ECS_WORLD_MAGIC, ECS_INVALID_FROM_WORKER, NULL);
+    ecs_assert(!world->in_progress, ECS_INVALID_WHILE_ITERATING, NULL);
+
+    if (type) {
+        ecs_table_t *table = get_table(&world->main_stage, type);
+        if (table) {
+            ecs_table_shrink(world, table);
+        }
+    }
+}
+
+/** FNV-1a hash of an entity name */
+static
+uint64_t hash_name(
+    const char *name)
+{
+    uint64_t hash = 14695981039346656037ULL;
+    const char *ch;
+
+    for (ch = name; *ch; ch ++) {
+        hash ^= (uint8_t)*ch;
+        hash *= 1099511628211ULL;
+    }
+
+    return hash;
+}
+
+/** Get the name of an entity in the main stage, and the type of the entity */
+static
+const char* main_stage_name(
+    ecs_world_t *world,
+    ecs_entity_t entity,
+    ecs_type_t *type_out)
+{
+    ecs_row_t row;
+    if (!ecs_sparse_has(world->main_stage.entity_index, entity, &row)) {
+        return NULL;
+    }
+
+    int16_t column;
+    if (!row.type || (column = ecs_type_index_of(row.type, EEcsId)) == -1) {
+        return NULL;
+    }
+
+    /* Index is negative if the entity is watched */
+    int32_t index = row.index < 0 ? -row.index : row.index;
+    ecs_table_t *table = get_table(&world->main_stage, row.type);
+    EcsId *name = ecs_table_column_get(&table->columns[column + 1], index - 1);
+
+    *type_out = row.type;
+    return *name;
+}
+
+/** Find an entity in the name index. Names with colliding hashes are stored in
+ * the same entry, so the name of each candidate is compared with the name. */
+static
+ecs_entity_t lookup_in_name_index(
+    ecs_world_t *world,
+    ecs_entity_t parent,
+    const char *id)
+{
+    ecs_vector_t *entities = NULL;
+    if (!ecs_map_has(world->name_index, hash_name(id), &entities)) {
+        return 0;
+    }
+
+    ecs_entity_t *buffer = ecs_vector_first(entities);
+    uint32_t i, count = ecs_vector_count(entities);
+
+    for (i = 0; i < count; i ++) {
+        ecs_entity_t entity = buffer[i];
+        ecs_type_t type = NULL;
+        const char *name = main_stage_name(world, entity, &type);
+
+        if (name && !strcmp(name, id)) {
+            if (!parent || ecs_type_index_of(type, parent) != -1) {
+                return entity;
+            }
+        }
+    }
+
+    return 0;
+}
+
+void ecs_world_index_name(
+    ecs_world_t *world,
+    ecs_entity_t entity,
+    const char *name)
+{
+    if (!name) {
+        ecs_world_unindex_name(world, entity);
+        return;
+    }
+
+    uint64_t key = hash_name(name), old_key;
+
+    /* If the entity was renamed, remove it from the entry of the old name */
+    if (ecs_map_has(world->name_keys, entity, &old_key)) {
+        if (old_key == key) {
+            return;
+        }
+
+        ecs_world_unindex_name(world, entity);
+    }
+
+    ecs_vector_t *entities = NULL;
+    ecs_map_has(world->name_index, key, &entities);
+
+    ecs_entity_t *elem = ecs_vector_add(&entities, &handle_arr_params);
+    *elem = entity;
+    ecs_map_set(world->name_index, key, &entities);
+    ecs_map_set(world->name_keys, entity, &key);
+}
+
+void ecs_world_unindex_name(
+    ecs_world_t *world,
+    ecs_entity_t entity)
+{
+    uint64_t key;
+    if (!ecs_map_has(world->name_keys, entity, &key)) {
+        return;
+    }
+
+    ecs_map_remove(world->name_keys, entity);
+
+    ecs_vector_t *entities = NULL;
+    ecs_map_has(world->name_index, key, &entities);
+    ecs_assert(entities != NULL, ECS_INTERNAL_ERROR, NULL);
+
+    ecs_entity_t *buffer = ecs_vector_first(entities);
+    uint32_t i, count = ecs_vector_count(entities);
+    for (i = 0; i < count; i ++) {
+        if (buffer[i] == entity) {
+            ecs_vector_remove_index(entities, &handle_arr_params, i);
+            break;
+        }
+    }
+
+    if (!ecs_vector_count(entities)) {
+        ecs_vector_free(entities);
+        ecs_map_remove(world->name_index, key);
+    }
+}
+
 static
 ecs_entity_t ecs_lookup_child_in_columns(
     ecs_type_t type,
@@ -892,11 +1492,11 @@ ecs_entity_t ecs_lookup_child_in_columns(
     }
 
     ecs_table_column_t *column = &columns[column_index + 1];
-    EcsId *buffer = ecs_vector_first(column->data);
-    uint32_t i, count = ecs_vector_count(column->data);
+    uint32_t i, count = ecs_vector_count(columns[0].data);
     
     for (i = 0; i < count; i ++) {
-        if (!strcmp(buffer[i], id)) {
+        EcsId *name = ecs_table_column_get(column, i);
+        if (!strcmp(*name, id)) {
             return *(ecs_entity_t*)ecs_vector_get(
                 columns[0].data, &handle_arr_params, i);
         }
@@ -928,17 +1528,7 @@ ecs_entity_t ecs_lookup_child(
     }
 
     if (!result) {
-        ecs_chunked_t *tables = world->main_stage.tables;
-        uint32_t t, count = ecs_chunked_count(tables);
-
-        for (t = 0; t < count; t ++) {
-            ecs_table_t *table = ecs_chunked_get(tables, ecs_table_t, t);
-            result = ecs_lookup_child_in_columns(
-                table->type, table->columns, parent, id);
-            if (result) {
-                break;
-            }
-        }
+        result = lookup_in_name_index(world, parent, id);
     }
 
     return result;
@@ -955,17 +1545,103 @@ ecs_entity_t ecs_lookup(
     return ecs_lookup_child(world, 0, id);
 }
 
+/** Add the watched entities of a table to the entities to visit. Only watched
+ * entities can be a parent or a prefab of another entity. */
+static
+void add_watched_entities(
+    ecs_world_t *world,
+    ecs_table_t *table,
+    ecs_vector_t **entities,
+    ecs_map_t *visited)
+{
+    ecs_entity_t *buffer = ecs_vector_first(table->columns[0].data);
+    uint32_t i, count = ecs_vector_count(table->columns[0].data);
+
+    for (i = 0; i < count; i ++) {
+        ecs_entity_t e = buffer[i];
+        ecs_row_t *row = ecs_sparse_get_ptr(world->main_stage.entity_index, e);
+
+        if (!row || row->index >= 0 || ecs_map_get_ptr(visited, e)) {
+            continue;
+        }
+
+        bool value = true;
+        ecs_map_set(visited, e, &value);
+
+        ecs_entity_t *elem = ecs_vector_add(entities, &handle_arr_params);
+        *elem = e;
+    }
+}
+
+/** Find the tables that are a child of, or inherit from a changed entity, with
+ * the component index. Entities that inherit from a changed entity are visited
+ * as well, as tables that depend on them inherit the changes. */
+static
+void collect_rematch_tables(
+    ecs_world_t *world,
+    ecs_rematch_t *rematch)
+{
+    ecs_vector_t *entities = NULL;
+    ecs_map_t *visited = ecs_map_new(0, sizeof(bool));
+    ecs_map_t *visited_tables = ecs_map_new(0, sizeof(bool));
+    bool value = true;
+
+    ecs_map_iter_t it = ecs_map_iter(rematch->entities);
+    while (ecs_map_hasnext(&it)) {
+        uint64_t key;
+        rematch->bloom |= ecs_map_next64_w_key(&it, &key);
+
+        ecs_entity_t *elem = ecs_vector_add(&entities, &handle_arr_params);
+        *elem = key;
+        ecs_map_set(visited, key, &value);
+    }
+
+    /* Entities are added while iterating */
+    uint32_t i;
+    for (i = 0; i < ecs_vector_count(entities); i ++) {
+        ecs_entity_t entity = *(ecs_entity_t*)ecs_vector_get(
+            entities, &handle_arr_params, i);
+        ecs_vector_t *tables = component_tables(world, entity);
+        uint32_t t, count = ecs_vector_count(tables);
+
+        for (t = 0; t < count; t ++) {
+            ecs_table_t *table = ((ecs_table_t**)ecs_vector_first(tables))[t];
+            ecs_entity_t flags = type_entity_flags(table->type, entity);
+
+            if (!(flags & (ECS_CHILDOF | ECS_INSTANCEOF))) {
+                continue;
+            }
+
+            if (!ecs_map_get_ptr(visited_tables, (uintptr_t)table)) {
+                ecs_map_set(visited_tables, (uintptr_t)table, &value);
+                ecs_table_t **elem = ecs_vector_add(
+                    &rematch->tables, &table_ptr_params);
+                *elem = table;
+            }
+
+            if (flags & ECS_INSTANCEOF) {
+                add_watched_entities(world, table, &entities, visited);
+            }
+        }
+    }
+
+    ecs_vector_free(entities);
+    ecs_map_free(visited);
+    ecs_map_free(visited_tables);
+}
+
 static
 void rematch_system_array(
     ecs_world_t *world,
-    ecs_vector_t *systems)
+    ecs_vector_t *systems,
+    const ecs_rematch_t *rematch)
 {
     uint32_t i, count = ecs_vector_count(systems);
     ecs_entity_t *buffer = ecs_vector_first(systems);
 
     for (i = 0; i < count; i ++) {
         ecs_entity_t system = buffer[i];
-        ecs_rematch_system(world, system);
+        ecs_rematch_system(world, system, rematch);
 
         if (system != buffer[i]) {
             /* It is possible that rematching a system caused it to be activated
@@ -977,19 +1653,30 @@ void rematch_system_array(
     }
 }
 
+/** Rematch systems after watched entities changed type. Only the tables that
+ * depend on the changed entities are rematched. */
 static
 void rematch_systems(
     ecs_world_t *world)
 {
-    rematch_system_array(world, world->on_load_systems);
-    rematch_system_array(world, world->post_load_systems);
-    rematch_system_array(world, world->pre_update_systems);
-    rematch_system_array(world, world->on_update_systems);
-    rematch_system_array(world, world->on_validate_systems);
-    rematch_system_array(world, world->post_update_systems);
-    rematch_system_array(world, world->pre_store_systems);
-    rematch_system_array(world, world->on_store_systems);    
-    rematch_system_array(world, world->inactive_systems);   
+    ecs_map_t *changes = world->watch_changes;
+    ecs_rematch_t rematch = {.entities = changes};
+
+    collect_rematch_tables(world, &rematch);
+
+    rematch_system_array(world, world->on_load_systems, &rematch);
+    rematch_system_array(world, world->post_load_systems, &rematch);
+    rematch_system_array(world, world->pre_update_systems, &rematch);
+    rematch_system_array(world, world->on_update_systems, &rematch);
+    rematch_system_array(world, world->on_validate_systems, &rematch);
+    rematch_system_array(world, world->post_update_systems, &rematch);
+    rematch_system_array(world, world->pre_store_systems, &rematch);
+    rematch_system_array(world, world->on_store_systems, &rematch);
+    rematch_system_array(world, world->inactive_systems, &rematch);
+    ecs_rematch_queries(world, &rematch);
+
+    ecs_vector_free(rematch.tables);
+    ecs_map_clear(changes);
 }
 
 static
@@ -1019,6 +1706,21 @@ void revalidate_system_refs(
     revalidate_system_array(world, world->pre_store_systems);
     revalidate_system_array(world, world->on_store_systems);    
     revalidate_system_array(world, world->inactive_systems);   
+    ecs_revalidate_query_refs(world);
+}
+
+/** Restore the order of tables of systems that sort their tables. This happens
+ * before any system is ran, so that tables are not modified while iterated. */
+static
+void sort_system_tables(
+    ecs_world_t *world)
+{
+    ecs_entity_t *buffer = ecs_vector_first(world->sorted_systems);
+    uint32_t i, count = ecs_vector_count(world->sorted_systems);
+
+    for (i = 0; i < count; i ++) {
+        ecs_col_system_sort_tables(world, buffer[i]);
+    }
 }
 
 static
@@ -1064,6 +1766,10 @@ void run_multi_thread_stage(
             }
             ecs_prepare_jobs(world, buffer[i]);
         }
+
+        /* Systems run in parallel, so their writes must be newer than the
+         * current run of each system */
+        world->change_tick ++;
         ecs_run_jobs(world);
 
         if (world->auto_merge) {
@@ -1074,6 +1780,33 @@ void run_multi_thread_stage(
     }
 }
 
+/** Shrink tables of which the occupancy has been below the shrink threshold for
+ * the configured number of frames */
+static
+void autoshrink_tables(
+    ecs_world_t *world)
+{
+    ecs_chunked_t *tables = world->main_stage.tables;
+    uint32_t i, count = ecs_chunked_count(tables);
+    float threshold = world->shrink_threshold;
+    uint32_t frames = world->shrink_frames;
+
+    for (i = 0; i < count; i ++) {
+        ecs_table_t *table = ecs_chunked_get(tables, ecs_table_t, i);
+        ecs_vector_t *entities = table->columns[0].data;
+        uint32_t size = ecs_vector_size(entities);
+
+        if (size && ecs_vector_count(entities) < size * threshold) {
+            table->low_occupancy_frames ++;
+            if (table->low_occupancy_frames >= frames) {
+                ecs_table_shrink(world, table);
+            }
+        } else {
+            table->low_occupancy_frames = 0;
+        }
+    }
+}
+
 static
 float start_measure_frame(
     ecs_world_t *world,
@@ -1148,11 +1881,12 @@ bool ecs_progress(
 
     bool has_threads = ecs_vector_count(world->worker_threads) != 0;
 
-    if (world->should_match) {
+    if (ecs_map_count(world->watch_changes)) {
         rematch_systems(world);
-        world->should_match = false;
     }
 
+    sort_system_tables(world);
+
     if (world->should_resolve) {
         revalidate_system_refs(world);
         world->should_resolve = false;
@@ -1189,6 +1923,14 @@ bool ecs_progress(
 
     world->in_progress = false;
 
+    if (world->shrink_frames) {
+        autoshrink_tables(world);
+    }
+
+    if (world->gc_frames) {
+        collect_tables(world, world->gc_frames);
+    }
+
     return !world->should_quit;
 }
 
@@ -1245,6 +1987,60 @@ void ecs_set_automerge(
     world->auto_merge = auto_merge;
 }
 
+void ecs_set_table_chunk_size(
+    ecs_world_t *world,
+    uint32_t size)
+{
+    ecs_assert(world->magic == ECS_WORLD_MAGIC, ECS_INVALID_FROM_WORKER, NULL);
+    ecs_assert(!world->in_progress, ECS_INVALID_WHILE_ITERATING, NULL);
+    world->table_chunk_size = size;
+}
+
+void ecs_set_column_arena(
+    ecs_world_t *world,
+    bool enable)
+{
+    ecs_assert(world->magic == ECS_WORLD_MAGIC, ECS_INVALID_FROM_WORKER, NULL);
+    ecs_assert(!world->in_progress, ECS_INVALID_WHILE_ITERATING, NULL);
+
+    /* Buffers that were allocated from the arena are released to it even after
+     * it is disabled, so the arena is kept alive until the world is deleted */
+    if (enable) {
+        if (!world->column_arena) {
+            world->column_arena = ecs_slab_new(ECS_COLUMN_ARENA_SIZE);
+        }
+        ecs_slab_set_arena(world->slab, world->column_arena);
+    } else {
+        ecs_slab_set_arena(world->slab, NULL);
+    }
+}
+
+void ecs_set_autogc(
+    ecs_world_t *world,
+    uint32_t frames)
+{
+    ecs_assert(world->magic == ECS_WORLD_MAGIC, ECS_INVALID_FROM_WORKER, NULL);
+    world->gc_frames = frames;
+}
+
+void ecs_set_autoshrink(
+    ecs_world_t *world,
+    float threshold,
+    uint32_t frames)
+{
+    ecs_assert(world->magic == ECS_WORLD_MAGIC, ECS_INVALID_FROM_WORKER, NULL);
+    ecs_assert(threshold >= 0 && threshold <= 1, ECS_INVALID_PARAMETER, NULL);
+
+    if (threshold == 0) {
+        frames = 0;
+    } else if (!frames) {
+        frames = 1;
+    }
+
+    world->shrink_threshold = threshold;
+    world->shrink_frames = frames;
+}
+
 void ecs_measure_frame_time(
     ecs_world_t *world,
     bool enable)
@@ -1350,6 +2146,14 @@ void ecs_set_entity_range(
 
     world->min_handle = id_start;
     world->max_handle = id_end;
+
+    /* Blocks reserved by worker stages may be outside of the new range */
+    ecs_stage_t *buffer = ecs_vector_first(world->worker_stages);
+    uint32_t i, count = ecs_vector_count(world->worker_stages);
+    for (i = 0; i < count; i ++) {
+        buffer[i].id_block_next = 0;
+        buffer[i].id_block_end = 0;
+    }
 }
 
 bool ecs_enable_range_check(
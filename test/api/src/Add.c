@@ -559,3 +559,93 @@ void Add_on_add_after_new_type_in_progress() {
 
     ecs_fini(world);
 }
+
+void Add_add_remove_cached() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+
+    ecs_entity_t e1 = ecs_new(world, Position);
+    ecs_entity_t e2 = ecs_new(world, Position);
+
+    /* Second add/remove uses the destination table cached by the first */
+    ecs_add(world, e1, Velocity);
+    ecs_add(world, e2, Velocity);
+    test_assert(ecs_get_type(world, e1) == ecs_get_type(world, e2));
+    test_assert(ecs_has(world, e2, Position));
+    test_assert(ecs_has(world, e2, Velocity));
+
+    ecs_remove(world, e1, Velocity);
+    ecs_remove(world, e2, Velocity);
+    test_assert(ecs_get_type(world, e1) == ecs_get_type(world, e2));
+    test_assert(ecs_has(world, e2, Position));
+    test_assert(!ecs_has(world, e2, Velocity));
+
+    ecs_remove(world, e1, Position);
+    ecs_remove(world, e2, Position);
+    test_assert(ecs_is_empty(world, e1));
+    test_assert(ecs_is_empty(world, e2));
+
+    ecs_fini(world);
+}
+
+void Add_add_cached_in_progress() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+    ECS_SYSTEM(world, AddInProgress, EcsOnUpdate, Position, .Velocity);
+
+    ecs_entity_t e1 = ecs_new(world, Position);
+    ecs_add(world, e1, Velocity);
+
+    ecs_entity_t e2 = ecs_new(world, Position);
+
+    ecs_progress(world, 1);
+
+    test_assert(ecs_has(world, e2, Position));
+    test_assert(ecs_has(world, e2, Velocity));
+    test_assert(ecs_get_type(world, e1) == ecs_get_type(world, e2));
+
+    ecs_fini(world);
+}
+
+/* Toggle a component on a large number of entities, which moves entities back
+ * and forth between the same two tables. */
+void Add_bench_toggle_1m() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+
+    uint32_t i, count = 1000000;
+    ecs_entity_t first = ecs_new_w_count(world, Position, count);
+
+    ecs_time_t t_start;
+    ecs_os_get_time(&t_start);
+
+    for (i = 0; i < count; i ++) {
+        ecs_add(world, first + i, Velocity);
+    }
+
+    double t_add = ecs_time_measure(&t_start);
+
+    test_int(ecs_count(world, Velocity), count);
+
+    ecs_os_get_time(&t_start);
+
+    for (i = 0; i < count; i ++) {
+        ecs_remove(world, first + i, Velocity);
+    }
+
+    double t_remove = ecs_time_measure(&t_start);
+
+    test_int(ecs_count(world, Velocity), 0);
+    test_int(ecs_count(world, Position), count);
+
+    ecs_os_log("toggle component on %u entities: add %.2fns, remove %.2fns",
+        count, t_add * 1000000000.0 / count, t_remove * 1000000000.0 / count);
+
+    ecs_fini(world);
+}
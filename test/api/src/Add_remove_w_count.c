@@ -0,0 +1,422 @@
+#include <api.h>
+
+static
+void set_positions(
+    ecs_world_t *world,
+    ecs_entity_t e,
+    uint32_t count)
+{
+    ECS_COMPONENT(world, Position);
+
+    uint32_t i;
+    for (i = 0; i < count; i ++) {
+        ecs_set(world, e + i, Position, {i, i * 2});
+    }
+}
+
+static
+void test_positions(
+    ecs_world_t *world,
+    ecs_entity_t e,
+    uint32_t count)
+{
+    ECS_COMPONENT(world, Position);
+
+    uint32_t i;
+    for (i = 0; i < count; i ++) {
+        Position *p = ecs_get_ptr(world, e + i, Position);
+        test_assert(p != NULL);
+        test_int(p->x, i);
+        test_int(p->y, i * 2);
+    }
+}
+
+void Add_remove_w_count_add() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+
+    ecs_entity_t e = ecs_new_w_count(world, Position, 100);
+    set_positions(world, e, 100);
+
+    ecs_add_w_count(world, e, 100, Velocity);
+
+    test_int(ecs_count(world, Position), 100);
+    test_int(ecs_count(world, Velocity), 100);
+
+    int i;
+    for (i = 0; i < 100; i ++) {
+        test_assert(ecs_has(world, e + i, Velocity));
+    }
+
+    test_positions(world, e, 100);
+
+    ecs_fini(world);
+}
+
+void Add_remove_w_count_remove() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+    ECS_TYPE(world, Type, Position, Velocity);
+
+    ecs_entity_t e = ecs_new_w_count(world, Type, 100);
+    set_positions(world, e, 100);
+
+    ecs_remove_w_count(world, e, 100, Velocity);
+
+    test_int(ecs_count(world, Position), 100);
+    test_int(ecs_count(world, Velocity), 0);
+
+    int i;
+    for (i = 0; i < 100; i ++) {
+        test_assert(ecs_get_type(world, e + i) == ecs_type(Position));
+    }
+
+    test_positions(world, e, 100);
+
+    ecs_fini(world);
+}
+
+void Add_remove_w_count_add_remove() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+    ECS_COMPONENT(world, Mass);
+    ECS_TYPE(world, Type, Position, Velocity);
+
+    ecs_entity_t e = ecs_new_w_count(world, Type, 100);
+    set_positions(world, e, 100);
+
+    ecs_add_remove_w_count(world, e, 100, Mass, Velocity);
+
+    test_int(ecs_count(world, Position), 100);
+    test_int(ecs_count(world, Velocity), 0);
+    test_int(ecs_count(world, Mass), 100);
+
+    test_positions(world, e, 100);
+
+    ecs_fini(world);
+}
+
+void Add_remove_w_count_remove_all() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+
+    ecs_entity_t e = ecs_new_w_count(world, Position, 100);
+
+    ecs_remove_w_count(world, e, 100, Position);
+
+    test_int(ecs_count(world, Position), 0);
+
+    int i;
+    for (i = 0; i < 100; i ++) {
+        test_assert(ecs_is_empty(world, e + i));
+    }
+
+    /* Entities can be added to the table again */
+    ecs_add_w_count(world, e, 100, Position);
+    test_int(ecs_count(world, Position), 100);
+    set_positions(world, e, 100);
+    test_positions(world, e, 100);
+
+    ecs_fini(world);
+}
+
+void Add_remove_w_count_add_subset() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+
+    ecs_entity_t e = ecs_new_w_count(world, Position, 100);
+    set_positions(world, e, 100);
+
+    /* Rows at the end of the table are moved into the gap */
+    ecs_add_w_count(world, e + 10, 30, Velocity);
+
+    test_int(ecs_count(world, Position), 100);
+    test_int(ecs_count(world, Velocity), 30);
+
+    int i;
+    for (i = 0; i < 100; i ++) {
+        test_assert(ecs_has(world, e + i, Velocity) == (i >= 10 && i < 40));
+    }
+
+    test_positions(world, e, 100);
+
+    ecs_fini(world);
+}
+
+void Add_remove_w_count_add_subset_at_end() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+
+    ecs_entity_t e = ecs_new_w_count(world, Position, 100);
+    set_positions(world, e, 100);
+
+    /* Gap is larger than the number of rows after it */
+    ecs_add_w_count(world, e + 50, 40, Velocity);
+
+    test_int(ecs_count(world, Velocity), 40);
+
+    int i;
+    for (i = 0; i < 100; i ++) {
+        test_assert(ecs_has(world, e + i, Velocity) == (i >= 50 && i < 90));
+    }
+
+    test_positions(world, e, 100);
+
+    ecs_fini(world);
+}
+
+void Add_remove_w_count_add_to_existing() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+    ECS_TYPE(world, Type, Position, Velocity);
+
+    /* Destination table is not empty */
+    ecs_entity_t e_1 = ecs_new_w_count(world, Type, 10);
+    set_positions(world, e_1, 10);
+
+    ecs_entity_t e_2 = ecs_new_w_count(world, Position, 100);
+    set_positions(world, e_2, 100);
+
+    ecs_add_w_count(world, e_2, 100, Velocity);
+
+    test_int(ecs_count(world, Type), 110);
+    test_positions(world, e_1, 10);
+    test_positions(world, e_2, 100);
+
+    ecs_fini(world);
+}
+
+void Add_remove_w_count_not_contiguous() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+    ECS_COMPONENT(world, Mass);
+
+    /* Entities alternate between tables, and some are empty */
+    ecs_entity_t e = ecs_new(world, 0);
+    int i;
+    for (i = 1; i < 100; i ++) {
+        if (i % 3 == 0) {
+            ecs_new(world, 0);
+        } else if (i % 3 == 1) {
+            ecs_new(world, Position);
+        } else {
+            ecs_new(world, Mass);
+        }
+    }
+
+    ecs_add_w_count(world, e, 100, Velocity);
+
+    test_int(ecs_count(world, Velocity), 100);
+
+    for (i = 0; i < 100; i ++) {
+        test_assert(ecs_has(world, e + i, Velocity));
+        if (i && i % 3 == 1) {
+            test_assert(ecs_has(world, e + i, Position));
+        }
+        if (i % 3 == 2) {
+            test_assert(ecs_has(world, e + i, Mass));
+        }
+    }
+
+    ecs_fini(world);
+}
+
+void Add_remove_w_count_watched() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+
+    ecs_entity_t e = ecs_new_w_count(world, Position, 10);
+    set_positions(world, e, 10);
+
+    /* Adding the entity as a parent marks it as watched */
+    ecs_entity_t child = ecs_new(world, 0);
+    ecs_adopt(world, child, e + 5);
+
+    ecs_add_w_count(world, e, 10, Velocity);
+
+    test_positions(world, e, 10);
+    test_assert(ecs_has(world, e + 5, Velocity));
+    test_assert(ecs_has_entity(world, child, ECS_CHILDOF | (e + 5)));
+
+    ecs_remove_w_count(world, e, 10, Velocity);
+    test_positions(world, e, 10);
+    test_assert(!ecs_has(world, e + 5, Velocity));
+
+    ecs_fini(world);
+}
+
+static
+void OnAddVelocity(ecs_rows_t *rows) {
+    ECS_COLUMN(rows, Velocity, v, 1);
+    int *count = rows->param;
+
+    int i;
+    for (i = 0; i < rows->count; i ++) {
+        v[i].x = rows->entities[i];
+        v[i].y = 0;
+    }
+
+    count[0] ++;
+    count[1] += rows->count;
+}
+
+void Add_remove_w_count_on_add() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+    ECS_SYSTEM(world, OnAddVelocity, EcsOnAdd, Velocity);
+
+    int count[2] = {0};
+    ecs_set_system_context(world, OnAddVelocity, count);
+
+    ecs_entity_t e = ecs_new_w_count(world, Position, 100);
+    ecs_add_w_count(world, e, 100, Velocity);
+
+    test_int(count[0], 1);
+    test_int(count[1], 100);
+
+    int i;
+    for (i = 0; i < 100; i ++) {
+        Velocity *v = ecs_get_ptr(world, e + i, Velocity);
+        test_assert(v != NULL);
+        test_int(v->x, e + i);
+    }
+
+    ecs_fini(world);
+}
+
+static
+void OnRemoveVelocity(ecs_rows_t *rows) {
+    ECS_COLUMN(rows, Velocity, v, 1);
+    int *count = rows->param;
+
+    int i;
+    for (i = 0; i < rows->count; i ++) {
+        test_int(v[i].x, rows->entities[i]);
+    }
+
+    count[0] ++;
+    count[1] += rows->count;
+}
+
+void Add_remove_w_count_on_remove() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+    ECS_TYPE(world, Type, Position, Velocity);
+    ECS_SYSTEM(world, OnRemoveVelocity, EcsOnRemove, Velocity);
+
+    int count[2] = {0};
+    ecs_set_system_context(world, OnRemoveVelocity, count);
+
+    ecs_entity_t e = ecs_new_w_count(world, Type, 100);
+
+    int i;
+    for (i = 0; i < 100; i ++) {
+        ecs_set(world, e + i, Velocity, {e + i, 0});
+    }
+
+    ecs_remove_w_count(world, e + 20, 50, Velocity);
+
+    test_int(count[0], 1);
+    test_int(count[1], 50);
+    test_int(ecs_count(world, Velocity), 50);
+
+    ecs_fini(world);
+}
+
+static
+void CountVelocity(ecs_rows_t *rows) {
+    int *count = rows->param;
+    *count += rows->count;
+}
+
+void Add_remove_w_count_system() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+    ECS_SYSTEM(world, CountVelocity, EcsOnUpdate, Velocity);
+
+    int count = 0;
+    ecs_set_system_context(world, CountVelocity, &count);
+
+    ecs_entity_t e = ecs_new_w_count(world, Position, 100);
+    ecs_add_w_count(world, e, 100, Velocity);
+
+    ecs_progress(world, 1);
+    test_int(count, 100);
+
+    /* Table with Velocity is deactivated when it becomes empty */
+    ecs_remove_w_count(world, e, 100, Velocity);
+
+    count = 0;
+    ecs_progress(world, 1);
+    test_int(count, 0);
+
+    ecs_fini(world);
+}
+
+void Add_remove_w_count_chunked() {
+    ecs_world_t *world = ecs_init();
+    ecs_set_table_chunk_size(world, 256);
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+
+    ecs_entity_t e = ecs_new_w_count(world, Position, 100);
+    set_positions(world, e, 100);
+
+    ecs_add_w_count(world, e + 5, 60, Velocity);
+    test_int(ecs_count(world, Velocity), 60);
+    test_positions(world, e, 100);
+
+    ecs_add_w_count(world, e, 100, Velocity);
+    test_int(ecs_count(world, Velocity), 100);
+    test_positions(world, e, 100);
+
+    ecs_fini(world);
+}
+
+static
+void AddVelocityRange(ecs_rows_t *rows) {
+    ECS_COLUMN_COMPONENT(rows, Velocity, 2);
+    ecs_add_w_count(rows->world, rows->entities[0], rows->count, Velocity);
+}
+
+void Add_remove_w_count_in_progress() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+    ECS_SYSTEM(world, AddVelocityRange, EcsOnUpdate, Position, .Velocity);
+
+    ecs_entity_t e = ecs_new_w_count(world, Position, 100);
+    set_positions(world, e, 100);
+
+    ecs_progress(world, 1);
+
+    test_int(ecs_count(world, Velocity), 100);
+    test_positions(world, e, 100);
+
+    ecs_fini(world);
+}
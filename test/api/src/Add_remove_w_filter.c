@@ -496,3 +496,35 @@ void Add_remove_w_filter_add_2() {
 
     ecs_fini(world);
 }
+
+void Add_remove_w_filter_add_1_preserves_data() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+
+    ecs_entity_t e = ecs_new_w_count(world, Position, 10);
+
+    int i;
+    for (i = 0; i < 10; i ++) {
+        ecs_set(world, e + i, Position, {i, i * 2});
+    }
+
+    ecs_add_remove_w_filter(world, Velocity, 0, &(ecs_type_filter_t){
+        .include = ecs_type(Position)
+    });
+
+    test_int( ecs_count(world, Velocity), 10);
+
+    for (i = 0; i < 10; i ++) {
+        Position *p = ecs_get_ptr(world, e + i, Position);
+        test_assert(p != NULL);
+        test_int(p->x, i);
+        test_int(p->y, i * 2);
+
+        ecs_set(world, e + i, Velocity, {i, 0});
+        test_assert(ecs_get_ptr(world, e + i, Velocity) != NULL);
+    }
+
+    ecs_fini(world);
+}
@@ -0,0 +1,352 @@
+#include <api.h>
+
+/* A chunk of 256 bytes stores 32 Position (or Velocity) components */
+#define CHUNK_SIZE (256)
+#define CHUNK_ROWS (32)
+
+static
+void Iter(ecs_rows_t *rows) {
+    ECS_COLUMN(rows, Position, p, 1);
+    int *count = rows->param;
+
+    test_assert(rows->count <= CHUNK_ROWS);
+    test_int(rows->offset % CHUNK_ROWS, 0);
+
+    int i;
+    for (i = 0; i < rows->count; i ++) {
+        test_int(p[i].x, rows->entities[i]);
+        p[i].y ++;
+    }
+
+    count[0] ++;
+    count[1] += rows->count;
+}
+
+void Chunked_iter() {
+    ecs_world_t *world = ecs_init();
+    ecs_set_table_chunk_size(world, CHUNK_SIZE);
+
+    ECS_COMPONENT(world, Position);
+    ECS_SYSTEM(world, Iter, EcsManual, Position);
+
+    int i;
+    for (i = 0; i < 100; i ++) {
+        ecs_entity_t e = ecs_new(world, 0);
+        ecs_set(world, e, Position, {e, 0});
+    }
+
+    int count[2] = {0};
+    ecs_run(world, Iter, 1, count);
+
+    /* 100 rows in chunks of 32 rows */
+    test_int(count[0], 4);
+    test_int(count[1], 100);
+
+    ecs_fini(world);
+}
+
+void Chunked_new_w_count() {
+    ecs_world_t *world = ecs_init();
+    ecs_set_table_chunk_size(world, CHUNK_SIZE);
+
+    ECS_COMPONENT(world, Position);
+    ECS_SYSTEM(world, Iter, EcsManual, Position);
+
+    ecs_entity_t e = ecs_new_w_count(world, Position, 100);
+    test_assert(e != 0);
+    test_int(ecs_count(world, Position), 100);
+
+    int i;
+    for (i = 0; i < 100; i ++) {
+        ecs_set(world, e + i, Position, {e + i, 0});
+    }
+
+    int count[2] = {0};
+    ecs_run(world, Iter, 1, count);
+    test_int(count[0], 4);
+    test_int(count[1], 100);
+
+    for (i = 0; i < 100; i ++) {
+        Position *p = ecs_get_ptr(world, e + i, Position);
+        test_assert(p != NULL);
+        test_int(p->x, e + i);
+        test_int(p->y, 1);
+    }
+
+    ecs_fini(world);
+}
+
+void Chunked_rows_do_not_move() {
+    ecs_world_t *world = ecs_init();
+    ecs_set_table_chunk_size(world, CHUNK_SIZE);
+
+    ECS_COMPONENT(world, Position);
+
+    ecs_entity_t e = ecs_set(world, 0, Position, {10, 20});
+    Position *p = ecs_get_ptr(world, e, Position);
+    test_assert(p != NULL);
+    test_int((uintptr_t)p % ECS_COLUMN_ALIGNMENT, 0);
+
+    int i;
+    for (i = 0; i < 1000; i ++) {
+        ecs_set(world, 0, Position, {i, i});
+    }
+
+    ecs_new_w_count(world, Position, 1000);
+
+    test_assert(ecs_get_ptr(world, e, Position) == p);
+    test_int(p->x, 10);
+    test_int(p->y, 20);
+
+    ecs_fini(world);
+}
+
+void Chunked_delete() {
+    ecs_world_t *world = ecs_init();
+    ecs_set_table_chunk_size(world, CHUNK_SIZE);
+
+    ECS_COMPONENT(world, Position);
+    ECS_SYSTEM(world, Iter, EcsManual, Position);
+
+    ecs_entity_t e = ecs_new_w_count(world, Position, 100);
+
+    int i;
+    for (i = 0; i < 100; i ++) {
+        ecs_set(world, e + i, Position, {e + i, 0});
+    }
+
+    /* Delete every other entity, so that rows from the last chunks are moved
+     * into earlier chunks. */
+    for (i = 0; i < 100; i += 2) {
+        ecs_delete(world, e + i);
+    }
+
+    test_int(ecs_count(world, Position), 50);
+
+    for (i = 1; i < 100; i += 2) {
+        Position *p = ecs_get_ptr(world, e + i, Position);
+        test_assert(p != NULL);
+        test_int(p->x, e + i);
+    }
+
+    int count[2] = {0};
+    ecs_run(world, Iter, 1, count);
+    test_int(count[0], 2);
+    test_int(count[1], 50);
+
+    ecs_fini(world);
+}
+
+void Chunked_add_remove() {
+    ecs_world_t *world = ecs_init();
+    ecs_set_table_chunk_size(world, CHUNK_SIZE);
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+
+    ecs_entity_t e = ecs_new_w_count(world, Position, 100);
+
+    int i;
+    for (i = 0; i < 100; i ++) {
+        ecs_set(world, e + i, Position, {i, i * 2});
+        ecs_set(world, e + i, Velocity, {i * 3, i * 4});
+    }
+
+    for (i = 0; i < 100; i += 3) {
+        ecs_remove(world, e + i, Velocity);
+    }
+
+    for (i = 0; i < 100; i ++) {
+        Position *p = ecs_get_ptr(world, e + i, Position);
+        test_assert(p != NULL);
+        test_int(p->x, i);
+        test_int(p->y, i * 2);
+
+        Velocity *v = ecs_get_ptr(world, e + i, Velocity);
+        if (i % 3) {
+            test_assert(v != NULL);
+            test_int(v->x, i * 3);
+            test_int(v->y, i * 4);
+        } else {
+            test_assert(v == NULL);
+        }
+    }
+
+    ecs_fini(world);
+}
+
+void Chunked_set_w_data() {
+    ecs_world_t *world = ecs_init();
+    ecs_set_table_chunk_size(world, CHUNK_SIZE);
+
+    ECS_COMPONENT(world, Position);
+
+    Position data[100];
+    int i;
+    for (i = 0; i < 100; i ++) {
+        data[i] = (Position){i, i * 2};
+    }
+
+    /* Start at an offset in the first chunk, so data spans four chunks */
+    ecs_new_w_count(world, Position, 10);
+
+    ecs_entity_t e = ecs_set_w_data(world, &(ecs_table_data_t){
+        .column_count = 1,
+        .row_count = 100,
+        .entities = NULL,
+        .components = (ecs_entity_t[]){ecs_entity(Position)},
+        .columns = (ecs_table_columns_t[]){ data }
+    });
+
+    test_assert(e != 0);
+    test_int(ecs_count(world, Position), 110);
+
+    for (i = 0; i < 100; i ++) {
+        Position *p = ecs_get_ptr(world, e + i, Position);
+        test_assert(p != NULL);
+        test_int(p->x, i);
+        test_int(p->y, i * 2);
+    }
+
+    ecs_fini(world);
+}
+
+static
+void AddVelocity(ecs_rows_t *rows) {
+    ECS_COLUMN_COMPONENT(rows, Velocity, 2);
+
+    int i;
+    for (i = 0; i < rows->count; i ++) {
+        ecs_set(rows->world, rows->entities[i], Velocity, {
+            rows->entities[i], 0});
+    }
+}
+
+void Chunked_add_in_progress() {
+    ecs_world_t *world = ecs_init();
+    ecs_set_table_chunk_size(world, CHUNK_SIZE);
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+    ECS_SYSTEM(world, AddVelocity, EcsOnUpdate, Position, .Velocity);
+
+    ecs_entity_t e = ecs_new_w_count(world, Position, 100);
+    ecs_progress(world, 1);
+
+    test_int(ecs_count(world, Velocity), 100);
+
+    int i;
+    for (i = 0; i < 100; i ++) {
+        Velocity *v = ecs_get_ptr(world, e + i, Velocity);
+        test_assert(v != NULL);
+        test_int(v->x, e + i);
+    }
+
+    ecs_fini(world);
+}
+
+static
+void OnAddPosition(ecs_rows_t *rows) {
+    ECS_COLUMN(rows, Position, p, 1);
+    int *count = rows->param;
+
+    test_assert(rows->count <= CHUNK_ROWS);
+
+    int i;
+    for (i = 0; i < rows->count; i ++) {
+        p[i].x = rows->entities[i];
+    }
+
+    count[0] ++;
+    count[1] += rows->count;
+}
+
+void Chunked_on_add() {
+    ecs_world_t *world = ecs_init();
+    ecs_set_table_chunk_size(world, CHUNK_SIZE);
+
+    ECS_COMPONENT(world, Position);
+    ECS_SYSTEM(world, OnAddPosition, EcsOnAdd, Position);
+
+    int count[2] = {0};
+    ecs_set_system_context(world, OnAddPosition, count);
+
+    ecs_entity_t e = ecs_new_w_count(world, Position, 100);
+    test_int(count[0], 4);
+    test_int(count[1], 100);
+
+    int i;
+    for (i = 0; i < 100; i ++) {
+        Position *p = ecs_get_ptr(world, e + i, Position);
+        test_assert(p != NULL);
+        test_int(p->x, e + i);
+    }
+
+    ecs_fini(world);
+}
+
+void Chunked_stats() {
+    ecs_world_t *world = ecs_init();
+    ecs_set_table_chunk_size(world, CHUNK_SIZE);
+
+    ECS_COMPONENT(world, Position);
+    ecs_new_w_count(world, Position, 100);
+
+    ecs_world_stats_t stats = {0};
+    ecs_get_stats(world, &stats);
+
+    EcsComponentStats *c = ecs_vector_first(stats.components);
+    uint32_t i, count = ecs_vector_count(stats.components);
+    for (i = 0; i < count; i ++) {
+        if (c[i].handle == ecs_entity(Position)) {
+            break;
+        }
+    }
+
+    test_assert(i != count);
+    test_int(c[i].entities, 100);
+    test_int(c[i].memory_used, 100 * sizeof(Position));
+    test_assert(c[i].memory_allocd >= 4 * CHUNK_SIZE);
+
+    ecs_free_stats(&stats);
+    ecs_fini(world);
+}
+
+static
+void IterTableColumn(ecs_rows_t *rows) {
+    ECS_COLUMN(rows, Position, p, 1);
+    int *count = rows->param;
+
+    Position *column = ecs_table_column(rows, 0);
+    test_assert(column != NULL);
+
+    int i;
+    for (i = 0; i < rows->count; i ++) {
+        test_assert(&column[rows->offset + i] == &p[i]);
+        test_int(column[rows->offset + i].x, rows->entities[i]);
+    }
+
+    count[0] ++;
+    count[1] += rows->count;
+}
+
+void Chunked_table_column() {
+    ecs_world_t *world = ecs_init();
+    ecs_set_table_chunk_size(world, CHUNK_SIZE);
+
+    ECS_COMPONENT(world, Position);
+    ECS_SYSTEM(world, IterTableColumn, EcsManual, Position);
+
+    int i;
+    for (i = 0; i < 100; i ++) {
+        ecs_entity_t e = ecs_new(world, 0);
+        ecs_set(world, e, Position, {e, 0});
+    }
+
+    int count[2] = {0};
+    ecs_run(world, IterTableColumn, 1, count);
+    test_int(count[0], 4);
+    test_int(count[1], 100);
+
+    ecs_fini(world);
+}
@@ -80,3 +80,86 @@ void Count_count_2_types_2_comps() {
 
     ecs_fini(world);
 }
+
+void Count_count_w_colliding_ids() {
+    ecs_world_t *world = ecs_init();
+
+    /* Entities that are 64 ids apart have the same bit in a type signature */
+    ecs_entity_t tag_1 = ecs_new(world, 0);
+    ecs_new_w_count(world, 0, 63);
+    ecs_entity_t tag_2 = ecs_new(world, 0);
+    test_int(tag_2 - tag_1, 64);
+
+    ecs_type_t type_1 = ecs_type_from_entity(world, tag_1);
+    ecs_type_t type_2 = ecs_type_from_entity(world, tag_2);
+
+    ecs_entity_t e = ecs_new(world, 0);
+    _ecs_add(world, e, type_2);
+
+    test_int(_ecs_count(world, type_1), 0);
+    test_int(_ecs_count(world, type_2), 1);
+
+    ecs_type_filter_t filter = {.include = type_1};
+    _ecs_add_remove_w_filter(world, type_1, 0, &filter);
+    test_assert(!_ecs_has(world, e, type_1));
+
+    ecs_fini(world);
+}
+
+void Count_count_inherited() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+    ECS_PREFAB(world, Base, Position);
+    ECS_TYPE(world, Type, INSTANCEOF | Base, Velocity);
+
+    ecs_new(world, Type);
+
+    /* Counts the prefab and the entity that inherits Position */
+    test_int(ecs_count(world, Position), 2);
+
+    ecs_fini(world);
+}
+
+void Count_count_inherited_and_owned() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+    ECS_PREFAB(world, Base, Position);
+    ECS_TYPE(world, Type_1, INSTANCEOF | Base, Position);
+    ECS_TYPE(world, Type_2, INSTANCEOF | Base, Velocity);
+
+    ecs_new_w_count(world, Type_1, 2);
+    ecs_new_w_count(world, Type_2, 3);
+    ecs_new(world, Position);
+
+    /* Tables that both own and inherit Position are counted once */
+    test_int(ecs_count(world, Position), 7);
+    test_int(ecs_count(world, Velocity), 3);
+
+    ecs_fini(world);
+}
+
+void Count_count_after_gc() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+    ECS_TYPE(world, Type, Position, Velocity);
+
+    ecs_entity_t e = ecs_new(world, Position);
+    ecs_new_w_count(world, Type, 2);
+
+    /* Deletes the empty table with only Position */
+    ecs_delete(world, e);
+    ecs_gc(world);
+    test_int(ecs_count(world, Position), 2);
+
+    ecs_new_w_count(world, Position, 3);
+    test_int(ecs_count(world, Position), 5);
+    test_int(ecs_count(world, Velocity), 2);
+
+    ecs_fini(world);
+}
@@ -193,3 +193,540 @@ void Delete_delete_w_on_remove() {
     
     ecs_fini(world);
 }
+
+void Delete_delete_recycle() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+
+    ecs_entity_t e = ecs_new(world, Position);
+    test_assert(e != 0);
+
+    ecs_delete(world, e);
+
+    ecs_entity_t e2 = ecs_new(world, 0);
+    test_assert(e2 != e);
+    test_int(e2 & ECS_ENTITY_ID_MASK, e);
+    test_int(ECS_GENERATION(e2), 1);
+    test_assert(ecs_is_empty(world, e2));
+    
+    ecs_fini(world);
+}
+
+void Delete_delete_recycle_w_component() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+
+    ecs_entity_t e = ecs_new(world, Position);
+    test_assert(e != 0);
+
+    ecs_delete(world, e);
+
+    ecs_entity_t e2 = ecs_new(world, Velocity);
+    test_int(e2 & ECS_ENTITY_ID_MASK, e);
+    test_assert(ecs_has(world, e2, Velocity));
+    test_assert(!ecs_has(world, e2, Position));
+
+    /* Deleted handle should not refer to the new entity */
+    test_assert(!ecs_has(world, e, Velocity));
+    test_assert(ecs_is_empty(world, e));
+    test_assert(ecs_get_ptr(world, e, Velocity) == NULL);
+    
+    ecs_fini(world);
+}
+
+void Delete_delete_recycle_generations() {
+    ecs_world_t *world = ecs_init();
+
+    ecs_entity_t e = ecs_new(world, 0);
+    ecs_entity_t id = e;
+
+    int i;
+    for (i = 1; i < 10; i ++) {
+        ecs_delete(world, e);
+        test_assert(!ecs_is_alive(world, e));
+
+        e = ecs_new(world, 0);
+        test_int(e & ECS_ENTITY_ID_MASK, id);
+        test_int(ECS_GENERATION(e), i);
+        test_assert(ecs_is_alive(world, e));
+    }
+    
+    ecs_fini(world);
+}
+
+void Delete_delete_twice_recycle_once() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+
+    ecs_entity_t e = ecs_new(world, Position);
+    ecs_delete(world, e);
+    ecs_delete(world, e);
+
+    ecs_entity_t e2 = ecs_new(world, 0);
+    ecs_entity_t e3 = ecs_new(world, 0);
+    test_int(e2 & ECS_ENTITY_ID_MASK, e);
+    test_assert((e3 & ECS_ENTITY_ID_MASK) != e);
+    
+    ecs_fini(world);
+}
+
+void Delete_delete_nonexist_no_recycle() {
+    ecs_world_t *world = ecs_init();
+
+    ecs_delete(world, 5000);
+
+    ecs_entity_t e = ecs_new(world, 0);
+    test_assert(e != 5000);
+    
+    ecs_fini(world);
+}
+
+void Delete_delete_revived_no_recycle() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+
+    ecs_entity_t e = ecs_new(world, Position);
+    ecs_delete(world, e);
+
+    /* Using the handle after the delete revives the entity */
+    ecs_add(world, e, Position);
+    test_assert(ecs_is_alive(world, e));
+
+    ecs_entity_t e2 = ecs_new(world, 0);
+    test_assert((e2 & ECS_ENTITY_ID_MASK) != e);
+    test_assert(ecs_has(world, e, Position));
+    
+    ecs_fini(world);
+}
+
+void Delete_delete_in_progress_recycle() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_SYSTEM(world, DeleteEntity, EcsOnUpdate, Position);
+
+    ecs_entity_t e = ecs_new(world, Position);
+
+    ecs_progress(world, 0);
+
+    test_assert(!ecs_is_alive(world, e));
+    test_int(ecs_count(world, Position), 0);
+
+    ecs_entity_t e2 = ecs_new(world, 0);
+    test_int(e2 & ECS_ENTITY_ID_MASK, e);
+    test_int(ECS_GENERATION(e2), 1);
+    
+    ecs_fini(world);
+}
+
+void Delete_is_alive() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+
+    ecs_entity_t e1 = ecs_new(world, 0);
+    ecs_entity_t e2 = ecs_new(world, Position);
+
+    test_assert(ecs_is_alive(world, e1));
+    test_assert(ecs_is_alive(world, e2));
+    test_assert(!ecs_is_alive(world, 5000));
+
+    ecs_delete(world, e1);
+    ecs_delete(world, e2);
+
+    test_assert(!ecs_is_alive(world, e1));
+    test_assert(!ecs_is_alive(world, e2));
+    
+    ecs_fini(world);
+}
+
+void Delete_delete_churn() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+
+    ecs_entity_t entities[100];
+    ecs_entity_t max_id = 0;
+    int i, j;
+
+    /* Creating and deleting entities should not grow the id space beyond the
+     * number of entities that are alive at the same time */
+    for (i = 0; i < 1000; i ++) {
+        for (j = 0; j < 100; j ++) {
+            entities[j] = ecs_new(world, Position);
+            if ((entities[j] & ECS_ENTITY_ID_MASK) > max_id) {
+                max_id = entities[j] & ECS_ENTITY_ID_MASK;
+            }
+        }
+
+        for (j = 0; j < 100; j ++) {
+            ecs_delete(world, entities[j]);
+        }
+    }
+
+    test_assert(max_id < 1000);
+    test_int(ecs_count(world, Position), 0);
+    
+    ecs_fini(world);
+}
+
+static
+void set_positions(
+    ecs_world_t *world,
+    ecs_entity_t e,
+    uint32_t count)
+{
+    ECS_COMPONENT(world, Position);
+
+    uint32_t i;
+    for (i = 0; i < count; i ++) {
+        ecs_set(world, e + i, Position, {e + i, 0});
+    }
+}
+
+static
+void test_positions(
+    ecs_world_t *world,
+    ecs_entity_t e,
+    uint32_t count)
+{
+    ECS_COMPONENT(world, Position);
+
+    uint32_t i;
+    for (i = 0; i < count; i ++) {
+        Position *p = ecs_get_ptr(world, e + i, Position);
+        test_assert(p != NULL);
+        test_int(p->x, e + i);
+    }
+}
+
+void Delete_delete_w_count() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+
+    ecs_entity_t e = ecs_new_w_count(world, Position, 100);
+    set_positions(world, e, 100);
+
+    ecs_delete_w_count(world, e, 100);
+
+    test_int(ecs_count(world, Position), 0);
+
+    int i;
+    for (i = 0; i < 100; i ++) {
+        test_assert(!ecs_is_alive(world, e + i));
+    }
+
+    ecs_fini(world);
+}
+
+void Delete_delete_w_count_subset() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+
+    ecs_entity_t e = ecs_new_w_count(world, Position, 100);
+    set_positions(world, e, 100);
+
+    ecs_delete_w_count(world, e + 10, 30);
+
+    test_int(ecs_count(world, Position), 70);
+
+    int i;
+    for (i = 0; i < 100; i ++) {
+        test_assert(ecs_is_alive(world, e + i) == (i < 10 || i >= 40));
+    }
+
+    test_positions(world, e, 10);
+    test_positions(world, e + 40, 60);
+
+    ecs_fini(world);
+}
+
+void Delete_delete_w_count_mixed() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+
+    /* Entities in different tables, and entities without components */
+    ecs_entity_t e = ecs_new(world, 0);
+    int i;
+    for (i = 1; i < 30; i ++) {
+        if (i % 3 == 0) {
+            ecs_new(world, 0);
+        } else if (i % 3 == 1) {
+            ecs_set(world, 0, Position, {e + i, 0});
+        } else {
+            ecs_set(world, 0, Velocity, {e + i, 0});
+        }
+    }
+
+    ecs_entity_t keep = ecs_set(world, 0, Position, {0, 0});
+    keep = ecs_set(world, keep, Velocity, {0, 0});
+
+    ecs_delete_w_count(world, e, 30);
+
+    for (i = 0; i < 30; i ++) {
+        test_assert(!ecs_is_alive(world, e + i));
+    }
+
+    test_int(ecs_count(world, Position), 1);
+    test_int(ecs_count(world, Velocity), 1);
+    test_assert(ecs_is_alive(world, keep));
+
+    ecs_fini(world);
+}
+
+void Delete_delete_w_count_nonexist() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+
+    ecs_entity_t e = ecs_new_w_count(world, Position, 10);
+    ecs_delete(world, e + 5);
+
+    /* Entities past the last created entity don't exist */
+    ecs_delete_w_count(world, e, 20);
+
+    test_int(ecs_count(world, Position), 0);
+
+    /* Each id is recycled once */
+    ecs_entity_t ids[10];
+    int i, j;
+    for (i = 0; i < 10; i ++) {
+        ids[i] = ecs_new(world, 0);
+        for (j = 0; j < i; j ++) {
+            test_assert((ids[i] & ECS_ENTITY_ID_MASK) != 
+                (ids[j] & ECS_ENTITY_ID_MASK));
+        }
+    }
+
+    ecs_fini(world);
+}
+
+void Delete_delete_n() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+    ECS_TYPE(world, Type, Position, Velocity);
+
+    ecs_entity_t e_1 = ecs_new_w_count(world, Position, 100);
+    set_positions(world, e_1, 100);
+
+    ecs_entity_t e_2 = ecs_new_w_count(world, Type, 100);
+    set_positions(world, e_2, 100);
+
+    /* Delete every third entity, in reverse order */
+    ecs_entity_t entities[68];
+    int i, count = 0;
+    for (i = 99; i >= 0; i -= 3) {
+        entities[count ++] = e_1 + i;
+        entities[count ++] = e_2 + i;
+    }
+
+    ecs_delete_n(world, entities, count);
+
+    test_int(ecs_count(world, Position), 200 - count);
+    test_int(ecs_count(world, Velocity), 100 - count / 2);
+
+    for (i = 0; i < 100; i ++) {
+        bool deleted = (99 - i) % 3 == 0;
+        test_assert(ecs_is_alive(world, e_1 + i) == !deleted);
+        test_assert(ecs_is_alive(world, e_2 + i) == !deleted);
+        if (!deleted) {
+            test_positions(world, e_1 + i, 1);
+            test_positions(world, e_2 + i, 1);
+            test_assert(ecs_has(world, e_2 + i, Velocity));
+        }
+    }
+
+    ecs_fini(world);
+}
+
+void Delete_delete_n_duplicates() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+
+    ecs_entity_t e = ecs_new_w_count(world, Position, 10);
+    ecs_entity_t empty = ecs_new(world, 0);
+
+    ecs_entity_t entities[] = {e + 2, e + 2, e + 9, empty, e + 2, empty, 5000};
+    ecs_delete_n(world, entities, 7);
+
+    test_int(ecs_count(world, Position), 8);
+    test_assert(!ecs_is_alive(world, e + 2));
+    test_assert(!ecs_is_alive(world, e + 9));
+    test_assert(!ecs_is_alive(world, empty));
+
+    /* Ids are recycled once */
+    ecs_entity_t r_1 = ecs_new(world, 0);
+    ecs_entity_t r_2 = ecs_new(world, 0);
+    ecs_entity_t r_3 = ecs_new(world, 0);
+    ecs_entity_t r_4 = ecs_new(world, 0);
+    test_assert(r_1 != r_2 && r_1 != r_3 && r_2 != r_3);
+    test_assert(r_4 > empty);
+
+    ecs_fini(world);
+}
+
+static
+void OnRemoveCount(ecs_rows_t *rows) {
+    ECS_COLUMN(rows, Position, p, 1);
+    int *count = rows->param;
+
+    int i;
+    for (i = 0; i < rows->count; i ++) {
+        test_int(p[i].x, rows->entities[i]);
+    }
+
+    count[0] ++;
+    count[1] += rows->count;
+}
+
+void Delete_delete_n_on_remove() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_SYSTEM(world, OnRemoveCount, EcsOnRemove, Position);
+
+    int count[2] = {0};
+    ecs_set_system_context(world, OnRemoveCount, count);
+
+    ecs_entity_t e = ecs_new_w_count(world, Position, 100);
+    set_positions(world, e, 100);
+
+    /* Two ranges of rows */
+    ecs_entity_t entities[20];
+    int i;
+    for (i = 0; i < 10; i ++) {
+        entities[i] = e + 10 + i;
+        entities[i + 10] = e + 50 + i;
+    }
+
+    ecs_delete_n(world, entities, 20);
+
+    test_int(count[0], 2);
+    test_int(count[1], 20);
+    test_int(ecs_count(world, Position), 80);
+
+    /* The last 20 entities were moved into the deleted rows, so the remaining
+     * entities are stored in two ranges of rows */
+    ecs_delete_w_count(world, e + 60, 40);
+
+    test_int(count[0], 4);
+    test_int(count[1], 60);
+    test_int(ecs_count(world, Position), 40);
+
+    test_positions(world, e, 10);
+    test_positions(world, e + 20, 30);
+
+    ecs_fini(world);
+}
+
+void Delete_delete_n_chunked() {
+    ecs_world_t *world = ecs_init();
+    ecs_set_table_chunk_size(world, 256);
+
+    ECS_COMPONENT(world, Position);
+
+    ecs_entity_t e = ecs_new_w_count(world, Position, 100);
+    set_positions(world, e, 100);
+
+    ecs_entity_t entities[50];
+    int i;
+    for (i = 0; i < 50; i ++) {
+        entities[i] = e + i * 2;
+    }
+
+    ecs_delete_n(world, entities, 50);
+
+    test_int(ecs_count(world, Position), 50);
+
+    for (i = 1; i < 100; i += 2) {
+        test_positions(world, e + i, 1);
+    }
+
+    ecs_fini(world);
+}
+
+static
+void DeleteRange(ecs_rows_t *rows) {
+    ecs_delete_w_count(rows->world, rows->entities[0], rows->count);
+}
+
+void Delete_delete_w_count_in_progress() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_SYSTEM(world, DeleteRange, EcsOnUpdate, Position);
+
+    ecs_entity_t e = ecs_new_w_count(world, Position, 100);
+
+    ecs_progress(world, 1);
+
+    test_int(ecs_count(world, Position), 0);
+
+    int i;
+    for (i = 0; i < 100; i ++) {
+        test_assert(!ecs_is_alive(world, e + i));
+    }
+
+    ecs_fini(world);
+}
+
+void Delete_add_stale() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+
+    ecs_entity_t e = ecs_new(world, Position);
+    ecs_delete(world, e);
+
+    ecs_entity_t e2 = ecs_new(world, Velocity);
+    test_int(e2 & ECS_ENTITY_ID_MASK, e);
+    ecs_type_t type = ecs_get_type(world, e2);
+
+    /* Adding to the deleted handle must not change the recycled entity */
+    ecs_add(world, e, Position);
+    test_assert(!ecs_is_alive(world, e));
+    test_assert(!ecs_has(world, e, Position));
+    test_assert(ecs_is_alive(world, e2));
+    test_assert(ecs_get_type(world, e2) == type);
+    test_assert(!ecs_has(world, e2, Position));
+    test_int(ecs_count(world, Position), 0);
+
+    ecs_fini(world);
+}
+
+void Delete_set_stale() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+
+    ecs_entity_t e = ecs_set(world, 0, Position, {1, 2});
+    ecs_delete(world, e);
+
+    ecs_entity_t e2 = ecs_set(world, 0, Position, {3, 4});
+    test_int(e2 & ECS_ENTITY_ID_MASK, e);
+
+    ecs_set(world, e, Position, {5, 6});
+    test_assert(!ecs_is_alive(world, e));
+    test_assert(ecs_get_ptr(world, e, Position) == NULL);
+    test_int(ecs_count(world, Position), 1);
+
+    Position *p = ecs_get_ptr(world, e2, Position);
+    test_assert(p != NULL);
+    test_int(p->x, 3);
+    test_int(p->y, 4);
+
+    ecs_fini(world);
+}
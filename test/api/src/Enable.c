@@ -0,0 +1,439 @@
+#include <api.h>
+
+static
+void Iter(ecs_rows_t *rows) {
+    int *count = rows->param;
+
+    int i;
+    for (i = 0; i < rows->count; i ++) {
+        count[0] ++;
+        count[1] += rows->entities[i];
+    }
+
+    count[2] ++;
+}
+
+void Enable_enable_disable() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+
+    ecs_entity_t e = ecs_set(world, 0, Position, {10, 20});
+    ecs_set(world, e, Velocity, {1, 2});
+
+    ecs_type_t type = ecs_get_type(world, e);
+    Position *p = ecs_get_ptr(world, e, Position);
+
+    test_assert(ecs_is_component_enabled(world, e, Position));
+    test_assert(ecs_is_component_enabled(world, e, Velocity));
+
+    ecs_enable_component(world, e, Position, false);
+    test_assert(!ecs_is_component_enabled(world, e, Position));
+    test_assert(ecs_is_component_enabled(world, e, Velocity));
+
+    /* Entity is not moved, and component is still accessible */
+    test_assert(ecs_get_type(world, e) == type);
+    test_assert(ecs_get_ptr(world, e, Position) == p);
+    test_assert(ecs_has(world, e, Position));
+    test_int(p->x, 10);
+
+    ecs_enable_component(world, e, Position, true);
+    test_assert(ecs_is_component_enabled(world, e, Position));
+    test_assert(ecs_get_type(world, e) == type);
+
+    ecs_fini(world);
+}
+
+void Enable_is_enabled_not_owned() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+
+    ecs_entity_t e = ecs_new(world, Position);
+    test_assert(!ecs_is_component_enabled(world, e, Velocity));
+
+    ecs_fini(world);
+}
+
+void Enable_system_skip_disabled() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_SYSTEM(world, Iter, EcsManual, Position);
+
+    ecs_entity_t e = ecs_new_w_count(world, Position, 10);
+    ecs_enable_component(world, e + 1, Position, false);
+    ecs_enable_component(world, e + 2, Position, false);
+    ecs_enable_component(world, e + 5, Position, false);
+
+    int count[3] = {0};
+    ecs_run(world, Iter, 1, count);
+    test_int(count[0], 7);
+    test_int(count[1], 10 * e + 45 - (e + 1) - (e + 2) - (e + 5));
+
+    /* System is invoked for each range of enabled rows */
+    test_int(count[2], 3);
+
+    ecs_enable_component(world, e + 2, Position, true);
+
+    count[0] = count[1] = count[2] = 0;
+    ecs_run(world, Iter, 1, count);
+    test_int(count[0], 8);
+    test_int(count[2], 3);
+
+    ecs_fini(world);
+}
+
+void Enable_system_skip_disabled_tag() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_TAG(world, Enemy);
+    ECS_TYPE(world, Type, Position, Enemy);
+    ECS_SYSTEM(world, Iter, EcsManual, Position, Enemy);
+
+    ecs_entity_t e = ecs_new_w_count(world, Type, 4);
+    _ecs_enable_component(world, e + 3, Enemy, false);
+    test_assert(!_ecs_is_component_enabled(world, e + 3, Enemy));
+    test_assert(ecs_is_component_enabled(world, e + 3, Position));
+
+    int count[3] = {0};
+    ecs_run(world, Iter, 1, count);
+    test_int(count[0], 3);
+    test_int(count[1], e + (e + 1) + (e + 2));
+    test_int(count[2], 1);
+
+    ecs_fini(world);
+}
+
+void Enable_system_other_column() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+    ECS_TYPE(world, Type, Position, Velocity);
+    ECS_SYSTEM(world, Iter, EcsManual, Position);
+
+    ecs_entity_t e = ecs_new_w_count(world, Type, 3);
+
+    /* System does not match Velocity, so entity is not skipped */
+    ecs_enable_component(world, e, Velocity, false);
+
+    int count[3] = {0};
+    ecs_run(world, Iter, 1, count);
+    test_int(count[0], 3);
+    test_int(count[2], 1);
+
+    ecs_fini(world);
+}
+
+void Enable_system_optional() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+    ECS_TYPE(world, Type, Position, Velocity);
+    ECS_SYSTEM(world, Iter, EcsManual, Position, ?Velocity);
+
+    ecs_entity_t e = ecs_new_w_count(world, Type, 3);
+    ecs_enable_component(world, e + 1, Velocity, false);
+
+    /* Disabling an optional component does not skip the entity */
+    int count[3] = {0};
+    ecs_run(world, Iter, 1, count);
+    test_int(count[0], 3);
+    test_int(count[2], 1);
+
+    ecs_fini(world);
+}
+
+static
+void IterDisabled(ecs_rows_t *rows) {
+    Iter(rows);
+}
+
+void Enable_disable_entity() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+    ECS_TYPE(world, Type, Position, Velocity);
+    ECS_SYSTEM(world, Iter, EcsManual, Position);
+    ECS_SYSTEM(world, IterDisabled, EcsManual, Position, ?EcsDisabled);
+
+    ecs_entity_t e = ecs_new_w_count(world, Type, 5);
+    test_assert(ecs_is_entity_enabled(world, e));
+
+    ecs_enable_entity(world, e + 4, false);
+    test_assert(!ecs_is_entity_enabled(world, e + 4));
+    test_assert(ecs_is_entity_enabled(world, e + 3));
+
+    /* Component state is not affected */
+    test_assert(ecs_is_component_enabled(world, e + 4, Position));
+
+    int count[3] = {0};
+    ecs_run(world, Iter, 1, count);
+    test_int(count[0], 4);
+    test_int(count[1], e + (e + 1) + (e + 2) + (e + 3));
+
+    /* Systems that match disabled entities are not affected */
+    count[0] = count[1] = count[2] = 0;
+    ecs_run(world, IterDisabled, 1, count);
+    test_int(count[0], 5);
+
+    ecs_enable_entity(world, e + 4, true);
+    test_assert(ecs_is_entity_enabled(world, e + 4));
+
+    count[0] = count[1] = count[2] = 0;
+    ecs_run(world, Iter, 1, count);
+    test_int(count[0], 5);
+
+    ecs_fini(world);
+}
+
+void Enable_delete() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_SYSTEM(world, Iter, EcsManual, Position);
+
+    ecs_entity_t e = ecs_new_w_count(world, Position, 4);
+    ecs_enable_component(world, e, Position, false);
+    ecs_enable_component(world, e + 3, Position, false);
+
+    /* Last entity is moved to the row of the deleted entity */
+    ecs_delete(world, e + 1);
+    test_assert(!ecs_is_component_enabled(world, e, Position));
+    test_assert(!ecs_is_component_enabled(world, e + 3, Position));
+    test_assert(ecs_is_component_enabled(world, e + 2, Position));
+
+    /* Deleted rows don't leave behind disabled state */
+    ecs_delete(world, e);
+    ecs_delete(world, e + 3);
+    ecs_entity_t e2 = ecs_new_w_count(world, Position, 2);
+    test_assert(ecs_is_component_enabled(world, e2, Position));
+    test_assert(ecs_is_component_enabled(world, e2 + 1, Position));
+
+    int count[3] = {0};
+    ecs_run(world, Iter, 1, count);
+    test_int(count[0], 3);
+    test_int(count[1], (e + 2) + e2 + (e2 + 1));
+
+    ecs_fini(world);
+}
+
+void Enable_delete_w_count() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+
+    ecs_entity_t e = ecs_new_w_count(world, Position, 10);
+    ecs_enable_component(world, e + 8, Position, false);
+    ecs_enable_component(world, e + 9, Position, false);
+
+    ecs_delete_w_count(world, e + 1, 3);
+
+    int i;
+    for (i = 4; i < 10; i ++) {
+        test_assert(ecs_is_component_enabled(world, e + i, Position) ==
+            (i < 8));
+    }
+    test_assert(ecs_is_component_enabled(world, e, Position));
+
+    ecs_fini(world);
+}
+
+void Enable_move_to_other_table() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+    ECS_SYSTEM(world, Iter, EcsManual, Position);
+
+    ecs_entity_t e = ecs_new_w_count(world, Position, 3);
+    ecs_enable_component(world, e + 1, Position, false);
+    ecs_enable_entity(world, e + 2, false);
+
+    ecs_add(world, e + 1, Velocity);
+    ecs_add(world, e + 2, Velocity);
+    test_assert(!ecs_is_component_enabled(world, e + 1, Position));
+    test_assert(ecs_is_component_enabled(world, e + 1, Velocity));
+    test_assert(!ecs_is_entity_enabled(world, e + 2));
+
+    int count[3] = {0};
+    ecs_run(world, Iter, 1, count);
+    test_int(count[0], 1);
+    test_int(count[1], e);
+
+    /* Removing a component resets its state */
+    ecs_remove(world, e + 1, Position);
+    ecs_add(world, e + 1, Position);
+    test_assert(ecs_is_component_enabled(world, e + 1, Position));
+
+    ecs_fini(world);
+}
+
+void Enable_move_w_count() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+
+    ecs_entity_t e = ecs_new_w_count(world, Position, 4);
+    ecs_enable_component(world, e + 2, Position, false);
+
+    ecs_add_w_count(world, e, 4, Velocity);
+
+    int i;
+    for (i = 0; i < 4; i ++) {
+        test_assert(ecs_has(world, e + i, Velocity));
+        test_assert(ecs_is_component_enabled(world, e + i, Position) ==
+            (i != 2));
+    }
+
+    ecs_fini(world);
+}
+
+static
+int compare_position(
+    ecs_entity_t e1,
+    void *ptr1,
+    ecs_entity_t e2,
+    void *ptr2)
+{
+    Position *p1 = ptr1;
+    Position *p2 = ptr2;
+    return (p1->x > p2->x) - (p1->x < p2->x);
+}
+
+void Enable_sort() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_SYSTEM(world, Iter, EcsManual, Position);
+
+    ecs_set_system_sort(world, Iter, Position, compare_position);
+
+    ecs_entity_t e = ecs_new_w_count(world, Position, 6);
+
+    int i;
+    for (i = 0; i < 6; i ++) {
+        ecs_set(world, e + i, Position, {6 - i, 0});
+    }
+
+    ecs_enable_component(world, e, Position, false);
+    ecs_enable_component(world, e + 4, Position, false);
+
+    int count[3] = {0};
+    ecs_run(world, Iter, 1, count);
+    test_int(count[0], 4);
+    test_int(count[1], 6 * e + 15 - e - (e + 4));
+
+    test_assert(!ecs_is_component_enabled(world, e, Position));
+    test_assert(!ecs_is_component_enabled(world, e + 4, Position));
+    test_assert(ecs_is_component_enabled(world, e + 5, Position));
+
+    ecs_fini(world);
+}
+
+void Enable_many_rows() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_SYSTEM(world, Iter, EcsManual, Position);
+
+    ecs_entity_t e = ecs_new_w_count(world, Position, 200);
+
+    /* Disable a range that crosses a word boundary, and a full word */
+    int i, enabled = 200;
+    for (i = 60; i < 200; i ++) {
+        if (i < 70 || (i >= 128 && i < 192)) {
+            ecs_enable_component(world, e + i, Position, false);
+            enabled --;
+        }
+    }
+
+    int count[3] = {0};
+    ecs_run(world, Iter, 1, count);
+    test_int(count[0], enabled);
+    test_int(count[2], 3);
+
+    ecs_fini(world);
+}
+
+void Enable_chunked() {
+    ecs_world_t *world = ecs_init();
+    ecs_set_table_chunk_size(world, 256);
+
+    ECS_COMPONENT(world, Position);
+    ECS_SYSTEM(world, Iter, EcsManual, Position);
+
+    ecs_entity_t e = ecs_new_w_count(world, Position, 1000);
+
+    int i, enabled = 1000;
+    ecs_entity_t sum = 0;
+    for (i = 0; i < 1000; i ++) {
+        if (i % 3) {
+            ecs_enable_component(world, e + i, Position, false);
+            enabled --;
+        } else {
+            sum += e + i;
+        }
+    }
+
+    int count[3] = {0};
+    ecs_run(world, Iter, 1, count);
+    test_int(count[0], enabled);
+    test_int(count[1], sum);
+
+    ecs_fini(world);
+}
+
+static
+void Disable(ecs_rows_t *rows) {
+    ECS_COLUMN_COMPONENT(rows, Position, 1);
+    ECS_COLUMN_COMPONENT(rows, Velocity, 2);
+
+    int i;
+    for (i = 0; i < rows->count; i ++) {
+        ecs_entity_t e = rows->entities[i];
+        if (e & 1) {
+            ecs_enable_component(rows->world, e, Position, false);
+        }
+
+        /* Entity is moved to another table when the stage is merged */
+        if (e & 2) {
+            ecs_add(rows->world, e, Velocity);
+        }
+    }
+}
+
+void Enable_in_progress() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+    ECS_SYSTEM(world, Disable, EcsOnUpdate, Position, .Velocity);
+    ECS_SYSTEM(world, Iter, EcsManual, Position);
+
+    ecs_entity_t e = ecs_new_w_count(world, Position, 4);
+
+    ecs_progress(world, 1);
+
+    int i, enabled = 0;
+    for (i = 0; i < 4; i ++) {
+        ecs_entity_t cur = e + i;
+        test_assert(ecs_has(world, cur, Velocity) == ((cur & 2) != 0));
+        test_assert(ecs_is_component_enabled(world, cur, Position) == 
+            !(cur & 1));
+        enabled += !(cur & 1);
+    }
+
+    int count[3] = {0};
+    ecs_run(world, Iter, 1, count);
+    test_int(count[0], enabled);
+
+    ecs_fini(world);
+}
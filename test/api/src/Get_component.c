@@ -204,3 +204,87 @@ void Get_component_get_both_from_2_add_remove_in_progress() {
     
     ecs_fini(world);
 }
+
+typedef struct bench_row_t {
+    void *type;
+    int32_t index;
+} bench_row_t;
+
+/* Measure random ecs_get_ptr calls on a world with count entities. The entity
+ * index used to be a map. That path no longer exists, so its cost is estimated
+ * by replacing the time of the index lookups in a sparse set with the time of
+ * the same lookups in a map with the same keys and row size. */
+static
+void bench_get(
+    uint32_t count)
+{
+    const uint32_t lookup_count = 1000000;
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+
+    ecs_entity_t first = ecs_new_w_count(world, Position, count);
+    ecs_entity_t *keys = ecs_os_malloc(lookup_count * sizeof(ecs_entity_t));
+    uint32_t i;
+
+    srand(count);
+    for (i = 0; i < lookup_count; i ++) {
+        keys[i] = first + ((((uint64_t)rand() << 16) ^ rand()) % count);
+    }
+
+    ecs_sparse_t *sparse = ecs_sparse_new(count, sizeof(bench_row_t));
+    ecs_map_t *map = ecs_map_new(count, sizeof(bench_row_t));
+
+    for (i = 0; i < count; i ++) {
+        bench_row_t row = {.index = i};
+        ecs_sparse_set(sparse, first + i, &row);
+        ecs_map_set(map, first + i, &row);
+    }
+
+    uint32_t found = 0;
+    int64_t sum_sparse = 0, sum_map = 0;
+    ecs_time_t t_start;
+
+    ecs_os_get_time(&t_start);
+    for (i = 0; i < lookup_count; i ++) {
+        found += ecs_get_ptr(world, keys[i], Position) != NULL;
+    }
+    double t_get = ecs_time_measure(&t_start);
+
+    ecs_os_get_time(&t_start);
+    for (i = 0; i < lookup_count; i ++) {
+        bench_row_t *row = ecs_sparse_get_ptr(sparse, keys[i]);
+        sum_sparse += row->index;
+    }
+    double t_sparse = ecs_time_measure(&t_start);
+
+    ecs_os_get_time(&t_start);
+    for (i = 0; i < lookup_count; i ++) {
+        bench_row_t *row = ecs_map_get_ptr(map, keys[i]);
+        sum_map += row->index;
+    }
+    double t_map = ecs_time_measure(&t_start);
+
+    test_int(found, lookup_count);
+    test_assert(sum_sparse == sum_map);
+
+    double t_get_map = t_get - t_sparse + t_map;
+    ecs_os_log("%u entities, %u random ecs_get_ptr: sparse index %.2fns, "
+        "map index (estimated) %.2fns",
+        count, lookup_count,
+        t_get * 1000000000.0 / lookup_count,
+        t_get_map * 1000000000.0 / lookup_count);
+
+    ecs_sparse_free(sparse);
+    ecs_map_free(map);
+    ecs_os_free(keys);
+    ecs_fini(world);
+}
+
+void Get_component_bench_get_1m() {
+    bench_get(1000000);
+}
+
+void Get_component_bench_get_10m() {
+    bench_get(10000000);
+}
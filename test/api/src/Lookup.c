@@ -179,3 +179,135 @@ void Lookup_get_id_from_empty() {
 
     ecs_fini(world);
 }
+
+void Lookup_lookup_after_rename() {
+    ecs_world_t *world = ecs_init();
+
+    ecs_entity_t e = ecs_set(world, 0, EcsId, {"Foo"});
+    test_assert(ecs_lookup(world, "Foo") == e);
+
+    ecs_set(world, e, EcsId, {"Bar"});
+    test_assert(ecs_lookup(world, "Foo") == 0);
+    test_assert(ecs_lookup(world, "Bar") == e);
+
+    /* Renaming back to the old name makes the entity findable again */
+    ecs_set(world, e, EcsId, {"Foo"});
+    test_assert(ecs_lookup(world, "Foo") == e);
+    test_assert(ecs_lookup(world, "Bar") == 0);
+
+    ecs_fini(world);
+}
+
+void Lookup_lookup_after_delete() {
+    ecs_world_t *world = ecs_init();
+
+    ecs_entity_t e_1 = ecs_set(world, 0, EcsId, {"Foo"});
+    ecs_entity_t e_2 = ecs_set(world, 0, EcsId, {"Foo"});
+    test_assert(ecs_lookup(world, "Foo") == e_1);
+
+    ecs_delete(world, e_1);
+    test_assert(ecs_lookup(world, "Foo") == e_2);
+
+    ecs_remove(world, e_2, EcsId);
+    test_assert(ecs_lookup(world, "Foo") == 0);
+
+    ecs_fini(world);
+}
+
+void Lookup_lookup_after_merge() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_SYSTEM(world, LookupSystem, EcsOnUpdate, 0);
+
+    ecs_progress(world, 1);
+
+    /* Name set while progressing is indexed when the stage is merged */
+    ecs_entity_t e = ecs_lookup(world, "Foo");
+    test_assert(e != 0);
+    test_str(ecs_get_id(world, e), "Foo");
+
+    ecs_fini(world);
+}
+
+void Lookup_lookup_clone() {
+    ecs_world_t *world = ecs_init();
+
+    ecs_entity_t e = ecs_set(world, 0, EcsId, {"Foo"});
+    ecs_entity_t clone = ecs_clone(world, e, true);
+    test_assert(clone != e);
+
+    ecs_delete(world, e);
+    test_assert(ecs_lookup(world, "Foo") == clone);
+
+    ecs_fini(world);
+}
+
+void Lookup_lookup_after_delete_w_filter() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+
+    ecs_entity_t e = ecs_set(world, 0, EcsId, {"Foo"});
+    ecs_add(world, e, Position);
+    test_assert(ecs_lookup(world, "Foo") == e);
+
+    ecs_delete_w_filter(world, &(ecs_type_filter_t){
+        ecs_type(Position)
+    });
+
+    test_assert(ecs_lookup(world, "Foo") == 0);
+
+    ecs_fini(world);
+}
+
+static
+void RenameSystem(ecs_rows_t *rows) {
+    uint32_t i;
+    for (i = 0; i < rows->count; i ++) {
+        ecs_set(rows->world, rows->entities[i], EcsId, {"Bar"});
+    }
+}
+
+void Lookup_lookup_after_rename_in_progress() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_SYSTEM(world, RenameSystem, EcsOnUpdate, Position);
+
+    ecs_entity_t e = ecs_set(world, 0, EcsId, {"Foo"});
+    ecs_add(world, e, Position);
+    test_assert(ecs_lookup(world, "Foo") == e);
+
+    ecs_progress(world, 1);
+
+    test_assert(ecs_lookup(world, "Foo") == 0);
+    test_assert(ecs_lookup(world, "Bar") == e);
+
+    ecs_fini(world);
+}
+
+static
+void DeleteSystem(ecs_rows_t *rows) {
+    uint32_t i;
+    for (i = 0; i < rows->count; i ++) {
+        ecs_delete(rows->world, rows->entities[i]);
+    }
+}
+
+void Lookup_lookup_after_delete_in_progress() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_SYSTEM(world, DeleteSystem, EcsOnUpdate, Position);
+
+    ecs_entity_t e = ecs_set(world, 0, EcsId, {"Foo"});
+    ecs_add(world, e, Position);
+    test_assert(ecs_lookup(world, "Foo") == e);
+
+    ecs_progress(world, 1);
+
+    test_assert(!ecs_is_alive(world, e));
+    test_assert(ecs_lookup(world, "Foo") == 0);
+
+    ecs_fini(world);
+}
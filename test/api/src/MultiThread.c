@@ -1049,3 +1049,106 @@ void MultiThread_reactive_system() {
 
     ecs_fini(world);
 }
+
+typedef ecs_entity_t Spawned;
+
+static
+void SpawnEntity(ecs_rows_t *rows) {
+    ECS_COLUMN(rows, Spawned, s, 1);
+    ECS_COLUMN_COMPONENT(rows, Velocity, 2);
+
+    int i;
+    for (i = 0; i < rows->count; i ++) {
+        s[i] = ecs_new(rows->world, Velocity);
+    }
+}
+
+void MultiThread_new_in_worker_threads() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Spawned);
+    ECS_COMPONENT(world, Velocity);
+    ECS_SYSTEM(world, SpawnEntity, EcsOnUpdate, Spawned, .Velocity);
+
+    int i, j, ENTITIES = 1000, THREADS = 4;
+    ecs_entity_t *handles = ecs_os_alloca(ecs_entity_t, ENTITIES);
+
+    for (i = 0; i < ENTITIES; i ++) {
+        handles[i] = ecs_new(world, Spawned);
+    }
+
+    ecs_set_threads(world, THREADS);
+    ecs_progress(world, 0);
+
+    test_int(ecs_count(world, Velocity), ENTITIES);
+
+    /* Each thread takes ids from its own block, so ids only jump between
+     * entities that were processed by different threads */
+    int jumps = 0;
+    ecs_entity_t prev = 0;
+    for (i = 0; i < ENTITIES; i ++) {
+        ecs_entity_t e = ecs_get(world, handles[i], Spawned);
+        test_assert(e != 0);
+        test_assert(ecs_has(world, e, Velocity));
+
+        if (prev && e != prev + 1) {
+            jumps ++;
+        }
+        prev = e;
+
+        for (j = 0; j < ENTITIES; j ++) {
+            test_assert(handles[j] != e);
+        }
+    }
+
+    test_assert(jumps < THREADS);
+
+    /* Entities created after the frame should not collide with entities that
+     * were created by the worker threads */
+    ecs_entity_t e = ecs_new(world, 0);
+    for (i = 0; i < ENTITIES; i ++) {
+        test_assert(ecs_get(world, handles[i], Spawned) != e);
+    }
+
+    ecs_fini(world);
+}
+
+static
+void SpawnEntities(ecs_rows_t *rows) {
+    ECS_COLUMN(rows, Spawned, s, 1);
+    ECS_COLUMN_COMPONENT(rows, Velocity, 2);
+
+    int i;
+    for (i = 0; i < rows->count; i ++) {
+        s[i] = ecs_new_w_count(rows->world, Velocity, 10);
+    }
+}
+
+void MultiThread_new_w_count_in_worker_threads() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Spawned);
+    ECS_COMPONENT(world, Velocity);
+    ECS_SYSTEM(world, SpawnEntities, EcsOnUpdate, Spawned, .Velocity);
+
+    int i, j, ENTITIES = 1000, THREADS = 4;
+    ecs_entity_t *handles = ecs_os_alloca(ecs_entity_t, ENTITIES);
+
+    for (i = 0; i < ENTITIES; i ++) {
+        handles[i] = ecs_new(world, Spawned);
+    }
+
+    ecs_set_threads(world, THREADS);
+    ecs_progress(world, 0);
+
+    test_int(ecs_count(world, Velocity), ENTITIES * 10);
+
+    for (i = 0; i < ENTITIES; i ++) {
+        ecs_entity_t e = ecs_get(world, handles[i], Spawned);
+        for (j = 0; j < 10; j ++) {
+            test_assert(ecs_has(world, e + j, Velocity));
+        }
+    }
+
+    ecs_fini(world);
+}
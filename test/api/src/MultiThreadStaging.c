@@ -446,3 +446,70 @@ void MultiThreadStaging_new_w_count() {
 
     ecs_fini(world);
 }
+
+static int32_t malloc_count;
+
+static
+void *count_malloc(size_t size) {
+    malloc_count ++;
+    return malloc(size);
+}
+
+static
+void *count_calloc(size_t size, size_t n) {
+    malloc_count ++;
+    return calloc(size, n);
+}
+
+static
+void *count_realloc(void *old_ptr, size_t size) {
+    malloc_count ++;
+    return realloc(old_ptr, size);
+}
+
+static
+void Set_and_remove(ecs_rows_t *rows) {
+    ECS_COLUMN_COMPONENT(rows, Position, 1);
+    ECS_COLUMN_COMPONENT(rows, Velocity, 2);
+
+    int i;
+    for (i = 0; i < rows->count; i ++) {
+        ecs_set(rows->world, rows->entities[i], Position, {i, i});
+        ecs_remove(rows->world, rows->entities[i], Velocity);
+    }
+}
+
+void MultiThreadStaging_no_alloc_in_steady_state() {
+    ecs_os_set_api_defaults();
+    ecs_os_api_t os_api = ecs_os_api;
+    os_api.malloc = count_malloc;
+    os_api.calloc = count_calloc;
+    os_api.realloc = count_realloc;
+    ecs_os_set_api(&os_api);
+
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+    ECS_TYPE(world, Type, Position, Velocity);
+    ECS_SYSTEM(world, Set_and_remove, EcsOnUpdate, Position, Velocity);
+    ecs_set_threads(world, 2);
+
+    ecs_new_w_count(world, Type, 100);
+
+    ecs_type_filter_t filter = {.include = ecs_type(Position)};
+
+    /* First frames create tables and size the stage arena. Velocity is added
+     * back after each frame, so that the system runs again. */
+    ecs_progress(world, 1);
+    _ecs_add_remove_w_filter(world, ecs_type(Velocity), 0, &filter);
+    ecs_progress(world, 1);
+    _ecs_add_remove_w_filter(world, ecs_type(Velocity), 0, &filter);
+
+    /* Staged data of a frame reuses the memory of the previous frame */
+    malloc_count = 0;
+    ecs_progress(world, 1);
+    test_int(malloc_count, 0);
+
+    ecs_fini(world);
+}
@@ -0,0 +1,289 @@
+#include <api.h>
+
+static
+void Iter(ecs_rows_t *rows) {
+    int *count = rows->param;
+    count[0] += rows->count;
+    count[1] ++;
+}
+
+void OnChange_skip_unchanged() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_SYSTEM(world, Iter, EcsManual, Position);
+
+    ecs_set_system_on_change(world, Iter, true);
+
+    ecs_entity_t e = ecs_new_w_count(world, Position, 3);
+
+    int count[2] = {0};
+    ecs_run(world, Iter, 1, count);
+    test_int(count[0], 3);
+    test_int(count[1], 1);
+
+    /* Nothing changed */
+    ecs_run(world, Iter, 1, count);
+    test_int(count[1], 1);
+
+    ecs_set(world, e + 1, Position, {10, 20});
+    ecs_run(world, Iter, 1, count);
+    test_int(count[0], 6);
+    test_int(count[1], 2);
+
+    ecs_run(world, Iter, 1, count);
+    test_int(count[1], 2);
+
+    ecs_fini(world);
+}
+
+void OnChange_skip_unchanged_table() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+    ECS_TYPE(world, Type, Position, Velocity);
+    ECS_SYSTEM(world, Iter, EcsManual, Position);
+
+    ecs_set_system_on_change(world, Iter, true);
+
+    ecs_new_w_count(world, Position, 3);
+    ecs_entity_t e = ecs_new_w_count(world, Type, 2);
+
+    int count[2] = {0};
+    ecs_run(world, Iter, 1, count);
+    test_int(count[0], 5);
+    test_int(count[1], 2);
+
+    /* Only the table of the entity is visited */
+    ecs_set(world, e, Position, {10, 20});
+    ecs_run(world, Iter, 1, count);
+    test_int(count[0], 7);
+    test_int(count[1], 3);
+
+    /* Velocity is not read by the system */
+    ecs_set(world, e, Velocity, {1, 2});
+    ecs_run(world, Iter, 1, count);
+    test_int(count[1], 3);
+
+    ecs_fini(world);
+}
+
+void OnChange_add_remove_entity() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_SYSTEM(world, Iter, EcsManual, Position);
+
+    ecs_set_system_on_change(world, Iter, true);
+
+    ecs_entity_t e = ecs_new_w_count(world, Position, 3);
+
+    int count[2] = {0};
+    ecs_run(world, Iter, 1, count);
+    test_int(count[1], 1);
+
+    ecs_new(world, Position);
+    ecs_run(world, Iter, 1, count);
+    test_int(count[0], 7);
+    test_int(count[1], 2);
+
+    ecs_delete(world, e);
+    ecs_run(world, Iter, 1, count);
+    test_int(count[0], 10);
+    test_int(count[1], 3);
+
+    ecs_run(world, Iter, 1, count);
+    test_int(count[1], 3);
+
+    ecs_fini(world);
+}
+
+void OnChange_enable_component() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_SYSTEM(world, Iter, EcsManual, Position);
+
+    ecs_set_system_on_change(world, Iter, true);
+
+    ecs_entity_t e = ecs_new_w_count(world, Position, 3);
+
+    int count[2] = {0};
+    ecs_run(world, Iter, 1, count);
+    test_int(count[1], 1);
+
+    ecs_enable_component(world, e, Position, false);
+    ecs_run(world, Iter, 1, count);
+    test_int(count[0], 5);
+    test_int(count[1], 2);
+
+    ecs_fini(world);
+}
+
+static
+void Move(ecs_rows_t *rows) {
+    ECS_COLUMN(rows, Position, p, 1);
+    int *count = rows->param;
+
+    int i;
+    for (i = 0; i < rows->count; i ++) {
+        p[i].x ++;
+    }
+
+    count[1] ++;
+}
+
+void OnChange_system_writes() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_SYSTEM(world, Move, EcsManual, Position);
+    ECS_SYSTEM(world, Iter, EcsManual, Position);
+
+    ecs_set_system_on_change(world, Iter, true);
+
+    ecs_new_w_count(world, Position, 3);
+
+    int count[2] = {0}, move_count[2] = {0};
+    ecs_run(world, Iter, 1, count);
+    test_int(count[1], 1);
+
+    /* Move does not declare that it writes Position */
+    ecs_run(world, Move, 1, move_count);
+    ecs_run(world, Iter, 1, count);
+    test_int(count[1], 1);
+
+    ecs_set_system_writes(world, Move, Position);
+    ecs_run(world, Move, 1, move_count);
+    ecs_run(world, Iter, 1, count);
+    test_int(count[1], 2);
+
+    ecs_run(world, Iter, 1, count);
+    test_int(count[1], 2);
+
+    ecs_fini(world);
+}
+
+void OnChange_ignore_own_writes() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_SYSTEM(world, Move, EcsManual, Position);
+
+    ecs_set_system_on_change(world, Move, true);
+    ecs_set_system_writes(world, Move, Position);
+
+    ecs_entity_t e = ecs_set(world, 0, Position, {0, 0});
+
+    int count[2] = {0};
+    ecs_run(world, Move, 1, count);
+    test_int(count[1], 1);
+
+    ecs_run(world, Move, 1, count);
+    test_int(count[1], 1);
+
+    ecs_set(world, e, Position, {10, 20});
+    ecs_run(world, Move, 1, count);
+    test_int(count[1], 2);
+
+    Position *p = ecs_get_ptr(world, e, Position);
+    test_int(p->x, 11);
+
+    ecs_fini(world);
+}
+
+static
+void SetPosition(ecs_rows_t *rows) {
+    ECS_COLUMN_COMPONENT(rows, Position, 1);
+
+    int i;
+    for (i = 0; i < rows->count; i ++) {
+        ecs_set(rows->world, rows->entities[i], Position, {1, 2});
+    }
+}
+
+void OnChange_set_in_progress() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_SYSTEM(world, SetPosition, EcsOnLoad, Position);
+    ECS_SYSTEM(world, Iter, EcsOnUpdate, Position);
+
+    ecs_enable(world, SetPosition, false);
+    ecs_set_system_on_change(world, Iter, true);
+
+    ecs_new_w_count(world, Position, 3);
+
+    int count[2] = {0};
+    ecs_set_system_context(world, Iter, count);
+
+    ecs_progress(world, 1);
+    test_int(count[1], 1);
+
+    ecs_progress(world, 1);
+    test_int(count[1], 1);
+
+    /* Staged sets are merged before Iter runs */
+    ecs_enable(world, SetPosition, true);
+    ecs_progress(world, 1);
+    test_int(count[1], 2);
+
+    ecs_enable(world, SetPosition, false);
+    ecs_progress(world, 1);
+    test_int(count[1], 2);
+
+    ecs_fini(world);
+}
+
+typedef struct Visits {
+    ecs_entity_t first;
+    int count[10];
+} Visits;
+
+static
+void Visit(ecs_rows_t *rows) {
+    Visits *v = rows->param;
+
+    int i;
+    for (i = 0; i < rows->count; i ++) {
+        v->count[rows->entities[i] - v->first] ++;
+    }
+}
+
+static
+int visit_count(
+    Visits *v)
+{
+    int i, result = 0;
+    for (i = 0; i < 10; i ++) {
+        result += v->count[i];
+    }
+    return result;
+}
+
+void OnChange_threaded() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_SYSTEM(world, Visit, EcsOnUpdate, Position);
+
+    ecs_set_system_on_change(world, Visit, true);
+    ecs_set_threads(world, 2);
+
+    Visits v = {0};
+    v.first = ecs_new_w_count(world, Position, 10);
+    ecs_set_system_context(world, Visit, &v);
+
+    ecs_progress(world, 1);
+    test_int(visit_count(&v), 10);
+
+    ecs_progress(world, 1);
+    test_int(visit_count(&v), 10);
+
+    ecs_set(world, v.first, Position, {10, 20});
+    ecs_progress(world, 1);
+    test_int(visit_count(&v), 20);
+
+    ecs_fini(world);
+}
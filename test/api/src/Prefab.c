@@ -2446,3 +2446,108 @@ void Prefab_override_from_nested() {
 
     ecs_fini(world);
 }
+
+void Prefab_rematch_after_add_to_base() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+    ECS_COMPONENT(world, Mass);
+
+    ECS_SYSTEM(world, Dummy, EcsOnUpdate, Position, Mass);
+
+    ECS_PREFAB(world, Base, Velocity);
+    ECS_PREFAB(world, Prefab, INSTANCEOF | Base);
+    ECS_ENTITY(world, Entity, INSTANCEOF | Prefab, Position);
+
+    SysTestData ctx = {0};
+    ecs_set_context(world, &ctx);
+
+    ecs_progress(world, 1);
+    test_int(ctx.count, 0);
+
+    /* The instance inherits Mass through Prefab, which does not change */
+    ecs_add(world, Base, Mass);
+
+    ecs_progress(world, 1);
+    test_int(ctx.count, 1);
+    ctx.count = 0;
+
+    ecs_remove(world, Base, Mass);
+
+    ecs_progress(world, 1);
+    test_int(ctx.count, 0);
+
+    ecs_fini(world);
+}
+
+void Prefab_rematch_after_add_base_to_prefab() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+
+    ECS_SYSTEM(world, Dummy, EcsOnUpdate, Position, Velocity);
+
+    ECS_PREFAB(world, Base, Velocity);
+    ECS_PREFAB(world, Prefab, Position);
+    ECS_ENTITY(world, Entity, INSTANCEOF | Prefab, Position);
+
+    SysTestData ctx = {0};
+    ecs_set_context(world, &ctx);
+
+    ecs_progress(world, 1);
+    test_int(ctx.count, 0);
+
+    /* Velocity is not added to Prefab, but is inherited from Base */
+    ecs_inherit(world, Prefab, Base);
+    test_assert(ecs_has(world, Entity, Velocity));
+
+    ecs_progress(world, 1);
+    test_int(ctx.count, 1);
+    ctx.count = 0;
+
+    ecs_disinherit(world, Prefab, Base);
+    test_assert(!ecs_has(world, Entity, Velocity));
+
+    ecs_progress(world, 1);
+    test_int(ctx.count, 0);
+
+    ecs_fini(world);
+}
+
+void Prefab_rematch_w_prefab_cycle() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+
+    ECS_SYSTEM(world, Dummy, EcsOnUpdate, Position, Velocity);
+
+    ECS_PREFAB(world, Prefab_1, Position);
+    ECS_PREFAB(world, Prefab_2, INSTANCEOF | Prefab_1);
+    ECS_ENTITY(world, Entity, INSTANCEOF | Prefab_2, Position);
+
+    /* Creates a cycle, which must not prevent rematching */
+    ecs_inherit(world, Prefab_1, Prefab_2);
+    ecs_add(world, Prefab_2, Velocity);
+
+    SysTestData ctx = {0};
+    ecs_set_context(world, &ctx);
+
+    ecs_progress(world, 1);
+    test_int(ctx.count, 1);
+    ctx.count = 0;
+
+    /* Tables that inherit from the cycle are tested when another watched
+     * entity changes */
+    ecs_entity_t parent = ecs_new(world, 0);
+    ecs_entity_t child = ecs_new(world, Position);
+    ecs_adopt(world, child, parent);
+    ecs_add(world, parent, Velocity);
+
+    ecs_progress(world, 1);
+    test_int(ctx.count, 1);
+
+    ecs_fini(world);
+}
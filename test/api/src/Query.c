@@ -0,0 +1,299 @@
+#include <api.h>
+
+static
+int query_count(
+    ecs_query_t *query,
+    int *iter_count)
+{
+    ecs_query_iter_t it = ecs_query_iter(query);
+    int result = 0;
+
+    while (ecs_query_next(&it)) {
+        result += it.rows.count;
+        if (iter_count) {
+            iter_count[0] ++;
+        }
+    }
+
+    return result;
+}
+
+void Query_iter() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+    ECS_TYPE(world, Type, Position, Velocity);
+
+    ecs_entity_t e = ecs_new_w_count(world, Type, 3);
+
+    int i;
+    for (i = 0; i < 3; i ++) {
+        ecs_set(world, e + i, Position, {i, i * 2});
+        ecs_set(world, e + i, Velocity, {1, 2});
+    }
+
+    ecs_query_t *q = ecs_query_new(world, "Position, Velocity");
+    test_assert(q != NULL);
+
+    int iter_count = 0;
+    ecs_query_iter_t it = ecs_query_iter(q);
+    while (ecs_query_next(&it)) {
+        ECS_COLUMN(&it.rows, Position, p, 1);
+        ECS_COLUMN(&it.rows, Velocity, v, 2);
+
+        for (i = 0; i < it.rows.count; i ++) {
+            p[i].x += v[i].x;
+            p[i].y += v[i].y;
+        }
+
+        iter_count ++;
+    }
+
+    test_int(iter_count, 1);
+
+    for (i = 0; i < 3; i ++) {
+        Position *p = ecs_get_ptr(world, e + i, Position);
+        test_int(p->x, i + 1);
+        test_int(p->y, i * 2 + 2);
+    }
+
+    ecs_query_free(q);
+    ecs_fini(world);
+}
+
+void Query_iter_multiple_tables() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+    ECS_COMPONENT(world, Mass);
+    ECS_TYPE(world, Type_1, Position, Velocity);
+    ECS_TYPE(world, Type_2, Position, Mass);
+
+    ecs_new_w_count(world, Position, 2);
+    ecs_new_w_count(world, Type_1, 3);
+    ecs_new_w_count(world, Type_2, 4);
+    ecs_new_w_count(world, Velocity, 5);
+
+    ecs_query_t *q = ecs_query_new(world, "Position");
+
+    int iter_count = 0;
+    test_int(query_count(q, &iter_count), 9);
+    test_int(iter_count, 3);
+
+    ecs_query_free(q);
+    ecs_fini(world);
+}
+
+void Query_match_new_table() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+    ECS_TYPE(world, Type, Position, Velocity);
+
+    ecs_query_t *q = ecs_query_new(world, "Position");
+    test_int(query_count(q, NULL), 0);
+
+    /* Table is created after the query */
+    ecs_new_w_count(world, Type, 3);
+    test_int(query_count(q, NULL), 3);
+
+    ecs_new_w_count(world, Position, 2);
+    test_int(query_count(q, NULL), 5);
+
+    ecs_query_free(q);
+    ecs_fini(world);
+}
+
+void Query_skip_empty_tables() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+    ECS_TYPE(world, Type, Position, Velocity);
+
+    ecs_entity_t e = ecs_new(world, Type);
+    ecs_new_w_count(world, Position, 2);
+
+    ecs_query_t *q = ecs_query_new(world, "Position");
+
+    ecs_delete(world, e);
+
+    int iter_count = 0;
+    test_int(query_count(q, &iter_count), 2);
+    test_int(iter_count, 1);
+
+    ecs_query_free(q);
+    ecs_fini(world);
+}
+
+void Query_iter_w_not() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+    ECS_TYPE(world, Type, Position, Velocity);
+
+    ecs_new_w_count(world, Type, 3);
+    ecs_new_w_count(world, Position, 2);
+
+    ecs_query_t *q = ecs_query_new(world, "Position, !Velocity");
+    test_int(query_count(q, NULL), 2);
+
+    ecs_query_free(q);
+    ecs_fini(world);
+}
+
+void Query_iter_w_shared() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+    ECS_PREFAB(world, Prefab, Velocity);
+    ECS_TYPE(world, Type, INSTANCEOF | Prefab, Position);
+
+    ecs_set(world, Prefab, Velocity, {1, 2});
+
+    ecs_entity_t e = ecs_new_w_count(world, Type, 2);
+    ecs_set(world, e, Position, {10, 20});
+    ecs_set(world, e + 1, Position, {30, 40});
+
+    ecs_query_t *q = ecs_query_new(world, "Position, SHARED.Velocity");
+
+    int iter_count = 0;
+    ecs_query_iter_t it = ecs_query_iter(q);
+    while (ecs_query_next(&it)) {
+        ECS_COLUMN(&it.rows, Position, p, 1);
+        ECS_COLUMN(&it.rows, Velocity, v, 2);
+        test_assert(ecs_is_shared(&it.rows, 2));
+
+        int i;
+        for (i = 0; i < it.rows.count; i ++) {
+            p[i].x += v->x;
+            p[i].y += v->y;
+        }
+
+        iter_count ++;
+    }
+
+    test_int(iter_count, 1);
+
+    Position *p = ecs_get_ptr(world, e, Position);
+    test_int(p->x, 11);
+    test_int(p->y, 22);
+
+    p = ecs_get_ptr(world, e + 1, Position);
+    test_int(p->x, 31);
+    test_int(p->y, 42);
+
+    ecs_query_free(q);
+    ecs_fini(world);
+}
+
+void Query_skip_disabled_components() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+
+    ecs_entity_t e = ecs_new_w_count(world, Position, 5);
+
+    ecs_query_t *q = ecs_query_new(world, "Position");
+
+    ecs_enable_component(world, e + 2, Position, false);
+
+    int iter_count = 0;
+    test_int(query_count(q, &iter_count), 4);
+    test_int(iter_count, 2);
+
+    ecs_query_free(q);
+    ecs_fini(world);
+}
+
+void Query_iter_chunked() {
+    ecs_world_t *world = ecs_init();
+    ecs_set_table_chunk_size(world, 256);
+
+    ECS_COMPONENT(world, Position);
+
+    ecs_query_t *q = ecs_query_new(world, "Position");
+
+    int i;
+    for (i = 0; i < 100; i ++) {
+        ecs_set(world, 0, Position, {i, 0});
+    }
+
+    /* 100 rows in chunks of 256 bytes, or 32 Position components */
+    int iter_count = 0;
+    test_int(query_count(q, &iter_count), 100);
+    test_int(iter_count, 4);
+
+    ecs_query_free(q);
+    ecs_fini(world);
+}
+
+void Query_iter_no_tables() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+
+    ecs_query_t *q = ecs_query_new(world, ".Position");
+
+    /* Query without columns that match tables is iterated once */
+    int iter_count = 0;
+    ecs_query_iter_t it = ecs_query_iter(q);
+    while (ecs_query_next(&it)) {
+        test_int(it.rows.count, 0);
+        test_assert(ecs_column_entity(&it.rows, 1) == ecs_entity(Position));
+        iter_count ++;
+    }
+
+    test_int(iter_count, 1);
+
+    ecs_query_free(q);
+    ecs_fini(world);
+}
+
+void Query_free_in_fini() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+
+    ecs_new_w_count(world, Position, 2);
+
+    ecs_query_t *q_1 = ecs_query_new(world, "Position");
+    ecs_query_t *q_2 = ecs_query_new(world, "Position");
+    test_int(query_count(q_1, NULL), 2);
+    test_int(query_count(q_2, NULL), 2);
+
+    /* q_2 is freed by ecs_fini */
+    ecs_query_free(q_1);
+    ecs_fini(world);
+}
+
+void Query_rematch_after_container_change() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Mass);
+
+    ecs_entity_t parent = ecs_new(world, 0);
+    ecs_entity_t e = ecs_new(world, Position);
+    ecs_adopt(world, e, parent);
+
+    ecs_query_t *q = ecs_query_new(world, "CONTAINER.Mass, Position");
+    test_int(query_count(q, NULL), 0);
+
+    /* Queries are rematched with systems at the start of a frame */
+    ecs_set(world, parent, Mass, {2});
+    ecs_progress(world, 1);
+    test_int(query_count(q, NULL), 1);
+
+    ecs_remove(world, parent, Mass);
+    ecs_progress(world, 1);
+    test_int(query_count(q, NULL), 0);
+
+    ecs_query_free(q);
+    ecs_fini(world);
+}
@@ -1238,3 +1238,140 @@ void Run_run_w_interrupt() {
  
     ecs_fini(world);
 }
+
+void Run_run_w_filter_handle() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+    ECS_COMPONENT(world, Mass);
+
+    ECS_ENTITY(world, e_1, Position, Velocity);
+    ECS_ENTITY(world, e_2, Position, Velocity, Mass);
+    ECS_ENTITY(world, e_3, Position, Mass);
+
+    ECS_SYSTEM(world, Iter, EcsManual, Position);
+
+    ecs_filter_t *filter = ecs_filter_new(world, Mass);
+
+    SysTestData ctx = {0};
+    ecs_set_context(world, &ctx);
+
+    test_int( ecs_run_w_filter_handle(world, Iter, 1.0, 0, 0, filter, NULL), 0);
+    test_int(ctx.count, 2);
+    test_int(ctx.invoked, 2);
+    test_int(ctx.e[0], e_2);
+    test_int(ctx.e[1], e_3);
+
+    /* Cached tables are reused by the next run */
+    ctx = (SysTestData){0};
+    test_int( ecs_run_w_filter_handle(world, Iter, 1.0, 0, 0, filter, NULL), 0);
+    test_int(ctx.count, 2);
+    test_int(ctx.invoked, 2);
+
+    ecs_filter_free(filter);
+    ecs_fini(world);
+}
+
+void Run_run_w_filter_handle_new_table() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+    ECS_COMPONENT(world, Mass);
+
+    ECS_ENTITY(world, e_1, Position, Mass);
+
+    ECS_SYSTEM(world, Iter, EcsManual, Position);
+
+    ecs_filter_t *filter = ecs_filter_new(world, Mass);
+
+    SysTestData ctx = {0};
+    ecs_set_context(world, &ctx);
+
+    test_int( ecs_run_w_filter_handle(world, Iter, 1.0, 0, 0, filter, NULL), 0);
+    test_int(ctx.count, 1);
+    test_int(ctx.e[0], e_1);
+
+    /* Matching a new table invalidates the cache */
+    ECS_ENTITY(world, e_2, Position, Velocity, Mass);
+    ECS_ENTITY(world, e_3, Position, Velocity);
+
+    ctx = (SysTestData){0};
+    test_int( ecs_run_w_filter_handle(world, Iter, 1.0, 0, 0, filter, NULL), 0);
+    test_int(ctx.count, 2);
+    test_int(ctx.e[0], e_1);
+    test_int(ctx.e[1], e_2);
+
+    /* As does emptying a table */
+    ecs_delete(world, e_1);
+
+    ctx = (SysTestData){0};
+    test_int( ecs_run_w_filter_handle(world, Iter, 1.0, 0, 0, filter, NULL), 0);
+    test_int(ctx.count, 1);
+    test_int(ctx.e[0], e_2);
+
+    ecs_filter_free(filter);
+    ecs_fini(world);
+}
+
+void Run_run_w_filter_handle_offset_limit() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+    ECS_COMPONENT(world, Mass);
+
+    ECS_ENTITY(world, e_1, Position);
+    ECS_ENTITY(world, e_2, Position, Mass);
+    ECS_ENTITY(world, e_3, Position, Mass);
+    ECS_ENTITY(world, e_4, Position, Velocity, Mass);
+
+    ECS_SYSTEM(world, Iter, EcsManual, Position);
+
+    ecs_filter_t *filter = ecs_filter_new(world, Mass);
+
+    SysTestData ctx = {0};
+    ecs_set_context(world, &ctx);
+
+    /* Offset and limit apply to the entities that pass the filter */
+    test_int( ecs_run_w_filter_handle(world, Iter, 1.0, 1, 2, filter, NULL), 0);
+    test_int(ctx.count, 2);
+    test_int(ctx.e[0], e_3);
+    test_int(ctx.e[1], e_4);
+
+    ecs_filter_free(filter);
+    ecs_fini(world);
+}
+
+void Run_run_w_filter_handle_prefab() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Mass);
+
+    ECS_PREFAB(world, Base, Position);
+    ECS_TYPE(world, Type, INSTANCEOF | Base, Position);
+
+    ECS_ENTITY(world, e_1, Type);
+
+    ECS_SYSTEM(world, Iter, EcsManual, Position);
+
+    ecs_filter_t *filter = ecs_filter_new(world, Mass);
+
+    SysTestData ctx = {0};
+    ecs_set_context(world, &ctx);
+
+    test_int( ecs_run_w_filter_handle(world, Iter, 1.0, 0, 0, filter, NULL), 0);
+    test_int(ctx.count, 0);
+
+    /* Entity inherits Mass after it is added to the prefab */
+    ecs_add(world, Base, Mass);
+
+    test_int( ecs_run_w_filter_handle(world, Iter, 1.0, 0, 0, filter, NULL), 0);
+    test_int(ctx.count, 1);
+    test_int(ctx.e[0], e_1);
+
+    ecs_filter_free(filter);
+    ecs_fini(world);
+}
@@ -0,0 +1,313 @@
+#include <api.h>
+
+static
+int compare_position(
+    ecs_entity_t e1,
+    void *ptr1,
+    ecs_entity_t e2,
+    void *ptr2)
+{
+    Position *p1 = ptr1;
+    Position *p2 = ptr2;
+    return (p1->x > p2->x) - (p1->x < p2->x);
+}
+
+typedef struct Visited {
+    int count;
+    ecs_entity_t entities[256];
+    float x[256];
+} Visited;
+
+static
+void Visit(ecs_rows_t *rows) {
+    ECS_COLUMN(rows, Position, p, 1);
+    Visited *v = rows->param;
+
+    bool shared = ecs_is_shared(rows, 1);
+
+    int i;
+    for (i = 0; i < rows->count; i ++) {
+        v->entities[v->count] = rows->entities[i];
+        v->x[v->count] = shared ? p->x : p[i].x;
+        v->count ++;
+    }
+}
+
+static
+void test_sorted(
+    ecs_world_t *world,
+    Visited *v,
+    int count)
+{
+    ECS_COMPONENT(world, Position);
+
+    test_int(v->count, count);
+
+    int i;
+    for (i = 0; i < v->count; i ++) {
+        if (i) {
+            test_assert(v->x[i - 1] <= v->x[i]);
+        }
+
+        /* Entity index must point to the moved rows */
+        Position *p = ecs_get_ptr(world, v->entities[i], Position);
+        test_assert(p != NULL);
+        test_int(p->x, v->x[i]);
+    }
+}
+
+void Sort_sort_on_progress() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_SYSTEM(world, Visit, EcsOnUpdate, Position);
+
+    ecs_set_system_sort(world, Visit, Position, compare_position);
+
+    int i;
+    for (i = 0; i < 100; i ++) {
+        ecs_set(world, 0, Position, {(i * 37) % 100, i});
+    }
+
+    Visited v = {0};
+    ecs_set_system_context(world, Visit, &v);
+
+    ecs_progress(world, 1);
+    test_sorted(world, &v, 100);
+
+    ecs_fini(world);
+}
+
+void Sort_sort_manual() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_SYSTEM(world, Visit, EcsManual, Position);
+
+    ecs_set_system_sort(world, Visit, Position, compare_position);
+
+    int i;
+    for (i = 0; i < 100; i ++) {
+        ecs_set(world, 0, Position, {100 - i, i});
+    }
+
+    Visited v = {0};
+    ecs_run(world, Visit, 1, &v);
+    test_sorted(world, &v, 100);
+
+    ecs_fini(world);
+}
+
+void Sort_sort_multiple_tables() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+    ECS_TYPE(world, Type, Position, Velocity);
+    ECS_SYSTEM(world, Visit, EcsManual, Position);
+
+    ecs_set_system_sort(world, Visit, Position, compare_position);
+
+    ecs_entity_t e_1 = ecs_new_w_count(world, Position, 50);
+    ecs_entity_t e_2 = ecs_new_w_count(world, Type, 50);
+
+    int i;
+    for (i = 0; i < 50; i ++) {
+        ecs_set(world, e_1 + i, Position, {50 - i, 0});
+        ecs_set(world, e_2 + i, Position, {50 - i, 0});
+    }
+
+    Visited v = {0};
+    ecs_run(world, Visit, 1, &v);
+
+    /* Each table is sorted by itself */
+    test_int(v.count, 100);
+    for (i = 0; i < 100; i ++) {
+        if (i % 50) {
+            test_assert(v.x[i - 1] <= v.x[i]);
+        }
+
+        Position *p = ecs_get_ptr(world, v.entities[i], Position);
+        test_int(p->x, v.x[i]);
+    }
+
+    for (i = 0; i < 50; i ++) {
+        test_assert(ecs_has(world, e_2 + i, Velocity));
+    }
+
+    ecs_fini(world);
+}
+
+void Sort_sort_stable() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_SYSTEM(world, Visit, EcsManual, Position);
+
+    ecs_set_system_sort(world, Visit, Position, compare_position);
+
+    ecs_entity_t e = ecs_new_w_count(world, Position, 100);
+
+    int i;
+    for (i = 0; i < 100; i ++) {
+        ecs_set(world, e + i, Position, {(99 - i) / 10, 0});
+    }
+
+    Visited v = {0};
+    ecs_run(world, Visit, 1, &v);
+    test_sorted(world, &v, 100);
+
+    /* Entities with the same value keep their order */
+    for (i = 1; i < 100; i ++) {
+        if (v.x[i - 1] == v.x[i]) {
+            test_assert(v.entities[i - 1] < v.entities[i]);
+        }
+    }
+
+    ecs_fini(world);
+}
+
+void Sort_sort_after_set() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_SYSTEM(world, Visit, EcsOnUpdate, Position);
+
+    ecs_set_system_sort(world, Visit, Position, compare_position);
+
+    ecs_entity_t e = ecs_new_w_count(world, Position, 100);
+
+    int i;
+    for (i = 0; i < 100; i ++) {
+        ecs_set(world, e + i, Position, {i, 0});
+    }
+
+    Visited v = {0};
+    ecs_set_system_context(world, Visit, &v);
+
+    ecs_progress(world, 1);
+    test_sorted(world, &v, 100);
+    test_assert(v.entities[0] == e);
+
+    /* Change values, and add new entities at the end of the table */
+    ecs_set(world, e, Position, {1000, 0});
+    ecs_set(world, e + 50, Position, {-1, 0});
+    ecs_set(world, 0, Position, {-2, 0});
+
+    v.count = 0;
+    ecs_progress(world, 1);
+    test_sorted(world, &v, 101);
+    test_assert(v.entities[1] == e + 50);
+    test_assert(v.entities[100] == e);
+
+    ecs_fini(world);
+}
+
+void Sort_sort_chunked() {
+    ecs_world_t *world = ecs_init();
+    ecs_set_table_chunk_size(world, 256);
+
+    ECS_COMPONENT(world, Position);
+    ECS_SYSTEM(world, Visit, EcsManual, Position);
+
+    ecs_set_system_sort(world, Visit, Position, compare_position);
+
+    int i;
+    for (i = 0; i < 100; i ++) {
+        ecs_set(world, 0, Position, {(i * 37) % 100, i});
+    }
+
+    Visited v = {0};
+    ecs_run(world, Visit, 1, &v);
+    test_sorted(world, &v, 100);
+
+    ecs_fini(world);
+}
+
+void Sort_sort_watched() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+    ECS_SYSTEM(world, Visit, EcsManual, Position);
+
+    ecs_set_system_sort(world, Visit, Position, compare_position);
+
+    ecs_entity_t e = ecs_new_w_count(world, Position, 10);
+
+    int i;
+    for (i = 0; i < 10; i ++) {
+        ecs_set(world, e + i, Position, {10 - i, 0});
+    }
+
+    /* Adopting a child marks the parent as watched */
+    ecs_entity_t child = ecs_new(world, 0);
+    ecs_adopt(world, child, e + 2);
+
+    Visited v = {0};
+    ecs_run(world, Visit, 1, &v);
+    test_sorted(world, &v, 10);
+
+    /* Parent must still be watched after it moved */
+    ecs_add(world, e + 2, Velocity);
+    test_assert(ecs_has(world, e + 2, Velocity));
+    test_assert(ecs_has_entity(world, child, ECS_CHILDOF | (e + 2)));
+
+    Position *p = ecs_get_ptr(world, e + 2, Position);
+    test_assert(p != NULL);
+    test_int(p->x, 8);
+
+    ecs_fini(world);
+}
+
+void Sort_sort_disable() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_SYSTEM(world, Visit, EcsManual, Position);
+
+    ecs_set_system_sort(world, Visit, Position, compare_position);
+    ecs_set_system_sort(world, Visit, Position, NULL);
+
+    ecs_entity_t e = ecs_new_w_count(world, Position, 10);
+
+    int i;
+    for (i = 0; i < 10; i ++) {
+        ecs_set(world, e + i, Position, {10 - i, 0});
+    }
+
+    Visited v = {0};
+    ecs_run(world, Visit, 1, &v);
+
+    test_int(v.count, 10);
+    for (i = 0; i < 10; i ++) {
+        test_assert(v.entities[i] == e + i);
+    }
+
+    ecs_fini(world);
+}
+
+void Sort_sort_shared() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+    ECS_PREFAB(world, Prefab, Position);
+    ECS_SYSTEM(world, Visit, EcsManual, Position);
+
+    ecs_set_system_sort(world, Visit, Position, compare_position);
+
+    /* Tables that don't own the component are not sorted */
+    ecs_entity_t e = ecs_new_instance_w_count(world, Prefab, Velocity, 10);
+
+    Visited v = {0};
+    ecs_run(world, Visit, 1, &v);
+    test_int(v.count, 10);
+
+    int i;
+    for (i = 0; i < 10; i ++) {
+        test_assert(ecs_is_alive(world, e + i));
+    }
+
+    ecs_fini(world);
+}
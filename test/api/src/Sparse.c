@@ -0,0 +1,696 @@
+#include <api.h>
+
+void Sparse_add_remove() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_TAG(world, Stunned);
+
+    _ecs_set_sparse_storage(world, Stunned);
+
+    ecs_entity_t e = ecs_new(world, Position);
+    ecs_type_t type = ecs_get_type(world, e);
+
+    ecs_add(world, e, Stunned);
+    test_assert(ecs_has(world, e, Stunned));
+    test_assert(ecs_has_entity(world, e, Stunned));
+    test_assert(ecs_has(world, e, Position));
+
+    /* Entity is not moved to another table */
+    test_assert(ecs_get_type(world, e) == type);
+
+    ecs_remove(world, e, Stunned);
+    test_assert(!ecs_has(world, e, Stunned));
+    test_assert(!ecs_has_entity(world, e, Stunned));
+    test_assert(ecs_has(world, e, Position));
+    test_assert(ecs_get_type(world, e) == type);
+
+    ecs_fini(world);
+}
+
+void Sparse_add_does_not_move() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_TAG(world, Stunned);
+
+    _ecs_set_sparse_storage(world, Stunned);
+
+    ecs_entity_t e1 = ecs_set(world, 0, Position, {10, 20});
+    ecs_entity_t e2 = ecs_set(world, 0, Position, {30, 40});
+
+    Position *p1 = ecs_get_ptr(world, e1, Position);
+    Position *p2 = ecs_get_ptr(world, e2, Position);
+
+    ecs_add(world, e1, Stunned);
+    ecs_remove(world, e1, Stunned);
+    ecs_add(world, e1, Stunned);
+
+    test_assert(ecs_get_ptr(world, e1, Position) == p1);
+    test_assert(ecs_get_ptr(world, e2, Position) == p2);
+    test_int(p1->x, 10);
+    test_int(p2->x, 30);
+
+    ecs_fini(world);
+}
+
+void Sparse_set_get() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+
+    ecs_set_sparse_storage(world, Velocity);
+
+    ecs_entity_t e = ecs_set(world, 0, Position, {10, 20});
+    ecs_type_t type = ecs_get_type(world, e);
+
+    ecs_set(world, e, Velocity, {1, 2});
+    test_assert(ecs_has(world, e, Velocity));
+    test_assert(ecs_get_type(world, e) == type);
+
+    Velocity *v = ecs_get_ptr(world, e, Velocity);
+    test_assert(v != NULL);
+    test_int(v->x, 1);
+    test_int(v->y, 2);
+
+    ecs_set(world, e, Velocity, {3, 4});
+    test_assert(ecs_get_ptr(world, e, Velocity) == v);
+    test_int(v->x, 3);
+    test_int(v->y, 4);
+
+    ecs_remove(world, e, Velocity);
+    test_assert(ecs_get_ptr(world, e, Velocity) == NULL);
+
+    /* Added components are zero-initialized */
+    ecs_add(world, e, Velocity);
+    v = ecs_get_ptr(world, e, Velocity);
+    test_assert(v != NULL);
+    test_int(v->x, 0);
+    test_int(v->y, 0);
+
+    ecs_fini(world);
+}
+
+void Sparse_new_w_type() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_TAG(world, Stunned);
+
+    _ecs_set_sparse_storage(world, Stunned);
+
+    ECS_TYPE(world, Type, Position, Stunned);
+
+    ecs_entity_t e = ecs_new(world, Type);
+    test_assert(ecs_has(world, e, Position));
+    test_assert(ecs_has(world, e, Stunned));
+    test_assert(ecs_has(world, e, Type));
+    test_assert(ecs_get_type(world, e) == ecs_type(Position));
+
+    ecs_entity_t e2 = ecs_new(world, Stunned);
+    test_assert(ecs_has(world, e2, Stunned));
+    test_assert(!ecs_has(world, e2, Position));
+    test_assert(ecs_is_alive(world, e2));
+    test_assert(!ecs_is_empty(world, e2));
+
+    ecs_fini(world);
+}
+
+void Sparse_new_w_count() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_TAG(world, Stunned);
+
+    _ecs_set_sparse_storage(world, Stunned);
+
+    ECS_TYPE(world, Type, Position, Stunned);
+
+    ecs_entity_t e = ecs_new_w_count(world, Type, 10);
+    test_int(ecs_count(world, Position), 10);
+    test_int(ecs_count(world, Stunned), 10);
+    test_int(ecs_count(world, Type), 10);
+
+    int i;
+    for (i = 0; i < 10; i ++) {
+        test_assert(ecs_has(world, e + i, Type));
+    }
+
+    ecs_fini(world);
+}
+
+void Sparse_has_any() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_TAG(world, Stunned);
+    ECS_TAG(world, Selected);
+
+    _ecs_set_sparse_storage(world, Stunned);
+    _ecs_set_sparse_storage(world, Selected);
+
+    ECS_TYPE(world, StunnedPosition, Stunned, Position);
+    ECS_TYPE(world, StunnedSelected, Stunned, Selected);
+
+    ecs_entity_t e1 = ecs_new(world, Position);
+    ecs_entity_t e2 = ecs_new(world, Stunned);
+
+    test_assert(!ecs_has(world, e1, StunnedPosition));
+    test_assert(ecs_has_any(world, e1, StunnedPosition));
+    test_assert(!ecs_has(world, e2, StunnedPosition));
+    test_assert(ecs_has_any(world, e2, StunnedPosition));
+
+    test_assert(!ecs_has(world, e2, StunnedSelected));
+    test_assert(ecs_has_any(world, e2, StunnedSelected));
+    test_assert(!ecs_has_any(world, e1, StunnedSelected));
+
+    ecs_add(world, e2, Selected);
+    test_assert(ecs_has(world, e2, StunnedSelected));
+
+    ecs_fini(world);
+}
+
+void Sparse_count() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+    ECS_TAG(world, Stunned);
+
+    _ecs_set_sparse_storage(world, Stunned);
+
+    ECS_TYPE(world, Type, Position, Stunned);
+
+    ecs_entity_t e = ecs_new_w_count(world, Position, 10);
+    ecs_new_w_count(world, Velocity, 10);
+
+    int i;
+    for (i = 0; i < 10; i += 2) {
+        ecs_add(world, e + i, Stunned);
+    }
+
+    ecs_entity_t e2 = ecs_new(world, Velocity);
+    ecs_add(world, e2, Stunned);
+
+    test_int(ecs_count(world, Stunned), 6);
+    test_int(ecs_count(world, Type), 5);
+    test_int(ecs_count(world, Position), 10);
+
+    ecs_fini(world);
+}
+
+void Sparse_delete() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_TAG(world, Stunned);
+
+    _ecs_set_sparse_storage(world, Stunned);
+
+    ecs_entity_t e1 = ecs_new(world, Position);
+    ecs_entity_t e2 = ecs_new(world, 0);
+    ecs_add(world, e1, Stunned);
+    ecs_add(world, e2, Stunned);
+    test_int(ecs_count(world, Stunned), 2);
+
+    ecs_delete(world, e1);
+    ecs_delete(world, e2);
+    test_assert(!ecs_has(world, e1, Stunned));
+    test_assert(!ecs_has(world, e2, Stunned));
+    test_assert(!ecs_is_alive(world, e2));
+    test_int(ecs_count(world, Stunned), 0);
+
+    /* Recycled ids don't inherit sparse components of deleted entities */
+    ecs_entity_t e3 = ecs_new(world, Position);
+    test_assert(!ecs_has(world, e3, Stunned));
+
+    ecs_fini(world);
+}
+
+void Sparse_delete_w_count() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_TAG(world, Stunned);
+
+    _ecs_set_sparse_storage(world, Stunned);
+
+    ecs_entity_t e = ecs_new_w_count(world, Position, 10);
+    ecs_add_w_count(world, e, 10, Stunned);
+    test_int(ecs_count(world, Stunned), 10);
+
+    ecs_delete_w_count(world, e, 5);
+    test_int(ecs_count(world, Stunned), 5);
+    test_int(ecs_count(world, Position), 5);
+
+    ecs_fini(world);
+}
+
+void Sparse_add_w_count() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+    ECS_TAG(world, Stunned);
+
+    _ecs_set_sparse_storage(world, Stunned);
+
+    ECS_TYPE(world, Type, Velocity, Stunned);
+
+    ecs_entity_t e = ecs_new_w_count(world, Position, 10);
+    ecs_add_w_count(world, e, 10, Type);
+    test_int(ecs_count(world, Stunned), 10);
+    test_int(ecs_count(world, Velocity), 10);
+
+    ecs_remove_w_count(world, e, 5, Stunned);
+    test_int(ecs_count(world, Stunned), 5);
+    test_int(ecs_count(world, Velocity), 10);
+
+    int i;
+    for (i = 0; i < 10; i ++) {
+        test_assert(ecs_has(world, e + i, Stunned) == (i >= 5));
+    }
+
+    ecs_fini(world);
+}
+
+void Sparse_add_w_filter() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+    ECS_TAG(world, Stunned);
+
+    _ecs_set_sparse_storage(world, Stunned);
+
+    ecs_new_w_count(world, Position, 5);
+    ecs_new_w_count(world, Velocity, 5);
+
+    _ecs_add_remove_w_filter(world, ecs_type(Stunned), 0, &(ecs_type_filter_t){
+        .include = ecs_type(Position)
+    });
+
+    test_int(ecs_count(world, Stunned), 5);
+
+    _ecs_add_remove_w_filter(world, 0, ecs_type(Stunned), &(ecs_type_filter_t){
+        .include = ecs_type(Position)
+    });
+
+    test_int(ecs_count(world, Stunned), 0);
+
+    ecs_fini(world);
+}
+
+void Sparse_clone() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+
+    ecs_set_sparse_storage(world, Velocity);
+
+    ecs_entity_t e = ecs_set(world, 0, Position, {10, 20});
+    ecs_set(world, e, Velocity, {1, 2});
+
+    ecs_entity_t e2 = ecs_clone(world, e, false);
+    test_assert(ecs_has(world, e2, Position));
+    test_assert(ecs_has(world, e2, Velocity));
+    Velocity *v = ecs_get_ptr(world, e2, Velocity);
+    test_int(v->x, 0);
+    test_int(v->y, 0);
+
+    ecs_entity_t e3 = ecs_clone(world, e, true);
+    test_assert(ecs_has(world, e3, Velocity));
+    v = ecs_get_ptr(world, e3, Velocity);
+    test_int(v->x, 1);
+    test_int(v->y, 2);
+
+    ecs_fini(world);
+}
+
+static
+void Iter(ecs_rows_t *rows) {
+    int *count = rows->param;
+
+    int i;
+    for (i = 0; i < rows->count; i ++) {
+        count[0] ++;
+        count[1] += rows->entities[i];
+    }
+
+    count[2] ++;
+}
+
+void Sparse_system_and() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_TAG(world, Stunned);
+
+    _ecs_set_sparse_storage(world, Stunned);
+
+    ECS_SYSTEM(world, Iter, EcsManual, Position, Stunned);
+
+    ecs_entity_t e = ecs_new_w_count(world, Position, 10);
+    ecs_add(world, e + 1, Stunned);
+    ecs_add(world, e + 2, Stunned);
+    ecs_add(world, e + 5, Stunned);
+
+    /* Not matched, doesn't have Position */
+    ecs_new(world, Stunned);
+
+    int count[3] = {0};
+    ecs_run(world, Iter, 1, count);
+    test_int(count[0], 3);
+    test_int(count[1], (e + 1) + (e + 2) + (e + 5));
+
+    /* Stunned is a tag, so subsequent rows are passed in a single call */
+    test_int(count[2], 2);
+
+    ecs_fini(world);
+}
+
+void Sparse_system_not() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_TAG(world, Stunned);
+
+    _ecs_set_sparse_storage(world, Stunned);
+
+    ECS_SYSTEM(world, Iter, EcsManual, Position, !Stunned);
+
+    ecs_entity_t e = ecs_new_w_count(world, Position, 5);
+    ecs_add(world, e + 1, Stunned);
+    ecs_add(world, e + 2, Stunned);
+
+    int count[3] = {0};
+    ecs_run(world, Iter, 1, count);
+    test_int(count[0], 3);
+    test_int(count[1], e + (e + 3) + (e + 4));
+    test_int(count[2], 2);
+
+    ecs_fini(world);
+}
+
+static
+void Move(ecs_rows_t *rows) {
+    ECS_COLUMN(rows, Position, p, 1);
+    ECS_COLUMN(rows, Velocity, v, 2);
+
+    test_int(rows->count, 1);
+    test_assert(ecs_is_shared(rows, 2));
+    test_assert(ecs_column_source(rows, 2) == rows->entities[0]);
+
+    p[0].x += v->x;
+    p[0].y += v->y;
+    v->x ++;
+}
+
+void Sparse_system_data() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+
+    ecs_set_sparse_storage(world, Velocity);
+
+    ECS_SYSTEM(world, Move, EcsOnUpdate, Position, Velocity);
+
+    ecs_entity_t e = ecs_set(world, 0, Position, {0, 0});
+    ecs_set(world, 0, Position, {0, 0});
+    ecs_set(world, 0, Position, {0, 0});
+    ecs_set(world, e, Velocity, {1, 2});
+    ecs_set(world, e + 2, Velocity, {3, 4});
+
+    ecs_progress(world, 1);
+
+    Position *p = ecs_get_ptr(world, e, Position);
+    test_int(p->x, 1);
+    test_int(p->y, 2);
+
+    p = ecs_get_ptr(world, e + 1, Position);
+    test_int(p->x, 0);
+    test_int(p->y, 0);
+
+    p = ecs_get_ptr(world, e + 2, Position);
+    test_int(p->x, 3);
+    test_int(p->y, 4);
+
+    Velocity *v = ecs_get_ptr(world, e, Velocity);
+    test_int(v->x, 2);
+    v = ecs_get_ptr(world, e + 2, Velocity);
+    test_int(v->x, 4);
+
+    ecs_fini(world);
+}
+
+static
+void CountOptional(ecs_rows_t *rows) {
+    ECS_COLUMN(rows, Velocity, v, 2);
+    int *count = rows->param;
+
+    test_int(rows->count, 1);
+
+    if (v) {
+        count[0] += v->x;
+    } else {
+        count[1] ++;
+    }
+}
+
+void Sparse_system_optional() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+
+    ecs_set_sparse_storage(world, Velocity);
+
+    ECS_SYSTEM(world, CountOptional, EcsManual, Position, ?Velocity);
+
+    ecs_entity_t e = ecs_new_w_count(world, Position, 4);
+    ecs_set(world, e, Velocity, {1, 0});
+    ecs_set(world, e + 3, Velocity, {2, 0});
+
+    int count[2] = {0};
+    ecs_run(world, CountOptional, 1, count);
+    test_int(count[0], 3);
+    test_int(count[1], 2);
+
+    ecs_fini(world);
+}
+
+static
+void ToggleStunned(ecs_rows_t *rows) {
+    ECS_COLUMN_COMPONENT(rows, Stunned, 2);
+
+    int i;
+    for (i = 0; i < rows->count; i ++) {
+        if (ecs_has(rows->world, rows->entities[i], Stunned)) {
+            ecs_remove(rows->world, rows->entities[i], Stunned);
+        } else {
+            ecs_add(rows->world, rows->entities[i], Stunned);
+        }
+    }
+}
+
+void Sparse_add_in_progress() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_TAG(world, Stunned);
+
+    _ecs_set_sparse_storage(world, Stunned);
+
+    ECS_SYSTEM(world, ToggleStunned, EcsOnUpdate, Position, .Stunned);
+
+    ecs_entity_t e = ecs_new_w_count(world, Position, 10);
+    ecs_add(world, e, Stunned);
+
+    ecs_progress(world, 1);
+    test_int(ecs_count(world, Stunned), 9);
+    test_assert(!ecs_has(world, e, Stunned));
+
+    ecs_progress(world, 1);
+    test_int(ecs_count(world, Stunned), 1);
+    test_assert(ecs_has(world, e, Stunned));
+
+    ecs_fini(world);
+}
+
+void Sparse_add_in_progress_threaded() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_TAG(world, Stunned);
+
+    _ecs_set_sparse_storage(world, Stunned);
+
+    ECS_SYSTEM(world, ToggleStunned, EcsOnUpdate, Position, .Stunned);
+
+    ecs_entity_t e = ecs_new_w_count(world, Position, 100);
+    ecs_add(world, e, Stunned);
+
+    ecs_set_threads(world, 4);
+
+    ecs_progress(world, 1);
+    test_int(ecs_count(world, Stunned), 99);
+    test_assert(!ecs_has(world, e, Stunned));
+
+    ecs_progress(world, 1);
+    test_int(ecs_count(world, Stunned), 1);
+    test_assert(ecs_has(world, e, Stunned));
+
+    ecs_fini(world);
+}
+
+static
+void SetVelocity(ecs_rows_t *rows) {
+    ECS_COLUMN_COMPONENT(rows, Velocity, 2);
+
+    int i;
+    for (i = 0; i < rows->count; i ++) {
+        ecs_set(rows->world, rows->entities[i], Velocity, {
+            rows->entities[i], 0});
+    }
+}
+
+void Sparse_set_in_progress_threaded() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+
+    ecs_set_sparse_storage(world, Velocity);
+
+    ECS_SYSTEM(world, SetVelocity, EcsOnUpdate, Position, .Velocity);
+
+    ecs_entity_t e = ecs_new_w_count(world, Position, 100);
+
+    ecs_set_threads(world, 4);
+    ecs_progress(world, 1);
+
+    test_int(ecs_count(world, Velocity), 100);
+
+    int i;
+    for (i = 0; i < 100; i ++) {
+        Velocity *v = ecs_get_ptr(world, e + i, Velocity);
+        test_assert(v != NULL);
+        test_int(v->x, e + i);
+    }
+
+    ecs_fini(world);
+}
+
+void Sparse_set_stale() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_TAG(world, Stunned);
+
+    ecs_set_sparse_storage(world, Position);
+    _ecs_set_sparse_storage(world, Stunned);
+
+    ecs_entity_t e = ecs_set(world, 0, Position, {1, 2});
+    ecs_delete(world, e);
+
+    ecs_entity_t e2 = ecs_set(world, 0, Position, {3, 4});
+    test_int(e2 & ECS_ENTITY_ID_MASK, e);
+
+    /* Deleted handle must not write to the storage of the recycled entity */
+    ecs_set(world, e, Position, {5, 6});
+    ecs_add(world, e, Stunned);
+    test_assert(!ecs_is_alive(world, e));
+    test_assert(!ecs_has(world, e, Stunned));
+    test_assert(!ecs_has(world, e2, Stunned));
+    test_int(ecs_count(world, Stunned), 0);
+
+    Position *p = ecs_get_ptr(world, e2, Position);
+    test_assert(p != NULL);
+    test_int(p->x, 3);
+    test_int(p->y, 4);
+
+    ecs_fini(world);
+}
+
+static
+void SetVelocityDeferred(ecs_rows_t *rows) {
+    ECS_COLUMN_COMPONENT(rows, Velocity, 2);
+
+    int i;
+    for (i = 0; i < rows->count; i ++) {
+        ecs_entity_t e = rows->entities[i];
+        ecs_set(rows->world, e, Velocity, {e, 0});
+
+        /* Storage is not modified until the stage is merged */
+        Velocity *v = ecs_get_ptr(rows->world, e, Velocity);
+        test_assert(v != NULL);
+        test_int(v->x, 0);
+    }
+}
+
+void Sparse_set_in_progress() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+
+    ecs_set_sparse_storage(world, Velocity);
+
+    ECS_SYSTEM(world, SetVelocityDeferred, EcsOnUpdate, Position, .Velocity);
+
+    ecs_entity_t e = ecs_new_w_count(world, Position, 10);
+
+    int i;
+    for (i = 0; i < 10; i ++) {
+        ecs_set(world, e + i, Velocity, {0, 0});
+    }
+
+    ecs_progress(world, 1);
+
+    for (i = 0; i < 10; i ++) {
+        Velocity *v = ecs_get_ptr(world, e + i, Velocity);
+        test_assert(v != NULL);
+        test_int(v->x, e + i);
+    }
+
+    ecs_fini(world);
+}
+
+static
+void RemoveStunned(ecs_rows_t *rows) {
+    ECS_COLUMN_COMPONENT(rows, Stunned, 2);
+
+    int i;
+    for (i = 0; i < rows->count; i ++) {
+        ecs_remove(rows->world, rows->entities[i], Stunned);
+
+        /* Storage is not modified until the stage is merged */
+        test_assert(ecs_has(rows->world, rows->entities[i], Stunned));
+    }
+}
+
+void Sparse_remove_in_progress() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_TAG(world, Stunned);
+
+    _ecs_set_sparse_storage(world, Stunned);
+
+    ECS_SYSTEM(world, RemoveStunned, EcsOnUpdate, Position, .Stunned);
+
+    ecs_entity_t e = ecs_new_w_count(world, Position, 10);
+
+    int i;
+    for (i = 0; i < 10; i ++) {
+        ecs_add(world, e + i, Stunned);
+    }
+
+    ecs_progress(world, 1);
+    test_int(ecs_count(world, Stunned), 0);
+
+    ecs_fini(world);
+}
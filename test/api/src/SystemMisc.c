@@ -476,3 +476,73 @@ void SystemMisc_table_columns_access() {
 
     ecs_fini(world);
 }
+
+static
+void Iter(ecs_rows_t *rows) {
+    ProbeSystem(rows);
+}
+
+void SystemMisc_match_tables_in_creation_order() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+    ECS_COMPONENT(world, Mass);
+    ECS_PREFAB(world, Base, Position);
+    ECS_TYPE(world, Type_1, Position, Velocity);
+    ECS_TYPE(world, Type_2, INSTANCEOF | Base, Velocity);
+    ECS_TYPE(world, Type_3, Position, Mass);
+
+    ecs_entity_t e_1 = ecs_new(world, Type_1);
+    ecs_entity_t e_2 = ecs_new(world, Type_2);
+    ecs_entity_t e_3 = ecs_new(world, Type_3);
+
+    /* Existing tables, of which one inherits Position, are matched in the
+     * order in which they were created */
+    ECS_SYSTEM(world, Iter, EcsOnUpdate, Position);
+
+    SysTestData ctx = {0};
+    ecs_set_context(world, &ctx);
+
+    ecs_progress(world, 1);
+
+    test_int(ctx.count, 3);
+    test_int(ctx.invoked, 3);
+    test_int(ctx.e[0], e_1);
+    test_int(ctx.e[1], e_2);
+    test_int(ctx.e[2], e_3);
+
+    ecs_fini(world);
+}
+
+void SystemMisc_match_tables_in_creation_order_after_gc() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+    ECS_COMPONENT(world, Mass);
+    ECS_TYPE(world, Type_1, Position, Velocity);
+    ECS_TYPE(world, Type_2, Position, Mass);
+
+    ecs_entity_t e = ecs_new(world, Position);
+    ecs_entity_t e_1 = ecs_new(world, Type_1);
+    ecs_entity_t e_2 = ecs_new(world, Type_2);
+
+    /* Deletes the first table with Position */
+    ecs_delete(world, e);
+    ecs_gc(world);
+
+    ECS_SYSTEM(world, Iter, EcsOnUpdate, Position);
+
+    SysTestData ctx = {0};
+    ecs_set_context(world, &ctx);
+
+    ecs_progress(world, 1);
+
+    test_int(ctx.count, 2);
+    test_int(ctx.invoked, 2);
+    test_int(ctx.e[0], e_1);
+    test_int(ctx.e[1], e_2);
+
+    ecs_fini(world);
+}
@@ -1929,3 +1929,59 @@ void SystemOnFrame_get_sys_context_from_param() {
 
     ecs_fini(world);
 }
+
+static
+void CheckAlignment(ecs_rows_t *rows) {
+    ECS_COLUMN(rows, Position, p, 1);
+    ECS_COLUMN(rows, Velocity, v, 2);
+    uint32_t *alignment = rows->param;
+
+    test_assert(p != NULL);
+    test_assert(v != NULL);
+    test_int((uintptr_t)p % *alignment, 0);
+    test_int((uintptr_t)v % *alignment, 0);
+}
+
+void SystemOnFrame_column_alignment() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+    ECS_SYSTEM(world, CheckAlignment, EcsOnUpdate, Position, Velocity);
+
+    ecs_new_w_count(world, Position, 10);
+    ecs_new(world, Velocity);
+
+    int i;
+    for (i = 0; i < 1000; i ++) {
+        ecs_entity_t e = ecs_new(world, Position);
+        ecs_add(world, e, Velocity);
+    }
+
+    uint32_t alignment = ECS_COLUMN_ALIGNMENT;
+    ecs_run(world, CheckAlignment, 1, &alignment);
+
+    ecs_fini(world);
+}
+
+void SystemOnFrame_column_alignment_custom() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+    ECS_SYSTEM(world, CheckAlignment, EcsOnUpdate, Position, Velocity);
+
+    ecs_set(world, ecs_entity(Position), EcsComponent, {
+        .size = sizeof(Position), .alignment = 256});
+    ecs_set(world, ecs_entity(Velocity), EcsComponent, {
+        .size = sizeof(Velocity), .alignment = 256});
+
+    ecs_new_w_count(world, Position, 100);
+    ecs_entity_t e = ecs_new(world, Position);
+    ecs_add(world, e, Velocity);
+
+    uint32_t alignment = 256;
+    ecs_run(world, CheckAlignment, 1, &alignment);
+
+    ecs_fini(world);
+}
@@ -1315,3 +1315,47 @@ void System_w_FromContainer_realloc_after_match() {
 
     ecs_fini(world);
 }
+
+void System_w_FromContainer_add_component_to_one_of_2_containers() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Mass);
+
+    ECS_ENTITY(world, e_1, Position);
+    ECS_ENTITY(world, e_2, Position);
+
+    ECS_SYSTEM(world, Iter, EcsOnUpdate, CONTAINER.Mass, Position);
+
+    ecs_entity_t parent_1 = ecs_new(world, 0);
+    ecs_entity_t parent_2 = ecs_new(world, 0);
+    ecs_adopt(world, e_1, parent_1);
+    ecs_adopt(world, e_2, parent_2);
+
+    SysTestData ctx = {0};
+    ecs_set_context(world, &ctx);
+
+    ecs_progress(world, 1);
+    test_int(ctx.count, 0);
+
+    /* Only the table with children of parent_1 is rematched */
+    ecs_set(world, parent_1, Mass, {2});
+
+    ecs_progress(world, 1);
+    test_int(ctx.count, 1);
+    test_int(ctx.e[0], e_1);
+    test_int(ctx.s[0][0], parent_1);
+
+    ctx = (SysTestData){0};
+    ecs_set(world, parent_2, Mass, {3});
+
+    ecs_progress(world, 1);
+    test_int(ctx.count, 2);
+
+    Position *p = ecs_get_ptr(world, e_2, Position);
+    test_assert(p != NULL);
+    test_int(p->x, 30);
+    test_int(p->y, 60);
+
+    ecs_fini(world);
+}
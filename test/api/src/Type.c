@@ -719,3 +719,67 @@ void Type_type_from_0() {
 
     ecs_fini(world);
 }
+
+void Type_find_large_ids() {
+    ecs_world_t *world = ecs_init();
+
+    ecs_entity_t e1 = ecs_new(world, 0);
+    ecs_entity_t e2 = e1 + 1000;
+    ecs_entity_t e3 = e1 + 100000;
+
+    ecs_type_t t1 = ecs_type_find(world, (ecs_entity_t[]){e1, e2, e3}, 3);
+    test_assert(t1 != NULL);
+    test_int(ecs_vector_count(t1), 3);
+
+    ecs_type_t t2 = ecs_type_find(world, (ecs_entity_t[]){e1, e3}, 2);
+    test_assert(t2 != NULL);
+    test_assert(t1 != t2);
+    test_int(ecs_vector_count(t2), 2);
+
+    test_assert(ecs_type_find(world, (ecs_entity_t[]){e1, e2, e3}, 3) == t1);
+    test_assert(ecs_type_find(world, (ecs_entity_t[]){e1, e3}, 2) == t2);
+
+    ecs_fini(world);
+}
+
+void Type_find_many_types() {
+    ecs_world_t *world = ecs_init();
+
+    ecs_entity_t e = ecs_new(world, 0);
+    ecs_type_t types[500];
+
+    int i;
+    for (i = 0; i < 500; i ++) {
+        types[i] = ecs_type_find(world, (ecs_entity_t[]){e, e + i + 1}, 2);
+        test_assert(types[i] != NULL);
+    }
+
+    /* Growing the type database does not change existing types */
+    for (i = 0; i < 500; i ++) {
+        ecs_type_t t = ecs_type_find(world, (ecs_entity_t[]){e, e + i + 1}, 2);
+        test_assert(t == types[i]);
+    }
+
+    ecs_fini(world);
+}
+
+void Type_find_not_normalized() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_ENTITY(world, Base, 0);
+
+    ecs_type_t t1 = ecs_type_find(
+        world, (ecs_entity_t[]){Base, ECS_INSTANCEOF | Base}, 2);
+    test_assert(t1 != NULL);
+    test_int(ecs_vector_count(t1), 1);
+    test_int(*(ecs_entity_t*)ecs_vector_first(t1), ECS_INSTANCEOF | Base);
+
+    ecs_type_t t2 = ecs_type_find(
+        world, (ecs_entity_t[]){ECS_INSTANCEOF | Base}, 1);
+    test_assert(t1 == t2);
+
+    test_assert(ecs_type_find(
+        world, (ecs_entity_t[]){Base, ECS_INSTANCEOF | Base}, 2) == t1);
+
+    ecs_fini(world);
+}
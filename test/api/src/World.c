@@ -296,7 +296,8 @@ void World_dim() {
 
     ecs_new_w_count(world, Position, 500);
 
-    test_int(malloc_count, 6);
+    /* Column arrays of the new table are allocated from the world slab */
+    test_int(malloc_count, 3);
 
     malloc_count = 0;
 
@@ -325,13 +326,13 @@ void World_dim_type() {
 
     ecs_new_w_count(world, Position, 500);
 
-    test_int(malloc_count, 2);
+    test_int(malloc_count, 1);
 
     malloc_count = 0;
 
     ecs_new_w_count(world, Position, 400);
 
-    test_int(malloc_count, 3);
+    test_int(malloc_count, 1);
 
     ecs_fini(world);
 }
@@ -1068,3 +1069,580 @@ void World_is_entity_enabled() {
 
     ecs_fini(world);
 }
+
+static
+uint32_t component_memory(
+    ecs_world_t *world,
+    ecs_entity_t component)
+{
+    ecs_world_stats_t stats = {0};
+    ecs_get_stats(world, &stats);
+
+    uint32_t result = 0;
+    EcsComponentStats *c = ecs_vector_first(stats.components);
+    uint32_t i, count = ecs_vector_count(stats.components);
+    for (i = 0; i < count; i ++) {
+        if (c[i].handle == component) {
+            result = c[i].memory_allocd;
+            break;
+        }
+    }
+
+    ecs_free_stats(&stats);
+
+    return result;
+}
+
+void World_shrink() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+
+    ecs_entity_t e = ecs_new_w_count(world, Position, 1000);
+
+    int i;
+    for (i = 0; i < 1000; i ++) {
+        ecs_set(world, e + i, Position, {i, i * 2});
+    }
+
+    for (i = 10; i < 1000; i ++) {
+        ecs_delete(world, e + i);
+    }
+
+    uint32_t before = component_memory(world, ecs_entity(Position));
+    test_assert(before >= 1000 * sizeof(Position));
+
+    ecs_shrink(world);
+
+    uint32_t after = component_memory(world, ecs_entity(Position));
+    test_assert(after < before);
+    test_assert(after < 100 * sizeof(Position));
+
+    test_int(ecs_count(world, Position), 10);
+    for (i = 0; i < 10; i ++) {
+        Position *p = ecs_get_ptr(world, e + i, Position);
+        test_assert(p != NULL);
+        test_int(p->x, i);
+        test_int(p->y, i * 2);
+    }
+
+    /* Table must still be usable after shrinking */
+    ecs_new_w_count(world, Position, 100);
+    test_int(ecs_count(world, Position), 110);
+
+    ecs_fini(world);
+}
+
+void World_shrink_empty() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+
+    ecs_entity_t e = ecs_new_w_count(world, Position, 1000);
+
+    int i;
+    for (i = 0; i < 1000; i ++) {
+        ecs_delete(world, e + i);
+    }
+
+    test_int(ecs_count(world, Position), 0);
+    test_assert(component_memory(world, ecs_entity(Position)) != 0);
+
+    ecs_shrink(world);
+
+    test_int(component_memory(world, ecs_entity(Position)), 0);
+
+    e = ecs_set(world, 0, Position, {10, 20});
+    Position *p = ecs_get_ptr(world, e, Position);
+    test_assert(p != NULL);
+    test_int(p->x, 10);
+    test_int(p->y, 20);
+
+    ecs_fini(world);
+}
+
+void World_shrink_type() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+
+    ecs_entity_t p = ecs_new_w_count(world, Position, 1000);
+    ecs_entity_t v = ecs_new_w_count(world, Velocity, 1000);
+
+    int i;
+    for (i = 0; i < 1000; i ++) {
+        ecs_delete(world, p + i);
+        ecs_delete(world, v + i);
+    }
+
+    ecs_shrink_type(world, Position);
+
+    test_int(component_memory(world, ecs_entity(Position)), 0);
+    test_assert(component_memory(world, ecs_entity(Velocity)) != 0);
+
+    ecs_fini(world);
+}
+
+void World_shrink_chunked() {
+    ecs_world_t *world = ecs_init();
+    ecs_set_table_chunk_size(world, 256);
+
+    ECS_COMPONENT(world, Position);
+
+    ecs_entity_t e = ecs_new_w_count(world, Position, 1000);
+
+    int i;
+    for (i = 0; i < 1000; i ++) {
+        ecs_set(world, e + i, Position, {i, i * 2});
+    }
+
+    for (i = 100; i < 1000; i ++) {
+        ecs_delete(world, e + i);
+    }
+
+    uint32_t before = component_memory(world, ecs_entity(Position));
+
+    ecs_shrink(world);
+
+    /* 100 rows fit in 4 chunks of 32 rows */
+    uint32_t after = component_memory(world, ecs_entity(Position));
+    test_assert(after < before);
+    test_assert(after < 5 * (256 + ECS_COLUMN_ALIGNMENT));
+
+    for (i = 0; i < 100; i ++) {
+        Position *p = ecs_get_ptr(world, e + i, Position);
+        test_assert(p != NULL);
+        test_int(p->x, i);
+        test_int(p->y, i * 2);
+    }
+
+    ecs_fini(world);
+}
+
+void World_autoshrink() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+
+    ecs_set_autoshrink(world, 0.25, 3);
+
+    ecs_entity_t e = ecs_new_w_count(world, Position, 1000);
+
+    int i;
+    for (i = 10; i < 1000; i ++) {
+        ecs_delete(world, e + i);
+    }
+
+    uint32_t before = component_memory(world, ecs_entity(Position));
+
+    /* Table must stay below threshold for 3 frames before it is shrunk */
+    ecs_progress(world, 1);
+    ecs_progress(world, 1);
+    test_int(component_memory(world, ecs_entity(Position)), before);
+
+    ecs_progress(world, 1);
+    test_assert(component_memory(world, ecs_entity(Position)) < before);
+    test_int(ecs_count(world, Position), 10);
+
+    ecs_fini(world);
+}
+
+void World_autoshrink_above_threshold() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+
+    ecs_set_autoshrink(world, 0.25, 1);
+
+    ecs_entity_t e = ecs_new_w_count(world, Position, 1000);
+
+    int i;
+    for (i = 500; i < 1000; i ++) {
+        ecs_delete(world, e + i);
+    }
+
+    uint32_t before = component_memory(world, ecs_entity(Position));
+
+    ecs_progress(world, 1);
+    ecs_progress(world, 1);
+    test_int(component_memory(world, ecs_entity(Position)), before);
+
+    ecs_fini(world);
+}
+
+void World_autoshrink_disable() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+
+    ecs_set_autoshrink(world, 0.25, 1);
+    ecs_set_autoshrink(world, 0, 0);
+
+    ecs_entity_t e = ecs_new_w_count(world, Position, 1000);
+
+    int i;
+    for (i = 10; i < 1000; i ++) {
+        ecs_delete(world, e + i);
+    }
+
+    uint32_t before = component_memory(world, ecs_entity(Position));
+
+    ecs_progress(world, 1);
+    test_int(component_memory(world, ecs_entity(Position)), before);
+
+    ecs_fini(world);
+}
+
+static
+uint32_t table_count(
+    ecs_world_t *world)
+{
+    ecs_world_stats_t stats = {0};
+    ecs_get_stats(world, &stats);
+    uint32_t result = stats.table_count;
+    ecs_free_stats(&stats);
+    return result;
+}
+
+static
+void CountPosition(ecs_rows_t *rows) {
+    int *count = rows->param;
+    *count += rows->count;
+}
+
+void World_gc() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+
+    ecs_entity_t e = ecs_new(world, Position);
+    ecs_add(world, e, Velocity);
+    ecs_remove(world, e, Velocity);
+
+    uint32_t before = table_count(world);
+
+    ecs_gc(world);
+
+    /* Table with Position, Velocity is empty and is deleted */
+    test_assert(table_count(world) < before);
+    test_assert(ecs_has(world, e, Position));
+
+    /* Table is recreated when needed */
+    ecs_set(world, e, Velocity, {1, 2});
+    test_assert(ecs_has(world, e, Position));
+    test_assert(ecs_has(world, e, Velocity));
+
+    Velocity *v = ecs_get_ptr(world, e, Velocity);
+    test_assert(v != NULL);
+    test_int(v->x, 1);
+    test_int(v->y, 2);
+
+    ecs_fini(world);
+}
+
+void World_gc_non_empty() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+
+    ecs_gc(world);
+    uint32_t before = table_count(world);
+
+    ecs_entity_t e = ecs_set(world, 0, Position, {10, 20});
+    test_int(table_count(world), before + 1);
+
+    ecs_gc(world);
+    test_int(table_count(world), before + 1);
+
+    Position *p = ecs_get_ptr(world, e, Position);
+    test_assert(p != NULL);
+    test_int(p->x, 10);
+    test_int(p->y, 20);
+
+    ecs_fini(world);
+}
+
+void World_gc_edges() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+    ECS_COMPONENT(world, Mass);
+
+    ecs_entity_t e_1 = ecs_new(world, Position);
+    ecs_entity_t e_2 = ecs_new(world, Position);
+
+    /* Populate edges between [Position] and [Position, Velocity] */
+    ecs_add(world, e_1, Velocity);
+    ecs_remove(world, e_1, Velocity);
+
+    ecs_gc(world);
+
+    /* Edge to deleted table must not be used */
+    ecs_add(world, e_1, Mass);
+    ecs_add(world, e_2, Velocity);
+    ecs_add(world, e_1, Velocity);
+
+    test_assert(ecs_has(world, e_1, Position));
+    test_assert(ecs_has(world, e_1, Velocity));
+    test_assert(ecs_has(world, e_1, Mass));
+    test_assert(ecs_has(world, e_2, Position));
+    test_assert(ecs_has(world, e_2, Velocity));
+    test_assert(!ecs_has(world, e_2, Mass));
+
+    test_int(ecs_count(world, Velocity), 2);
+
+    ecs_remove(world, e_2, Velocity);
+    test_assert(ecs_has(world, e_2, Position));
+    test_assert(!ecs_has(world, e_2, Velocity));
+
+    ecs_fini(world);
+}
+
+void World_gc_system() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+    ECS_SYSTEM(world, CountPosition, EcsOnUpdate, Position);
+
+    int count = 0;
+    ecs_set_system_context(world, CountPosition, &count);
+
+    ecs_entity_t e_1 = ecs_new(world, Position);
+    ecs_entity_t e_2 = ecs_new(world, Position);
+    ecs_add(world, e_2, Velocity);
+    ecs_delete(world, e_2);
+
+    ecs_gc(world);
+
+    ecs_progress(world, 1);
+    test_int(count, 1);
+
+    /* Recreate deleted table, which must be matched with the system again */
+    ecs_add(world, e_1, Velocity);
+    ecs_entity_t e_3 = ecs_new(world, Position);
+
+    count = 0;
+    ecs_progress(world, 1);
+    test_int(count, 2);
+
+    /* Delete all tables matched with the system */
+    ecs_delete(world, e_1);
+    ecs_delete(world, e_3);
+    ecs_gc(world);
+
+    count = 0;
+    ecs_progress(world, 1);
+    test_int(count, 0);
+
+    ecs_new(world, Position);
+    ecs_progress(world, 1);
+    test_int(count, 1);
+
+    ecs_fini(world);
+}
+
+void World_autogc() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+
+    ecs_set_autogc(world, 3);
+
+    ecs_entity_t e = ecs_new(world, Position);
+    ecs_add(world, e, Velocity);
+    ecs_remove(world, e, Velocity);
+
+    uint32_t before = table_count(world);
+
+    /* Table must be empty for 3 frames before it is deleted */
+    ecs_progress(world, 1);
+    ecs_progress(world, 1);
+    test_int(table_count(world), before);
+
+    ecs_progress(world, 1);
+    test_assert(table_count(world) < before);
+    test_assert(ecs_has(world, e, Position));
+
+    ecs_fini(world);
+}
+
+void World_autogc_reset() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+
+    ecs_set_autogc(world, 2);
+
+    ecs_entity_t e = ecs_new(world, Position);
+    ecs_add(world, e, Velocity);
+    ecs_remove(world, e, Velocity);
+
+    uint32_t before = table_count(world);
+
+    ecs_progress(world, 1);
+
+    /* Table is no longer empty, which resets the number of empty frames */
+    ecs_add(world, e, Velocity);
+    ecs_progress(world, 1);
+    ecs_remove(world, e, Velocity);
+    ecs_progress(world, 1);
+    test_int(table_count(world), before);
+
+    ecs_progress(world, 1);
+    test_assert(table_count(world) < before);
+
+    ecs_fini(world);
+}
+
+void World_allocator_stats() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+
+    ecs_world_stats_t stats = {0};
+    ecs_get_stats(world, &stats);
+
+    uint32_t alloc_count = stats.allocator.alloc_count;
+    uint32_t used = stats.allocator.used;
+    test_assert(alloc_count != 0);
+    test_assert(stats.allocator.allocd >= used);
+    test_int(stats.column_arena.alloc_count, 0);
+
+    ecs_new_w_count(world, Position, 10);
+
+    ecs_get_stats(world, &stats);
+    test_assert(stats.allocator.alloc_count > alloc_count);
+    test_assert(stats.allocator.used > used);
+
+    ecs_free_stats(&stats);
+    ecs_fini(world);
+}
+
+void World_type_memory_stats() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+
+    ecs_world_stats_t stats = {0};
+    ecs_get_stats(world, &stats);
+
+    uint32_t allocd = stats.memory.families.allocd;
+    uint32_t used = stats.memory.families.used;
+    test_assert(used != 0);
+    test_assert(allocd >= used);
+    ecs_free_stats(&stats);
+
+    ECS_TYPE(world, Type, Position, Velocity);
+    ecs_new(world, Type);
+
+    memset(&stats, 0, sizeof(stats));
+    ecs_get_stats(world, &stats);
+    test_assert(stats.memory.families.used > used);
+    test_assert(stats.memory.families.allocd >= stats.memory.families.used);
+
+    ecs_free_stats(&stats);
+    ecs_fini(world);
+}
+
+void World_type_merge_stats() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+    ECS_COMPONENT(world, Mass);
+    ECS_COMPONENT(world, Rotation);
+    ECS_TYPE(world, Type, Position, Velocity);
+    ECS_TYPE(world, Type_2, Mass, Rotation);
+
+    ecs_entity_t e = ecs_new(world, Type);
+
+    ecs_world_stats_t stats = {0};
+    ecs_get_stats(world, &stats);
+    uint32_t hits = stats.type_merge_hits;
+    uint32_t misses = stats.type_merge_misses;
+    test_assert(misses != 0);
+    ecs_free_stats(&stats);
+
+    ecs_add(world, e, Type_2);
+    ecs_remove(world, e, Type_2);
+
+    memset(&stats, 0, sizeof(stats));
+    ecs_get_stats(world, &stats);
+    test_assert(stats.type_merge_misses > misses);
+    hits = stats.type_merge_hits;
+    misses = stats.type_merge_misses;
+    ecs_free_stats(&stats);
+
+    /* Repeating the same transitions hits the cache */
+    ecs_add(world, e, Type_2);
+    ecs_remove(world, e, Type_2);
+
+    memset(&stats, 0, sizeof(stats));
+    ecs_get_stats(world, &stats);
+    test_assert(stats.type_merge_hits > hits);
+    test_int(stats.type_merge_misses, misses);
+    test_assert(ecs_has(world, e, Type));
+    test_assert(!ecs_has(world, e, Type_2));
+    ecs_free_stats(&stats);
+
+    ecs_fini(world);
+}
+
+void World_column_arena() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+
+    ecs_set_column_arena(world, true);
+
+    ecs_new_w_count(world, Position, 10000);
+
+    ecs_world_stats_t stats = {0};
+    ecs_get_stats(world, &stats);
+    test_assert(stats.column_arena.used >= 10000 * sizeof(Position));
+    uint32_t os_alloc_count = stats.column_arena.os_alloc_count;
+
+    ecs_type_filter_t filter = {.include = ecs_type(Position)};
+    ecs_delete_w_filter(world, &filter);
+
+    /* Memory of the deleted columns is reused by the arena */
+    ecs_new_w_count(world, Position, 10000);
+    ecs_get_stats(world, &stats);
+    test_int(stats.column_arena.os_alloc_count, os_alloc_count);
+
+    /* Columns that live in the arena are still released to it */
+    ecs_set_column_arena(world, false);
+    ecs_delete_w_filter(world, &filter);
+
+    ecs_free_stats(&stats);
+    ecs_fini(world);
+}
+
+void World_entity_range_add_recycled() {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+
+    ecs_set_entity_range(world, 5000, 6000);
+
+    ecs_entity_t e = ecs_new(world, 0);
+    test_int(e, 5000);
+    ecs_delete(world, e);
+
+    /* Recycled id has a generation, but is still in range */
+    ecs_entity_t e2 = ecs_new(world, 0);
+    test_int(e2 & ECS_ENTITY_ID_MASK, 5000);
+    test_int(ECS_GENERATION(e2), 1);
+
+    ecs_add(world, e2, Position);
+    test_assert(ecs_has(world, e2, Position));
+
+    ecs_fini(world);
+}
@@ -87,6 +87,9 @@ void Add_add_remove(void);
 void Add_add_remove_same(void);
 void Add_add_2_remove(void);
 void Add_on_add_after_new_type_in_progress(void);
+void Add_add_remove_cached(void);
+void Add_add_cached_in_progress(void);
+void Add_bench_toggle_1m(void);
 
 // Testsuite 'Remove'
 void Remove_zero(void);
@@ -118,6 +121,7 @@ void Add_remove_w_filter_remove_1_include_1(void);
 void Add_remove_w_filter_remove_1_include_2(void);
 void Add_remove_w_filter_add_1(void);
 void Add_remove_w_filter_add_2(void);
+void Add_remove_w_filter_add_1_preserves_data(void);
 
 // Testsuite 'Has'
 void Has_zero(void);
@@ -154,6 +158,10 @@ void Count_count_1_component(void);
 void Count_count_2_components(void);
 void Count_count_3_components(void);
 void Count_count_2_types_2_comps(void);
+void Count_count_w_colliding_ids(void);
+void Count_count_inherited(void);
+void Count_count_inherited_and_owned(void);
+void Count_count_after_gc(void);
 
 // Testsuite 'Get_component'
 void Get_component_get_empty(void);
@@ -165,6 +173,8 @@ void Get_component_get_1_from_2_in_progress_from_main_stage(void);
 void Get_component_get_1_from_2_add_in_progress(void);
 void Get_component_get_both_from_2_add_in_progress(void);
 void Get_component_get_both_from_2_add_remove_in_progress(void);
+void Get_component_bench_get_1m(void);
+void Get_component_bench_get_10m(void);
 
 // Testsuite 'Delete'
 void Delete_delete_1(void);
@@ -176,6 +186,26 @@ void Delete_delete_2nd_of_3(void);
 void Delete_delete_2_of_3(void);
 void Delete_delete_3_of_3(void);
 void Delete_delete_w_on_remove(void);
+void Delete_delete_recycle(void);
+void Delete_delete_recycle_w_component(void);
+void Delete_delete_recycle_generations(void);
+void Delete_delete_twice_recycle_once(void);
+void Delete_delete_nonexist_no_recycle(void);
+void Delete_delete_revived_no_recycle(void);
+void Delete_delete_in_progress_recycle(void);
+void Delete_is_alive(void);
+void Delete_delete_churn(void);
+void Delete_delete_w_count(void);
+void Delete_delete_w_count_subset(void);
+void Delete_delete_w_count_mixed(void);
+void Delete_delete_w_count_nonexist(void);
+void Delete_delete_n(void);
+void Delete_delete_n_duplicates(void);
+void Delete_delete_n_on_remove(void);
+void Delete_delete_n_chunked(void);
+void Delete_delete_w_count_in_progress(void);
+void Delete_add_stale(void);
+void Delete_set_stale(void);
 
 // Testsuite 'Delete_w_filter'
 void Delete_w_filter_delete_1(void);
@@ -215,6 +245,13 @@ void Lookup_lookup_w_null_id(void);
 void Lookup_get_id(void);
 void Lookup_get_id_no_id(void);
 void Lookup_get_id_from_empty(void);
+void Lookup_lookup_after_rename(void);
+void Lookup_lookup_after_delete(void);
+void Lookup_lookup_after_merge(void);
+void Lookup_lookup_clone(void);
+void Lookup_lookup_after_delete_w_filter(void);
+void Lookup_lookup_after_rename_in_progress(void);
+void Lookup_lookup_after_delete_in_progress(void);
 
 // Testsuite 'Singleton'
 void Singleton_set(void);
@@ -273,6 +310,8 @@ void SystemMisc_system_w_or_prefab(void);
 void SystemMisc_system_w_or_disabled(void);
 void SystemMisc_system_w_or_disabled_and_prefab(void);
 void SystemMisc_table_columns_access(void);
+void SystemMisc_match_tables_in_creation_order(void);
+void SystemMisc_match_tables_in_creation_order_after_gc(void);
 
 // Testsuite 'SystemOnAdd'
 void SystemOnAdd_new_match_1_of_1(void);
@@ -387,6 +426,8 @@ void SystemOnFrame_not_from_singleton(void);
 void SystemOnFrame_not_from_entity(void);
 void SystemOnFrame_sys_context(void);
 void SystemOnFrame_get_sys_context_from_param(void);
+void SystemOnFrame_column_alignment(void);
+void SystemOnFrame_column_alignment_custom(void);
 
 // Testsuite 'SystemCascade'
 void SystemCascade_cascade_depth_1(void);
@@ -495,6 +536,9 @@ void Prefab_cyclic_inheritance_get_unavailable(void);
 void Prefab_cyclic_inheritance_has_unavailable(void);
 void Prefab_clone_after_inherit_in_on_add(void);
 void Prefab_override_from_nested(void);
+void Prefab_rematch_after_add_to_base(void);
+void Prefab_rematch_after_add_base_to_prefab(void);
+void Prefab_rematch_w_prefab_cycle(void);
 
 // Testsuite 'System_w_FromContainer'
 void System_w_FromContainer_1_column_from_container(void);
@@ -517,6 +561,7 @@ void System_w_FromContainer_add_component_after_match_and_rematch_w_entity_type_
 void System_w_FromContainer_adopt_after_match(void);
 void System_w_FromContainer_new_child_after_match(void);
 void System_w_FromContainer_realloc_after_match(void);
+void System_w_FromContainer_add_component_to_one_of_2_containers(void);
 
 // Testsuite 'System_w_FromId'
 void System_w_FromId_2_column_1_from_id(void);
@@ -533,6 +578,7 @@ void System_w_FromSystem_auto_add_tag(void);
 
 // Testsuite 'System_w_FromEntity'
 void System_w_FromEntity_2_column_1_from_entity(void);
+void System_w_FromEntity_add_component_to_entity_after_match(void);
 
 // Testsuite 'World'
 void World_progress_w_0(void);
@@ -568,6 +614,24 @@ void World_init_w_args_enable_dbg(void);
 void World_no_threading(void);
 void World_no_time(void);
 void World_is_entity_enabled(void);
+void World_shrink(void);
+void World_shrink_empty(void);
+void World_shrink_type(void);
+void World_shrink_chunked(void);
+void World_autoshrink(void);
+void World_autoshrink_above_threshold(void);
+void World_autoshrink_disable(void);
+void World_gc(void);
+void World_gc_non_empty(void);
+void World_gc_edges(void);
+void World_gc_system(void);
+void World_autogc(void);
+void World_autogc_reset(void);
+void World_allocator_stats(void);
+void World_column_arena(void);
+void World_type_memory_stats(void);
+void World_type_merge_stats(void);
+void World_entity_range_add_recycled(void);
 
 // Testsuite 'Type'
 void Type_type_of_1_tostr(void);
@@ -611,6 +675,9 @@ void Type_entity_from_type_w_2_elements(void);
 void Type_type_from_entity(void);
 void Type_type_from_empty(void);
 void Type_type_from_0(void);
+void Type_find_large_ids(void);
+void Type_find_many_types(void);
+void Type_find_not_normalized(void);
 
 // Testsuite 'Run'
 void Run_run(void);
@@ -636,6 +703,10 @@ void Run_run_w_container_filter(void);
 void Run_run_comb_10_entities_1_type(void);
 void Run_run_comb_10_entities_2_types(void);
 void Run_run_w_interrupt(void);
+void Run_run_w_filter_handle(void);
+void Run_run_w_filter_handle_new_table(void);
+void Run_run_w_filter_handle_offset_limit(void);
+void Run_run_w_filter_handle_prefab(void);
 
 // Testsuite 'MultiThread'
 void MultiThread_2_thread_1_entity(void);
@@ -672,6 +743,8 @@ void MultiThread_change_thread_count(void);
 void MultiThread_multithread_quit(void);
 void MultiThread_schedule_w_tasks(void);
 void MultiThread_reactive_system(void);
+void MultiThread_new_in_worker_threads(void);
+void MultiThread_new_w_count_in_worker_threads(void);
 
 // Testsuite 'SingleThreadStaging'
 void SingleThreadStaging_new_empty(void);
@@ -738,6 +811,7 @@ void SingleThreadStaging_merge_table_w_container_added_on_set(void);
 void SingleThreadStaging_merge_table_w_container_added_on_set_reverse(void);
 void SingleThreadStaging_merge_after_tasks(void);
 void SingleThreadStaging_override_after_remove_in_progress(void);
+void SingleThreadStaging_no_alloc_in_steady_state(void);
 
 // Testsuite 'MultiThreadStaging'
 void MultiThreadStaging_2_threads_add_to_current(void);
@@ -749,6 +823,7 @@ void MultiThreadStaging_stress_create_delete_entity_random_components(void);
 void MultiThreadStaging_stress_set_entity_random_components(void);
 void MultiThreadStaging_2_threads_on_add(void);
 void MultiThreadStaging_new_w_count(void);
+void MultiThreadStaging_no_alloc_in_steady_state(void);
 
 // Testsuite 'Modules'
 void Modules_simple_module(void);
@@ -778,6 +853,109 @@ void Error_log_log(void);
 void Error_log_warning(void);
 void Error_log_error(void);
 
+// Testsuite 'Chunked'
+void Chunked_iter(void);
+void Chunked_new_w_count(void);
+void Chunked_rows_do_not_move(void);
+void Chunked_delete(void);
+void Chunked_add_remove(void);
+void Chunked_set_w_data(void);
+void Chunked_add_in_progress(void);
+void Chunked_on_add(void);
+void Chunked_stats(void);
+void Chunked_table_column(void);
+
+// Testsuite 'Add_remove_w_count'
+void Add_remove_w_count_add(void);
+void Add_remove_w_count_remove(void);
+void Add_remove_w_count_add_remove(void);
+void Add_remove_w_count_remove_all(void);
+void Add_remove_w_count_add_subset(void);
+void Add_remove_w_count_add_subset_at_end(void);
+void Add_remove_w_count_add_to_existing(void);
+void Add_remove_w_count_not_contiguous(void);
+void Add_remove_w_count_watched(void);
+void Add_remove_w_count_on_add(void);
+void Add_remove_w_count_on_remove(void);
+void Add_remove_w_count_system(void);
+void Add_remove_w_count_chunked(void);
+void Add_remove_w_count_in_progress(void);
+
+// Testsuite 'Sort'
+void Sort_sort_on_progress(void);
+void Sort_sort_manual(void);
+void Sort_sort_multiple_tables(void);
+void Sort_sort_stable(void);
+void Sort_sort_after_set(void);
+void Sort_sort_chunked(void);
+void Sort_sort_watched(void);
+void Sort_sort_disable(void);
+void Sort_sort_shared(void);
+
+// Testsuite 'Sparse'
+void Sparse_add_remove(void);
+void Sparse_add_does_not_move(void);
+void Sparse_set_get(void);
+void Sparse_new_w_type(void);
+void Sparse_new_w_count(void);
+void Sparse_has_any(void);
+void Sparse_count(void);
+void Sparse_delete(void);
+void Sparse_delete_w_count(void);
+void Sparse_add_w_count(void);
+void Sparse_add_w_filter(void);
+void Sparse_clone(void);
+void Sparse_system_and(void);
+void Sparse_system_not(void);
+void Sparse_system_data(void);
+void Sparse_system_optional(void);
+void Sparse_add_in_progress(void);
+void Sparse_add_in_progress_threaded(void);
+void Sparse_set_in_progress_threaded(void);
+void Sparse_set_stale(void);
+void Sparse_set_in_progress(void);
+void Sparse_remove_in_progress(void);
+
+// Testsuite 'Enable'
+void Enable_enable_disable(void);
+void Enable_is_enabled_not_owned(void);
+void Enable_system_skip_disabled(void);
+void Enable_system_skip_disabled_tag(void);
+void Enable_system_other_column(void);
+void Enable_system_optional(void);
+void Enable_disable_entity(void);
+void Enable_delete(void);
+void Enable_delete_w_count(void);
+void Enable_move_to_other_table(void);
+void Enable_move_w_count(void);
+void Enable_sort(void);
+void Enable_many_rows(void);
+void Enable_chunked(void);
+void Enable_in_progress(void);
+
+// Testsuite 'OnChange'
+void OnChange_skip_unchanged(void);
+void OnChange_skip_unchanged_table(void);
+void OnChange_add_remove_entity(void);
+void OnChange_enable_component(void);
+void OnChange_system_writes(void);
+void OnChange_ignore_own_writes(void);
+void OnChange_set_in_progress(void);
+void OnChange_threaded(void);
+
+// Testsuite 'Query'
+void Query_iter(void);
+void Query_iter_multiple_tables(void);
+void Query_match_new_table(void);
+void Query_skip_empty_tables(void);
+void Query_iter_w_not(void);
+void Query_iter_w_shared(void);
+void Query_skip_disabled_components(void);
+void Query_iter_chunked(void);
+void Query_iter_no_tables(void);
+void Query_free_in_fini(void);
+void Query_rematch_after_container_change(void);
+
 static bake_test_suite suites[] = {
     {
         .id = "New",
@@ -971,7 +1149,7 @@ static bake_test_suite suites[] = {
     },
     {
         .id = "Add",
-        .testcase_count = 29,
+        .testcase_count = 32,
         .testcases = (bake_test_case[]){
             {
                 .id = "zero",
@@ -1088,6 +1266,18 @@ static bake_test_suite suites[] = {
             {
                 .id = "on_add_after_new_type_in_progress",
                 .function = Add_on_add_after_new_type_in_progress
+            },
+            {
+                .id = "add_remove_cached",
+                .function = Add_add_remove_cached
+            },
+            {
+                .id = "add_cached_in_progress",
+                .function = Add_add_cached_in_progress
+            },
+            {
+                .id = "bench_toggle_1m",
+                .function = Add_bench_toggle_1m
             }
         }
     },
@@ -1159,7 +1349,7 @@ static bake_test_suite suites[] = {
     },
     {
         .id = "Add_remove_w_filter",
-        .testcase_count = 12,
+        .testcase_count = 13,
         .testcases = (bake_test_case[]){
             {
                 .id = "remove_1_no_filter",
@@ -1208,6 +1398,10 @@ static bake_test_suite suites[] = {
             {
                 .id = "add_2",
                 .function = Add_remove_w_filter_add_2
+            },
+            {
+                .id = "add_1_preserves_data",
+                .function = Add_remove_w_filter_add_1_preserves_data
             }
         }
     },
@@ -1327,7 +1521,7 @@ static bake_test_suite suites[] = {
     },
     {
         .id = "Count",
-        .testcase_count = 5,
+        .testcase_count = 9,
         .testcases = (bake_test_case[]){
             {
                 .id = "count_empty",
@@ -1348,12 +1542,28 @@ static bake_test_suite suites[] = {
             {
                 .id = "count_2_types_2_comps",
                 .function = Count_count_2_types_2_comps
+            },
+            {
+                .id = "count_w_colliding_ids",
+                .function = Count_count_w_colliding_ids
+            },
+            {
+                .id = "count_inherited",
+                .function = Count_count_inherited
+            },
+            {
+                .id = "count_inherited_and_owned",
+                .function = Count_count_inherited_and_owned
+            },
+            {
+                .id = "count_after_gc",
+                .function = Count_count_after_gc
             }
         }
     },
     {
         .id = "Get_component",
-        .testcase_count = 9,
+        .testcase_count = 11,
         .testcases = (bake_test_case[]){
             {
                 .id = "get_empty",
@@ -1390,12 +1600,20 @@ static bake_test_suite suites[] = {
             {
                 .id = "get_both_from_2_add_remove_in_progress",
                 .function = Get_component_get_both_from_2_add_remove_in_progress
+            },
+            {
+                .id = "bench_get_1m",
+                .function = Get_component_bench_get_1m
+            },
+            {
+                .id = "bench_get_10m",
+                .function = Get_component_bench_get_10m
             }
         }
     },
     {
         .id = "Delete",
-        .testcase_count = 9,
+        .testcase_count = 29,
         .testcases = (bake_test_case[]){
             {
                 .id = "delete_1",
@@ -1432,6 +1650,86 @@ static bake_test_suite suites[] = {
             {
                 .id = "delete_w_on_remove",
                 .function = Delete_delete_w_on_remove
+            },
+            {
+                .id = "delete_recycle",
+                .function = Delete_delete_recycle
+            },
+            {
+                .id = "delete_recycle_w_component",
+                .function = Delete_delete_recycle_w_component
+            },
+            {
+                .id = "delete_recycle_generations",
+                .function = Delete_delete_recycle_generations
+            },
+            {
+                .id = "delete_twice_recycle_once",
+                .function = Delete_delete_twice_recycle_once
+            },
+            {
+                .id = "delete_nonexist_no_recycle",
+                .function = Delete_delete_nonexist_no_recycle
+            },
+            {
+                .id = "delete_revived_no_recycle",
+                .function = Delete_delete_revived_no_recycle
+            },
+            {
+                .id = "delete_in_progress_recycle",
+                .function = Delete_delete_in_progress_recycle
+            },
+            {
+                .id = "is_alive",
+                .function = Delete_is_alive
+            },
+            {
+                .id = "delete_churn",
+                .function = Delete_delete_churn
+            },
+            {
+                .id = "delete_w_count",
+                .function = Delete_delete_w_count
+            },
+            {
+                .id = "delete_w_count_subset",
+                .function = Delete_delete_w_count_subset
+            },
+            {
+                .id = "delete_w_count_mixed",
+                .function = Delete_delete_w_count_mixed
+            },
+            {
+                .id = "delete_w_count_nonexist",
+                .function = Delete_delete_w_count_nonexist
+            },
+            {
+                .id = "delete_n",
+                .function = Delete_delete_n
+            },
+            {
+                .id = "delete_n_duplicates",
+                .function = Delete_delete_n_duplicates
+            },
+            {
+                .id = "delete_n_on_remove",
+                .function = Delete_delete_n_on_remove
+            },
+            {
+                .id = "delete_n_chunked",
+                .function = Delete_delete_n_chunked
+            },
+            {
+                .id = "delete_w_count_in_progress",
+                .function = Delete_delete_w_count_in_progress
+            },
+            {
+                .id = "add_stale",
+                .function = Delete_add_stale
+            },
+            {
+                .id = "set_stale",
+                .function = Delete_set_stale
             }
         }
     },
@@ -1537,7 +1835,7 @@ static bake_test_suite suites[] = {
     },
     {
         .id = "Lookup",
-        .testcase_count = 11,
+        .testcase_count = 18,
         .testcases = (bake_test_case[]){
             {
                 .id = "lookup",
@@ -1582,6 +1880,34 @@ static bake_test_suite suites[] = {
             {
                 .id = "get_id_from_empty",
                 .function = Lookup_get_id_from_empty
+            },
+            {
+                .id = "lookup_after_rename",
+                .function = Lookup_lookup_after_rename
+            },
+            {
+                .id = "lookup_after_delete",
+                .function = Lookup_lookup_after_delete
+            },
+            {
+                .id = "lookup_after_merge",
+                .function = Lookup_lookup_after_merge
+            },
+            {
+                .id = "lookup_clone",
+                .function = Lookup_lookup_clone
+            },
+            {
+                .id = "lookup_after_delete_w_filter",
+                .function = Lookup_lookup_after_delete_w_filter
+            },
+            {
+                .id = "lookup_after_rename_in_progress",
+                .function = Lookup_lookup_after_rename_in_progress
+            },
+            {
+                .id = "lookup_after_delete_in_progress",
+                .function = Lookup_lookup_after_delete_in_progress
             }
         }
     },
@@ -1683,7 +2009,7 @@ static bake_test_suite suites[] = {
     },
     {
         .id = "SystemMisc",
-        .testcase_count = 31,
+        .testcase_count = 33,
         .testcases = (bake_test_case[]){
             {
                 .id = "invalid_not_without_id",
@@ -1808,6 +2134,14 @@ static bake_test_suite suites[] = {
             {
                 .id = "table_columns_access",
                 .function = SystemMisc_table_columns_access
+            },
+            {
+                .id = "match_tables_in_creation_order",
+                .function = SystemMisc_match_tables_in_creation_order
+            },
+            {
+                .id = "match_tables_in_creation_order_after_gc",
+                .function = SystemMisc_match_tables_in_creation_order_after_gc
             }
         }
     },
@@ -2079,7 +2413,7 @@ static bake_test_suite suites[] = {
     },
     {
         .id = "SystemOnFrame",
-        .testcase_count = 44,
+        .testcase_count = 46,
         .testcases = (bake_test_case[]){
             {
                 .id = "1_type_1_component",
@@ -2256,6 +2590,14 @@ static bake_test_suite suites[] = {
             {
                 .id = "get_sys_context_from_param",
                 .function = SystemOnFrame_get_sys_context_from_param
+            },
+            {
+                .id = "column_alignment",
+                .function = SystemOnFrame_column_alignment
+            },
+            {
+                .id = "column_alignment_custom",
+                .function = SystemOnFrame_column_alignment_custom
             }
         }
     },
@@ -2441,7 +2783,7 @@ static bake_test_suite suites[] = {
     },
     {
         .id = "Prefab",
-        .testcase_count = 59,
+        .testcase_count = 62,
         .testcases = (bake_test_case[]){
             {
                 .id = "new_w_prefab",
@@ -2678,12 +3020,24 @@ static bake_test_suite suites[] = {
             {
                 .id = "override_from_nested",
                 .function = Prefab_override_from_nested
+            },
+            {
+                .id = "rematch_after_add_to_base",
+                .function = Prefab_rematch_after_add_to_base
+            },
+            {
+                .id = "rematch_after_add_base_to_prefab",
+                .function = Prefab_rematch_after_add_base_to_prefab
+            },
+            {
+                .id = "rematch_w_prefab_cycle",
+                .function = Prefab_rematch_w_prefab_cycle
             }
         }
     },
     {
         .id = "System_w_FromContainer",
-        .testcase_count = 20,
+        .testcase_count = 21,
         .testcases = (bake_test_case[]){
             {
                 .id = "1_column_from_container",
@@ -2764,6 +3118,10 @@ static bake_test_suite suites[] = {
             {
                 .id = "realloc_after_match",
                 .function = System_w_FromContainer_realloc_after_match
+            },
+            {
+                .id = "add_component_to_one_of_2_containers",
+                .function = System_w_FromContainer_add_component_to_one_of_2_containers
             }
         }
     },
@@ -2817,17 +3175,21 @@ static bake_test_suite suites[] = {
     },
     {
         .id = "System_w_FromEntity",
-        .testcase_count = 1,
+        .testcase_count = 2,
         .testcases = (bake_test_case[]){
             {
                 .id = "2_column_1_from_entity",
                 .function = System_w_FromEntity_2_column_1_from_entity
+            },
+            {
+                .id = "add_component_to_entity_after_match",
+                .function = System_w_FromEntity_add_component_to_entity_after_match
             }
         }
     },
     {
         .id = "World",
-        .testcase_count = 33,
+        .testcase_count = 51,
         .testcases = (bake_test_case[]){
             {
                 .id = "progress_w_0",
@@ -2960,12 +3322,84 @@ static bake_test_suite suites[] = {
             {
                 .id = "is_entity_enabled",
                 .function = World_is_entity_enabled
+            },
+            {
+                .id = "shrink",
+                .function = World_shrink
+            },
+            {
+                .id = "shrink_empty",
+                .function = World_shrink_empty
+            },
+            {
+                .id = "shrink_type",
+                .function = World_shrink_type
+            },
+            {
+                .id = "shrink_chunked",
+                .function = World_shrink_chunked
+            },
+            {
+                .id = "autoshrink",
+                .function = World_autoshrink
+            },
+            {
+                .id = "autoshrink_above_threshold",
+                .function = World_autoshrink_above_threshold
+            },
+            {
+                .id = "autoshrink_disable",
+                .function = World_autoshrink_disable
+            },
+            {
+                .id = "gc",
+                .function = World_gc
+            },
+            {
+                .id = "gc_non_empty",
+                .function = World_gc_non_empty
+            },
+            {
+                .id = "gc_edges",
+                .function = World_gc_edges
+            },
+            {
+                .id = "gc_system",
+                .function = World_gc_system
+            },
+            {
+                .id = "autogc",
+                .function = World_autogc
+            },
+            {
+                .id = "autogc_reset",
+                .function = World_autogc_reset
+            },
+            {
+                .id = "allocator_stats",
+                .function = World_allocator_stats
+            },
+            {
+                .id = "column_arena",
+                .function = World_column_arena
+            },
+            {
+                .id = "type_memory_stats",
+                .function = World_type_memory_stats
+            },
+            {
+                .id = "type_merge_stats",
+                .function = World_type_merge_stats
+            },
+            {
+                .id = "entity_range_add_recycled",
+                .function = World_entity_range_add_recycled
             }
         }
     },
     {
         .id = "Type",
-        .testcase_count = 41,
+        .testcase_count = 44,
         .testcases = (bake_test_case[]){
             {
                 .id = "type_of_1_tostr",
@@ -3130,12 +3564,24 @@ static bake_test_suite suites[] = {
             {
                 .id = "type_from_0",
                 .function = Type_type_from_0
+            },
+            {
+                .id = "find_large_ids",
+                .function = Type_find_large_ids
+            },
+            {
+                .id = "find_many_types",
+                .function = Type_find_many_types
+            },
+            {
+                .id = "find_not_normalized",
+                .function = Type_find_not_normalized
             }
         }
     },
     {
         .id = "Run",
-        .testcase_count = 23,
+        .testcase_count = 27,
         .testcases = (bake_test_case[]){
             {
                 .id = "run",
@@ -3228,12 +3674,28 @@ static bake_test_suite suites[] = {
             {
                 .id = "run_w_interrupt",
                 .function = Run_run_w_interrupt
+            },
+            {
+                .id = "run_w_filter_handle",
+                .function = Run_run_w_filter_handle
+            },
+            {
+                .id = "run_w_filter_handle_new_table",
+                .function = Run_run_w_filter_handle_new_table
+            },
+            {
+                .id = "run_w_filter_handle_offset_limit",
+                .function = Run_run_w_filter_handle_offset_limit
+            },
+            {
+                .id = "run_w_filter_handle_prefab",
+                .function = Run_run_w_filter_handle_prefab
             }
         }
     },
     {
         .id = "MultiThread",
-        .testcase_count = 34,
+        .testcase_count = 36,
         .testcases = (bake_test_case[]){
             {
                 .id = "2_thread_1_entity",
@@ -3370,12 +3832,20 @@ static bake_test_suite suites[] = {
             {
                 .id = "reactive_system",
                 .function = MultiThread_reactive_system
+            },
+            {
+                .id = "new_in_worker_threads",
+                .function = MultiThread_new_in_worker_threads
+            },
+            {
+                .id = "new_w_count_in_worker_threads",
+                .function = MultiThread_new_w_count_in_worker_threads
             }
         }
     },
     {
         .id = "SingleThreadStaging",
-        .testcase_count = 64,
+        .testcase_count = 65,
         .testcases = (bake_test_case[]){
             {
                 .id = "new_empty",
@@ -3632,12 +4102,16 @@ static bake_test_suite suites[] = {
             {
                 .id = "override_after_remove_in_progress",
                 .function = SingleThreadStaging_override_after_remove_in_progress
+            },
+            {
+                .id = "no_alloc_in_steady_state",
+                .function = SingleThreadStaging_no_alloc_in_steady_state
             }
         }
     },
     {
         .id = "MultiThreadStaging",
-        .testcase_count = 9,
+        .testcase_count = 10,
         .testcases = (bake_test_case[]){
             {
                 .id = "2_threads_add_to_current",
@@ -3674,6 +4148,10 @@ static bake_test_suite suites[] = {
             {
                 .id = "new_w_count",
                 .function = MultiThreadStaging_new_w_count
+            },
+            {
+                .id = "no_alloc_in_steady_state",
+                .function = MultiThreadStaging_no_alloc_in_steady_state
             }
         }
     },
@@ -3779,10 +4257,408 @@ static bake_test_suite suites[] = {
                 .function = Error_log_error
             }
         }
+    },
+    {
+        .id = "Chunked",
+        .testcase_count = 10,
+        .testcases = (bake_test_case[]){
+            {
+                .id = "iter",
+                .function = Chunked_iter
+            },
+            {
+                .id = "new_w_count",
+                .function = Chunked_new_w_count
+            },
+            {
+                .id = "rows_do_not_move",
+                .function = Chunked_rows_do_not_move
+            },
+            {
+                .id = "delete",
+                .function = Chunked_delete
+            },
+            {
+                .id = "add_remove",
+                .function = Chunked_add_remove
+            },
+            {
+                .id = "set_w_data",
+                .function = Chunked_set_w_data
+            },
+            {
+                .id = "add_in_progress",
+                .function = Chunked_add_in_progress
+            },
+            {
+                .id = "on_add",
+                .function = Chunked_on_add
+            },
+            {
+                .id = "stats",
+                .function = Chunked_stats
+            },
+            {
+                .id = "table_column",
+                .function = Chunked_table_column
+            }
+        }
+    },
+    {
+        .id = "Add_remove_w_count",
+        .testcase_count = 14,
+        .testcases = (bake_test_case[]){
+            {
+                .id = "add",
+                .function = Add_remove_w_count_add
+            },
+            {
+                .id = "remove",
+                .function = Add_remove_w_count_remove
+            },
+            {
+                .id = "add_remove",
+                .function = Add_remove_w_count_add_remove
+            },
+            {
+                .id = "remove_all",
+                .function = Add_remove_w_count_remove_all
+            },
+            {
+                .id = "add_subset",
+                .function = Add_remove_w_count_add_subset
+            },
+            {
+                .id = "add_subset_at_end",
+                .function = Add_remove_w_count_add_subset_at_end
+            },
+            {
+                .id = "add_to_existing",
+                .function = Add_remove_w_count_add_to_existing
+            },
+            {
+                .id = "not_contiguous",
+                .function = Add_remove_w_count_not_contiguous
+            },
+            {
+                .id = "watched",
+                .function = Add_remove_w_count_watched
+            },
+            {
+                .id = "on_add",
+                .function = Add_remove_w_count_on_add
+            },
+            {
+                .id = "on_remove",
+                .function = Add_remove_w_count_on_remove
+            },
+            {
+                .id = "system",
+                .function = Add_remove_w_count_system
+            },
+            {
+                .id = "chunked",
+                .function = Add_remove_w_count_chunked
+            },
+            {
+                .id = "in_progress",
+                .function = Add_remove_w_count_in_progress
+            }
+        }
+    },
+    {
+        .id = "Sort",
+        .testcase_count = 9,
+        .testcases = (bake_test_case[]){
+            {
+                .id = "sort_on_progress",
+                .function = Sort_sort_on_progress
+            },
+            {
+                .id = "sort_manual",
+                .function = Sort_sort_manual
+            },
+            {
+                .id = "sort_multiple_tables",
+                .function = Sort_sort_multiple_tables
+            },
+            {
+                .id = "sort_stable",
+                .function = Sort_sort_stable
+            },
+            {
+                .id = "sort_after_set",
+                .function = Sort_sort_after_set
+            },
+            {
+                .id = "sort_chunked",
+                .function = Sort_sort_chunked
+            },
+            {
+                .id = "sort_watched",
+                .function = Sort_sort_watched
+            },
+            {
+                .id = "sort_disable",
+                .function = Sort_sort_disable
+            },
+            {
+                .id = "sort_shared",
+                .function = Sort_sort_shared
+            }
+        }
+    },
+    {
+        .id = "Sparse",
+        .testcase_count = 22,
+        .testcases = (bake_test_case[]){
+            {
+                .id = "add_remove",
+                .function = Sparse_add_remove
+            },
+            {
+                .id = "add_does_not_move",
+                .function = Sparse_add_does_not_move
+            },
+            {
+                .id = "set_get",
+                .function = Sparse_set_get
+            },
+            {
+                .id = "new_w_type",
+                .function = Sparse_new_w_type
+            },
+            {
+                .id = "new_w_count",
+                .function = Sparse_new_w_count
+            },
+            {
+                .id = "has_any",
+                .function = Sparse_has_any
+            },
+            {
+                .id = "count",
+                .function = Sparse_count
+            },
+            {
+                .id = "delete",
+                .function = Sparse_delete
+            },
+            {
+                .id = "delete_w_count",
+                .function = Sparse_delete_w_count
+            },
+            {
+                .id = "add_w_count",
+                .function = Sparse_add_w_count
+            },
+            {
+                .id = "add_w_filter",
+                .function = Sparse_add_w_filter
+            },
+            {
+                .id = "clone",
+                .function = Sparse_clone
+            },
+            {
+                .id = "system_and",
+                .function = Sparse_system_and
+            },
+            {
+                .id = "system_not",
+                .function = Sparse_system_not
+            },
+            {
+                .id = "system_data",
+                .function = Sparse_system_data
+            },
+            {
+                .id = "system_optional",
+                .function = Sparse_system_optional
+            },
+            {
+                .id = "add_in_progress",
+                .function = Sparse_add_in_progress
+            },
+            {
+                .id = "add_in_progress_threaded",
+                .function = Sparse_add_in_progress_threaded
+            },
+            {
+                .id = "set_in_progress_threaded",
+                .function = Sparse_set_in_progress_threaded
+            },
+            {
+                .id = "set_stale",
+                .function = Sparse_set_stale
+            },
+            {
+                .id = "set_in_progress",
+                .function = Sparse_set_in_progress
+            },
+            {
+                .id = "remove_in_progress",
+                .function = Sparse_remove_in_progress
+            }
+        }
+    },
+    {
+        .id = "Enable",
+        .testcase_count = 15,
+        .testcases = (bake_test_case[]){
+            {
+                .id = "enable_disable",
+                .function = Enable_enable_disable
+            },
+            {
+                .id = "is_enabled_not_owned",
+                .function = Enable_is_enabled_not_owned
+            },
+            {
+                .id = "system_skip_disabled",
+                .function = Enable_system_skip_disabled
+            },
+            {
+                .id = "system_skip_disabled_tag",
+                .function = Enable_system_skip_disabled_tag
+            },
+            {
+                .id = "system_other_column",
+                .function = Enable_system_other_column
+            },
+            {
+                .id = "system_optional",
+                .function = Enable_system_optional
+            },
+            {
+                .id = "disable_entity",
+                .function = Enable_disable_entity
+            },
+            {
+                .id = "delete",
+                .function = Enable_delete
+            },
+            {
+                .id = "delete_w_count",
+                .function = Enable_delete_w_count
+            },
+            {
+                .id = "move_to_other_table",
+                .function = Enable_move_to_other_table
+            },
+            {
+                .id = "move_w_count",
+                .function = Enable_move_w_count
+            },
+            {
+                .id = "sort",
+                .function = Enable_sort
+            },
+            {
+                .id = "many_rows",
+                .function = Enable_many_rows
+            },
+            {
+                .id = "chunked",
+                .function = Enable_chunked
+            },
+            {
+                .id = "in_progress",
+                .function = Enable_in_progress
+            }
+        }
+    },
+    {
+        .id = "OnChange",
+        .testcase_count = 8,
+        .testcases = (bake_test_case[]){
+            {
+                .id = "skip_unchanged",
+                .function = OnChange_skip_unchanged
+            },
+            {
+                .id = "skip_unchanged_table",
+                .function = OnChange_skip_unchanged_table
+            },
+            {
+                .id = "add_remove_entity",
+                .function = OnChange_add_remove_entity
+            },
+            {
+                .id = "enable_component",
+                .function = OnChange_enable_component
+            },
+            {
+                .id = "system_writes",
+                .function = OnChange_system_writes
+            },
+            {
+                .id = "ignore_own_writes",
+                .function = OnChange_ignore_own_writes
+            },
+            {
+                .id = "set_in_progress",
+                .function = OnChange_set_in_progress
+            },
+            {
+                .id = "threaded",
+                .function = OnChange_threaded
+            }
+        }
+    },
+    {
+        .id = "Query",
+        .testcase_count = 11,
+        .testcases = (bake_test_case[]){
+            {
+                .id = "iter",
+                .function = Query_iter
+            },
+            {
+                .id = "iter_multiple_tables",
+                .function = Query_iter_multiple_tables
+            },
+            {
+                .id = "match_new_table",
+                .function = Query_match_new_table
+            },
+            {
+                .id = "skip_empty_tables",
+                .function = Query_skip_empty_tables
+            },
+            {
+                .id = "iter_w_not",
+                .function = Query_iter_w_not
+            },
+            {
+                .id = "iter_w_shared",
+                .function = Query_iter_w_shared
+            },
+            {
+                .id = "skip_disabled_components",
+                .function = Query_skip_disabled_components
+            },
+            {
+                .id = "iter_chunked",
+                .function = Query_iter_chunked
+            },
+            {
+                .id = "iter_no_tables",
+                .function = Query_iter_no_tables
+            },
+            {
+                .id = "free_in_fini",
+                .function = Query_free_in_fini
+            },
+            {
+                .id = "rematch_after_container_change",
+                .function = Query_rematch_after_container_change
+            }
+        }
     }
 };
 
 int main(int argc, char *argv[]) {
     ut_init(argv[0]);
-    return bake_test_run("api", argc, argv, suites, 38);
+    return bake_test_run("api", argc, argv, suites, 45);
 }
@@ -49,14 +49,14 @@ void Map_set_rehash() {
     ecs_map_t *map = ecs_map_new(8, sizeof(char*));
     fill_map(map);
 
-    test_int(ecs_map_bucket_count(map), 10);
+    test_int(ecs_map_bucket_count(map), 16);
 
     int i;
-    for (i = 5; i < 10; i ++) {
+    for (i = 5; i < 20; i ++) {
         ecs_map_set(map, i, &(char*){"zzz"});
     }
 
-    test_int(ecs_map_bucket_count(map), 20);
+    test_int(ecs_map_bucket_count(map), 32);
     test_str(*(char**)ecs_map_get_ptr(map, 1), "hello");
     test_str(*(char**)ecs_map_get_ptr(map, 2), "world");
     test_str(*(char**)ecs_map_get_ptr(map, 3), "foo");
@@ -123,20 +123,25 @@ void Map_iter() {
     ecs_map_t *map = ecs_map_new(16, sizeof(char*));
     fill_map(map);
 
-    ecs_map_iter_t it = ecs_map_iter(map);
-    test_assert(ecs_map_hasnext(&it) == true);
-    test_str(*(char**)ecs_map_next(&it), "hello");
-
-    test_assert(ecs_map_hasnext(&it) == true);
-    test_str(*(char**)ecs_map_next(&it), "world");
+    /* Iteration order is not defined, only check that each element is
+     * returned exactly once */
+    bool found[5] = {false};
+    int count = 0;
 
-    test_assert(ecs_map_hasnext(&it) == true);
-    test_str(*(char**)ecs_map_next(&it), "foo");
-
-    test_assert(ecs_map_hasnext(&it) == true);
-    test_str(*(char**)ecs_map_next(&it), "bar");
+    ecs_map_iter_t it = ecs_map_iter(map);
+    while (ecs_map_hasnext(&it)) {
+        uint64_t key;
+        char *value = *(char**)ecs_map_next_w_key(&it, &key);
+        test_assert(key >= 1 && key <= 4);
+        test_assert(!found[key]);
+        test_str(value, elems[key - 1].value);
+        found[key] = true;
+        count ++;
+    }
 
+    test_int(count, 4);
     test_assert(ecs_map_hasnext(&it) == false);
+    ecs_map_free(map);
 }
 
 void Map_iter_empty() {
@@ -181,3 +186,284 @@ void Map_remove_unknown() {
     ecs_map_free(map);
 }
 
+void Map_set_large_key() {
+    ecs_map_t *map = ecs_map_new(16, sizeof(char*));
+    fill_map(map);
+
+    uint64_t key = ((uint64_t)1 << 63) | 1;
+    ecs_map_set(map, key, &(char*){"large"});
+    test_int(ecs_map_count(map), 5);
+    test_str(*(char**)ecs_map_get_ptr(map, key), "large");
+    test_str(*(char**)ecs_map_get_ptr(map, 1), "hello");
+
+    ecs_map_free(map);
+}
+
+void Map_set_get_many() {
+    ecs_map_t *map = ecs_map_new(0, sizeof(uint64_t));
+
+    uint64_t i;
+    for (i = 0; i < 100000; i ++) {
+        uint64_t value = i * 3;
+        ecs_map_set(map, i * 16, &value);
+    }
+
+    test_int(ecs_map_count(map), 100000);
+
+    for (i = 0; i < 100000; i ++) {
+        uint64_t *value = ecs_map_get_ptr(map, i * 16);
+        test_assert(value != NULL);
+        test_assert(*value == i * 3);
+        test_null(ecs_map_get_ptr(map, i * 16 + 1));
+    }
+
+    ecs_map_free(map);
+}
+
+void Map_remove_reinsert() {
+    ecs_map_t *map = ecs_map_new(0, sizeof(uint64_t));
+
+    /* Repeatedly removing and inserting elements leaves deleted slots behind,
+     * which must be reused or cleaned up without growing the map. */
+    uint64_t i, value = 10;
+    for (i = 0; i < 1000; i ++) {
+        ecs_map_set(map, i, &value);
+    }
+
+    uint32_t bucket_count = ecs_map_bucket_count(map);
+
+    for (i = 0; i < 100000; i ++) {
+        test_int(ecs_map_remove(map, i), 0);
+        ecs_map_set(map, i + 1000, &value);
+        test_int(ecs_map_count(map), 1000);
+    }
+
+    test_int(ecs_map_bucket_count(map), bucket_count);
+
+    for (i = 0; i < 100000; i ++) {
+        test_bool(ecs_map_has(map, i, &value), false);
+    }
+
+    for (i = 100000; i < 101000; i ++) {
+        test_bool(ecs_map_has(map, i, &value), true);
+        test_assert(value == 10);
+    }
+
+    ecs_map_free(map);
+}
+
+void Map_load_factor() {
+    ecs_map_t *map = ecs_map_new(0, sizeof(uint64_t));
+
+    uint64_t i, value = 0;
+    for (i = 0; i < 50000; i ++) {
+        ecs_map_set(map, i, &value);
+        test_assert(ecs_map_count(map) * 8 <= ecs_map_bucket_count(map) * 7);
+    }
+
+    for (i = 0; i < 50000; i += 2) {
+        ecs_map_remove(map, i);
+    }
+
+    for (i = 50000; i < 75000; i ++) {
+        ecs_map_set(map, i, &value);
+        test_assert(ecs_map_count(map) * 8 <= ecs_map_bucket_count(map) * 7);
+    }
+
+    test_int(ecs_map_count(map), 50000);
+
+    ecs_map_free(map);
+}
+
+void Map_clear() {
+    ecs_map_t *map = ecs_map_new(16, sizeof(char*));
+    fill_map(map);
+
+    ecs_map_clear(map);
+    test_int(ecs_map_count(map), 0);
+    test_bool(ecs_map_has(map, 1, (void**)NULL), false);
+
+    fill_map(map);
+    test_int(ecs_map_count(map), 4);
+    test_str(*(char**)ecs_map_get_ptr(map, 2), "world");
+
+    ecs_map_free(map);
+}
+
+void Map_clear_shrink() {
+    ecs_map_t *map = ecs_map_new(16, sizeof(uint64_t));
+
+    uint64_t i, value = 0;
+    for (i = 0; i < 10000; i ++) {
+        ecs_map_set(map, i, &value);
+    }
+
+    for (i = 10; i < 10000; i ++) {
+        ecs_map_remove(map, i);
+    }
+
+    /* Clear keeps enough slots for the number of elements that were in the map,
+     * but releases slots that were left unused after a spike in elements */
+    test_assert(ecs_map_bucket_count(map) > 32);
+
+    ecs_map_clear(map);
+    test_int(ecs_map_bucket_count(map), 32);
+    test_int(ecs_map_count(map), 0);
+
+    ecs_map_free(map);
+}
+
+void Map_set_size() {
+    ecs_map_t *map = ecs_map_new(0, sizeof(uint64_t));
+    test_assert(ecs_map_set_size(map, 1000) >= 1000);
+
+    uint32_t bucket_count = ecs_map_bucket_count(map);
+
+    uint64_t i, value = 0;
+    for (i = 0; i < 1000; i ++) {
+        ecs_map_set(map, i, &value);
+    }
+
+    test_int(ecs_map_bucket_count(map), bucket_count);
+    test_int(ecs_map_grow(map, 10), 0);
+
+    ecs_map_free(map);
+}
+
+static
+double ns_per_op(
+    double t,
+    uint32_t count)
+{
+    return t * 1000000000.0 / count;
+}
+
+static
+uint64_t* random_keys(
+    uint32_t count,
+    uint32_t seed)
+{
+    uint64_t *keys = ecs_os_malloc(count * sizeof(uint64_t));
+    uint32_t i;
+
+    srand(seed);
+    for (i = 0; i < count; i ++) {
+        keys[i] = ((uint64_t)rand() << 32) ^ ((uint64_t)rand() << 16) ^ rand();
+    }
+
+    return keys;
+}
+
+/* Measure insert, lookup and remove throughput for sequential (entity id like)
+ * and random keys. */
+static
+void bench_throughput(
+    const char *label,
+    uint64_t *keys,
+    uint32_t count)
+{
+    ecs_map_t *map = ecs_map_new(0, sizeof(uint64_t));
+    uint64_t i, sum = 0;
+    ecs_time_t t_start;
+
+    ecs_os_get_time(&t_start);
+    for (i = 0; i < count; i ++) {
+        ecs_map_set(map, keys[i], &i);
+    }
+    double t_insert = ecs_time_measure(&t_start);
+
+    ecs_os_get_time(&t_start);
+    for (i = 0; i < count; i ++) {
+        sum += *(uint64_t*)ecs_map_get_ptr(map, keys[i]);
+    }
+    double t_get = ecs_time_measure(&t_start);
+
+    ecs_os_get_time(&t_start);
+    for (i = 0; i < count; i ++) {
+        ecs_map_remove(map, keys[i]);
+    }
+    double t_remove = ecs_time_measure(&t_start);
+
+    test_int(ecs_map_count(map), 0);
+    test_assert(sum == (uint64_t)count * (count - 1) / 2);
+
+    ecs_os_log("%s keys (%u): insert %.2fns, get %.2fns, remove %.2fns",
+        label, count,
+        ns_per_op(t_insert, count),
+        ns_per_op(t_get, count),
+        ns_per_op(t_remove, count));
+
+    ecs_map_free(map);
+}
+
+void Map_bench_throughput() {
+    const uint32_t count = 1000000;
+    uint64_t *keys = ecs_os_malloc(count * sizeof(uint64_t));
+    uint32_t i;
+    for (i = 0; i < count; i ++) {
+        keys[i] = i + 1;
+    }
+
+    bench_throughput("sequential", keys, count);
+    ecs_os_free(keys);
+
+    /* Random keys may (rarely) collide, which is fine for timing purposes but
+     * not for checking the sum, so make them unique by mixing in the index */
+    keys = random_keys(count, 1);
+    for (i = 0; i < count; i ++) {
+        keys[i] = (keys[i] << 20) | i;
+    }
+
+    bench_throughput("random", keys, count);
+    ecs_os_free(keys);
+}
+
+/* Measure lookup cost for hits and misses at different load factors. Maps are
+ * presized so that they don't grow, and are filled up to a fraction of the
+ * maximum load factor. */
+void Map_bench_load_factor() {
+    const uint32_t lookup_count = 1000000;
+    const uint32_t capacity = 1 << 20;
+    uint64_t *keys = random_keys(capacity, 2);
+    uint32_t fill;
+
+    for (fill = 25; fill <= 100; fill += 25) {
+        ecs_map_t *map = ecs_map_new(0, sizeof(uint64_t));
+        ecs_map_set_size(map, capacity * 7 / 8);
+        uint32_t bucket_count = ecs_map_bucket_count(map);
+        uint32_t i, count = (uint64_t)bucket_count * 7 / 8 * fill / 100;
+
+        for (i = 0; i < count; i ++) {
+            /* Set low bit, so that keys with low bit cleared are misses */
+            ecs_map_set(map, keys[i] | 1, &keys[i]);
+        }
+
+        test_int(ecs_map_bucket_count(map), bucket_count);
+
+        uint64_t hits = 0;
+        ecs_time_t t_start;
+
+        ecs_os_get_time(&t_start);
+        for (i = 0; i < lookup_count; i ++) {
+            hits += ecs_map_get_ptr(map, keys[i % count] | 1) != NULL;
+        }
+        double t_hit = ecs_time_measure(&t_start);
+
+        ecs_os_get_time(&t_start);
+        for (i = 0; i < lookup_count; i ++) {
+            hits += ecs_map_get_ptr(map, keys[i % count] & ~1ULL) != NULL;
+        }
+        double t_miss = ecs_time_measure(&t_start);
+
+        test_int(hits, lookup_count);
+
+        ecs_os_log("load %.3f (%u elements): hit %.2fns, miss %.2fns",
+            (double)ecs_map_count(map) / bucket_count, ecs_map_count(map),
+            ns_per_op(t_hit, lookup_count),
+            ns_per_op(t_miss, lookup_count));
+
+        ecs_map_free(map);
+    }
+
+    ecs_os_free(keys);
+}
@@ -0,0 +1,297 @@
+#include <collections.h>
+
+void Slab_setup() {
+    ecs_os_set_api_defaults();
+}
+
+void Slab_alloc_release() {
+    ecs_slab_t *slab = ecs_slab_new(4096);
+
+    int *ptr = ecs_slab_alloc(slab, sizeof(int) * 4);
+    test_assert(ptr != NULL);
+    test_assert(((uintptr_t)ptr & 15) == 0);
+    test_assert(ecs_slab_owner(ptr) == slab);
+
+    ptr[0] = 10;
+    ptr[3] = 20;
+
+    ecs_slab_release(slab, ptr);
+    ecs_slab_free(slab);
+}
+
+void Slab_reuse_released() {
+    ecs_slab_t *slab = ecs_slab_new(4096);
+
+    void *ptr_1 = ecs_slab_alloc(slab, 40);
+    ecs_slab_release(slab, ptr_1);
+
+    /* Allocations of the same size class reuse released memory */
+    void *ptr_2 = ecs_slab_alloc(slab, 48);
+    test_assert(ptr_1 == ptr_2);
+
+    ecs_slab_stats_t stats;
+    ecs_slab_get_stats(slab, &stats);
+    test_int(stats.alloc_count, 2);
+    test_int(stats.os_alloc_count, 1);
+
+    ecs_slab_release(slab, ptr_2);
+    ecs_slab_free(slab);
+}
+
+void Slab_size_classes() {
+    ecs_slab_t *slab = ecs_slab_new(4096);
+
+    void *ptrs[64];
+    int i;
+    for (i = 0; i < 64; i ++) {
+        ptrs[i] = ecs_slab_alloc(slab, (i + 1) * 50);
+        memset(ptrs[i], i, (i + 1) * 50);
+    }
+
+    /* Make sure that allocations do not overlap */
+    for (i = 0; i < 64; i ++) {
+        unsigned char *bytes = ptrs[i];
+        int j;
+        for (j = 0; j < (i + 1) * 50; j ++) {
+            test_int(bytes[j], i);
+        }
+    }
+
+    for (i = 0; i < 64; i ++) {
+        ecs_slab_release(slab, ptrs[i]);
+    }
+
+    ecs_slab_stats_t stats;
+    ecs_slab_get_stats(slab, &stats);
+    test_int(stats.used, 0);
+
+    ecs_slab_free(slab);
+}
+
+void Slab_realloc_same_class() {
+    ecs_slab_t *slab = ecs_slab_new(4096);
+
+    void *ptr = ecs_slab_alloc(slab, 1000);
+    void *ptr_2 = ecs_slab_realloc(slab, ptr, 1008);
+    test_assert(ptr == ptr_2);
+
+    ecs_slab_release(slab, ptr_2);
+    ecs_slab_free(slab);
+}
+
+void Slab_realloc_grow() {
+    ecs_slab_t *slab = ecs_slab_new(4096);
+
+    int *ptr = ecs_slab_alloc(slab, sizeof(int) * 4);
+    int i;
+    for (i = 0; i < 4; i ++) {
+        ptr[i] = i;
+    }
+
+    /* Grow past the largest size class of the slab */
+    ptr = ecs_slab_realloc(slab, ptr, sizeof(int) * 4096);
+    for (i = 0; i < 4; i ++) {
+        test_int(ptr[i], i);
+    }
+
+    ptr[4095] = 10;
+
+    ecs_slab_stats_t stats;
+    ecs_slab_get_stats(slab, &stats);
+    test_assert(stats.used >= sizeof(int) * 4096);
+
+    ecs_slab_release(slab, ptr);
+
+    ecs_slab_get_stats(slab, &stats);
+    test_int(stats.used, 0);
+
+    ecs_slab_free(slab);
+}
+
+void Slab_large_alloc() {
+    ecs_slab_t *slab = ecs_slab_new(4096);
+
+    void *ptr = ecs_slab_alloc(slab, 10000);
+    test_assert(ecs_slab_owner(ptr) == slab);
+
+    ecs_slab_stats_t stats;
+    ecs_slab_get_stats(slab, &stats);
+    test_int(stats.allocd, stats.used);
+
+    ecs_slab_release(slab, ptr);
+
+    ecs_slab_get_stats(slab, &stats);
+    test_int(stats.allocd, 0);
+
+    ecs_slab_free(slab);
+}
+
+void Slab_arena() {
+    ecs_slab_t *slab = ecs_slab_new(4096);
+    ecs_slab_t *arena = ecs_slab_new(1024 * 1024);
+    ecs_slab_set_arena(slab, arena);
+
+    void *small = ecs_slab_alloc(slab, 100);
+    test_assert(ecs_slab_owner(small) == slab);
+
+    void *large = ecs_slab_alloc(slab, 100000);
+    test_assert(ecs_slab_owner(large) == arena);
+    ecs_slab_release(slab, large);
+
+    /* Released memory is kept by the arena */
+    void *large_2 = ecs_slab_alloc(slab, 100000);
+    test_assert(large == large_2);
+
+    ecs_slab_stats_t stats;
+    ecs_slab_get_stats(arena, &stats);
+    test_int(stats.alloc_count, 2);
+    test_int(stats.os_alloc_count, 1);
+
+    ecs_slab_release(slab, large_2);
+    ecs_slab_release(slab, small);
+
+    ecs_slab_free(slab);
+    ecs_slab_free(arena);
+}
+
+void Slab_no_slab() {
+    int *ptr = ecs_slab_calloc(NULL, sizeof(int) * 4);
+    test_int(ptr[3], 0);
+
+    ptr = ecs_slab_realloc(NULL, ptr, sizeof(int) * 8);
+    ptr[7] = 10;
+
+    ecs_slab_release(NULL, ptr);
+}
+
+void Slab_vector() {
+    ecs_slab_t *slab = ecs_slab_new(4096);
+    ecs_vector_params_t params = {.element_size = sizeof(int), .slab = slab};
+
+    ecs_vector_t *v = NULL;
+    int i;
+    for (i = 0; i < 2000; i ++) {
+        int *elem = ecs_vector_add(&v, &params);
+        *elem = i;
+    }
+
+    int *buffer = ecs_vector_first(v);
+    for (i = 0; i < 2000; i ++) {
+        test_int(buffer[i], i);
+    }
+
+    ecs_vector_free(v);
+
+    ecs_slab_stats_t stats;
+    ecs_slab_get_stats(slab, &stats);
+    test_int(stats.used, 0);
+
+    ecs_slab_free(slab);
+}
+
+void Slab_vector_aligned() {
+    ecs_slab_t *slab = ecs_slab_new(4096);
+    ecs_vector_params_t params = {
+        .element_size = sizeof(int), .alignment = 64, .slab = slab
+    };
+
+    ecs_vector_t *v = NULL;
+    int i;
+    for (i = 0; i < 100; i ++) {
+        int *elem = ecs_vector_add(&v, &params);
+        *elem = i;
+        test_assert(((uintptr_t)ecs_vector_first(v) & 63) == 0);
+    }
+
+    int *buffer = ecs_vector_first(v);
+    for (i = 0; i < 100; i ++) {
+        test_int(buffer[i], i);
+    }
+
+    ecs_vector_reclaim(&v, &params);
+    test_assert(((uintptr_t)ecs_vector_first(v) & 63) == 0);
+
+    ecs_vector_free(v);
+
+    ecs_slab_stats_t stats;
+    ecs_slab_get_stats(slab, &stats);
+    test_int(stats.used, 0);
+
+    ecs_slab_free(slab);
+}
+
+void Slab_map() {
+    ecs_slab_t *slab = ecs_slab_new(4096);
+    ecs_map_t *map = ecs_map_new_w_slab(0, sizeof(int), slab);
+
+    int i;
+    for (i = 0; i < 1000; i ++) {
+        ecs_map_set(map, i, &i);
+    }
+
+    for (i = 0; i < 1000; i ++) {
+        int value;
+        test_assert(ecs_map_has(map, i, &value));
+        test_int(value, i);
+    }
+
+    ecs_map_free(map);
+
+    ecs_slab_stats_t stats;
+    ecs_slab_get_stats(slab, &stats);
+    test_int(stats.used, 0);
+
+    ecs_slab_free(slab);
+}
+
+void Slab_bump_alloc() {
+    ecs_slab_t *slab = ecs_slab_new_bump(1024);
+
+    int *ptr_1 = ecs_slab_alloc(slab, sizeof(int) * 4);
+    int *ptr_2 = ecs_slab_alloc(slab, sizeof(int) * 4);
+    test_assert(ptr_1 != ptr_2);
+    test_assert(((uintptr_t)ptr_2 & 15) == 0);
+    test_assert(ecs_slab_owner(ptr_2) == slab);
+
+    /* The last allocation is grown in place */
+    int *ptr_3 = ecs_slab_realloc(slab, ptr_2, sizeof(int) * 8);
+    test_assert(ptr_2 == ptr_3);
+
+    /* Allocations that do not fit in a block get their own block */
+    void *large = ecs_slab_alloc(slab, 4096);
+    test_assert(large != NULL);
+
+    ecs_slab_stats_t stats;
+    ecs_slab_get_stats(slab, &stats);
+    test_int(stats.os_alloc_count, 2);
+
+    ecs_slab_free(slab);
+}
+
+void Slab_bump_reset() {
+    ecs_slab_t *slab = ecs_slab_new_bump(1024);
+
+    int i;
+    for (i = 0; i < 10; i ++) {
+        ecs_slab_alloc(slab, 500);
+    }
+
+    ecs_slab_stats_t stats;
+    ecs_slab_get_stats(slab, &stats);
+    test_assert(stats.os_alloc_count > 1);
+
+    /* After a reset, the same allocations fit in a single block */
+    ecs_slab_reset(slab);
+    ecs_slab_get_stats(slab, &stats);
+    test_int(stats.used, 0);
+
+    uint32_t os_alloc_count = stats.os_alloc_count;
+    for (i = 0; i < 10; i ++) {
+        ecs_slab_alloc(slab, 500);
+    }
+
+    ecs_slab_get_stats(slab, &stats);
+    test_int(stats.os_alloc_count, os_alloc_count);
+
+    ecs_slab_free(slab);
+}
@@ -0,0 +1,293 @@
+#include <collections.h>
+
+typedef struct row_t {
+    void *type;
+    int32_t index;
+} row_t;
+
+static
+void fill_sparse(
+    ecs_sparse_t *sparse,
+    uint64_t count)
+{
+    uint64_t i;
+    for (i = 1; i <= count; i ++) {
+        ecs_sparse_set(sparse, i, &((row_t){.index = i}));
+    }
+}
+
+void Sparse_setup() {
+    ecs_os_set_api_defaults();
+}
+
+void Sparse_count() {
+    ecs_sparse_t *sparse = ecs_sparse_new(0, sizeof(row_t));
+    fill_sparse(sparse, 4);
+    test_int(ecs_sparse_count(sparse), 4);
+    ecs_sparse_free(sparse);
+}
+
+void Sparse_count_empty() {
+    ecs_sparse_t *sparse = ecs_sparse_new(0, sizeof(row_t));
+    test_int(ecs_sparse_count(sparse), 0);
+    ecs_sparse_free(sparse);
+}
+
+void Sparse_set_overwrite() {
+    ecs_sparse_t *sparse = ecs_sparse_new(0, sizeof(row_t));
+    fill_sparse(sparse, 4);
+    ecs_sparse_set(sparse, 2, &((row_t){.index = 10}));
+    test_int(ecs_sparse_count(sparse), 4);
+
+    row_t row;
+    test_bool(ecs_sparse_has(sparse, 2, &row), true);
+    test_int(row.index, 10);
+    ecs_sparse_free(sparse);
+}
+
+void Sparse_set_zero() {
+    ecs_sparse_t *sparse = ecs_sparse_new(0, sizeof(row_t));
+    ecs_sparse_set(sparse, 1, &((row_t){0}));
+
+    row_t row = {.index = 10};
+    test_bool(ecs_sparse_has(sparse, 1, &row), true);
+    test_int(row.index, 0);
+    test_int(ecs_sparse_count(sparse), 1);
+    ecs_sparse_free(sparse);
+}
+
+void Sparse_set_large_key() {
+    ecs_sparse_t *sparse = ecs_sparse_new(0, sizeof(row_t));
+    fill_sparse(sparse, 4);
+
+    uint64_t key = (uint64_t)1 << 62;
+    ecs_sparse_set(sparse, key, &((row_t){.index = 10}));
+    test_int(ecs_sparse_count(sparse), 5);
+
+    row_t *row = ecs_sparse_get_ptr(sparse, key);
+    test_assert(row != NULL);
+    test_int(row->index, 10);
+
+    test_int(ecs_sparse_remove(sparse, key), 0);
+    test_null(ecs_sparse_get_ptr(sparse, key));
+    test_int(ecs_sparse_count(sparse), 4);
+    ecs_sparse_free(sparse);
+}
+
+void Sparse_get() {
+    ecs_sparse_t *sparse = ecs_sparse_new(0, sizeof(row_t));
+    fill_sparse(sparse, 4);
+
+    row_t *row = ecs_sparse_get_ptr(sparse, 3);
+    test_assert(row != NULL);
+    test_int(row->index, 3);
+    ecs_sparse_free(sparse);
+}
+
+void Sparse_get_all() {
+    ecs_sparse_t *sparse = ecs_sparse_new(0, sizeof(row_t));
+    fill_sparse(sparse, 10000);
+
+    uint64_t i;
+    for (i = 1; i <= 10000; i ++) {
+        row_t *row = ecs_sparse_get_ptr(sparse, i);
+        test_assert(row != NULL);
+        test_int(row->index, i);
+    }
+
+    ecs_sparse_free(sparse);
+}
+
+void Sparse_get_empty() {
+    ecs_sparse_t *sparse = ecs_sparse_new(0, sizeof(row_t));
+    test_null(ecs_sparse_get_ptr(sparse, 1));
+    ecs_sparse_free(sparse);
+}
+
+void Sparse_get_unknown() {
+    ecs_sparse_t *sparse = ecs_sparse_new(0, sizeof(row_t));
+    fill_sparse(sparse, 4);
+    test_null(ecs_sparse_get_ptr(sparse, 5));
+    test_null(ecs_sparse_get_ptr(sparse, 100000));
+    test_null(ecs_sparse_get_ptr(sparse, (uint64_t)1 << 62));
+    ecs_sparse_free(sparse);
+}
+
+void Sparse_remove() {
+    ecs_sparse_t *sparse = ecs_sparse_new(0, sizeof(row_t));
+    fill_sparse(sparse, 4);
+
+    test_int(ecs_sparse_remove(sparse, 2), 0);
+    test_int(ecs_sparse_count(sparse), 3);
+    test_null(ecs_sparse_get_ptr(sparse, 2));
+    test_int(((row_t*)ecs_sparse_get_ptr(sparse, 1))->index, 1);
+    test_int(((row_t*)ecs_sparse_get_ptr(sparse, 3))->index, 3);
+    test_int(((row_t*)ecs_sparse_get_ptr(sparse, 4))->index, 4);
+    ecs_sparse_free(sparse);
+}
+
+void Sparse_remove_last() {
+    ecs_sparse_t *sparse = ecs_sparse_new(0, sizeof(row_t));
+    fill_sparse(sparse, 4);
+
+    test_int(ecs_sparse_remove(sparse, 4), 0);
+    test_int(ecs_sparse_count(sparse), 3);
+    test_null(ecs_sparse_get_ptr(sparse, 4));
+    test_int(((row_t*)ecs_sparse_get_ptr(sparse, 3))->index, 3);
+    ecs_sparse_free(sparse);
+}
+
+void Sparse_remove_empty() {
+    ecs_sparse_t *sparse = ecs_sparse_new(0, sizeof(row_t));
+    test_int(ecs_sparse_remove(sparse, 1), -1);
+    ecs_sparse_free(sparse);
+}
+
+void Sparse_remove_unknown() {
+    ecs_sparse_t *sparse = ecs_sparse_new(0, sizeof(row_t));
+    fill_sparse(sparse, 4);
+    test_int(ecs_sparse_remove(sparse, 5), -1);
+    test_int(ecs_sparse_count(sparse), 4);
+    ecs_sparse_free(sparse);
+}
+
+void Sparse_iter() {
+    ecs_sparse_t *sparse = ecs_sparse_new(0, sizeof(row_t));
+    fill_sparse(sparse, 4);
+    ecs_sparse_remove(sparse, 2);
+
+    ecs_sparse_iter_t it = ecs_sparse_iter(sparse);
+    int32_t count = 0;
+    bool found[5] = {false};
+
+    while (ecs_sparse_hasnext(&it)) {
+        uint64_t key;
+        row_t *row = ecs_sparse_next_w_key(&it, &key);
+        test_assert(key <= 4);
+        test_int(row->index, key);
+        found[key] = true;
+        count ++;
+    }
+
+    test_int(count, 3);
+    test_bool(found[1], true);
+    test_bool(found[2], false);
+    test_bool(found[3], true);
+    test_bool(found[4], true);
+    ecs_sparse_free(sparse);
+}
+
+void Sparse_iter_empty() {
+    ecs_sparse_t *sparse = ecs_sparse_new(0, sizeof(row_t));
+    ecs_sparse_iter_t it = ecs_sparse_iter(sparse);
+    test_bool(ecs_sparse_hasnext(&it), false);
+    ecs_sparse_free(sparse);
+}
+
+void Sparse_clear() {
+    ecs_sparse_t *sparse = ecs_sparse_new(0, sizeof(row_t));
+    fill_sparse(sparse, 4);
+    ecs_sparse_set(sparse, (uint64_t)1 << 62, &((row_t){.index = 10}));
+
+    ecs_sparse_clear(sparse);
+    test_int(ecs_sparse_count(sparse), 0);
+    test_null(ecs_sparse_get_ptr(sparse, 1));
+    test_null(ecs_sparse_get_ptr(sparse, (uint64_t)1 << 62));
+
+    fill_sparse(sparse, 2);
+    test_int(ecs_sparse_count(sparse), 2);
+    test_int(((row_t*)ecs_sparse_get_ptr(sparse, 2))->index, 2);
+    ecs_sparse_free(sparse);
+}
+
+void Sparse_grow() {
+    ecs_sparse_t *sparse = ecs_sparse_new(0, sizeof(row_t));
+    test_int(ecs_sparse_grow(sparse, 100), 100);
+    test_int(ecs_sparse_grow(sparse, 50), 0);
+    test_int(ecs_sparse_count(sparse), 0);
+    ecs_sparse_free(sparse);
+}
+
+void Sparse_memory_null() {
+    uint32_t allocd = 0, used = 0;
+    ecs_sparse_memory(NULL, &allocd, &used);
+    test_int(allocd, 0);
+    test_int(used, 0);
+}
+
+/* Compare random lookups in a sparse set with lookups in a map, for the same
+ * number of keys and the same (random) lookup order. */
+static
+void bench_get(
+    uint32_t count)
+{
+    const uint32_t lookup_count = 1000000;
+    uint64_t *keys = ecs_os_malloc(lookup_count * sizeof(uint64_t));
+    uint32_t i;
+
+    srand(count);
+    for (i = 0; i < lookup_count; i ++) {
+        keys[i] = ((((uint64_t)rand() << 16) ^ rand()) % count) + 1;
+    }
+
+    ecs_sparse_t *sparse = ecs_sparse_new(count, sizeof(row_t));
+    ecs_map_t *map = ecs_map_new(count, sizeof(row_t));
+
+    for (i = 1; i <= count; i ++) {
+        ecs_sparse_set(sparse, i, &((row_t){.index = i}));
+        ecs_map_set(map, i, &((row_t){.index = i}));
+    }
+
+    int64_t sum_sparse = 0, sum_map = 0;
+    ecs_time_t t_start;
+
+    ecs_os_get_time(&t_start);
+    for (i = 0; i < lookup_count; i ++) {
+        row_t *row = ecs_sparse_get_ptr(sparse, keys[i]);
+        sum_sparse += row->index;
+    }
+    double t_sparse = ecs_time_measure(&t_start);
+
+    ecs_os_get_time(&t_start);
+    for (i = 0; i < lookup_count; i ++) {
+        row_t *row = ecs_map_get_ptr(map, keys[i]);
+        sum_map += row->index;
+    }
+    double t_map = ecs_time_measure(&t_start);
+
+    test_assert(sum_sparse == sum_map);
+
+    ecs_os_log("%u entities, %u random lookups: sparse %.2fns, map %.2fns",
+        count, lookup_count,
+        t_sparse * 1000000000.0 / lookup_count,
+        t_map * 1000000000.0 / lookup_count);
+
+    ecs_sparse_free(sparse);
+    ecs_map_free(map);
+    ecs_os_free(keys);
+}
+
+void Sparse_bench_get_1m() {
+    bench_get(1000000);
+}
+
+void Sparse_bench_get_10m() {
+    bench_get(10000000);
+}
+
+void Sparse_set_stale() {
+    ecs_sparse_t *sparse = ecs_sparse_new(0, sizeof(row_t));
+    fill_sparse(sparse, 4);
+
+    /* Key with the same index as 2 but a different generation */
+    uint64_t stale = ((uint64_t)1 << 32) | 2;
+    test_bool(ecs_sparse_is_stale(sparse, stale), true);
+    test_bool(ecs_sparse_is_stale(sparse, 2), false);
+    test_bool(ecs_sparse_is_stale(sparse, 5), false);
+
+    test_null(ecs_sparse_set(sparse, stale, &((row_t){.index = 10})));
+    test_null(ecs_sparse_get_ptr(sparse, stale));
+    test_int(ecs_sparse_count(sparse), 4);
+    test_int(((row_t*)ecs_sparse_get_ptr(sparse, 2))->index, 2);
+    ecs_sparse_free(sparse);
+}
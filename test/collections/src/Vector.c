@@ -328,3 +328,62 @@ void Vector_pop_elements() {
 
     ecs_vector_free(array);
 }
+
+static
+ecs_vector_params_t aligned_params = {
+    .element_size = sizeof(int),
+    .alignment = 64
+};
+
+void Vector_aligned_new() {
+    ecs_vector_t *array = ecs_vector_new(&aligned_params, 4);
+    test_assert(array != NULL);
+    test_int((uintptr_t)ecs_vector_first(array) % 64, 0);
+    ecs_vector_free(array);
+}
+
+void Vector_aligned_add() {
+    ecs_vector_t *array = NULL;
+    int i;
+
+    for (i = 0; i < 1000; i ++) {
+        int *elem = ecs_vector_add(&array, &aligned_params);
+        *elem = i;
+        test_int((uintptr_t)ecs_vector_first(array) % 64, 0);
+    }
+
+    test_int(ecs_vector_count(array), 1000);
+
+    int *buffer = ecs_vector_first(array);
+    for (i = 0; i < 1000; i ++) {
+        test_int(buffer[i], i);
+    }
+
+    ecs_vector_free(array);
+}
+
+void Vector_aligned_set_size() {
+    ecs_vector_t *array = NULL;
+    ecs_vector_set_count(&array, &aligned_params, 3);
+    test_int((uintptr_t)ecs_vector_first(array) % 64, 0);
+
+    ecs_vector_set_size(&array, &aligned_params, 100);
+    test_int(ecs_vector_size(array), 100);
+    test_int(ecs_vector_count(array), 3);
+    test_int((uintptr_t)ecs_vector_first(array) % 64, 0);
+
+    ecs_vector_reclaim(&array, &aligned_params);
+    test_int(ecs_vector_size(array), 3);
+    test_int((uintptr_t)ecs_vector_first(array) % 64, 0);
+
+    ecs_vector_free(array);
+}
+
+void Vector_aligned_memory() {
+    ecs_vector_t *array = ecs_vector_new(&aligned_params, 4);
+    uint32_t allocd = 0, used = 0;
+    ecs_vector_memory(array, &aligned_params, &allocd, &used);
+    test_assert(allocd >= 4 * sizeof(int) + 64);
+    test_int(used, 0);
+    ecs_vector_free(array);
+}
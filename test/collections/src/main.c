@@ -33,6 +33,10 @@ void Vector_size_of_null(void);
 void Vector_remove_index_w_move(void);
 void Vector_set_size_smaller_than_count(void);
 void Vector_pop_elements(void);
+void Vector_aligned_new(void);
+void Vector_aligned_add(void);
+void Vector_aligned_set_size(void);
+void Vector_aligned_memory(void);
 
 // Testsuite 'Map'
 void Map_setup(void);
@@ -51,6 +55,15 @@ void Map_iter_zero_buckets(void);
 void Map_remove(void);
 void Map_remove_empty(void);
 void Map_remove_unknown(void);
+void Map_set_large_key(void);
+void Map_set_get_many(void);
+void Map_remove_reinsert(void);
+void Map_load_factor(void);
+void Map_clear(void);
+void Map_clear_shrink(void);
+void Map_set_size(void);
+void Map_bench_throughput(void);
+void Map_bench_load_factor(void);
 
 // Testsuite 'Chunked'
 void Chunked_setup(void);
@@ -70,10 +83,50 @@ void Chunked_clear_n(void);
 void Chunked_clear_n_chunks(void);
 void Chunked_memory_null(void);
 
+// Testsuite 'Sparse'
+void Sparse_setup(void);
+void Sparse_count(void);
+void Sparse_count_empty(void);
+void Sparse_set_overwrite(void);
+void Sparse_set_zero(void);
+void Sparse_set_large_key(void);
+void Sparse_get(void);
+void Sparse_get_all(void);
+void Sparse_get_empty(void);
+void Sparse_get_unknown(void);
+void Sparse_remove(void);
+void Sparse_remove_last(void);
+void Sparse_remove_empty(void);
+void Sparse_remove_unknown(void);
+void Sparse_iter(void);
+void Sparse_iter_empty(void);
+void Sparse_clear(void);
+void Sparse_grow(void);
+void Sparse_memory_null(void);
+void Sparse_bench_get_1m(void);
+void Sparse_bench_get_10m(void);
+void Sparse_set_stale(void);
+
+// Testsuite 'Slab'
+void Slab_setup(void);
+void Slab_alloc_release(void);
+void Slab_reuse_released(void);
+void Slab_size_classes(void);
+void Slab_realloc_same_class(void);
+void Slab_realloc_grow(void);
+void Slab_large_alloc(void);
+void Slab_arena(void);
+void Slab_no_slab(void);
+void Slab_vector(void);
+void Slab_vector_aligned(void);
+void Slab_map(void);
+void Slab_bump_alloc(void);
+void Slab_bump_reset(void);
+
 static bake_test_suite suites[] = {
     {
         .id = "Vector",
-        .testcase_count = 23,
+        .testcase_count = 27,
         .setup = Vector_setup,
         .testcases = (bake_test_case[]){
             {
@@ -167,12 +220,28 @@ static bake_test_suite suites[] = {
             {
                 .id = "pop_elements",
                 .function = Vector_pop_elements
+            },
+            {
+                .id = "aligned_new",
+                .function = Vector_aligned_new
+            },
+            {
+                .id = "aligned_add",
+                .function = Vector_aligned_add
+            },
+            {
+                .id = "aligned_set_size",
+                .function = Vector_aligned_set_size
+            },
+            {
+                .id = "aligned_memory",
+                .function = Vector_aligned_memory
             }
         }
     },
     {
         .id = "Map",
-        .testcase_count = 15,
+        .testcase_count = 24,
         .setup = Map_setup,
         .testcases = (bake_test_case[]){
             {
@@ -234,6 +303,42 @@ static bake_test_suite suites[] = {
             {
                 .id = "remove_unknown",
                 .function = Map_remove_unknown
+            },
+            {
+                .id = "set_large_key",
+                .function = Map_set_large_key
+            },
+            {
+                .id = "set_get_many",
+                .function = Map_set_get_many
+            },
+            {
+                .id = "remove_reinsert",
+                .function = Map_remove_reinsert
+            },
+            {
+                .id = "load_factor",
+                .function = Map_load_factor
+            },
+            {
+                .id = "clear",
+                .function = Map_clear
+            },
+            {
+                .id = "clear_shrink",
+                .function = Map_clear_shrink
+            },
+            {
+                .id = "set_size",
+                .function = Map_set_size
+            },
+            {
+                .id = "bench_throughput",
+                .function = Map_bench_throughput
+            },
+            {
+                .id = "bench_load_factor",
+                .function = Map_bench_load_factor
             }
         }
     },
@@ -303,10 +408,160 @@ static bake_test_suite suites[] = {
                 .function = Chunked_memory_null
             }
         }
+    },
+    {
+        .id = "Sparse",
+        .testcase_count = 21,
+        .setup = Sparse_setup,
+        .testcases = (bake_test_case[]){
+            {
+                .id = "count",
+                .function = Sparse_count
+            },
+            {
+                .id = "count_empty",
+                .function = Sparse_count_empty
+            },
+            {
+                .id = "set_overwrite",
+                .function = Sparse_set_overwrite
+            },
+            {
+                .id = "set_zero",
+                .function = Sparse_set_zero
+            },
+            {
+                .id = "set_large_key",
+                .function = Sparse_set_large_key
+            },
+            {
+                .id = "get",
+                .function = Sparse_get
+            },
+            {
+                .id = "get_all",
+                .function = Sparse_get_all
+            },
+            {
+                .id = "get_empty",
+                .function = Sparse_get_empty
+            },
+            {
+                .id = "get_unknown",
+                .function = Sparse_get_unknown
+            },
+            {
+                .id = "remove",
+                .function = Sparse_remove
+            },
+            {
+                .id = "remove_last",
+                .function = Sparse_remove_last
+            },
+            {
+                .id = "remove_empty",
+                .function = Sparse_remove_empty
+            },
+            {
+                .id = "remove_unknown",
+                .function = Sparse_remove_unknown
+            },
+            {
+                .id = "iter",
+                .function = Sparse_iter
+            },
+            {
+                .id = "iter_empty",
+                .function = Sparse_iter_empty
+            },
+            {
+                .id = "clear",
+                .function = Sparse_clear
+            },
+            {
+                .id = "grow",
+                .function = Sparse_grow
+            },
+            {
+                .id = "memory_null",
+                .function = Sparse_memory_null
+            },
+            {
+                .id = "bench_get_1m",
+                .function = Sparse_bench_get_1m
+            },
+            {
+                .id = "bench_get_10m",
+                .function = Sparse_bench_get_10m
+            },
+            {
+                .id = "set_stale",
+                .function = Sparse_set_stale
+            }
+        }
+    },
+    {
+        .id = "Slab",
+        .testcase_count = 13,
+        .setup = Slab_setup,
+        .testcases = (bake_test_case[]){
+            {
+                .id = "alloc_release",
+                .function = Slab_alloc_release
+            },
+            {
+                .id = "reuse_released",
+                .function = Slab_reuse_released
+            },
+            {
+                .id = "size_classes",
+                .function = Slab_size_classes
+            },
+            {
+                .id = "realloc_same_class",
+                .function = Slab_realloc_same_class
+            },
+            {
+                .id = "realloc_grow",
+                .function = Slab_realloc_grow
+            },
+            {
+                .id = "large_alloc",
+                .function = Slab_large_alloc
+            },
+            {
+                .id = "arena",
+                .function = Slab_arena
+            },
+            {
+                .id = "no_slab",
+                .function = Slab_no_slab
+            },
+            {
+                .id = "vector",
+                .function = Slab_vector
+            },
+            {
+                .id = "vector_aligned",
+                .function = Slab_vector_aligned
+            },
+            {
+                .id = "map",
+                .function = Slab_map
+            },
+            {
+                .id = "bump_alloc",
+                .function = Slab_bump_alloc
+            },
+            {
+                .id = "bump_reset",
+                .function = Slab_bump_reset
+            }
+        }
     }
 };
 
 int main(int argc, char *argv[]) {
     ut_init(argv[0]);
-    return bake_test_run("collections", argc, argv, suites, 3);
+    return bake_test_run("collections", argc, argv, suites, 5);
 }